@@ -0,0 +1,41 @@
+//
+// Blinking LED output.
+//
+// Frequencies that the PWM slice of the pin can produce are generated in
+// hardware and cost no CPU time per cycle. Lower frequencies are generated
+// by the blink task from a schedule that is kept in microseconds, so the
+// rounding of each edge to a tick never accumulates into drift.
+//
+// The setting is read from a PublishedState, so the LED state and the
+// frequency are always seen together and a new setting wakes the task.
+//
+
+#ifndef BLINKOUTPUT_H
+#define BLINKOUTPUT_H
+
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pico/stdlib.h"
+#include "PublishedState.h"
+#include "BlinkSchedule.h"
+
+struct BlinkSetting {
+    bool on;
+    uint32_t frequency_hz;
+};
+
+class BlinkOutput {
+public:
+    BlinkOutput(uint pin, PublishedState<BlinkSetting> &setting);
+    BlinkOutput(const BlinkOutput &) = delete;
+    // blink task body, never returns
+    [[noreturn]] void run();
+private:
+    bool start_pwm(uint32_t frequency_hz);
+    void start_gpio();
+    uint pin;
+    PublishedState<BlinkSetting> &setting;
+};
+
+#endif //BLINKOUTPUT_H
@@ -0,0 +1,102 @@
+//
+// State published by one writer task and read by any number of tasks on
+// either core.
+//
+// The value is kept in two slots, each guarded by its own sequence counter.
+// The writer always fills the slot that readers are not directed to and then
+// publishes its version. A reader copies the newest complete slot and
+// retries only if that slot was rewritten during the copy, which takes two
+// publishes. Readers never block and a reader that preempts the writer in
+// the middle of an update still finds a complete slot to read.
+//
+// Tasks can subscribe to be notified with xTaskNotify(eSetBits) on publish.
+//
+
+#ifndef PUBLISHEDSTATE_H
+#define PUBLISHEDSTATE_H
+
+#include <atomic>
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "task.h"
+
+template<typename T, int MaxSubscribers = 4>
+class PublishedState {
+public:
+    explicit PublishedState(const T &initial) : version{0}, subscriber_count{0} {
+        slots[0].value = initial;
+        slots[0].version = 0;
+        slots[0].sequence.store(0, std::memory_order_relaxed);
+        slots[1].sequence.store(0, std::memory_order_relaxed);
+    }
+    PublishedState(const PublishedState &) = delete;
+
+    // only one task may publish
+    void publish(const T &value) {
+        uint32_t next = version.load(std::memory_order_relaxed) + 1;
+        Slot &slot = slots[next & 1];
+        uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);  // odd: being written
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.version = next;
+        slot.value = value;
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.sequence.store(sequence + 2, std::memory_order_relaxed);
+        version.store(next, std::memory_order_release);
+
+        for (int i = 0; i < subscriber_count; ++i) {
+            xTaskNotify(subscribers[i].task, subscribers[i].bits, eSetBits);
+        }
+    }
+
+    // consistent copy of the latest published value, version is optional
+    T read(uint32_t *read_version = nullptr) const {
+        for (;;) {
+            uint32_t current = version.load(std::memory_order_acquire);
+            const Slot &slot = slots[current & 1];
+            uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;  // writer has moved on to this slot, newer version is on the way
+            }
+            uint32_t slot_version = slot.version;
+            T value = slot.value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // a slot the writer lapped us on may hold a publish that version doesn't count yet,
+            // returning it would let the next read go back in time
+            if (slot.sequence.load(std::memory_order_relaxed) == before && slot_version == current) {
+                if (read_version) *read_version = current;
+                return value;
+            }
+        }
+    }
+
+    // number of publishes so far
+    [[nodiscard]] uint32_t get_version() const { return version.load(std::memory_order_acquire); }
+
+    // one task at a time may subscribe, publishes that start earlier are not notified
+    bool subscribe(TaskHandle_t task, uint32_t bits) {
+        if (subscriber_count >= MaxSubscribers) return false;
+        subscribers[subscriber_count].task = task;
+        subscribers[subscriber_count].bits = bits;
+        std::atomic_thread_fence(std::memory_order_release);
+        ++subscriber_count;
+        return true;
+    }
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence;
+        uint32_t version;  // publish that the value belongs to
+        T value;
+    };
+    struct Subscriber {
+        TaskHandle_t task;
+        uint32_t bits;
+    };
+    Slot slots[2];
+    std::atomic<uint32_t> version;
+    Subscriber subscribers[MaxSubscribers];
+    volatile int subscriber_count;
+};
+
+#endif //PUBLISHEDSTATE_H
@@ -0,0 +1,82 @@
+//
+// Quadrature decoder for rotary encoders.
+//
+
+#include "QuadratureEncoder.h"
+#include "task.h"
+
+// index is previous state << 2 | current state, states are (A << 1) | B
+// clockwise sequence is 00 -> 10 -> 11 -> 01 -> 00
+static const int8_t transitions[16] = {
+         0, -1, +1,  0,
+        +1,  0,  0, -1,
+        -1,  0,  0, +1,
+         0, +1, -1,  0
+};
+
+// transitions where both channels changed
+static const uint16_t invalid_transitions = (1 << 0b0011) | (1 << 0b0110) | (1 << 0b1001) | (1 << 0b1100);
+
+QuadratureEncoder::QuadratureEncoder(uint pin_a, uint pin_b, int counts_per_step, Notify notify) :
+        pin_a{pin_a}, pin_b{pin_b}, counts_per_step{counts_per_step}, notify{notify},
+        state{0}, position{0}, pending{0}, notified{false}, errors{0}, remainder{0} {
+    gpio_init(pin_a);
+    gpio_init(pin_b);
+    gpio_set_dir(pin_a, GPIO_IN);
+    gpio_set_dir(pin_b, GPIO_IN);
+    state = read_state();
+}
+
+void QuadratureEncoder::enable(gpio_irq_callback_t callback) {
+    state = read_state();
+    gpio_set_irq_enabled_with_callback(pin_a, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, callback);
+    gpio_set_irq_enabled(pin_b, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+}
+
+uint8_t QuadratureEncoder::read_state() const {
+    // sample both channels at the same instant
+    uint32_t pins = gpio_get_all();
+    return (((pins >> pin_a) & 1) << 1) | ((pins >> pin_b) & 1);
+}
+
+int8_t QuadratureEncoder::decode(uint8_t previous, uint8_t current, bool &error) {
+    uint8_t index = (previous << 2) | current;
+    error = (invalid_transitions >> index) & 1;
+    return transitions[index];
+}
+
+bool QuadratureEncoder::gpio_irq(uint gpio, BaseType_t *pxHigherPriorityTaskWoken) {
+    if (gpio != pin_a && gpio != pin_b) return false;
+
+    uint8_t current = read_state();
+    bool error;
+    int8_t delta = decode(state, current, error);
+    state = current;
+    if (error) {
+        errors = errors + 1;
+    }
+    if (delta != 0) {
+        position = position + delta;
+        pending = pending + delta;
+        // one notification per burst, consumer collects the total with take(). Counts between
+        // detents don't make a step, waiting for the detent keeps slow turning at one per step.
+        if (!notified && notify && position % counts_per_step == 0) {
+            notified = notify(pxHigherPriorityTaskWoken);
+        }
+    }
+    return true;
+}
+
+int32_t QuadratureEncoder::take() {
+    taskENTER_CRITICAL();
+    int32_t counts = pending;
+    pending = 0;
+    notified = false;
+    taskEXIT_CRITICAL();
+
+    counts += remainder;
+    // division truncates towards zero so remainder keeps the sign of the partial step
+    int32_t steps = counts / counts_per_step;
+    remainder = counts - steps * counts_per_step;
+    return steps;
+}
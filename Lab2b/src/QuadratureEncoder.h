@@ -0,0 +1,52 @@
+//
+// Quadrature decoder for rotary encoders.
+//
+// Both channels are sampled on both edges and every transition is decoded
+// with a 16-entry table, giving four counts per quadrature cycle. The
+// interrupt handler only accumulates a signed count. The consumer is
+// notified when the knob reaches a detent after the count has been taken,
+// so a fast spin costs one notification instead of one per step and slow
+// turning one per step instead of one per count.
+//
+
+#ifndef QUADRATUREENCODER_H
+#define QUADRATUREENCODER_H
+
+#include "FreeRTOS.h"
+#include "pico/stdlib.h"
+
+class QuadratureEncoder {
+public:
+    // called from interrupt when the first detent after take() is reached,
+    // returning false makes the encoder retry at the next detent
+    using Notify = bool (*)(BaseType_t *pxHigherPriorityTaskWoken);
+
+    QuadratureEncoder(uint pin_a, uint pin_b, int counts_per_step = 4, Notify notify = nullptr);
+    QuadratureEncoder(const QuadratureEncoder &) = delete;
+    // enable edge interrupts on both channels, gpio_callback must call gpio_irq() for them
+    void enable(gpio_irq_callback_t callback);
+    // returns true if gpio belongs to this encoder
+    bool gpio_irq(uint gpio, BaseType_t *pxHigherPriorityTaskWoken);
+    // steps since previous take, positive is clockwise. Counts that don't make a full step are kept.
+    int32_t take();
+    [[nodiscard]] int32_t get_position() const { return position; }
+    // transitions where both channels changed at once, i.e. steps were missed
+    [[nodiscard]] uint32_t get_errors() const { return errors; }
+
+    // decode transition between two A/B states (bit 1 = A, bit 0 = B), returns -1, 0 or +1
+    static int8_t decode(uint8_t previous, uint8_t current, bool &error);
+private:
+    uint8_t read_state() const;
+    uint pin_a;
+    uint pin_b;
+    int counts_per_step;
+    Notify notify;
+    uint8_t state;
+    volatile int32_t position;   // total counts since start
+    volatile int32_t pending;    // counts not yet taken
+    volatile bool notified;
+    volatile uint32_t errors;
+    int32_t remainder;           // counts taken that didn't make a full step
+};
+
+#endif //QUADRATUREENCODER_H
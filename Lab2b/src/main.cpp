@@ -7,6 +7,9 @@
 #include "semphr.h"
 
 #include "hardware/timer.h"
+#include "QuadratureEncoder.h"
+#include "EventChannel.h"
+#include "BlinkOutput.h"
 
 uint32_t read_runtime_ctr(void) {
     return time_us_32();
@@ -20,11 +23,11 @@ uint32_t read_runtime_ctr(void) {
 #define BUTTON_DEBOUNCE_MS 250
 #define MIN_FREQUENCY 2
 #define MAX_FREQUENCY 200
+#define EVENT_BATCH_SIZE 8
 
 typedef enum {
     BUTTON_PRESS,
-    ENCODER_TURN_CLOCKWISE,
-    ENCODER_TURN_COUNTERCLOCKWISE
+    ENCODER_TURN
 } EventType;
 
 typedef struct {
@@ -32,10 +35,30 @@ typedef struct {
     TickType_t time;
 } Event;
 
-QueueHandle_t xEventQueue;
+// Keep only the latest of consecutive events of the same type. Encoder steps are
+// accumulated by the encoder, so one pending ENCODER_TURN is enough.
+bool mergeEvents(Event &pending, const Event &incoming) {
+    if (pending.type != incoming.type) return false;
+    pending = incoming;
+    return true;
+}
+
+EventChannel<Event, 16> xEventChannel(mergeEvents);
+
+// written only by the event task, the LED starts off at 5 Hz
+PublishedState<BlinkSetting> blinkSetting({false, 5});
+
+BlinkOutput blink(LED_PIN, blinkSetting);
+
+// encoder posts one event per burst of turning, the steps are collected with take()
+bool encoderNotify(BaseType_t *pxHigherPriorityTaskWoken) {
+    Event event;
+    event.time = xTaskGetTickCountFromISR();
+    event.type = ENCODER_TURN;
+    return xEventChannel.post_from_isr(event, pxHigherPriorityTaskWoken);
+}
 
-volatile int ledState = 0;
-volatile int blinkFrequency = 5;
+QuadratureEncoder encoder(ROT_A_PIN, ROT_B_PIN, 4, encoderNotify);
 
 void gpio_callback(uint gpio, uint32_t events) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
@@ -44,49 +67,50 @@ void gpio_callback(uint gpio, uint32_t events) {
 
     if (gpio == ROT_SW_PIN && (events & GPIO_IRQ_EDGE_FALL)) {
         event.type = BUTTON_PRESS;
-        xQueueSendFromISR(xEventQueue, &event, &xHigherPriorityTaskWoken);
-    } else if (gpio == ROT_A_PIN && (events & GPIO_IRQ_EDGE_RISE)) {
-        // Determine direction based on state of ROT_B_PIN
-        if (gpio_get(ROT_B_PIN) == 0) {
-            event.type = ENCODER_TURN_CLOCKWISE;
-        } else {
-            event.type = ENCODER_TURN_COUNTERCLOCKWISE;
-        }
-        xQueueSendFromISR(xEventQueue, &event, &xHigherPriorityTaskWoken);
+        xEventChannel.post_from_isr(event, &xHigherPriorityTaskWoken);
+    } else {
+        encoder.gpio_irq(gpio, &xHigherPriorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 void vEventTask(void *pvParameters) {
-    Event event;
+    Event batch[EVENT_BATCH_SIZE];
     TickType_t lastButtonPressTime = 0;
+    BlinkSetting setting = blinkSetting.read();  // this task is the only writer
+
+    xEventChannel.set_consumer(xTaskGetCurrentTaskHandle());
 
     while (1) {
-        if (xQueueReceive(xEventQueue, &event, portMAX_DELAY)) {
+        // handle everything that arrived since the previous wake up
+        size_t count = xEventChannel.receive(batch, EVENT_BATCH_SIZE, portMAX_DELAY);
+        for (size_t i = 0; i < count; ++i) {
+            const Event &event = batch[i];
             switch (event.type) {
                 case BUTTON_PRESS:
                     // Debounce button
                     if ((event.time - lastButtonPressTime) > pdMS_TO_TICKS(BUTTON_DEBOUNCE_MS)) {
-                        ledState = !ledState;  // Toggle LED state
-                        printf("LED state: %d\nBlink frequency: %d Hz\n", ledState, blinkFrequency);
+                        setting.on = !setting.on;  // Toggle LED state
+                        blinkSetting.publish(setting);
+                        printf("LED state: %d\nBlink frequency: %d Hz\n", setting.on, (int) setting.frequency_hz);
                         lastButtonPressTime = event.time;
                     }
                     break;
 
-                case ENCODER_TURN_CLOCKWISE:
-                    if (ledState) {
-                        blinkFrequency = (blinkFrequency < MAX_FREQUENCY) ? blinkFrequency + 1 : MAX_FREQUENCY;
-                        printf("Blink frequency: %d Hz\n", blinkFrequency);
-                    }
-                    break;
-
-                case ENCODER_TURN_COUNTERCLOCKWISE:
-                    if (ledState) {
-                        blinkFrequency = (blinkFrequency > MIN_FREQUENCY) ? blinkFrequency - 1 : MIN_FREQUENCY;
-                        printf("Blink frequency: %d Hz\n", blinkFrequency);
+                case ENCODER_TURN: {
+                    // all steps turned since the previous event, positive is clockwise
+                    int steps = encoder.take();
+                    if (setting.on && steps != 0) {
+                        int frequency = (int) setting.frequency_hz + steps;
+                        if (frequency > MAX_FREQUENCY) frequency = MAX_FREQUENCY;
+                        if (frequency < MIN_FREQUENCY) frequency = MIN_FREQUENCY;
+                        setting.frequency_hz = frequency;
+                        blinkSetting.publish(setting);
+                        printf("Blink frequency: %d Hz\n", frequency);
                     }
                     break;
+                }
 
                 default:
                     break;
@@ -96,22 +120,7 @@ void vEventTask(void *pvParameters) {
 }
 
 void vBlinkTask(void *pvParameters) {
-    gpio_init(LED_PIN);
-    gpio_set_dir(LED_PIN, GPIO_OUT);
-    gpio_put(LED_PIN, 0);  // Ensure LED is off initially
-
-    while (1) {
-        if (ledState) {
-            gpio_put(LED_PIN, 1);
-            vTaskDelay(pdMS_TO_TICKS(500 / blinkFrequency));
-            gpio_put(LED_PIN, 0);
-            vTaskDelay(pdMS_TO_TICKS(500 / blinkFrequency));
-        } else {
-            // LED is OFF
-            gpio_put(LED_PIN, 0);
-            vTaskDelay(pdMS_TO_TICKS(100));  // Sleep for a short while
-        }
-    }
+    blink.run();
 }
 
 void setup_gpio() {
@@ -119,16 +128,13 @@ void setup_gpio() {
     gpio_set_dir(LED_PIN, GPIO_OUT);
     gpio_put(LED_PIN, 0);  // Ensure LED is off initially
 
-    gpio_init(ROT_A_PIN);
-    gpio_init(ROT_B_PIN);
-    gpio_set_dir(ROT_A_PIN, GPIO_IN);
-    gpio_set_dir(ROT_B_PIN, GPIO_IN);
+    // encoder pins are initialized by the encoder
 
     gpio_init(ROT_SW_PIN);
     gpio_set_dir(ROT_SW_PIN, GPIO_IN);
     gpio_pull_up(ROT_SW_PIN);
 
-    gpio_set_irq_enabled_with_callback(ROT_A_PIN, GPIO_IRQ_EDGE_RISE, true, &gpio_callback);
+    encoder.enable(&gpio_callback);
     gpio_set_irq_enabled(ROT_SW_PIN, GPIO_IRQ_EDGE_FALL, true);
 }
 
@@ -137,13 +143,6 @@ int main() {
 
     setup_gpio();
 
-    xEventQueue = xQueueCreate(10, sizeof(Event));
-    if (xEventQueue == NULL) {
-        printf("Failed to create event queue.\n");
-        while (1);
-    }
-    vQueueAddToRegistry(xEventQueue, "EventQueue");
-
     xTaskCreate(vEventTask, "EventTask", 256, NULL, 1, NULL);
     xTaskCreate(vBlinkTask, "BlinkTask", 256, NULL, 1, NULL);
 
@@ -0,0 +1,24 @@
+//
+// Stand-in for the Pico SDK calls of QuadratureEncoder.cpp. The pin levels
+// are set by encoder_replay_test.cpp from the waveform being replayed.
+//
+
+#ifndef ENCODER_STUB_STDLIB_H
+#define ENCODER_STUB_STDLIB_H
+
+#include <cstdint>
+
+typedef unsigned int uint;
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+#define GPIO_IN             false
+#define GPIO_IRQ_EDGE_FALL  0x4u
+#define GPIO_IRQ_EDGE_RISE  0x8u
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+uint32_t gpio_get_all();
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback);
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled);
+
+#endif //ENCODER_STUB_STDLIB_H
@@ -0,0 +1,349 @@
+//
+// Benchmark of EventChannel against the 10 deep xQueue it replaced in
+// main.cpp, on the POSIX port. Scripts of button and encoder interrupts are
+// replayed by the highest priority task, which stands for the interrupt: the
+// events of one tick are posted back to back, and the consumer runs in
+// between only when the next interrupt is a tick or more later. The consumer
+// is vEventTask with EVENT_BATCH_SIZE batches, or one xQueueReceive() per
+// event as before; each event it handles takes HANDLE_TICKS, the printf of
+// main.cpp, during which it doesn't wait for events. The tick only moves on
+// while the tasks are idle, so both runs of a script see the same timing.
+//
+// Reported per script: the time of one post from the interrupt, the consumer
+// wakeups (each time it blocks waiting for events), the events it handled
+// and the events lost because the queue or ring was full. Checks that the
+// channel accounts for every post, loses nothing, delivers the last event of
+// every press and turn and never two events of the same type next to each
+// other in a batch, that its consumer wakes at most once per tick with
+// interrupts and handles no more events than with the queue. With the queue
+// the consumer may wake less often: while it works through a backlog of
+// turning it doesn't wait, the channel's consumer catches up and waits for
+// the next detent. The post times are of the host and the POSIX port's
+// critical sections, only their ratio carries over to the RP2040.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "EventChannel.h"
+
+static constexpr size_t EVENT_BATCH_SIZE = 8;  // main.cpp
+static constexpr UBaseType_t QUEUE_LENGTH = 10;  // xEventQueue of the queue version
+static constexpr TickType_t HANDLE_TICKS = 2;
+static constexpr TickType_t SETTLE_TICKS = pdMS_TO_TICKS(1000);  // longer than a full queue takes to handle
+static constexpr unsigned WATCHDOG_SECONDS = 20;  // the test takes well under a second
+
+static constexpr UBaseType_t CONSUMER_PRIORITY = 1;  // vEventTask
+static constexpr UBaseType_t INTERRUPT_PRIORITY = 4;
+
+// Event and mergeEvents() of main.cpp
+typedef enum {
+    BUTTON_PRESS,
+    ENCODER_TURN
+} EventType;
+
+typedef struct {
+    EventType type;
+    TickType_t time;
+} Event;
+
+bool mergeEvents(Event &pending, const Event &incoming) {
+    if (pending.type != incoming.type) return false;
+    pending = incoming;
+    return true;
+}
+
+using Channel = EventChannel<Event, 16>;
+
+struct Post {
+    uint64_t time_us;
+    EventType type;
+    bool last;  // last event of its press or turn
+};
+
+// tick of the interrupt from the start of the replay
+static TickType_t postTick(const Post &post) {
+    return static_cast<TickType_t>(post.time_us * configTICK_RATE_HZ / 1000000);
+}
+
+struct Run {
+    size_t posted;
+    size_t handled;
+    size_t lost;
+    uint32_t merged;
+    uint32_t wakeups;
+    double post_ns;  // average time of one post
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char *script, const char *what) {
+    if (!ok) {
+        if (failures < 10) printf("%s: %s\n", script, what);
+        ++failures;
+    }
+}
+
+//-----------------------------------------------------------
+// Virtual tick, see event_channel/FreeRTOSConfig.h
+
+extern "C" void vApplicationIdleHook() {
+    static bool tickTimerStopped = false;
+    static const struct itimerval stopped = {{0, 0}, {0, 0}};
+
+    if (!tickTimerStopped) {
+        setitimer(ITIMER_REAL, &stopped, nullptr);
+        tickTimerStopped = true;
+    }
+    xTaskCatchUpTicks(1);
+}
+
+extern "C" void vTestSkipIdleTicks(uint32_t expectedIdleTime) {
+    // called with the scheduler suspended, the last tick is processed when it resumes
+    portDISABLE_INTERRUPTS();
+    if (eTaskConfirmSleepModeStatus() == eStandardSleep) {
+        vTaskStepTick(expectedIdleTime);
+    }
+    portENABLE_INTERRUPTS();
+}
+
+// only the consumer waits for events
+static uint32_t wakeups;
+
+extern "C" void vTestConsumerBlocking() {
+    ++wakeups;
+}
+
+//-----------------------------------------------------------
+// Scripts of the interrupts
+
+static uint32_t randomBetween(uint32_t low, uint32_t high) {
+    return low + static_cast<uint32_t>(rand()) % (high - low + 1);
+}
+
+// falling edges of a press, the contact chatters a few times before it settles
+static void press(std::vector<Post> &script, uint64_t t) {
+    int chatter = rand() % 5;
+    for (int i = 0; i < chatter; ++i) {
+        script.push_back({t, BUTTON_PRESS, false});
+        t += randomBetween(100, 6000);
+    }
+    script.push_back({t, BUTTON_PRESS, true});
+}
+
+// one notification per detent, see QuadratureEncoder.h, returns the time after the turn
+static uint64_t turn(std::vector<Post> &script, uint64_t t, uint32_t min_us, uint32_t max_us) {
+    int detents = static_cast<int>(randomBetween(5, 40));
+    for (int i = 0; i < detents; ++i) {
+        script.push_back({t, ENCODER_TURN, i == detents - 1});
+        t += randomBetween(min_us, max_us);
+    }
+    return t;
+}
+
+static std::vector<Post> buttonScript() {
+    std::vector<Post> script;
+    uint64_t t = 0;
+    for (int i = 0; i < 100; ++i) {
+        press(script, t);
+        t += randomBetween(200, 600) * 1000;
+    }
+    return script;
+}
+
+static std::vector<Post> encoderScript(uint32_t min_us, uint32_t max_us) {
+    std::vector<Post> script;
+    uint64_t t = 0;
+    for (int i = 0; i < 30; ++i) {
+        t = turn(script, t, min_us, max_us) + randomBetween(200, 600) * 1000;
+    }
+    return script;
+}
+
+// presses during fast turns
+static std::vector<Post> mixedScript() {
+    std::vector<Post> script;
+    uint64_t t = 0;
+    for (int i = 0; i < 30; ++i) {
+        uint64_t start = t;
+        t = turn(script, t, 500, 3000);
+        std::vector<Post> buttons;
+        press(buttons, start + randomBetween(0, static_cast<uint32_t>(t - start)));
+        script.insert(script.end(), buttons.begin(), buttons.end());
+        t += randomBetween(200, 600) * 1000;
+    }
+    std::stable_sort(script.begin(), script.end(), [](const Post &a, const Post &b) { return a.time_us < b.time_us; });
+    return script;
+}
+
+//-----------------------------------------------------------
+// The two consumers
+
+static QueueHandle_t queue;
+static Channel *channel;
+static std::vector<Event> handled;
+static uint32_t unmergedNeighbours;  // events of the same type next to each other in a batch
+
+static void handle(const Event &event) {
+    handled.push_back(event);
+    vTaskDelay(HANDLE_TICKS);
+}
+
+// vEventTask before the channel
+static void queueConsumerTask(void *) {
+    Event event;
+    for (;;) {
+        if (xQueueReceive(queue, &event, portMAX_DELAY)) {
+            handle(event);
+        }
+    }
+}
+
+static void channelConsumerTask(void *) {
+    Event batch[EVENT_BATCH_SIZE];
+    for (;;) {
+        size_t count = channel->receive(batch, EVENT_BATCH_SIZE, portMAX_DELAY);
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0 && batch[i].type == batch[i - 1].type) ++unmergedNeighbours;
+            handle(batch[i]);
+        }
+    }
+}
+
+// replays the script as interrupts into the queue or the channel, called from the interrupt task
+static Run replay(const std::vector<Post> &script, bool useChannel) {
+    Run run{};
+    handled.clear();
+    unmergedNeighbours = 0;
+
+    TaskHandle_t consumer;
+    if (useChannel) {
+        channel = new Channel(mergeEvents);
+        xTaskCreate(channelConsumerTask, "Channel", configMINIMAL_STACK_SIZE * 4, nullptr, CONSUMER_PRIORITY,
+                    &consumer);
+        channel->set_consumer(consumer);
+    } else {
+        queue = xQueueCreate(QUEUE_LENGTH, sizeof(Event));
+        xTaskCreate(queueConsumerTask, "Queue", configMINIMAL_STACK_SIZE * 4, nullptr, CONSUMER_PRIORITY, &consumer);
+    }
+    wakeups = 0;
+
+    std::chrono::nanoseconds postTime{0};
+    TickType_t start = xTaskGetTickCount();
+    for (const Post &post : script) {
+        TickType_t due = start + postTick(post);
+        TickType_t now = xTaskGetTickCount();
+        if (due > now) vTaskDelay(due - now);
+
+        // the interrupt
+        Event event{post.type, xTaskGetTickCount()};
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        auto begin = std::chrono::steady_clock::now();
+        bool stored = useChannel ? channel->post_from_isr(event, &xHigherPriorityTaskWoken)
+                                 : xQueueSendFromISR(queue, &event, &xHigherPriorityTaskWoken) == pdTRUE;
+        postTime += std::chrono::steady_clock::now() - begin;
+        if (!stored) ++run.lost;
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+    vTaskDelay(SETTLE_TICKS);
+
+    run.posted = script.size();
+    run.handled = handled.size();
+    run.wakeups = wakeups;
+    run.post_ns = static_cast<double>(postTime.count()) / script.size();
+    vTaskDelete(consumer);
+    if (useChannel) {
+        run.merged = channel->get_merged();
+        check(run.lost == channel->get_overflows(), "channel", "overflows not counted");
+        delete channel;
+    } else {
+        vQueueDelete(queue);
+    }
+    return run;
+}
+
+static bool wasHandled(const Post &post, TickType_t start) {
+    for (const Event &event : handled) {
+        if (event.type == post.type && event.time - start == postTick(post)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void compare(const char *name, const std::vector<Post> &script) {
+    Run queueRun = replay(script, false);
+    TickType_t start = xTaskGetTickCount();
+    Run channelRun = replay(script, true);
+
+    check(channelRun.handled + channelRun.merged + channelRun.lost == channelRun.posted, name,
+          "posts not accounted for");
+    check(channelRun.lost == 0, name, "events lost");
+    check(unmergedNeighbours == 0, name, "events of the same type not merged");
+    for (const Post &post : script) {
+        if (post.last) check(wasHandled(post, start), name, "last event of a press or turn not handled");
+    }
+    for (size_t i = 1; i < handled.size(); ++i) {
+        check(handled[i].time - handled[i - 1].time < 0x80000000u, name, "events out of order");
+    }
+    // the interrupts of one tick are a burst, the last wakeup is the consumer's wait after the script
+    size_t bursts = 0;
+    for (size_t i = 0; i < script.size(); ++i) {
+        if (i == 0 || postTick(script[i]) != postTick(script[i - 1])) ++bursts;
+    }
+    check(channelRun.wakeups <= bursts + 1, name, "more than one wakeup per burst");
+    check(channelRun.handled <= queueRun.handled, name, "more events handled than with the queue");
+
+    printf("%-16s %6zu %10.0f %7.0f %9lu %7lu %9zu %7zu %7zu %6zu\n", name, script.size(), queueRun.post_ns,
+           channelRun.post_ns, static_cast<unsigned long>(queueRun.wakeups),
+           static_cast<unsigned long>(channelRun.wakeups), queueRun.handled, channelRun.handled, queueRun.lost,
+           channelRun.lost);
+}
+
+static void interruptTask(void *) {
+    printf("                        post ns          wakeups          handled           lost\n");
+    printf("script           events  queue channel   queue channel   queue channel   queue channel\n");
+    compare("button chatter", buttonScript());
+    compare("encoder slow", encoderScript(20000, 80000));
+    compare("encoder fast", encoderScript(500, 3000));
+    compare("encoder spin", encoderScript(100, 600));
+    compare("mixed", mixedScript());
+    vTaskEndScheduler();
+}
+
+// a task that never blocks keeps the tick from moving, so the test is failed on the host's clock
+static void watchdog() {
+    sleep(WATCHDOG_SECONDS);
+    printf("still running after %u s\n", WATCHDOG_SECONDS);
+    fflush(stdout);
+    _exit(1);
+}
+
+int main() {
+    // the tick signal of the POSIX port has to go to the kernel's threads
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    std::thread(watchdog).detach();
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+    srand(1);
+    xTaskCreate(interruptTask, "Interrupt", configMINIMAL_STACK_SIZE * 16, nullptr, INTERRUPT_PRIORITY, nullptr);
+    vTaskStartScheduler();
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,16 @@
+/*
+ * The POSIX port with the 32-bit tick count of the RP2040 port.  The POSIX
+ * port's TickType_t is an unsigned long, 64 bits on the host, and a tick count
+ * of that width never wraps.
+ */
+
+#ifndef HOST_TESTS_PORTMACRO_H
+#define HOST_TESTS_PORTMACRO_H
+
+#define TickType_t    PosixTickType_t
+#include_next <portmacro.h>
+#undef TickType_t
+
+typedef uint32_t TickType_t;
+
+#endif /* HOST_TESTS_PORTMACRO_H */
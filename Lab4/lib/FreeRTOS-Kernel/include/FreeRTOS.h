@@ -533,6 +533,88 @@
 
 #endif /* configUSE_TIMERS */
 
+/* Set configUSE_DELAYED_TASK_WHEEL to 1 to keep tasks that block with a
+ * timeout in a hierarchical timing wheel instead of the sorted delayed task
+ * lists, making blocking O(1) regardless of the number of delayed tasks.  Each
+ * level has 32 slots, so configDELAYED_TASK_WHEEL_LEVELS levels cover
+ * 2^(5 * levels) ticks directly.  Longer delays are re-placed when the end of
+ * that range is reached. */
+#ifndef configUSE_DELAYED_TASK_WHEEL
+    #define configUSE_DELAYED_TASK_WHEEL    0
+#endif
+
+#ifndef configDELAYED_TASK_WHEEL_LEVELS
+    #define configDELAYED_TASK_WHEEL_LEVELS    4
+#endif
+
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    #if ( configDELAYED_TASK_WHEEL_LEVELS < 2 ) || ( configDELAYED_TASK_WHEEL_LEVELS > 6 ) || ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS ) && ( configDELAYED_TASK_WHEEL_LEVELS > 3 ) )
+        #error configDELAYED_TASK_WHEEL_LEVELS must be 2 to 6, or 2 to 3 with 16 bit ticks.
+    #endif
+#endif
+
+/* portHIGHEST_SET_BIT( ulBitmap ) returns the position of the highest set bit
+ * of a non-zero 32 bit word.  The delayed task wheel and the latency
+ * histograms use it.  A port without a fast way of its own gets the portable
+ * version in tasks.c. */
+
+/* Set configUSE_LATENCY_HISTOGRAMS to 1 to record, per core, log2 histograms
+ * of the time from an ISR readying a task until the task runs, from
+ * portYIELD_FROM_ISR() until the next task is switched in, of the time spent
+ * in task level critical sections and of the time the scheduler is suspended.
+ * Times are measured with portGET_RUN_TIME_COUNTER_VALUE().  Bucket 0 counts
+ * zero length times and bucket n counts times of 2^(n-1) to 2^n - 1, the last
+ * bucket also counts everything longer.  Critical sections are only measured
+ * when the kernel keeps the nesting count, that is with more than one core or
+ * with portCRITICAL_NESTING_IN_TCB. */
+#ifndef configUSE_LATENCY_HISTOGRAMS
+    #define configUSE_LATENCY_HISTOGRAMS    0
+#endif
+
+#ifndef configLATENCY_HISTOGRAM_BUCKETS
+    #define configLATENCY_HISTOGRAM_BUCKETS    16
+#endif
+
+#if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+    #if ( configGENERATE_RUN_TIME_STATS != 1 ) || !defined( portGET_RUN_TIME_COUNTER_VALUE )
+        #error configUSE_LATENCY_HISTOGRAMS requires configGENERATE_RUN_TIME_STATS to be 1 and portGET_RUN_TIME_COUNTER_VALUE to be defined.
+    #endif
+
+    #ifndef portCHECK_IF_IN_ISR
+        #error configUSE_LATENCY_HISTOGRAMS requires the port to define portCHECK_IF_IN_ISR.
+    #endif
+
+    #if ( configLATENCY_HISTOGRAM_BUCKETS < 2 ) || ( configLATENCY_HISTOGRAM_BUCKETS > 33 )
+        #error configLATENCY_HISTOGRAM_BUCKETS must be 2 to 33.
+    #endif
+
+/* Called by portYIELD_FROM_ISR() when it requests a context switch. */
+    #define portLATENCY_YIELD_FROM_ISR()    vTaskLatencyYieldFromISR()
+#else
+    #define portLATENCY_YIELD_FROM_ISR()
+#endif
+
+/* Set configUSE_CORE_YIELD_POLICY to 1 to cut the interrupts an SMP build
+ * sends to make another core yield.  When a readied task could preempt the
+ * calling core or another core running the same priority, the calling core is
+ * chosen as it yields without an interrupt.  A core that is already waiting
+ * for the kernel locks to select its next task is not interrupted, it sees the
+ * readied task once the locks are released. */
+#ifndef configUSE_CORE_YIELD_POLICY
+    #define configUSE_CORE_YIELD_POLICY    0
+#endif
+
+/* Set configUSE_CORE_YIELD_STATS to 1 to count, per core, the yield requests
+ * received from the other cores and whether they made the core switch task,
+ * see vTaskGetCoreYieldStats(). */
+#ifndef configUSE_CORE_YIELD_STATS
+    #define configUSE_CORE_YIELD_STATS    0
+#endif
+
+#if ( ( configUSE_CORE_YIELD_POLICY == 1 ) || ( configUSE_CORE_YIELD_STATS == 1 ) ) && ( configNUMBER_OF_CORES == 1 )
+    #error configUSE_CORE_YIELD_POLICY and configUSE_CORE_YIELD_STATS require configNUMBER_OF_CORES to be more than 1.
+#endif
+
 #ifndef portHAS_NESTED_INTERRUPTS
     #if defined( portSET_INTERRUPT_MASK_FROM_ISR ) && defined( portCLEAR_INTERRUPT_MASK_FROM_ISR )
         #define portHAS_NESTED_INTERRUPTS    1
@@ -1044,6 +1126,30 @@
     #define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceMPSC_RING_CREATE
+    #define traceMPSC_RING_CREATE( pxRing )
+#endif
+
+#ifndef traceMPSC_RING_CREATE_FAILED
+    #define traceMPSC_RING_CREATE_FAILED()
+#endif
+
+#ifndef traceMPSC_RING_DELETE
+    #define traceMPSC_RING_DELETE( xRing )
+#endif
+
+#ifndef traceMPSC_RING_SEND
+    #define traceMPSC_RING_SEND( xRing )
+#endif
+
+#ifndef traceMPSC_RING_SEND_FAILED
+    #define traceMPSC_RING_SEND_FAILED( xRing )
+#endif
+
+#ifndef traceMPSC_RING_RECEIVE
+    #define traceMPSC_RING_RECEIVE( xRing )
+#endif
+
 #ifndef traceENTER_xEventGroupCreateStatic
     #define traceENTER_xEventGroupCreateStatic( pxEventGroupBuffer )
 #endif
@@ -2400,6 +2506,38 @@
     #define traceRETURN_ulTaskGetIdleRunTimePercent( ulReturn )
 #endif
 
+#ifndef traceENTER_xTaskGetLatencyHistogram
+    #define traceENTER_xTaskGetLatencyHistogram( xCoreID, eHistogram, pxHistogram )
+#endif
+
+#ifndef traceRETURN_xTaskGetLatencyHistogram
+    #define traceRETURN_xTaskGetLatencyHistogram( xReturn )
+#endif
+
+#ifndef traceENTER_vTaskResetLatencyHistograms
+    #define traceENTER_vTaskResetLatencyHistograms()
+#endif
+
+#ifndef traceRETURN_vTaskResetLatencyHistograms
+    #define traceRETURN_vTaskResetLatencyHistograms()
+#endif
+
+#ifndef traceENTER_vTaskGetCoreYieldStats
+    #define traceENTER_vTaskGetCoreYieldStats( xCoreID, pxStats )
+#endif
+
+#ifndef traceRETURN_vTaskGetCoreYieldStats
+    #define traceRETURN_vTaskGetCoreYieldStats()
+#endif
+
+#ifndef traceENTER_vTaskResetCoreYieldStats
+    #define traceENTER_vTaskResetCoreYieldStats()
+#endif
+
+#ifndef traceRETURN_vTaskResetCoreYieldStats
+    #define traceRETURN_vTaskResetCoreYieldStats()
+#endif
+
 #ifndef traceENTER_xTaskGetMPUSettings
     #define traceENTER_xTaskGetMPUSettings( xTask )
 #endif
@@ -2592,6 +2730,54 @@
     #define traceRETURN_ucStreamBufferGetStreamBufferType( ucStreamBufferType )
 #endif
 
+#ifndef traceENTER_xMpscRingCreate
+    #define traceENTER_xMpscRingCreate( uxRingLength, uxRecordSize )
+#endif
+
+#ifndef traceRETURN_xMpscRingCreate
+    #define traceRETURN_xMpscRingCreate( pxRing )
+#endif
+
+#ifndef traceENTER_vMpscRingDelete
+    #define traceENTER_vMpscRingDelete( xRing )
+#endif
+
+#ifndef traceRETURN_vMpscRingDelete
+    #define traceRETURN_vMpscRingDelete()
+#endif
+
+#ifndef traceENTER_xMpscRingSend
+    #define traceENTER_xMpscRingSend( xRing, pvRecord )
+#endif
+
+#ifndef traceRETURN_xMpscRingSend
+    #define traceRETURN_xMpscRingSend( xReturn )
+#endif
+
+#ifndef traceENTER_xMpscRingReceive
+    #define traceENTER_xMpscRingReceive( xRing, pvBuffer )
+#endif
+
+#ifndef traceRETURN_xMpscRingReceive
+    #define traceRETURN_xMpscRingReceive( xReturn )
+#endif
+
+#ifndef traceENTER_uxMpscRingDropped
+    #define traceENTER_uxMpscRingDropped( xRing )
+#endif
+
+#ifndef traceRETURN_uxMpscRingDropped
+    #define traceRETURN_uxMpscRingDropped( uxDropped )
+#endif
+
+#ifndef traceENTER_xMpscRingIsEmpty
+    #define traceENTER_xMpscRingIsEmpty( xRing )
+#endif
+
+#ifndef traceRETURN_xMpscRingIsEmpty
+    #define traceRETURN_xMpscRingIsEmpty( xReturn )
+#endif
+
 #ifndef traceENTER_vListInitialise
     #define traceENTER_vListInitialise( pxList )
 #endif
@@ -2884,8 +3070,8 @@
     #error configUSE_CORE_AFFINITY is not supported in single core FreeRTOS
 #endif
 
-#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 ) )
-    #error configUSE_PORT_OPTIMISED_TASK_SELECTION is not supported in SMP FreeRTOS
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_PORT_OPTIMISED_TASK_SELECTION != 0 ) && ( configRUN_MULTIPLE_PRIORITIES == 0 ) )
+    #error configUSE_PORT_OPTIMISED_TASK_SELECTION is only supported in SMP FreeRTOS with configRUN_MULTIPLE_PRIORITIES set to 1
 #endif
 
 #ifndef configINITIAL_TICK_COUNT
@@ -3184,6 +3370,10 @@ typedef struct xSTATIC_TCB
     #if ( configGENERATE_RUN_TIME_STATS == 1 )
         configRUN_TIME_COUNTER_TYPE ulDummy16;
     #endif
+    #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulDummy27;
+        BaseType_t xDummy28;
+    #endif
     #if ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 )
         configTLS_BLOCK_TYPE xDummy17;
     #endif
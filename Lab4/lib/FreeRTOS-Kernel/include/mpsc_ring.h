@@ -0,0 +1,229 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * MPSC rings pass fixed size records from any number of tasks and interrupts,
+ * on any core (the producers), to one task (the consumer), in the order the
+ * records were claimed.  They are intended for logging and event tracing,
+ * where producers must never block and a full ring drops the record.
+ *
+ * Each slot carries a sequence number next to the record.  A producer claims a
+ * slot by advancing the shared head counter with a compare and swap, copies
+ * its record with interrupts enabled, then publishes the slot by updating the
+ * sequence number.  The consumer only reads a slot once it is published, so
+ * neither side enters a critical section for the copy and the kernel is never
+ * entered by a producer.
+ *
+ * The compare and swap is port specific.  Ports for cores without exclusive
+ * access instructions define portMPSC_RING_COMPARE_AND_SWAP() in portmacro.h,
+ * otherwise the GCC atomic builtins are used.
+ *
+ * ***NOTE***:  A record claimed by a producer that is preempted before it
+ * publishes the record holds back the records claimed after it until the
+ * producer runs again.  There must only be one consumer.
+ */
+
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include mpsc_ring.h"
+#endif
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which MPSC rings are referenced.  For example, a call to
+ * xMpscRingCreate() returns an MpscRingHandle_t variable that can then be used
+ * as a parameter to xMpscRingSend(), xMpscRingReceive(), etc.
+ */
+struct MpscRingDefinition;
+typedef struct MpscRingDefinition * MpscRingHandle_t;
+
+/**
+ * mpsc_ring.h
+ *
+ * @code{c}
+ * MpscRingHandle_t xMpscRingCreate( UBaseType_t uxRingLength, UBaseType_t uxRecordSize );
+ * @endcode
+ *
+ * Creates a new MPSC ring and returns a handle by which it can be referenced.
+ * The ring structure and its slots are allocated in one call to
+ * pvPortMalloc().
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xMpscRingCreate() to be available.
+ *
+ * @param uxRingLength The maximum number of records the ring can hold at any
+ * one time.  Must be a power of two.
+ *
+ * @param uxRecordSize The size, in bytes, of each record.  Must not be 0.
+ *
+ * @return If the ring is created successfully then a handle to the ring is
+ * returned.  If the memory required could not be allocated then NULL is
+ * returned.
+ *
+ * \defgroup xMpscRingCreate xMpscRingCreate
+ * \ingroup MpscRingManagement
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    MpscRingHandle_t xMpscRingCreate( UBaseType_t uxRingLength,
+                                      UBaseType_t uxRecordSize ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * mpsc_ring.h
+ *
+ * @code{c}
+ * void vMpscRingDelete( MpscRingHandle_t xRing );
+ * @endcode
+ *
+ * Deletes an MPSC ring that was created with xMpscRingCreate().  No producer
+ * or consumer may use the ring while, or after, it is deleted.
+ *
+ * @param xRing The handle of the ring to be deleted.
+ *
+ * \defgroup vMpscRingDelete vMpscRingDelete
+ * \ingroup MpscRingManagement
+ */
+void vMpscRingDelete( MpscRingHandle_t xRing ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpsc_ring.h
+ *
+ * @code{c}
+ * BaseType_t xMpscRingSend( MpscRingHandle_t xRing, const void * pvRecord );
+ * @endcode
+ *
+ * Copies a record into an MPSC ring.  Never blocks, and can be called from
+ * tasks and interrupts on any core.  If the ring is full the record is
+ * dropped and counted, see uxMpscRingDropped().
+ *
+ * @param xRing The handle of the ring to which the record is sent.
+ *
+ * @param pvRecord A pointer to the record to copy into the ring.
+ *
+ * @return pdPASS if the record was sent, otherwise errQUEUE_FULL.
+ *
+ * Example use:
+ * @code{c}
+ * struct ALogRecord
+ * {
+ *  const char * pcFormat;
+ *  uint32_t ulValue;
+ * };
+ *
+ * void vAnInterruptHandler( void )
+ * {
+ * struct ALogRecord xRecord = { "ADC %u\n", ulReadADC() };
+ *
+ *  // No need to check the result, drops are counted by the ring.
+ *  ( void ) xMpscRingSend( xLogRing, &xRecord );
+ * }
+ * @endcode
+ * \defgroup xMpscRingSend xMpscRingSend
+ * \ingroup MpscRingManagement
+ */
+BaseType_t xMpscRingSend( MpscRingHandle_t xRing,
+                          const void * pvRecord ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpsc_ring.h
+ *
+ * @code{c}
+ * BaseType_t xMpscRingReceive( MpscRingHandle_t xRing, void * pvBuffer );
+ * @endcode
+ *
+ * Copies the oldest published record out of an MPSC ring and frees its slot.
+ * Never blocks, the consumer is expected to poll or to be woken by other
+ * means.  Only one task may receive from a given ring.
+ *
+ * @param xRing The handle of the ring from which the record is received.
+ *
+ * @param pvBuffer A pointer to the buffer into which the record is copied.
+ *
+ * @return pdPASS if a record was received, otherwise errQUEUE_EMPTY.  The ring
+ * also reads as empty while the oldest claimed record is still being written.
+ *
+ * \defgroup xMpscRingReceive xMpscRingReceive
+ * \ingroup MpscRingManagement
+ */
+BaseType_t xMpscRingReceive( MpscRingHandle_t xRing,
+                             void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpsc_ring.h
+ *
+ * @code{c}
+ * UBaseType_t uxMpscRingDropped( MpscRingHandle_t xRing );
+ * @endcode
+ *
+ * Returns the number of records dropped because the ring was full since it
+ * was created.  The count wraps.
+ *
+ * @param xRing The handle of the ring being queried.
+ *
+ * @return The number of dropped records.
+ *
+ * \defgroup uxMpscRingDropped uxMpscRingDropped
+ * \ingroup MpscRingManagement
+ */
+UBaseType_t uxMpscRingDropped( MpscRingHandle_t xRing ) PRIVILEGED_FUNCTION;
+
+/**
+ * mpsc_ring.h
+ *
+ * @code{c}
+ * BaseType_t xMpscRingIsEmpty( MpscRingHandle_t xRing );
+ * @endcode
+ *
+ * Tells whether xMpscRingReceive() would find no record.  Only the consumer
+ * may call it, for example to check the ring once more after telling the
+ * producers that it is about to block.
+ *
+ * @param xRing The handle of the ring being queried.
+ *
+ * @return pdTRUE if the oldest claimed record is not published yet or nothing
+ * is claimed, otherwise pdFALSE.
+ *
+ * \defgroup xMpscRingIsEmpty xMpscRingIsEmpty
+ * \ingroup MpscRingManagement
+ */
+BaseType_t xMpscRingIsEmpty( MpscRingHandle_t xRing ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* !defined( MPSC_RING_H ) */
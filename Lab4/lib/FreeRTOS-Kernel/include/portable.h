@@ -156,6 +156,17 @@ typedef struct xHeapStats
     size_t xNumberOfSuccessfulFrees;        /* The number of calls to vPortFree() that has successfully freed a block of memory. */
 } HeapStats_t;
 
+/* Used to pass information about the size classes of heap_pool.c out of
+ * uxPortGetHeapClassStats(). */
+typedef struct xHeapClassStats
+{
+    size_t xRequestSize;         /* The largest request, in bytes, that is served by the class. */
+    size_t xBlocksInUse;         /* The number of blocks of the class currently allocated. */
+    size_t xBlocksCached;        /* The number of freed blocks kept by the class for reuse. */
+    size_t xNumberOfAllocations; /* The number of allocations served by the class. */
+    size_t xNumberOfCacheMisses; /* The number of allocations of the class that had to take a block from the coalescing heap. */
+} HeapClassStats_t;
+
 /*
  * Used to define multiple heap regions for use by heap_5.c.  This function
  * must be called before any calls to pvPortMalloc() - not creating a task,
@@ -175,6 +186,13 @@ void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions ) PRIVILEG
  */
 void vPortGetHeapStats( HeapStats_t * pxHeapStats );
 
+/*
+ * Fills up to uxArraySize HeapClassStats_t structures, one per size class of
+ * heap_pool.c, and returns the number filled.  Only implemented by heap_pool.c.
+ */
+UBaseType_t uxPortGetHeapClassStats( HeapClassStats_t * pxClassStats,
+                                     UBaseType_t uxArraySize );
+
 /*
  * Map to the memory management routines required for the port.
  */
@@ -188,6 +188,33 @@ typedef enum
     #endif /* INCLUDE_vTaskSuspend */
 } eSleepModeStatus;
 
+/* The latency histograms kept when configUSE_LATENCY_HISTOGRAMS is 1. */
+typedef enum
+{
+    eLatencyISRToTask = 0,      /* From an ISR readying a task until the task is switched in. */
+    eLatencyYieldFromISR,       /* From portYIELD_FROM_ISR() until the next task is switched in. */
+    eLatencyCritical,           /* Time spent in taskENTER_CRITICAL() sections entered by tasks. */
+    eLatencySchedulerSuspended, /* Time from vTaskSuspendAll() until xTaskResumeAll() resumes the scheduler. */
+    eLatencyHistogramCount
+} eLatencyHistogram;
+
+/* Used with the xTaskGetLatencyHistogram() function. */
+typedef struct xLATENCY_HISTOGRAM
+{
+    uint32_t ulBuckets[ configLATENCY_HISTOGRAM_BUCKETS ]; /* Bucket 0 counts zero length times, bucket n times of 2^(n-1) to 2^n - 1 run time counter units.  The last bucket also counts all longer times. */
+    uint32_t ulMax;                                        /* The longest time recorded, in run time counter units. */
+} LatencyHistogram_t;
+
+/* Used with the vTaskGetCoreYieldStats() function. */
+typedef struct xCORE_YIELD_STATS
+{
+    uint32_t ulRequests; /* Interrupts sent by the other cores to make this core yield. */
+    uint32_t ulUseful;   /* Requests after which the core switched to another task. */
+    uint32_t ulWasted;   /* Requests after which the core kept running the same task. */
+    uint32_t ulSkipped;  /* Requests not sent because the core was already selecting its next task. */
+    uint32_t ulLocal;    /* Tasks readied by this core that it ran itself rather than interrupting a core running the same priority. */
+} CoreYieldStats_t;
+
 /**
  * Defines the priority used by the idle task.  This must not be modified.
  *
@@ -2495,6 +2522,77 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) PRIVILEGED_FUNCTION;
     configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimePercent( void ) PRIVILEGED_FUNCTION;
 #endif
 
+/**
+ * task. h
+ * @code{c}
+ * BaseType_t xTaskGetLatencyHistogram( BaseType_t xCoreID, eLatencyHistogram eHistogram, LatencyHistogram_t * pxHistogram );
+ * void vTaskResetLatencyHistograms( void );
+ * @endcode
+ *
+ * configUSE_LATENCY_HISTOGRAMS must be defined as 1 for these functions to be
+ * available.
+ *
+ * Each core keeps a log2 histogram and the maximum of the times listed in
+ * eLatencyHistogram.  Recording a time costs a few instructions and is done
+ * with interrupts already masked, so the histograms can be left enabled in
+ * production builds to find the longest latencies of a running system.
+ *
+ * xTaskGetLatencyHistogram() copies one histogram of one core into
+ * pxHistogram.  vTaskResetLatencyHistograms() clears the histograms of all
+ * cores.
+ *
+ * @param xCoreID The core whose histogram is copied.
+ *
+ * @param eHistogram The histogram to copy.
+ *
+ * @param pxHistogram The structure the histogram is copied into.
+ *
+ * @return pdPASS if the histogram was copied, pdFAIL if xCoreID or eHistogram
+ * is out of range.
+ *
+ * \defgroup xTaskGetLatencyHistogram xTaskGetLatencyHistogram
+ * \ingroup TaskUtils
+ */
+#if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+    BaseType_t xTaskGetLatencyHistogram( BaseType_t xCoreID,
+                                         eLatencyHistogram eHistogram,
+                                         LatencyHistogram_t * pxHistogram ) PRIVILEGED_FUNCTION;
+    void vTaskResetLatencyHistograms( void ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * @code{c}
+ * void vTaskGetCoreYieldStats( BaseType_t xCoreID, CoreYieldStats_t * pxStats );
+ * void vTaskResetCoreYieldStats( void );
+ * @endcode
+ *
+ * configUSE_CORE_YIELD_STATS must be defined as 1 for these functions to be
+ * available.
+ *
+ * A core that readies a task for another core interrupts that core to make it
+ * yield.  Each core counts the requests it received and whether its next
+ * context switch after a request ran a different task.  A wasted request cost
+ * both cores an interrupt and a pass through the scheduler for nothing, for
+ * example because the core had switched on its own before the interrupt was
+ * taken.
+ *
+ * vTaskGetCoreYieldStats() copies the counters of one core into pxStats.
+ * vTaskResetCoreYieldStats() clears the counters of all cores.
+ *
+ * @param xCoreID The core whose counters are copied.
+ *
+ * @param pxStats The structure the counters are copied into.
+ *
+ * \defgroup vTaskGetCoreYieldStats vTaskGetCoreYieldStats
+ * \ingroup TaskUtils
+ */
+#if ( configUSE_CORE_YIELD_STATS == 1 )
+    void vTaskGetCoreYieldStats( BaseType_t xCoreID,
+                                 CoreYieldStats_t * pxStats ) PRIVILEGED_FUNCTION;
+    void vTaskResetCoreYieldStats( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * task. h
  * @code{c}
@@ -3575,6 +3673,18 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
     portDONT_DISCARD void vTaskSwitchContext( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
 #endif
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS ONLY
+ * INTENDED FOR USE WHEN IMPLEMENTING A PORT OF THE SCHEDULER AND IS
+ * AN INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
+ *
+ * Called through portLATENCY_YIELD_FROM_ISR() by an ISR that requests a
+ * context switch, to start the eLatencyYieldFromISR time of the core.
+ */
+#if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+    void vTaskLatencyYieldFromISR( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  THEY ARE USED BY
  * THE EVENT BITS MODULE.
@@ -0,0 +1,394 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mpsc_ring.h"
+
+/* The MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Ports for cores with exclusive access instructions can use the compiler's
+ * atomics.  The barrier has to order memory accesses between cores, a compiler
+ * barrier is not enough. */
+#ifndef portMPSC_RING_COMPARE_AND_SWAP
+    #define portMPSC_RING_COMPARE_AND_SWAP( puxDestination, uxComparand, uxExchange )    prvCompareAndSwap( ( puxDestination ), ( uxComparand ), ( uxExchange ) )
+    #define mpscUSE_COMPILER_ATOMICS    1
+#else
+    #define mpscUSE_COMPILER_ATOMICS    0
+#endif
+
+#ifndef portMPSC_RING_MEMORY_BARRIER
+    #define portMPSC_RING_MEMORY_BARRIER()    __atomic_thread_fence( __ATOMIC_SEQ_CST )
+#endif
+
+/* Ports that guard the compare and swap with a lock set it up here. */
+#ifndef portMPSC_RING_INIT
+    #define portMPSC_RING_INIT()
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Header of each slot, the record follows it.  The sequence number tells the
+ * producers and the consumer who owns the slot for ring position uxPosition:
+ * uxPosition - the slot is free for the producer that claims uxPosition.
+ * uxPosition + 1 - the record is published and can be read.
+ * uxPosition + ring length - the record was read, the slot is free for the
+ * next lap. */
+typedef struct MpscRingSlot
+{
+    volatile UBaseType_t uxSequence;
+} MpscRingSlot_t;
+
+/* Structure that hold state information on the ring. */
+typedef struct MpscRingDefinition
+{
+    volatile UBaseType_t uxHead;    /**< The next position to claim, advanced by the producers. */
+    volatile UBaseType_t uxTail;    /**< The next position to read, only written by the consumer. */
+    volatile UBaseType_t uxDropped; /**< Records dropped because the ring was full. */
+    UBaseType_t uxMask;             /**< The ring length minus one, the length is a power of two. */
+    UBaseType_t uxRecordSize;       /**< The size of each record in bytes. */
+    UBaseType_t uxSlotSize;         /**< The size of the slot header and record, rounded up so every header is aligned. */
+    uint8_t * pucSlots;             /**< Points to the first slot. */
+} MpscRing_t;
+
+/*
+ * Returns the slot used for a ring position.
+ */
+static MpscRingSlot_t * prvGetSlot( const MpscRing_t * const pxRing,
+                                    UBaseType_t uxPosition ) PRIVILEGED_FUNCTION;
+
+#if ( mpscUSE_COMPILER_ATOMICS == 1 )
+
+/*
+ * Sets *puxDestination to uxExchange if it holds uxComparand, as a single
+ * atomic operation.  Returns pdTRUE if the value was swapped.
+ */
+    static BaseType_t prvCompareAndSwap( volatile UBaseType_t * puxDestination,
+                                         UBaseType_t uxComparand,
+                                         UBaseType_t uxExchange ) PRIVILEGED_FUNCTION;
+#endif
+
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    MpscRingHandle_t xMpscRingCreate( UBaseType_t uxRingLength,
+                                      UBaseType_t uxRecordSize )
+    {
+        MpscRing_t * pxRing = NULL;
+        size_t xSlotSize = 0;
+        UBaseType_t x;
+
+        traceENTER_xMpscRingCreate( uxRingLength, uxRecordSize );
+
+        portMPSC_RING_INIT();
+
+        /* The position is mapped to a slot with a mask. */
+        configASSERT( uxRingLength > ( UBaseType_t ) 0 );
+        configASSERT( ( uxRingLength & ( uxRingLength - ( UBaseType_t ) 1 ) ) == ( UBaseType_t ) 0 );
+        configASSERT( uxRecordSize > ( UBaseType_t ) 0 );
+
+        /* Round the slot up so the header of the next slot is aligned, and
+         * check the size of all slots can be represented. */
+        if( ( size_t ) uxRecordSize <= ( SIZE_MAX - ( 2U * sizeof( MpscRingSlot_t ) ) ) )
+        {
+            xSlotSize = sizeof( MpscRingSlot_t ) + ( size_t ) uxRecordSize;
+            xSlotSize += ( sizeof( MpscRingSlot_t ) - ( xSlotSize % sizeof( MpscRingSlot_t ) ) ) % sizeof( MpscRingSlot_t );
+
+            if( ( ( SIZE_MAX - sizeof( MpscRing_t ) ) / xSlotSize ) >= ( size_t ) uxRingLength )
+            {
+                /* The slots follow the structure, whose size is a multiple of
+                 * the pointer size, so they are aligned as well as the block
+                 * returned by pvPortMalloc(). */
+                pxRing = ( MpscRing_t * ) pvPortMalloc( sizeof( MpscRing_t ) + ( xSlotSize * ( size_t ) uxRingLength ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pxRing != NULL )
+        {
+            ( void ) memset( ( void * ) pxRing, 0x00, sizeof( MpscRing_t ) );
+            pxRing->uxMask = uxRingLength - ( UBaseType_t ) 1;
+            pxRing->uxRecordSize = uxRecordSize;
+            pxRing->uxSlotSize = ( UBaseType_t ) xSlotSize;
+            pxRing->pucSlots = ( ( uint8_t * ) pxRing ) + sizeof( MpscRing_t );
+
+            /* Every slot starts out free for the first lap. */
+            for( x = ( UBaseType_t ) 0; x < uxRingLength; x++ )
+            {
+                prvGetSlot( pxRing, x )->uxSequence = x;
+            }
+
+            traceMPSC_RING_CREATE( pxRing );
+        }
+        else
+        {
+            traceMPSC_RING_CREATE_FAILED();
+        }
+
+        traceRETURN_xMpscRingCreate( pxRing );
+
+        return pxRing;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+void vMpscRingDelete( MpscRingHandle_t xRing )
+{
+    MpscRing_t * pxRing = xRing;
+
+    traceENTER_vMpscRingDelete( xRing );
+
+    configASSERT( pxRing );
+
+    traceMPSC_RING_DELETE( xRing );
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    {
+        vPortFree( ( void * ) pxRing );
+    }
+    #else
+    {
+        /* Only dynamically created rings exist. */
+        ( void ) pxRing;
+    }
+    #endif
+
+    traceRETURN_vMpscRingDelete();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMpscRingSend( MpscRingHandle_t xRing,
+                          const void * pvRecord )
+{
+    MpscRing_t * const pxRing = xRing;
+    MpscRingSlot_t * pxSlot;
+    UBaseType_t uxPosition, uxSequence, uxDropped;
+    BaseType_t xReturn = errQUEUE_FULL;
+
+    traceENTER_xMpscRingSend( xRing, pvRecord );
+
+    configASSERT( pxRing );
+    configASSERT( pvRecord );
+
+    uxPosition = pxRing->uxHead;
+
+    for( ; ; )
+    {
+        pxSlot = prvGetSlot( pxRing, uxPosition );
+        uxSequence = pxSlot->uxSequence;
+
+        if( uxSequence == uxPosition )
+        {
+            /* The slot is free, claim the position unless another producer
+             * got there first. */
+            if( portMPSC_RING_COMPARE_AND_SWAP( &( pxRing->uxHead ), uxPosition, uxPosition + ( UBaseType_t ) 1 ) != pdFALSE )
+            {
+                xReturn = pdPASS;
+                break;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else if( ( BaseType_t ) ( uxSequence - uxPosition ) < ( BaseType_t ) 0 )
+        {
+            /* The slot still belongs to the previous lap, the ring is full. */
+            break;
+        }
+        else
+        {
+            /* The position was claimed after it was read. */
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxPosition = pxRing->uxHead;
+    }
+
+    if( xReturn == pdPASS )
+    {
+        /* The slot is owned until the sequence number is updated, so the
+         * record is copied without holding anything. */
+        ( void ) memcpy( ( void * ) &( pxSlot[ 1 ] ), pvRecord, ( size_t ) pxRing->uxRecordSize );
+
+        /* The record must be complete before the consumer sees it published. */
+        portMPSC_RING_MEMORY_BARRIER();
+        pxSlot->uxSequence = uxPosition + ( UBaseType_t ) 1;
+
+        traceMPSC_RING_SEND( xRing );
+    }
+    else
+    {
+        do
+        {
+            uxDropped = pxRing->uxDropped;
+        } while( portMPSC_RING_COMPARE_AND_SWAP( &( pxRing->uxDropped ), uxDropped, uxDropped + ( UBaseType_t ) 1 ) == pdFALSE );
+
+        traceMPSC_RING_SEND_FAILED( xRing );
+    }
+
+    traceRETURN_xMpscRingSend( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMpscRingReceive( MpscRingHandle_t xRing,
+                             void * pvBuffer )
+{
+    MpscRing_t * const pxRing = xRing;
+    MpscRingSlot_t * pxSlot;
+    UBaseType_t uxPosition;
+    BaseType_t xReturn;
+
+    traceENTER_xMpscRingReceive( xRing, pvBuffer );
+
+    configASSERT( pxRing );
+    configASSERT( pvBuffer );
+
+    /* Only the consumer changes the tail, so it can be read without
+     * protection. */
+    uxPosition = pxRing->uxTail;
+    pxSlot = prvGetSlot( pxRing, uxPosition );
+
+    if( pxSlot->uxSequence == ( uxPosition + ( UBaseType_t ) 1 ) )
+    {
+        /* The sequence number must be read before the record. */
+        portMPSC_RING_MEMORY_BARRIER();
+        ( void ) memcpy( pvBuffer, ( const void * ) &( pxSlot[ 1 ] ), ( size_t ) pxRing->uxRecordSize );
+
+        /* The record must be copied out before a producer can claim the slot
+         * again. */
+        portMPSC_RING_MEMORY_BARRIER();
+        pxSlot->uxSequence = uxPosition + pxRing->uxMask + ( UBaseType_t ) 1;
+        pxRing->uxTail = uxPosition + ( UBaseType_t ) 1;
+
+        traceMPSC_RING_RECEIVE( xRing );
+        xReturn = pdPASS;
+    }
+    else
+    {
+        /* Empty, or the oldest claimed record is not published yet. */
+        xReturn = errQUEUE_EMPTY;
+    }
+
+    traceRETURN_xMpscRingReceive( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxMpscRingDropped( MpscRingHandle_t xRing )
+{
+    const MpscRing_t * const pxRing = xRing;
+
+    traceENTER_uxMpscRingDropped( xRing );
+
+    configASSERT( pxRing );
+
+    traceRETURN_uxMpscRingDropped( pxRing->uxDropped );
+
+    return pxRing->uxDropped;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xMpscRingIsEmpty( MpscRingHandle_t xRing )
+{
+    const MpscRing_t * const pxRing = xRing;
+    UBaseType_t uxPosition;
+    BaseType_t xReturn;
+
+    traceENTER_xMpscRingIsEmpty( xRing );
+
+    configASSERT( pxRing );
+
+    /* The same test as in xMpscRingReceive(). */
+    uxPosition = pxRing->uxTail;
+
+    if( prvGetSlot( pxRing, uxPosition )->uxSequence == ( uxPosition + ( UBaseType_t ) 1 ) )
+    {
+        xReturn = pdFALSE;
+    }
+    else
+    {
+        xReturn = pdTRUE;
+    }
+
+    traceRETURN_xMpscRingIsEmpty( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static MpscRingSlot_t * prvGetSlot( const MpscRing_t * const pxRing,
+                                    UBaseType_t uxPosition )
+{
+    /* The slot size keeps every header aligned. */
+    /* coverity[misra_c_2012_rule_11_3_violation] */
+    return ( MpscRingSlot_t * ) &( pxRing->pucSlots[ ( uxPosition & pxRing->uxMask ) * pxRing->uxSlotSize ] );
+}
+/*-----------------------------------------------------------*/
+
+#if ( mpscUSE_COMPILER_ATOMICS == 1 )
+
+    static BaseType_t prvCompareAndSwap( volatile UBaseType_t * puxDestination,
+                                         UBaseType_t uxComparand,
+                                         UBaseType_t uxExchange )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        if( __atomic_compare_exchange_n( puxDestination, &uxComparand, uxExchange, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) )
+        {
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+
+#endif /* mpscUSE_COMPILER_ATOMICS */
@@ -0,0 +1,884 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * A sample implementation of pvPortMalloc() and vPortFree() that serves the
+ * common kernel object sizes from segregated size classes and everything else
+ * from a heap_4 style first fit list that coalesces adjacent free blocks.
+ *
+ * configHEAP_POOL_CLASS_SIZES lists the request sizes, in ascending order,
+ * that get a class of their own (at most heapMAX_CLASSES).  A request is
+ * rounded up to the smallest class it fits, unless that would more than
+ * double its block: such a request is served from the coalescing heap, so the
+ * gaps between the classes do not waste memory.  Freed class blocks are kept
+ * on a singly linked list per class, so allocating and freeing them is O(1).
+ * A class with an empty list takes a new block from the coalescing heap.  If the coalescing heap cannot satisfy
+ * a request, all cached class blocks are returned to it and the request is
+ * retried.
+ *
+ * vPortGetHeapStats() counts cached class blocks as available heap space, the
+ * free block fields describe the coalescing heap only.  Per class statistics
+ * are returned by uxPortGetHeapClassStats().
+ *
+ * See heap_4.c for the allocator without size classes, and the memory
+ * management pages of https://www.FreeRTOS.org for more information.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+    #error This file must not be used if configSUPPORT_DYNAMIC_ALLOCATION is 0
+#endif
+
+#ifndef configHEAP_CLEAR_MEMORY_ON_FREE
+    #define configHEAP_CLEAR_MEMORY_ON_FREE    0
+#endif
+
+/* Request sizes, in bytes, that are served from a size class. */
+#ifndef configHEAP_POOL_CLASS_SIZES
+    #define configHEAP_POOL_CLASS_SIZES    32, 64, 128, 256, 512, 1024
+#endif
+
+/* Block sizes must not get too small. */
+#define heapMINIMUM_BLOCK_SIZE    ( ( size_t ) ( xHeapStructSize << 1 ) )
+
+/* Assumes 8bit bytes! */
+#define heapBITS_PER_BYTE         ( ( size_t ) 8 )
+
+/* Max value that fits in a size_t type. */
+#define heapSIZE_MAX              ( ~( ( size_t ) 0 ) )
+
+/* Check if multiplying a and b will result in overflow. */
+#define heapMULTIPLY_WILL_OVERFLOW( a, b )     ( ( ( a ) > 0 ) && ( ( b ) > ( heapSIZE_MAX / ( a ) ) ) )
+
+/* Check if adding a and b will result in overflow. */
+#define heapADD_WILL_OVERFLOW( a, b )          ( ( a ) > ( heapSIZE_MAX - ( b ) ) )
+
+/* Check if the subtraction operation ( a - b ) will result in underflow. */
+#define heapSUBTRACT_WILL_UNDERFLOW( a, b )    ( ( a ) < ( b ) )
+
+/* MSB of the xBlockSize member of an BlockLink_t structure is used to track
+ * the allocation status of a block.  When MSB of the xBlockSize member of
+ * an BlockLink_t structure is set then the block belongs to the application.
+ * When the bit is free the block is still part of the free heap space.
+ *
+ * The three bits below the MSB hold the size class of a block plus one, or
+ * zero if the block belongs to the coalescing heap. */
+#define heapBLOCK_ALLOCATED_BITMASK    ( ( ( size_t ) 1 ) << ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 1 ) )
+#define heapBLOCK_CLASS_SHIFT          ( ( sizeof( size_t ) * heapBITS_PER_BYTE ) - 4 )
+#define heapBLOCK_CLASS_BITMASK        ( ( ( size_t ) 7 ) << heapBLOCK_CLASS_SHIFT )
+#define heapBLOCK_FLAGS_BITMASK        ( heapBLOCK_ALLOCATED_BITMASK | heapBLOCK_CLASS_BITMASK )
+#define heapMAX_CLASSES                ( ( UBaseType_t ) 7 )
+#define heapNO_CLASS                   heapMAX_CLASSES
+
+#define heapBLOCK_SIZE_IS_VALID( xBlockSize )    ( ( ( xBlockSize ) & heapBLOCK_FLAGS_BITMASK ) == 0 )
+#define heapBLOCK_IS_ALLOCATED( pxBlock )        ( ( ( pxBlock->xBlockSize ) & heapBLOCK_ALLOCATED_BITMASK ) != 0 )
+#define heapALLOCATE_BLOCK( pxBlock )            ( ( pxBlock->xBlockSize ) |= heapBLOCK_ALLOCATED_BITMASK )
+#define heapFREE_BLOCK( pxBlock )                ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_ALLOCATED_BITMASK )
+#define heapBLOCK_SIZE( pxBlock )                ( ( pxBlock->xBlockSize ) & ~heapBLOCK_FLAGS_BITMASK )
+#define heapBLOCK_CLASS( pxBlock )               ( ( UBaseType_t ) ( ( ( ( ( pxBlock->xBlockSize ) & heapBLOCK_CLASS_BITMASK ) >> heapBLOCK_CLASS_SHIFT ) - 1 ) & 7 ) )
+#define heapSET_BLOCK_CLASS( pxBlock, uxClass )  ( ( pxBlock->xBlockSize ) |= ( ( size_t ) ( uxClass ) + 1 ) << heapBLOCK_CLASS_SHIFT )
+#define heapCLEAR_BLOCK_CLASS( pxBlock )         ( ( pxBlock->xBlockSize ) &= ~heapBLOCK_CLASS_BITMASK )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+
+/* The application writer has already defined the array used for the RTOS
+* heap - probably so it can be placed in a special segment or address. */
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif /* configAPPLICATION_ALLOCATED_HEAP */
+
+/* Define the linked list structure.  This is used to link free blocks in order
+ * of their memory address, and the cached blocks of each size class. */
+typedef struct A_BLOCK_LINK
+{
+    struct A_BLOCK_LINK * pxNextFreeBlock; /**< The next free block in the list. */
+    size_t xBlockSize;                     /**< The size of the free block. */
+} BlockLink_t;
+
+/* Setting configENABLE_HEAP_PROTECTOR to 1 enables heap block pointers
+ * protection using an application supplied canary value to catch heap
+ * corruption should a heap buffer overflow occur.
+ */
+#if ( configENABLE_HEAP_PROTECTOR == 1 )
+
+/**
+ * @brief Application provided function to get a random value to be used as canary.
+ *
+ * @param pxHeapCanary [out] Output parameter to return the canary value.
+ */
+    extern void vApplicationGetRandomHeapCanary( portPOINTER_SIZE_TYPE * pxHeapCanary );
+
+/* Canary value for protecting internal heap pointers. */
+    PRIVILEGED_DATA static portPOINTER_SIZE_TYPE xHeapCanary;
+
+/* Macro to load/store BlockLink_t pointers to memory. By XORing the
+ * pointers with a random canary value, heap overflows will result
+ * in randomly unpredictable pointer values which will be caught by
+ * heapVALIDATE_BLOCK_POINTER assert. */
+    #define heapPROTECT_BLOCK_POINTER( pxBlock )    ( ( BlockLink_t * ) ( ( ( portPOINTER_SIZE_TYPE ) ( pxBlock ) ) ^ xHeapCanary ) )
+#else
+
+    #define heapPROTECT_BLOCK_POINTER( pxBlock )    ( pxBlock )
+
+#endif /* configENABLE_HEAP_PROTECTOR */
+
+/* Assert that a heap block pointer is within the heap bounds. */
+#define heapVALIDATE_BLOCK_POINTER( pxBlock )                          \
+    configASSERT( ( ( uint8_t * ) ( pxBlock ) >= &( ucHeap[ 0 ] ) ) && \
+                  ( ( uint8_t * ) ( pxBlock ) <= &( ucHeap[ configTOTAL_HEAP_SIZE - 1 ] ) ) )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Inserts a block of memory that is being freed into the correct position in
+ * the list of free memory blocks.  The block being freed will be merged with
+ * the block in front it and/or the block behind it if the memory blocks are
+ * adjacent to each other.
+ */
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) PRIVILEGED_FUNCTION;
+
+/*
+ * Takes a block of at least xWantedSize bytes, header included, from the
+ * list of free memory blocks.  Returns NULL if there is no such block.  Must
+ * be called with the scheduler suspended.
+ */
+static BlockLink_t * prvAllocateFromFreeList( size_t xWantedSize ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the blocks cached by all size classes to the list of free memory
+ * blocks so they can be coalesced.  Returns pdTRUE if any block was returned.
+ * Must be called with the scheduler suspended.
+ */
+static BaseType_t prvReleaseClassBlocks( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Called automatically to setup the required heap structures the first time
+ * pvPortMalloc() is called.
+ */
+static void prvHeapInit( void ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+/* The size of the structure placed at the beginning of each allocated memory
+ * block must by correctly byte aligned. */
+static const size_t xHeapStructSize = ( sizeof( BlockLink_t ) + ( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+
+/* Request sizes of the size classes. */
+static const size_t xClassRequestSizes[] = { configHEAP_POOL_CLASS_SIZES };
+
+#define heapNUMBER_OF_CLASSES    ( ( UBaseType_t ) ( sizeof( xClassRequestSizes ) / sizeof( xClassRequestSizes[ 0 ] ) ) )
+
+/* Create a couple of list links to mark the start and end of the list. */
+PRIVILEGED_DATA static BlockLink_t xStart;
+PRIVILEGED_DATA static BlockLink_t * pxEnd = NULL;
+
+/* Per size class block size, header included, list of cached blocks and
+ * statistics. */
+typedef struct A_SIZE_CLASS
+{
+    size_t xBlockSize;
+    BlockLink_t * pxFreeBlocks;
+    size_t xBlocksInUse;
+    size_t xBlocksCached;
+    size_t xNumberOfAllocations;
+    size_t xNumberOfCacheMisses;
+} SizeClass_t;
+
+PRIVILEGED_DATA static SizeClass_t xClasses[ heapNUMBER_OF_CLASSES ];
+
+/* Keeps track of the number of calls to allocate and free memory as well as the
+ * number of free bytes remaining, but says nothing about fragmentation.  Free
+ * bytes include the blocks cached by the size classes. */
+PRIVILEGED_DATA static size_t xFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+PRIVILEGED_DATA static size_t xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    BlockLink_t * pxBlock = NULL;
+    SizeClass_t * pxClass = NULL;
+    void * pvReturn = NULL;
+    size_t xAdditionalRequiredSize;
+    size_t xAllocatedBlockSize = 0;
+    UBaseType_t uxClass = heapNO_CLASS;
+
+    if( xWantedSize > 0 )
+    {
+        /* The wanted size must be increased so it can contain a BlockLink_t
+         * structure in addition to the requested amount of bytes. */
+        if( heapADD_WILL_OVERFLOW( xWantedSize, xHeapStructSize ) == 0 )
+        {
+            xWantedSize += xHeapStructSize;
+
+            /* Ensure that blocks are always aligned to the required number
+             * of bytes. */
+            if( ( xWantedSize & portBYTE_ALIGNMENT_MASK ) != 0x00 )
+            {
+                /* Byte alignment required. */
+                xAdditionalRequiredSize = portBYTE_ALIGNMENT - ( xWantedSize & portBYTE_ALIGNMENT_MASK );
+
+                if( heapADD_WILL_OVERFLOW( xWantedSize, xAdditionalRequiredSize ) == 0 )
+                {
+                    xWantedSize += xAdditionalRequiredSize;
+                }
+                else
+                {
+                    xWantedSize = 0;
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            xWantedSize = 0;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    vTaskSuspendAll();
+    {
+        /* If this is the first call to malloc then the heap will require
+         * initialisation to setup the list of free blocks. */
+        if( pxEnd == NULL )
+        {
+            prvHeapInit();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Check the block size we are trying to allocate is not so large that
+         * the flag bits are set.  The top bits of the block size member of the
+         * BlockLink_t structure are used to determine who owns the block and
+         * its size class, so they must be free. */
+        if( ( heapBLOCK_SIZE_IS_VALID( xWantedSize ) != 0 ) && ( xWantedSize > 0 ) )
+        {
+            /* Find the smallest size class the request fits, and take it if
+             * the request fills more than half of the class's block. */
+            for( uxClass = 0; uxClass < heapNUMBER_OF_CLASSES; uxClass++ )
+            {
+                if( xWantedSize <= xClasses[ uxClass ].xBlockSize )
+                {
+                    break;
+                }
+            }
+
+            if( ( uxClass < heapNUMBER_OF_CLASSES ) && ( xWantedSize > ( xClasses[ uxClass ].xBlockSize >> 1 ) ) )
+            {
+                pxClass = &( xClasses[ uxClass ] );
+                xWantedSize = pxClass->xBlockSize;
+                pxClass->xNumberOfAllocations++;
+
+                if( pxClass->pxFreeBlocks != heapPROTECT_BLOCK_POINTER( NULL ) )
+                {
+                    /* O(1) path, reuse a cached block of this class. */
+                    pxBlock = heapPROTECT_BLOCK_POINTER( pxClass->pxFreeBlocks );
+                    heapVALIDATE_BLOCK_POINTER( pxBlock );
+                    pxClass->pxFreeBlocks = pxBlock->pxNextFreeBlock;
+                    pxClass->xBlocksCached--;
+                    xFreeBytesRemaining -= heapBLOCK_SIZE( pxBlock );
+                    heapALLOCATE_BLOCK( pxBlock );
+                    pxBlock->pxNextFreeBlock = NULL;
+                }
+                else
+                {
+                    pxClass->xNumberOfCacheMisses++;
+                }
+            }
+            else
+            {
+                uxClass = heapNO_CLASS;
+            }
+
+            if( pxBlock == NULL )
+            {
+                pxBlock = prvAllocateFromFreeList( xWantedSize );
+
+                if( ( pxBlock == NULL ) && ( xWantedSize <= xFreeBytesRemaining ) && ( prvReleaseClassBlocks() != pdFALSE ) )
+                {
+                    /* Cached class blocks may have coalesced into a block
+                     * that is large enough. */
+                    pxBlock = prvAllocateFromFreeList( xWantedSize );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ( pxBlock != NULL ) && ( pxClass != NULL ) )
+                {
+                    heapSET_BLOCK_CLASS( pxBlock, uxClass );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( pxBlock != NULL )
+            {
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( pxClass != NULL )
+                {
+                    pxClass->xBlocksInUse++;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Return the memory space pointed to - jumping over the
+                 * BlockLink_t structure at its start. */
+                pvReturn = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xHeapStructSize );
+                heapVALIDATE_BLOCK_POINTER( pvReturn );
+                xAllocatedBlockSize = heapBLOCK_SIZE( pxBlock );
+                xNumberOfSuccessfulAllocations++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceMALLOC( pvReturn, xAllocatedBlockSize );
+
+        /* Prevent compiler warnings when trace macros are not used. */
+        ( void ) xAllocatedBlockSize;
+    }
+    ( void ) xTaskResumeAll();
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    #endif /* if ( configUSE_MALLOC_FAILED_HOOK == 1 ) */
+
+    configASSERT( ( ( ( size_t ) pvReturn ) & ( size_t ) portBYTE_ALIGNMENT_MASK ) == 0 );
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFree( void * pv )
+{
+    uint8_t * puc = ( uint8_t * ) pv;
+    BlockLink_t * pxLink;
+    SizeClass_t * pxClass;
+    UBaseType_t uxClass;
+
+    if( pv != NULL )
+    {
+        /* The memory being freed will have an BlockLink_t structure immediately
+         * before it. */
+        puc -= xHeapStructSize;
+
+        /* This casting is to keep the compiler from issuing warnings. */
+        pxLink = ( void * ) puc;
+
+        heapVALIDATE_BLOCK_POINTER( pxLink );
+        configASSERT( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 );
+        configASSERT( pxLink->pxNextFreeBlock == NULL );
+
+        if( heapBLOCK_IS_ALLOCATED( pxLink ) != 0 )
+        {
+            if( pxLink->pxNextFreeBlock == NULL )
+            {
+                /* The block is being returned to the heap - it is no longer
+                 * allocated. */
+                heapFREE_BLOCK( pxLink );
+                uxClass = heapBLOCK_CLASS( pxLink );
+                #if ( configHEAP_CLEAR_MEMORY_ON_FREE == 1 )
+                {
+                    /* Check for underflow as this can occur if xBlockSize is
+                     * overwritten in a heap block. */
+                    if( heapSUBTRACT_WILL_UNDERFLOW( heapBLOCK_SIZE( pxLink ), xHeapStructSize ) == 0 )
+                    {
+                        ( void ) memset( puc + xHeapStructSize, 0, heapBLOCK_SIZE( pxLink ) - xHeapStructSize );
+                    }
+                }
+                #endif
+
+                vTaskSuspendAll();
+                {
+                    xFreeBytesRemaining += heapBLOCK_SIZE( pxLink );
+                    traceFREE( pv, heapBLOCK_SIZE( pxLink ) );
+
+                    if( uxClass < heapNUMBER_OF_CLASSES )
+                    {
+                        /* Keep the block, and its class, on the list of its
+                         * size class. */
+                        pxClass = &( xClasses[ uxClass ] );
+                        pxLink->pxNextFreeBlock = pxClass->pxFreeBlocks;
+                        pxClass->pxFreeBlocks = heapPROTECT_BLOCK_POINTER( pxLink );
+                        pxClass->xBlocksCached++;
+                        pxClass->xBlocksInUse--;
+                    }
+                    else
+                    {
+                        /* Add this block to the list of free blocks. */
+                        heapCLEAR_BLOCK_CLASS( pxLink );
+                        prvInsertBlockIntoFreeList( ( ( BlockLink_t * ) pxLink ) );
+                    }
+
+                    xNumberOfSuccessfulFrees++;
+                }
+                ( void ) xTaskResumeAll();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortInitialiseBlocks( void )
+{
+    /* This just exists to keep the linker quiet. */
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortCalloc( size_t xNum,
+                     size_t xSize )
+{
+    void * pv = NULL;
+
+    if( heapMULTIPLY_WILL_OVERFLOW( xNum, xSize ) == 0 )
+    {
+        pv = pvPortMalloc( xNum * xSize );
+
+        if( pv != NULL )
+        {
+            ( void ) memset( pv, 0, xNum * xSize );
+        }
+    }
+
+    return pv;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxFirstFreeBlock;
+    portPOINTER_SIZE_TYPE uxStartAddress, uxEndAddress;
+    size_t xTotalHeapSize = configTOTAL_HEAP_SIZE;
+    UBaseType_t uxClass;
+
+    /* The class of a block is kept in three bits of its size. */
+    configASSERT( heapNUMBER_OF_CLASSES <= heapMAX_CLASSES );
+
+    /* Ensure the heap starts on a correctly aligned boundary. */
+    uxStartAddress = ( portPOINTER_SIZE_TYPE ) ucHeap;
+
+    if( ( uxStartAddress & portBYTE_ALIGNMENT_MASK ) != 0 )
+    {
+        uxStartAddress += ( portBYTE_ALIGNMENT - 1 );
+        uxStartAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+        xTotalHeapSize -= ( size_t ) ( uxStartAddress - ( portPOINTER_SIZE_TYPE ) ucHeap );
+    }
+
+    #if ( configENABLE_HEAP_PROTECTOR == 1 )
+    {
+        vApplicationGetRandomHeapCanary( &( xHeapCanary ) );
+    }
+    #endif
+
+    /* xStart is used to hold a pointer to the first item in the list of free
+     * blocks.  The void cast is used to prevent compiler warnings. */
+    xStart.pxNextFreeBlock = ( void * ) heapPROTECT_BLOCK_POINTER( uxStartAddress );
+    xStart.xBlockSize = ( size_t ) 0;
+
+    /* pxEnd is used to mark the end of the list of free blocks and is inserted
+     * at the end of the heap space. */
+    uxEndAddress = uxStartAddress + ( portPOINTER_SIZE_TYPE ) xTotalHeapSize;
+    uxEndAddress -= ( portPOINTER_SIZE_TYPE ) xHeapStructSize;
+    uxEndAddress &= ~( ( portPOINTER_SIZE_TYPE ) portBYTE_ALIGNMENT_MASK );
+    pxEnd = ( BlockLink_t * ) uxEndAddress;
+    pxEnd->xBlockSize = 0;
+    pxEnd->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( NULL );
+
+    /* To start with there is a single free block that is sized to take up the
+     * entire heap space, minus the space taken by pxEnd. */
+    pxFirstFreeBlock = ( BlockLink_t * ) uxStartAddress;
+    pxFirstFreeBlock->xBlockSize = ( size_t ) ( uxEndAddress - ( portPOINTER_SIZE_TYPE ) pxFirstFreeBlock );
+    pxFirstFreeBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxEnd );
+
+    /* Only one block exists - and it covers the entire usable heap space. */
+    xMinimumEverFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+    xFreeBytesRemaining = pxFirstFreeBlock->xBlockSize;
+
+    /* Class blocks carry the same header and alignment as any other block. */
+    for( uxClass = 0; uxClass < heapNUMBER_OF_CLASSES; uxClass++ )
+    {
+        configASSERT( ( uxClass == 0 ) || ( xClassRequestSizes[ uxClass ] > xClassRequestSizes[ uxClass - 1 ] ) );
+
+        xClasses[ uxClass ].xBlockSize = ( xClassRequestSizes[ uxClass ] + xHeapStructSize + portBYTE_ALIGNMENT_MASK ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK );
+        xClasses[ uxClass ].pxFreeBlocks = heapPROTECT_BLOCK_POINTER( NULL );
+        xClasses[ uxClass ].xBlocksInUse = 0;
+        xClasses[ uxClass ].xBlocksCached = 0;
+        xClasses[ uxClass ].xNumberOfAllocations = 0;
+        xClasses[ uxClass ].xNumberOfCacheMisses = 0;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static BlockLink_t * prvAllocateFromFreeList( size_t xWantedSize ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock;
+    BlockLink_t * pxPreviousBlock;
+    BlockLink_t * pxNewBlockLink;
+
+    if( xWantedSize > xFreeBytesRemaining )
+    {
+        return NULL;
+    }
+
+    /* Traverse the list from the start (lowest address) block until
+     * one of adequate size is found. */
+    pxPreviousBlock = &xStart;
+    pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
+    heapVALIDATE_BLOCK_POINTER( pxBlock );
+
+    while( ( pxBlock->xBlockSize < xWantedSize ) && ( pxBlock->pxNextFreeBlock != heapPROTECT_BLOCK_POINTER( NULL ) ) )
+    {
+        pxPreviousBlock = pxBlock;
+        pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+        heapVALIDATE_BLOCK_POINTER( pxBlock );
+    }
+
+    /* If the end marker was reached then a block of adequate size
+     * was not found. */
+    if( pxBlock == pxEnd )
+    {
+        return NULL;
+    }
+
+    /* This block is being returned for use so must be taken out
+     * of the list of free blocks. */
+    pxPreviousBlock->pxNextFreeBlock = pxBlock->pxNextFreeBlock;
+
+    /* If the block is larger than required it can be split into
+     * two. */
+    configASSERT( heapSUBTRACT_WILL_UNDERFLOW( pxBlock->xBlockSize, xWantedSize ) == 0 );
+
+    if( ( pxBlock->xBlockSize - xWantedSize ) > heapMINIMUM_BLOCK_SIZE )
+    {
+        /* This block is to be split into two.  Create a new
+         * block following the number of bytes requested. The void
+         * cast is used to prevent byte alignment warnings from the
+         * compiler. */
+        pxNewBlockLink = ( void * ) ( ( ( uint8_t * ) pxBlock ) + xWantedSize );
+        configASSERT( ( ( ( size_t ) pxNewBlockLink ) & portBYTE_ALIGNMENT_MASK ) == 0 );
+
+        /* Calculate the sizes of two blocks split from the
+         * single block. */
+        pxNewBlockLink->xBlockSize = pxBlock->xBlockSize - xWantedSize;
+        pxBlock->xBlockSize = xWantedSize;
+
+        /* Insert the new block into the list of free blocks. */
+        pxNewBlockLink->pxNextFreeBlock = pxPreviousBlock->pxNextFreeBlock;
+        pxPreviousBlock->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxNewBlockLink );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xFreeBytesRemaining -= pxBlock->xBlockSize;
+
+    /* The block is being returned - it is allocated and owned
+     * by the application and has no "next" block. */
+    heapALLOCATE_BLOCK( pxBlock );
+    pxBlock->pxNextFreeBlock = NULL;
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvReleaseClassBlocks( void ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxBlock;
+    UBaseType_t uxClass;
+    BaseType_t xReleased = pdFALSE;
+
+    for( uxClass = 0; uxClass < heapNUMBER_OF_CLASSES; uxClass++ )
+    {
+        while( xClasses[ uxClass ].pxFreeBlocks != heapPROTECT_BLOCK_POINTER( NULL ) )
+        {
+            pxBlock = heapPROTECT_BLOCK_POINTER( xClasses[ uxClass ].pxFreeBlocks );
+            heapVALIDATE_BLOCK_POINTER( pxBlock );
+            xClasses[ uxClass ].pxFreeBlocks = pxBlock->pxNextFreeBlock;
+
+            /* The bytes are already counted as free. */
+            heapCLEAR_BLOCK_CLASS( pxBlock );
+            prvInsertBlockIntoFreeList( pxBlock );
+            xReleased = pdTRUE;
+        }
+
+        xClasses[ uxClass ].xBlocksCached = 0;
+    }
+
+    return xReleased;
+}
+/*-----------------------------------------------------------*/
+static void prvInsertBlockIntoFreeList( BlockLink_t * pxBlockToInsert ) /* PRIVILEGED_FUNCTION */
+{
+    BlockLink_t * pxIterator;
+    uint8_t * puc;
+
+    /* Iterate through the list until a block is found that has a higher address
+     * than the block being inserted. */
+    for( pxIterator = &xStart; heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) < pxBlockToInsert; pxIterator = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+    {
+        /* Nothing to do here, just iterate to the right position. */
+    }
+
+    if( pxIterator != &xStart )
+    {
+        heapVALIDATE_BLOCK_POINTER( pxIterator );
+    }
+
+    /* Do the block being inserted, and the block it is being inserted after
+     * make a contiguous block of memory? */
+    puc = ( uint8_t * ) pxIterator;
+
+    if( ( puc + pxIterator->xBlockSize ) == ( uint8_t * ) pxBlockToInsert )
+    {
+        pxIterator->xBlockSize += pxBlockToInsert->xBlockSize;
+        pxBlockToInsert = pxIterator;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    /* Do the block being inserted, and the block it is being inserted before
+     * make a contiguous block of memory? */
+    puc = ( uint8_t * ) pxBlockToInsert;
+
+    if( ( puc + pxBlockToInsert->xBlockSize ) == ( uint8_t * ) heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) )
+    {
+        if( heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock ) != pxEnd )
+        {
+            /* Form one big block from the two blocks. */
+            pxBlockToInsert->xBlockSize += heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock )->xBlockSize;
+            pxBlockToInsert->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxIterator->pxNextFreeBlock )->pxNextFreeBlock;
+        }
+        else
+        {
+            pxBlockToInsert->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxEnd );
+        }
+    }
+    else
+    {
+        pxBlockToInsert->pxNextFreeBlock = pxIterator->pxNextFreeBlock;
+    }
+
+    /* If the block being inserted plugged a gab, so was merged with the block
+     * before and the block after, then it's pxNextFreeBlock pointer will have
+     * already been set, and should not be set here as that would make it point
+     * to itself. */
+    if( pxIterator != pxBlockToInsert )
+    {
+        pxIterator->pxNextFreeBlock = heapPROTECT_BLOCK_POINTER( pxBlockToInsert );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    BlockLink_t * pxBlock;
+    size_t xBlocks = 0, xMaxSize = 0, xMinSize = portMAX_DELAY; /* portMAX_DELAY used as a portable way of getting the maximum value. */
+
+    vTaskSuspendAll();
+    {
+        pxBlock = heapPROTECT_BLOCK_POINTER( xStart.pxNextFreeBlock );
+
+        /* pxBlock will be NULL if the heap has not been initialised.  The heap
+         * is initialised automatically when the first allocation is made. */
+        if( pxBlock != NULL )
+        {
+            while( pxBlock != pxEnd )
+            {
+                /* Increment the number of blocks and record the largest block seen
+                 * so far. */
+                xBlocks++;
+
+                if( pxBlock->xBlockSize > xMaxSize )
+                {
+                    xMaxSize = pxBlock->xBlockSize;
+                }
+
+                if( pxBlock->xBlockSize < xMinSize )
+                {
+                    xMinSize = pxBlock->xBlockSize;
+                }
+
+                /* Move to the next block in the chain until the last block is
+                 * reached. */
+                pxBlock = heapPROTECT_BLOCK_POINTER( pxBlock->pxNextFreeBlock );
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xMaxSize;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = xMinSize;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    taskENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortGetHeapClassStats( HeapClassStats_t * pxClassStats,
+                                     UBaseType_t uxArraySize )
+{
+    UBaseType_t uxClass;
+
+    if( uxArraySize > heapNUMBER_OF_CLASSES )
+    {
+        uxArraySize = heapNUMBER_OF_CLASSES;
+    }
+
+    vTaskSuspendAll();
+    {
+        for( uxClass = 0; uxClass < uxArraySize; uxClass++ )
+        {
+            pxClassStats[ uxClass ].xRequestSize = xClassRequestSizes[ uxClass ];
+            pxClassStats[ uxClass ].xBlocksInUse = xClasses[ uxClass ].xBlocksInUse;
+            pxClassStats[ uxClass ].xBlocksCached = xClasses[ uxClass ].xBlocksCached;
+            pxClassStats[ uxClass ].xNumberOfAllocations = xClasses[ uxClass ].xNumberOfAllocations;
+            pxClassStats[ uxClass ].xNumberOfCacheMisses = xClasses[ uxClass ].xNumberOfCacheMisses;
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return uxArraySize;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Reset the state in this file. This state is normally initialized at start up.
+ * This function must be called by the application before restarting the
+ * scheduler.
+ */
+void vPortHeapResetState( void )
+{
+    UBaseType_t uxClass;
+
+    pxEnd = NULL;
+
+    xFreeBytesRemaining = ( size_t ) 0U;
+    xMinimumEverFreeBytesRemaining = ( size_t ) 0U;
+    xNumberOfSuccessfulAllocations = ( size_t ) 0U;
+    xNumberOfSuccessfulFrees = ( size_t ) 0U;
+
+    for( uxClass = 0; uxClass < heapNUMBER_OF_CLASSES; uxClass++ )
+    {
+        xClasses[ uxClass ].xBlocksInUse = 0;
+        xClasses[ uxClass ].xBlocksCached = 0;
+        xClasses[ uxClass ].xNumberOfAllocations = 0;
+        xClasses[ uxClass ].xNumberOfCacheMisses = 0;
+    }
+}
+/*-----------------------------------------------------------*/
@@ -104,6 +104,8 @@ extern void vPortYield( void );
         if( xSwitchRequired )                               \
         {                                                   \
             traceISR_EXIT_TO_SCHEDULER();                   \
+            portLATENCY_YIELD_FROM_ISR();                   \
+            portTICKLESS_WAKE();                            \
             portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT; \
         }                                                   \
         else                                                \
@@ -272,6 +274,85 @@ static inline void vPortRecursiveLock( uint32_t ulLockNum,
     extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
     #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
 #endif
+
+#if ( configUSE_TICKLESS_IDLE == 1 ) && ( configNUMBER_OF_CORES > 1 )
+
+/* Only the tick core suppresses the tick, the kernel keeps the idle task that
+ * does it there.  While that core sleeps the scheduler is suspended, so a task
+ * readied by an interrupt on the other core can't run until the tick core
+ * wakes up and resumes it: sev wakes it from wfe. */
+    #ifdef configTICK_CORE
+        #define portTICKLESS_IDLE_CORE    configTICK_CORE
+    #else
+        #define portTICKLESS_IDLE_CORE    0
+    #endif
+    #define portTICKLESS_WAKE()           __sev()
+#else
+    #define portTICKLESS_WAKE()
+#endif
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+/* Time spent with the tick suppressed, times are in microseconds. */
+    typedef struct xTICKLESS_STATS
+    {
+        uint64_t ullElapsedTime;     /* Time since the statistics were reset. */
+        uint64_t ullSleepTime;       /* Time spent waiting for the wake time or an interrupt. */
+        uint32_t ulSleeps;           /* Number of times the tick was suppressed. */
+        uint32_t ulAborted;          /* Sleeps abandoned because a task became ready first. */
+        uint32_t ulEarlyWakes;       /* Sleeps ended by an interrupt before the wake time. */
+        uint32_t ulTicksStepped;     /* Ticks accounted for with vTaskStepTick(). */
+        uint32_t ulWakeLatencyTotal; /* Wake time to tick running again, summed over the sleeps that lasted to the wake time. */
+        uint32_t ulWakeLatencyMax;   /* Longest of the above. */
+    } TicklessStats_t;
+
+    void vPortGetTicklessStats( TicklessStats_t * pxStats );
+    void vPortResetTicklessStats( void );
+#endif
+/*-----------------------------------------------------------*/
+
+/* Architecture specific optimisations. */
+
+/* The Cortex-M0+ has no CLZ instruction.  The highest set bit is found by
+ * setting all the bits below it and looking the result up with a de Bruijn
+ * multiply, which takes the same time whichever bits are set.  Task selection,
+ * the delayed task wheel and the latency histograms all use it. */
+__attribute__( ( always_inline ) ) static inline uint32_t ulPortHighestSetBit( uint32_t ulBitmap )
+{
+    static const uint8_t ucDeBruijnLog2[ 32 ] =
+    {
+        0U, 9U,  1U,  10U, 13U, 21U, 2U,  29U, 11U, 14U, 16U, 18U, 22U, 25U, 3U, 30U,
+        8U, 12U, 20U, 28U, 15U, 17U, 24U, 7U,  19U, 27U, 23U, 6U,  26U, 5U,  4U, 31U
+    };
+
+    ulBitmap |= ulBitmap >> 1;
+    ulBitmap |= ulBitmap >> 2;
+    ulBitmap |= ulBitmap >> 4;
+    ulBitmap |= ulBitmap >> 8;
+    ulBitmap |= ulBitmap >> 16;
+
+    return ucDeBruijnLog2[ ( uint32_t ) ( ulBitmap * 0x07C4ACDDU ) >> 27 ];
+}
+
+#define portHIGHEST_SET_BIT( ulBitmap )    ulPortHighestSetBit( ulBitmap )
+
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+/* Check the configuration. */
+    #if ( configMAX_PRIORITIES > 32 )
+        #error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.
+    #endif
+
+/* Store/clear the ready priorities in a bit map. */
+    #define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities )    ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+    #define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities )     ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+/*-----------------------------------------------------------*/
+
+    #define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities )    uxTopPriority = ulPortHighestSetBit( ( uxReadyPriorities ) )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
 /*-----------------------------------------------------------*/
 
 /* Task function macros as described on the FreeRTOS.org WEB site. */
@@ -282,6 +363,37 @@ static inline void vPortRecursiveLock( uint32_t ulLockNum,
 
 #define portMEMORY_BARRIER()    __asm volatile ( "" ::: "memory" )
 
+/* Spin lock of the MPSC rings, claimed by vPortMpscRingInit() when the first
+ * ring is created. */
+extern spin_lock_t * pxPortMpscRingSpinLock;
+void vPortMpscRingInit( void );
+
+/* Compare and swap for the MPSC ring.  Interrupts are masked and the spin lock
+ * is held only for the compare and the store, so it can be called from tasks
+ * and interrupts on both cores. */
+static inline BaseType_t xPortCompareAndSwap( volatile UBaseType_t * puxDestination,
+                                              UBaseType_t uxComparand,
+                                              UBaseType_t uxExchange )
+{
+    spin_lock_t * const pxSpinLock = pxPortMpscRingSpinLock;
+    uint32_t ulSave = spin_lock_blocking( pxSpinLock );
+    BaseType_t xSwapped = pdFALSE;
+
+    if( *puxDestination == uxComparand )
+    {
+        *puxDestination = uxExchange;
+        xSwapped = pdTRUE;
+    }
+
+    spin_unlock( pxSpinLock, ulSave );
+
+    return xSwapped;
+}
+
+#define portMPSC_RING_COMPARE_AND_SWAP( puxDestination, uxComparand, uxExchange )    xPortCompareAndSwap( ( puxDestination ), ( uxComparand ), ( uxExchange ) )
+#define portMPSC_RING_MEMORY_BARRIER()                                                __dmb()
+#define portMPSC_RING_INIT()                                                          vPortMpscRingInit()
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
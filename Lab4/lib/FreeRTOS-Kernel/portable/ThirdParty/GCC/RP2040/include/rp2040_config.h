@@ -74,6 +74,23 @@
     #endif
 #endif
 
+/* With configUSE_TICKLESS_IDLE == 1 the tick interrupt comes from hardware
+ * alarm configTICK_ALARM_NUM of the RP2040 timer instead of SysTick.  Alarm 3
+ * is used by the SDK default alarm pool */
+#if ( configUSE_TICKLESS_IDLE == 1 )
+    #ifndef configTICK_ALARM_NUM
+        #define configTICK_ALARM_NUM    2
+    #endif
+
+/* configTICKLESS_DEEP_SLEEP == 1 sets SLEEPDEEP while the tick is suppressed,
+ * so the clocks the application has cleared in CLOCKS_SLEEP_EN0/1 stop while
+ * both cores are asleep.  The timer and the tick alarm interrupt must be left
+ * running */
+    #ifndef configTICKLESS_DEEP_SLEEP
+        #define configTICKLESS_DEEP_SLEEP    0
+    #endif
+#endif
+
 /* This SMP port requires two spin locks, which are claimed from the SDK.
  * the spin lock numbers to be used are defined statically and defaulted here
  * to the values nominally set aside for RTOS by the SDK */
@@ -85,6 +102,13 @@
     #define configSMP_SPINLOCK_1    PICO_SPINLOCK_ID_OS2
 #endif
 
+/* The MPSC ring advances its head under a spin lock of its own, as the M0+ has
+ * no exclusive access instructions.  An unused one is claimed from the SDK
+ * when the first ring is created, define configMPSC_RING_SPINLOCK to pick a
+ * fixed one instead.  The SDK's striped locks are not used, their other users
+ * may hold them for longer or take them from an interrupt while the ring's
+ * lock is held. */
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     }
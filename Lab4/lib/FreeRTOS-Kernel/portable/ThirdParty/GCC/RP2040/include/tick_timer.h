@@ -0,0 +1,112 @@
+/*
+ * FreeRTOS Kernel <DEVELOPMENT BRANCH>
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ * Copyright (c) 2021 Raspberry Pi (Trading) Ltd.
+ *
+ * SPDX-License-Identifier: MIT AND BSD-3-Clause
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ */
+
+/*
+ * Tick accounting of tickless idle on the RP2040 port.
+ *
+ * The tick is taken from a 1 MHz timer that keeps counting while the core
+ * sleeps.  The time of the latest tick the kernel has counted is kept, and
+ * both the tick interrupt and the wake up from a sleep count the whole tick
+ * periods that have passed since then on the timer.  The arithmetic is kept
+ * here, free of hardware access, so that it can be checked on a host with a
+ * simulated timer (Lab4/tests/tick_timer_test.c).
+ */
+
+#ifndef TICK_TIMER_H
+#define TICK_TIMER_H
+
+#include <stdint.h>
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+typedef struct xTICK_TIMER
+{
+    uint32_t ulLastTickTime;          /* Timer value at the latest tick the kernel has counted. */
+    uint32_t ulTimerCountsForOneTick; /* Timer counts that make up one tick period. */
+} TickTimer_t;
+
+/* Has the free running timer reached ulTarget?  Holds across the 32-bit wrap
+ * for targets less than half the range ahead. */
+static inline int xTickTimerReached( uint32_t ulNow,
+                                     uint32_t ulTarget )
+{
+    return ( int32_t ) ( ulNow - ulTarget ) >= 0;
+}
+
+/* The number of tick periods that can be suppressed while keeping the alarm
+ * target less than half the timer range ahead of the latest tick. */
+static inline uint32_t ulTickTimerMaxSuppressedTicks( const TickTimer_t * pxTimer )
+{
+    return 0x7fffffffUL / pxTimer->ulTimerCountsForOneTick;
+}
+
+/* Counts the whole tick periods that have passed at ulNow, at most ulMaxTicks,
+ * and moves the latest tick time over them.  A late tick interrupt counts every
+ * period it was late for and a period already stepped over is never counted
+ * again. */
+static inline uint32_t ulTickTimerAdvance( TickTimer_t * pxTimer,
+                                           uint32_t ulNow,
+                                           uint32_t ulMaxTicks )
+{
+    uint32_t ulTicks = ( ulNow - pxTimer->ulLastTickTime ) / pxTimer->ulTimerCountsForOneTick;
+
+    if( ulTicks > ulMaxTicks )
+    {
+        ulTicks = ulMaxTicks;
+    }
+
+    pxTimer->ulLastTickTime += ulTicks * pxTimer->ulTimerCountsForOneTick;
+
+    return ulTicks;
+}
+
+/* Alarm target of the next tick. */
+static inline uint32_t ulTickTimerNextTick( const TickTimer_t * pxTimer )
+{
+    return pxTimer->ulLastTickTime + pxTimer->ulTimerCountsForOneTick;
+}
+
+/* Alarm target that ends a sleep of xExpectedIdleTime ticks, which count from
+ * the latest tick. */
+static inline uint32_t ulTickTimerWakeTime( const TickTimer_t * pxTimer,
+                                            uint32_t ulExpectedIdleTime )
+{
+    return pxTimer->ulLastTickTime + ( pxTimer->ulTimerCountsForOneTick * ulExpectedIdleTime );
+}
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* TICK_TIMER_H */
@@ -9,6 +9,7 @@ target_sources(FreeRTOS-Kernel-Core INTERFACE
         ${FREERTOS_KERNEL_PATH}/croutine.c
         ${FREERTOS_KERNEL_PATH}/event_groups.c
         ${FREERTOS_KERNEL_PATH}/list.c
+        ${FREERTOS_KERNEL_PATH}/mpsc_ring.c
         ${FREERTOS_KERNEL_PATH}/queue.c
         ${FREERTOS_KERNEL_PATH}/stream_buffer.c
         ${FREERTOS_KERNEL_PATH}/tasks.c
@@ -35,6 +36,8 @@ target_link_libraries(FreeRTOS-Kernel INTERFACE
         pico_base_headers
         hardware_clocks
         hardware_exception
+        hardware_irq
+        hardware_timer
         pico_multicore
 )
 
@@ -67,6 +70,10 @@ add_library(FreeRTOS-Kernel-Heap4 INTERFACE)
 target_sources(FreeRTOS-Kernel-Heap4 INTERFACE ${FREERTOS_KERNEL_PATH}/portable/MemMang/heap_4.c)
 target_link_libraries(FreeRTOS-Kernel-Heap4 INTERFACE FreeRTOS-Kernel)
 
+add_library(FreeRTOS-Kernel-HeapPool INTERFACE)
+target_sources(FreeRTOS-Kernel-HeapPool INTERFACE ${FREERTOS_KERNEL_PATH}/portable/MemMang/heap_pool.c)
+target_link_libraries(FreeRTOS-Kernel-HeapPool INTERFACE FreeRTOS-Kernel)
+
 add_library(FreeRTOS-Kernel-Heap5 INTERFACE)
 target_sources(FreeRTOS-Kernel-Heap5 INTERFACE ${FREERTOS_KERNEL_PATH}/portable/MemMang/heap_5.c)
 target_link_libraries(FreeRTOS-Kernel-Heap5 INTERFACE FreeRTOS-Kernel)
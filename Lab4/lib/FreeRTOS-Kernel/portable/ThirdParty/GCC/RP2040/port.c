@@ -36,6 +36,11 @@
 #include "rp2040_config.h"
 #include "hardware/clocks.h"
 #include "hardware/exception.h"
+#if ( configUSE_TICKLESS_IDLE == 1 )
+    #include "hardware/irq.h"
+    #include "hardware/timer.h"
+    #include "tick_timer.h"
+#endif
 
 /*
  * LIB_PICO_MULTICORE == 1, if we are linked with pico_multicore (note that
@@ -63,20 +68,15 @@
 #define portMIN_INTERRUPT_PRIORITY            ( 255UL )
 #define portNVIC_PENDSV_PRI                   ( portMIN_INTERRUPT_PRIORITY << 16UL )
 #define portNVIC_SYSTICK_PRI                  ( portMIN_INTERRUPT_PRIORITY << 24UL )
+#define portNVIC_ISER_REG                     ( *( ( volatile uint32_t * ) 0xe000e100 ) )
+#define portNVIC_ISPR_REG                     ( *( ( volatile uint32_t * ) 0xe000e200 ) )
+#define portSCB_SCR_REG                       ( *( ( volatile uint32_t * ) 0xe000ed10 ) )
+#define portSCB_SCR_SLEEPDEEP_BIT             ( 1UL << 2UL )
+#define portSCB_SCR_SEVONPEND_BIT             ( 1UL << 4UL )
 
 /* Constants required to set up the initial stack. */
 #define portINITIAL_XPSR                      ( 0x01000000 )
 
-/* The systick is a 24-bit counter. */
-#define portMAX_24_BIT_NUMBER                 ( 0xffffffUL )
-
-/* A fiddle factor to estimate the number of SysTick counts that would have
- * occurred while the SysTick counter is stopped during tickless idle
- * calculations. */
-#ifndef portMISSED_COUNTS_FACTOR
-    #define portMISSED_COUNTS_FACTOR    ( 45UL )
-#endif
-
 /* Let the user override the pre-loading of the initial LR with the address of
  * prvTaskExitError() in case it messes up unwinding of the stack in the
  * debugger. */
@@ -98,6 +98,9 @@ void vPortSetupTimerInterrupt( void );
  */
 void xPortPendSVHandler( void ) __attribute__( ( naked ) );
 void xPortSysTickHandler( void );
+#if ( configUSE_TICKLESS_IDLE == 1 )
+    void xPortTickAlarmHandler( void );
+#endif
 void vPortSVCHandler( void );
 
 /*
@@ -142,26 +145,30 @@ UBaseType_t uxCriticalNestings[ configNUMBER_OF_CORES ] = { 0 };
 #endif /* configSUPPORT_PICO_SYNC_INTEROP */
 
 /*
- * The number of SysTick increments that make up one tick period.
+ * With tickless idle the tick interrupt comes from a hardware alarm of the
+ * 1 MHz RP2040 timer instead of SysTick.  The timer keeps counting while the
+ * cores sleep, so the ticks that passed can be worked out exactly and it
+ * doesn't matter which core's SysTick would have been stopped.
  */
 #if ( configUSE_TICKLESS_IDLE == 1 )
-    static uint32_t ulTimerCountsForOneTick = 0;
-#endif /* configUSE_TICKLESS_IDLE */
+    #if ( ( 1000000UL % configTICK_RATE_HZ ) != 0 )
+        #error configTICK_RATE_HZ must divide 1000000 when configUSE_TICKLESS_IDLE is 1
+    #endif
 
-/*
- * The maximum number of tick periods that can be suppressed is limited by the
- * 24 bit resolution of the SysTick timer.
- */
-#if ( configUSE_TICKLESS_IDLE == 1 )
+    #define portTICK_ALARM_IRQ    ( TIMER_IRQ_0 + configTICK_ALARM_NUM )
+    #define portTICK_ALARM_BIT    ( 1UL << configTICK_ALARM_NUM )
+
+/* The latest tick the kernel has counted and the timer microseconds that make
+ * up one tick period.  Only accessed on the tick core with interrupts masked. */
+    static TickTimer_t xTickTimer;
+
+/* The maximum number of tick periods that can be suppressed keeps the alarm
+ * target less than half the 32-bit timer range ahead. */
     static uint32_t xMaximumPossibleSuppressedTicks = 0;
-#endif /* configUSE_TICKLESS_IDLE */
 
-/*
- * Compensate for the CPU cycles that pass while the SysTick is stopped (low
- * power functionality only.
- */
-#if ( configUSE_TICKLESS_IDLE == 1 )
-    static uint32_t ulStoppedTimerCompensation = 0;
+/* Sleep statistics, updated by the tick core and read under the kernel lock. */
+    static TicklessStats_t xTicklessStats;
+    static uint64_t ullTicklessStatsResetTime;
 #endif /* configUSE_TICKLESS_IDLE */
 
 /*-----------------------------------------------------------*/
@@ -443,6 +450,27 @@ void vPortStartFirstTask( void )
 
 /*-----------------------------------------------------------*/
 
+spin_lock_t * pxPortMpscRingSpinLock = NULL;
+
+void vPortMpscRingInit( void )
+{
+    /* Rings may be created on either core, the first one claims the lock. */
+    portENTER_CRITICAL();
+
+    if( pxPortMpscRingSpinLock == NULL )
+    {
+        #ifdef configMPSC_RING_SPINLOCK
+            spin_lock_claim( configMPSC_RING_SPINLOCK );
+            pxPortMpscRingSpinLock = spin_lock_init( configMPSC_RING_SPINLOCK );
+        #else
+            pxPortMpscRingSpinLock = spin_lock_init( ( uint32_t ) spin_lock_claim_unused( true ) );
+        #endif
+    }
+
+    portEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
 void vPortEndScheduler( void )
 {
     /* Not implemented in ports where there is nothing to return to. */
@@ -759,58 +787,122 @@ void xPortSysTickHandler( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TICKLESS_IDLE == 1 )
+
+    static void prvTickAlarmSet( uint32_t ulTarget )
+    {
+        /* Writing the target arms the alarm. */
+        timer_hw->alarm[ configTICK_ALARM_NUM ] = ulTarget;
+
+        /* The alarm only fires when the timer reaches the target, if that has
+         * already happened raise the interrupt by hand.  An extra interrupt is
+         * harmless as xPortTickAlarmHandler() counts ticks from the timer. */
+        if( xTickTimerReached( timer_hw->timerawl, ulTarget ) != 0 )
+        {
+            timer_hw->armed = portTICK_ALARM_BIT;
+            hw_set_bits( &timer_hw->intf, portTICK_ALARM_BIT );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void xPortTickAlarmHandler( void )
+    {
+        uint32_t ulPreviousMask;
+        uint32_t ulTicks;
+        BaseType_t xSwitchRequired = pdFALSE;
+
+        ulPreviousMask = taskENTER_CRITICAL_FROM_ISR();
+        traceISR_ENTER();
+        {
+            hw_clear_bits( &timer_hw->intf, portTICK_ALARM_BIT );
+            timer_hw->intr = portTICK_ALARM_BIT;
+
+            /* Count the tick periods that have passed on the timer rather than
+             * the interrupts, so a late tick is not lost and a tick already
+             * stepped over by vPortSuppressTicksAndSleep() is not counted
+             * twice. */
+            ulTicks = ulTickTimerAdvance( &xTickTimer, timer_hw->timerawl, UINT32_MAX );
+
+            while( ulTicks > 0U )
+            {
+                ulTicks--;
+
+                if( xTaskIncrementTick() != pdFALSE )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+            }
+
+            prvTickAlarmSet( ulTickTimerNextTick( &xTickTimer ) );
+
+            if( xSwitchRequired != pdFALSE )
+            {
+                traceISR_EXIT_TO_SCHEDULER();
+                /* Pend a context switch. */
+                portNVIC_INT_CTRL_REG = portNVIC_PENDSVSET_BIT;
+            }
+            else
+            {
+                traceISR_EXIT();
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( ulPreviousMask );
+    }
+/*-----------------------------------------------------------*/
+
 /*
- * Setup the systick timer to generate the tick interrupts at the required
- * frequency.
+ * Setup the timer alarm to generate the tick interrupts at the required
+ * frequency.  Called on the tick core.
  */
-__attribute__( ( weak ) ) void vPortSetupTimerInterrupt( void )
-{
-    /* Calculate the constants required to configure the tick interrupt. */
-    #if ( configUSE_TICKLESS_IDLE == 1 )
+    __attribute__( ( weak ) ) void vPortSetupTimerInterrupt( void )
     {
-        ulTimerCountsForOneTick = ( clock_get_hz( clk_sys ) / configTICK_RATE_HZ );
-        xMaximumPossibleSuppressedTicks = portMAX_24_BIT_NUMBER / ulTimerCountsForOneTick;
-        ulStoppedTimerCompensation = portMISSED_COUNTS_FACTOR;
-    }
-    #endif /* configUSE_TICKLESS_IDLE */
+        xTickTimer.ulTimerCountsForOneTick = 1000000UL / configTICK_RATE_HZ;
+        xMaximumPossibleSuppressedTicks = ulTickTimerMaxSuppressedTicks( &xTickTimer );
 
-    /* Stop and reset the SysTick. */
-    portNVIC_SYSTICK_CTRL_REG = 0UL;
-    portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
+        /* SysTick is not used. */
+        portNVIC_SYSTICK_CTRL_REG = 0UL;
 
-    /* Configure SysTick to interrupt at the requested rate. */
-    portNVIC_SYSTICK_LOAD_REG = ( clock_get_hz( clk_sys ) / configTICK_RATE_HZ ) - 1UL;
-    portNVIC_SYSTICK_CTRL_REG = portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT | portNVIC_SYSTICK_ENABLE_BIT;
-}
+        hardware_alarm_claim( configTICK_ALARM_NUM );
+        irq_set_priority( portTICK_ALARM_IRQ, portMIN_INTERRUPT_PRIORITY );
+        irq_set_exclusive_handler( portTICK_ALARM_IRQ, xPortTickAlarmHandler );
+        hw_set_bits( &timer_hw->inte, portTICK_ALARM_BIT );
+        irq_set_enabled( portTICK_ALARM_IRQ, true );
+
+        /* Let an interrupt that becomes pending wake the core from wfe while
+         * interrupts are masked in vPortSuppressTicksAndSleep(). */
+        portSCB_SCR_REG |= portSCB_SCR_SEVONPEND_BIT;
+
+        xTickTimer.ulLastTickTime = timer_hw->timerawl;
+        prvTickAlarmSet( ulTickTimerNextTick( &xTickTimer ) );
+
+        vPortResetTicklessStats();
+    }
 /*-----------------------------------------------------------*/
 
-#if ( configUSE_TICKLESS_IDLE == 1 )
+    static BaseType_t prvInterruptPending( void )
+    {
+        return ( portNVIC_ISPR_REG & portNVIC_ISER_REG ) != 0UL;
+    }
+/*-----------------------------------------------------------*/
 
     __attribute__( ( weak ) ) void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
     {
-        uint32_t ulReloadValue, ulCompleteTickPeriods, ulCompletedSysTickDecrements;
+        uint32_t ulWakeTime, ulSleepStart, ulNow, ulCompleteTickPeriods, ulLatency;
         TickType_t xModifiableIdleTime;
+        UBaseType_t uxSavedInterruptStatus;
 
-        /* Make sure the SysTick reload value does not overflow the counter. */
-        if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
+        /* Only the core that takes the tick interrupt can stop it.  In SMP the
+         * idle task calling this is kept on that core when
+         * configUSE_CORE_AFFINITY is 1. */
+        if( get_core_num() != ucPrimaryCoreNum )
         {
-            xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
+            return;
         }
 
-        /* Stop the SysTick momentarily.  The time the SysTick is stopped for
-         * is accounted for as best it can be, but using the tickless mode will
-         * inevitably result in some tiny drift of the time maintained by the
-         * kernel with respect to calendar time. */
-        portNVIC_SYSTICK_CTRL_REG &= ~portNVIC_SYSTICK_ENABLE_BIT;
-
-        /* Calculate the reload value required to wait xExpectedIdleTime
-         * tick periods.  -1 is used because this code will execute part way
-         * through one of the tick periods. */
-        ulReloadValue = portNVIC_SYSTICK_CURRENT_VALUE_REG + ( ulTimerCountsForOneTick * ( xExpectedIdleTime - 1UL ) );
-
-        if( ulReloadValue > ulStoppedTimerCompensation )
+        /* Make sure the alarm target stays within reach of the timer. */
+        if( xExpectedIdleTime > xMaximumPossibleSuppressedTicks )
         {
-            ulReloadValue -= ulStoppedTimerCompensation;
+            xExpectedIdleTime = xMaximumPossibleSuppressedTicks;
         }
 
         /* Enter a critical section but don't use the taskENTER_CRITICAL()
@@ -823,132 +915,126 @@ __attribute__( ( weak ) ) void vPortSetupTimerInterrupt( void )
          * to be unsuspended then abandon the low power entry. */
         if( eTaskConfirmSleepModeStatus() == eAbortSleep )
         {
-            /* Restart from whatever is left in the count register to complete
-             * this tick period. */
-            portNVIC_SYSTICK_LOAD_REG = portNVIC_SYSTICK_CURRENT_VALUE_REG;
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            xTicklessStats.ulAborted++;
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
-            /* Restart SysTick. */
-            portNVIC_SYSTICK_CTRL_REG |= portNVIC_SYSTICK_ENABLE_BIT;
-
-            /* Reset the reload register to the value required for normal tick
-             * periods. */
-            portNVIC_SYSTICK_LOAD_REG = ulTimerCountsForOneTick - 1UL;
-
-            /* Re-enable interrupts - see comments above the cpsid instruction()
-             * above. */
             __asm volatile ( "cpsie i" ::: "memory" );
+            return;
         }
-        else
-        {
-            /* Set the new reload value. */
-            portNVIC_SYSTICK_LOAD_REG = ulReloadValue;
 
-            /* Clear the SysTick count flag and set the count value back to
-             * zero. */
-            portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
+        /* The expected idle time counts from the latest tick. */
+        ulWakeTime = ulTickTimerWakeTime( &xTickTimer, xExpectedIdleTime );
+        prvTickAlarmSet( ulWakeTime );
+        ulSleepStart = timer_hw->timerawl;
 
-            /* Restart SysTick. */
-            portNVIC_SYSTICK_CTRL_REG |= portNVIC_SYSTICK_ENABLE_BIT;
+        /* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
+         * set its parameter to 0 to indicate that its implementation contains
+         * its own wait for interrupt or wait for event instruction, and so wfe
+         * should not be executed again.  However, the original expected idle
+         * time variable must remain unmodified, so a copy is taken. */
+        xModifiableIdleTime = xExpectedIdleTime;
+        configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
 
-            /* Sleep until something happens.  configPRE_SLEEP_PROCESSING() can
-             * set its parameter to 0 to indicate that its implementation contains
-             * its own wait for interrupt or wait for event instruction, and so wfi
-             * should not be executed again.  However, the original expected idle
-             * time variable must remain unmodified, so a copy is taken. */
-            xModifiableIdleTime = xExpectedIdleTime;
-            configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+        if( xModifiableIdleTime > 0 )
+        {
+            #if ( configTICKLESS_DEEP_SLEEP == 1 )
+                portSCB_SCR_REG |= portSCB_SCR_SLEEPDEEP_BIT;
+            #endif
 
-            if( xModifiableIdleTime > 0 )
+            /* wfe rather than wfi so that the other core can wake this one
+             * with sev when one of its interrupts readies a task, which it
+             * can't switch to while the scheduler is suspended. */
+            while( ( prvInterruptPending() == pdFALSE ) && ( eTaskConfirmSleepModeStatus() != eAbortSleep ) )
             {
                 __asm volatile ( "dsb" ::: "memory" );
-                __asm volatile ( "wfi" );
+                __asm volatile ( "wfe" );
                 __asm volatile ( "isb" );
             }
 
-            configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+            #if ( configTICKLESS_DEEP_SLEEP == 1 )
+                portSCB_SCR_REG &= ~portSCB_SCR_SLEEPDEEP_BIT;
+            #endif
+        }
 
-            /* Re-enable interrupts to allow the interrupt that brought the MCU
-             * out of sleep mode to execute immediately.  see comments above
-             * __disable_interrupt() call above. */
-            __asm volatile ( "cpsie i" ::: "memory" );
-            __asm volatile ( "dsb" );
-            __asm volatile ( "isb" );
-
-            /* Disable interrupts again because the clock is about to be stopped
-             * and interrupts that execute while the clock is stopped will increase
-             * any slippage between the time maintained by the RTOS and calendar
-             * time. */
-            __asm volatile ( "cpsid i" ::: "memory" );
-            __asm volatile ( "dsb" );
-            __asm volatile ( "isb" );
-
-            /* Disable the SysTick clock without reading the
-             * portNVIC_SYSTICK_CTRL_REG register to ensure the
-             * portNVIC_SYSTICK_COUNT_FLAG_BIT is not cleared if it is set.  Again,
-             * the time the SysTick is stopped for is accounted for as best it can
-             * be, but using the tickless mode will inevitably result in some tiny
-             * drift of the time maintained by the kernel with respect to calendar
-             * time*/
-            portNVIC_SYSTICK_CTRL_REG = ( portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT );
-
-            /* Determine if the SysTick clock has already counted to zero and
-             * been set back to the current reload value (the reload back being
-             * correct for the entire expected idle time) or if the SysTick is yet
-             * to count to zero (in which case an interrupt other than the SysTick
-             * must have brought the system out of sleep mode). */
-            if( ( portNVIC_SYSTICK_CTRL_REG & portNVIC_SYSTICK_COUNT_FLAG_BIT ) != 0 )
-            {
-                uint32_t ulCalculatedLoadValue;
-
-                /* The tick interrupt is already pending, and the SysTick count
-                 * reloaded with ulReloadValue.  Reset the
-                 * portNVIC_SYSTICK_LOAD_REG with whatever remains of this tick
-                 * period. */
-                ulCalculatedLoadValue = ( ulTimerCountsForOneTick - 1UL ) - ( ulReloadValue - portNVIC_SYSTICK_CURRENT_VALUE_REG );
-
-                /* Don't allow a tiny value, or values that have somehow
-                 * underflowed because the post sleep hook did something
-                 * that took too long. */
-                if( ( ulCalculatedLoadValue < ulStoppedTimerCompensation ) || ( ulCalculatedLoadValue > ulTimerCountsForOneTick ) )
-                {
-                    ulCalculatedLoadValue = ( ulTimerCountsForOneTick - 1UL );
-                }
+        configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+        /* Step over the tick periods that passed while asleep.  vTaskStepTick()
+         * can't go past the expected idle time, anything beyond that is left
+         * for the tick interrupt to count. */
+        ulNow = timer_hw->timerawl;
+        ulCompleteTickPeriods = ulTickTimerAdvance( &xTickTimer, ulNow, xExpectedIdleTime );
+        vTaskStepTick( ulCompleteTickPeriods );
+        prvTickAlarmSet( ulTickTimerNextTick( &xTickTimer ) );
 
-                portNVIC_SYSTICK_LOAD_REG = ulCalculatedLoadValue;
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            xTicklessStats.ulSleeps++;
+            xTicklessStats.ullSleepTime += ulNow - ulSleepStart;
+            xTicklessStats.ulTicksStepped += ulCompleteTickPeriods;
 
-                /* As the pending tick will be processed as soon as this
-                 * function exits, the tick value maintained by the tick is stepped
-                 * forward by one less than the time spent waiting. */
-                ulCompleteTickPeriods = xExpectedIdleTime - 1UL;
+            if( xTickTimerReached( ulNow, ulWakeTime ) == 0 )
+            {
+                xTicklessStats.ulEarlyWakes++;
             }
             else
             {
-                /* Something other than the tick interrupt ended the sleep.
-                 * Work out how long the sleep lasted rounded to complete tick
-                 * periods (not the ulReload value which accounted for part
-                 * ticks). */
-                ulCompletedSysTickDecrements = ( xExpectedIdleTime * ulTimerCountsForOneTick ) - portNVIC_SYSTICK_CURRENT_VALUE_REG;
-
-                /* How many complete tick periods passed while the processor
-                 * was waiting? */
-                ulCompleteTickPeriods = ulCompletedSysTickDecrements / ulTimerCountsForOneTick;
-
-                /* The reload value is set to whatever fraction of a single tick
-                 * period remains. */
-                portNVIC_SYSTICK_LOAD_REG = ( ( ulCompleteTickPeriods + 1UL ) * ulTimerCountsForOneTick ) - ulCompletedSysTickDecrements;
+                /* Time from the wake time to the tick running again. */
+                ulLatency = timer_hw->timerawl - ulWakeTime;
+                xTicklessStats.ulWakeLatencyTotal += ulLatency;
+
+                if( ulLatency > xTicklessStats.ulWakeLatencyMax )
+                {
+                    xTicklessStats.ulWakeLatencyMax = ulLatency;
+                }
             }
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
 
-            /* Restart SysTick so it runs from portNVIC_SYSTICK_LOAD_REG
-             * again, then set portNVIC_SYSTICK_LOAD_REG back to its standard
-             * value. */
-            portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
-            portNVIC_SYSTICK_CTRL_REG |= portNVIC_SYSTICK_ENABLE_BIT;
-            vTaskStepTick( ulCompleteTickPeriods );
-            portNVIC_SYSTICK_LOAD_REG = ulTimerCountsForOneTick - 1UL;
+        /* Exit with interrupts enabled, the interrupt that ended the sleep
+         * runs now. */
+        __asm volatile ( "cpsie i" ::: "memory" );
+    }
+/*-----------------------------------------------------------*/
 
-            /* Exit with interrupts enabled. */
-            __asm volatile ( "cpsie i" ::: "memory" );
+    void vPortGetTicklessStats( TicklessStats_t * pxStats )
+    {
+        taskENTER_CRITICAL();
+        {
+            *pxStats = xTicklessStats;
+            pxStats->ullElapsedTime = time_us_64() - ullTicklessStatsResetTime;
         }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vPortResetTicklessStats( void )
+    {
+        const TicklessStats_t xEmptyStats = { 0 };
+
+        taskENTER_CRITICAL();
+        {
+            xTicklessStats = xEmptyStats;
+            ullTicklessStatsResetTime = time_us_64();
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#else /* configUSE_TICKLESS_IDLE */
+
+/*
+ * Setup the systick timer to generate the tick interrupts at the required
+ * frequency.
+ */
+    __attribute__( ( weak ) ) void vPortSetupTimerInterrupt( void )
+    {
+        /* Stop and reset the SysTick. */
+        portNVIC_SYSTICK_CTRL_REG = 0UL;
+        portNVIC_SYSTICK_CURRENT_VALUE_REG = 0UL;
+
+        /* Configure SysTick to interrupt at the requested rate. */
+        portNVIC_SYSTICK_LOAD_REG = ( clock_get_hz( clk_sys ) / configTICK_RATE_HZ ) - 1UL;
+        portNVIC_SYSTICK_CTRL_REG = portNVIC_SYSTICK_CLK_BIT | portNVIC_SYSTICK_INT_BIT | portNVIC_SYSTICK_ENABLE_BIT;
     }
 
 #endif /* configUSE_TICKLESS_IDLE */
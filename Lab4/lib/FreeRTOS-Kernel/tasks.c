@@ -216,7 +216,8 @@
 
 /*-----------------------------------------------------------*/
 
-    #define taskSELECT_HIGHEST_PRIORITY_TASK()                                                  \
+    #if ( configNUMBER_OF_CORES == 1 )
+        #define taskSELECT_HIGHEST_PRIORITY_TASK()                                              \
     do {                                                                                        \
         UBaseType_t uxTopPriority;                                                              \
                                                                                                 \
@@ -225,6 +226,14 @@
         configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 ); \
         listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );   \
     } while( 0 )
+    #else /* if ( configNUMBER_OF_CORES == 1 ) */
+
+/* uxTopReadyPriority is a bit map of the priorities that have ready tasks, so
+ * prvSelectHighestPriorityTask() goes from one non-empty ready list straight to
+ * the next lower one. */
+        #define taskSELECT_HIGHEST_PRIORITY_TASK( xCoreID )    prvSelectHighestPriorityTask( xCoreID )
+
+    #endif /* if ( configNUMBER_OF_CORES == 1 ) */
 
 /*-----------------------------------------------------------*/
 
@@ -327,6 +336,42 @@
 
 #if ( configNUMBER_OF_CORES > 1 )
 
+    #if ( configUSE_CORE_YIELD_STATS == 1 )
+        #define taskYIELD_STATS_INCREMENT( xCoreID, ulCounter )    ( xCoreYieldStats[ ( xCoreID ) ].ulCounter++ )
+        #define taskYIELD_STATS_REQUEST_SENT( xCoreID )   \
+    do {                                                  \
+        xYieldRequested[ ( xCoreID ) ] = pdTRUE;          \
+        xCoreYieldStats[ ( xCoreID ) ].ulRequests++;      \
+    } while( 0 )
+    #else
+        #define taskYIELD_STATS_INCREMENT( xCoreID, ulCounter )
+        #define taskYIELD_STATS_REQUEST_SENT( xCoreID )
+    #endif
+
+/* Interrupts another core to make it yield.  With configUSE_CORE_YIELD_POLICY
+ * a core that is waiting for the kernel locks in vTaskSwitchContext() is left
+ * alone, it selects its next task after the caller releases the locks. */
+    #if ( configUSE_CORE_YIELD_POLICY == 1 )
+        #define taskREQUEST_CORE_YIELD( xCoreID )                \
+    do {                                                         \
+        if( xSelectingTask[ ( xCoreID ) ] == pdFALSE )           \
+        {                                                        \
+            portYIELD_CORE( xCoreID );                           \
+            taskYIELD_STATS_REQUEST_SENT( xCoreID );             \
+        }                                                        \
+        else                                                     \
+        {                                                        \
+            taskYIELD_STATS_INCREMENT( ( xCoreID ), ulSkipped ); \
+        }                                                        \
+    } while( 0 )
+    #else
+        #define taskREQUEST_CORE_YIELD( xCoreID )    \
+    do {                                             \
+        portYIELD_CORE( xCoreID );                   \
+        taskYIELD_STATS_REQUEST_SENT( xCoreID );     \
+    } while( 0 )
+    #endif
+
 /* Yields the given core. This must be called from a critical section and xCoreID
  * must be valid. This macro is not required in single core since there is only
  * one core to yield. */
@@ -342,7 +387,7 @@
             /* Request other core to yield if it is not requested before. */                 \
             if( pxCurrentTCBs[ ( xCoreID ) ]->xTaskRunState != taskTASK_SCHEDULED_TO_YIELD ) \
             {                                                                                \
-                portYIELD_CORE( xCoreID );                                                   \
+                taskREQUEST_CORE_YIELD( xCoreID );                                           \
                 pxCurrentTCBs[ ( xCoreID ) ]->xTaskRunState = taskTASK_SCHEDULED_TO_YIELD;   \
             }                                                                                \
         }                                                                                    \
@@ -411,6 +456,11 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
         configRUN_TIME_COUNTER_TYPE ulRunTimeCounter; /**< Stores the amount of time the task has spent in the Running state. */
     #endif
 
+    #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulReadiedFromISRTime; /**< The run time counter value when an ISR last readied the task. */
+        BaseType_t xReadiedFromISR;                       /**< Set to pdTRUE when an ISR readies the task, cleared when the task is switched in. */
+    #endif
+
     #if ( configUSE_C_RUNTIME_TLS_SUPPORT == 1 )
         configTLS_BLOCK_TYPE xTLSBlock; /**< Memory block used as Thread Local Storage (TLS) Block for the task. */
     #endif
@@ -457,11 +507,58 @@ typedef tskTCB TCB_t;
  * doing so breaks some kernel aware debuggers and debuggers that rely on removing
  * the static qualifier. */
 PRIVILEGED_DATA static List_t pxReadyTasksLists[ configMAX_PRIORITIES ]; /**< Prioritised ready tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList1;                         /**< Delayed tasks. */
-PRIVILEGED_DATA static List_t xDelayedTaskList2;                         /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /**< Points to the delayed task list currently being used. */
-PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
-PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
+
+#if ( ( configUSE_DELAYED_TASK_WHEEL == 1 ) || ( configUSE_LATENCY_HISTOGRAMS == 1 ) ) && !defined( portHIGHEST_SET_BIT )
+
+/* Position of the highest set bit of a non-zero word, for ports that don't
+ * define portHIGHEST_SET_BIT. */
+    static uint32_t prvHighestSetBit( uint32_t ulBitmap )
+    {
+        uint32_t ulBit = 0U;
+        uint32_t ulShift;
+
+        for( ulShift = 16U; ulShift > 0U; ulShift >>= 1 )
+        {
+            if( ( ulBitmap >> ulShift ) != 0U )
+            {
+                ulBitmap >>= ulShift;
+                ulBit += ulShift;
+            }
+        }
+
+        return ulBit;
+    }
+
+    #define portHIGHEST_SET_BIT( ulBitmap )    prvHighestSetBit( ulBitmap )
+
+#endif
+
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* Each level of the delayed task wheel has 32 slots.  A slot of level n spans
+ * 2^(5 * n) ticks, so level 0 holds the tasks that wake within 32 ticks, one
+ * slot per tick.  When the tick count reaches the start of a slot of a higher
+ * level the tasks in it are re-placed at the levels below.  Tasks leave the
+ * wheel with uxListRemove() like they leave any other state list, so the bit
+ * of a slot that has become empty may still be set until the slot is
+ * reached. */
+    #define taskWHEEL_SLOT_BITS           ( 5U )
+    #define taskWHEEL_SLOTS               ( ( UBaseType_t ) 1U << taskWHEEL_SLOT_BITS )
+    #define taskWHEEL_SLOT_MASK           ( taskWHEEL_SLOTS - 1U )
+    #define taskWHEEL_SHIFT( uxLevel )    ( ( UBaseType_t ) ( uxLevel ) * taskWHEEL_SLOT_BITS )
+
+    PRIVILEGED_DATA static List_t xDelayedTaskWheel[ configDELAYED_TASK_WHEEL_LEVELS ][ taskWHEEL_SLOTS ]; /**< Delayed tasks, placed by wake time. */
+    PRIVILEGED_DATA static uint32_t ulDelayedWheelOccupied[ configDELAYED_TASK_WHEEL_LEVELS ];           /**< A bit per slot that is set while the slot may hold tasks. */
+
+#else /* configUSE_DELAYED_TASK_WHEEL */
+
+    PRIVILEGED_DATA static List_t xDelayedTaskList1;                    /**< Delayed tasks. */
+    PRIVILEGED_DATA static List_t xDelayedTaskList2;                    /**< Delayed tasks (two lists are used - one for delays that have overflowed the current tick count. */
+    PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;         /**< Points to the delayed task list currently being used. */
+    PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList; /**< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+PRIVILEGED_DATA static List_t xPendingReadyList; /**< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
 #if ( INCLUDE_vTaskDelete == 1 )
 
@@ -522,6 +619,51 @@ PRIVILEGED_DATA static volatile configRUN_TIME_COUNTER_TYPE ulTotalRunTime[ conf
 
 #endif
 
+#if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+
+/* Each core only updates its own histograms and start times, always with
+ * interrupts masked. */
+PRIVILEGED_DATA static LatencyHistogram_t xLatencyHistograms[ configNUMBER_OF_CORES ][ eLatencyHistogramCount ]; /**< The latency histograms of each core. */
+#if ( configNUMBER_OF_CORES > 1 ) || ( portCRITICAL_NESTING_IN_TCB == 1 )
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulCriticalEnterTime[ configNUMBER_OF_CORES ];              /**< When the critical section of each core was entered. */
+#endif
+PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulSchedulerSuspendTime[ configNUMBER_OF_CORES ];               /**< When the core that suspended the scheduler did so. */
+PRIVILEGED_DATA static volatile configRUN_TIME_COUNTER_TYPE ulYieldFromISRTime[ configNUMBER_OF_CORES ];          /**< When an ISR of each core last requested a context switch. */
+PRIVILEGED_DATA static volatile BaseType_t xYieldFromISRPending[ configNUMBER_OF_CORES ];                         /**< Set when an ISR requests a context switch, cleared when the core switches context. */
+
+/* Record that an ISR readied pxTCB, so the time until it is switched in can be
+ * recorded. */
+    #define taskLATENCY_MARK_READIED( pxTCB )                                        \
+    do {                                                                            \
+        if( portCHECK_IF_IN_ISR() )                                                 \
+        {                                                                           \
+            ( pxTCB )->ulReadiedFromISRTime = portGET_RUN_TIME_COUNTER_VALUE();     \
+            ( pxTCB )->xReadiedFromISR = pdTRUE;                                    \
+        }                                                                           \
+    } while( 0 )
+
+#else /* configUSE_LATENCY_HISTOGRAMS */
+
+    #define taskLATENCY_MARK_READIED( pxTCB )
+
+#endif /* configUSE_LATENCY_HISTOGRAMS */
+
+#if ( configUSE_CORE_YIELD_POLICY == 1 )
+
+/* Set by a core from before it takes the kernel locks in vTaskSwitchContext()
+ * until it has selected its next task.  Interrupts are masked all that time. */
+PRIVILEGED_DATA static volatile BaseType_t xSelectingTask[ configNUMBER_OF_CORES ] = { pdFALSE };
+
+#endif
+
+#if ( configUSE_CORE_YIELD_STATS == 1 )
+
+/* Only changed with the kernel locks held. */
+PRIVILEGED_DATA static CoreYieldStats_t xCoreYieldStats[ configNUMBER_OF_CORES ]; /**< The yield request counters of each core. */
+PRIVILEGED_DATA static BaseType_t xYieldRequested[ configNUMBER_OF_CORES ];       /**< Set when a request is sent to the core, cleared by its next context switch. */
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* File private functions. --------------------------------*/
@@ -674,6 +816,12 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 
     static TickType_t prvGetExpectedIdleTime( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Returns pdTRUE if a yield was pended on any core while the scheduler was
+ * suspended.  Used by eTaskConfirmSleepModeStatus().
+ */
+    static BaseType_t prvYieldPendingOnAnyCore( void ) PRIVILEGED_FUNCTION;
+
 #endif
 
 /*
@@ -682,6 +830,47 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/*
+ * Place a task in the delayed task wheel to be woken at xTimeToWake, which
+ * must not be before the tick count, and bring xNextTaskUnblockTime forward if
+ * the slot used is reached before it.
+ */
+    static void prvDelayedWheelInsert( TCB_t * const pxTCB,
+                                       const TickType_t xTimeToWake ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the next tick at which the delayed task wheel has work to do, either
+ * tasks to wake or a higher level slot to re-place.
+ */
+    static TickType_t prvDelayedWheelNextEvent( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Re-place the tasks of the higher level slots that start at xConstTickCount,
+ * then return the level 0 slot that holds the tasks to wake at xConstTickCount.
+ */
+    static List_t * prvDelayedWheelCascade( const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
+#if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+
+/*
+ * Add a time of ulElapsed run time counter units to a histogram of the core
+ * xCoreID.  Must be called on that core with interrupts masked.
+ */
+    static void prvLatencyRecord( BaseType_t xCoreID,
+                                  eLatencyHistogram eHistogram,
+                                  uint32_t ulElapsed ) PRIVILEGED_FUNCTION;
+
+/*
+ * Record the latencies that end when the core xCoreID has switched in a task.
+ */
+    static void prvLatencyTaskSwitchedIn( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_LATENCY_HISTOGRAMS */
+
 #if ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 )
 
 /*
@@ -873,11 +1062,20 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         BaseType_t xCurrentCoreTaskPriority;
         BaseType_t xLowestPriorityCore = ( BaseType_t ) -1;
         BaseType_t xCoreID;
+        BaseType_t x;
 
         #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
             BaseType_t xYieldCount = 0;
         #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
 
+        #if ( configUSE_CORE_YIELD_POLICY == 1 )
+            const BaseType_t xThisCoreID = ( BaseType_t ) portGET_CORE_ID();
+        #endif
+
+        #if ( configUSE_CORE_YIELD_POLICY == 1 ) && ( configUSE_CORE_YIELD_STATS == 1 )
+            BaseType_t xKeptLocal = pdFALSE;
+        #endif
+
         /* This must be called from a critical section. */
         configASSERT( portGET_CRITICAL_NESTING_COUNT() > 0U );
 
@@ -897,8 +1095,25 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
              * is 0. This is ok as we will give system idle tasks a priority of -1 below. */
             --xLowestPriorityToPreempt;
 
-            for( xCoreID = ( BaseType_t ) 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+            for( x = ( BaseType_t ) 0; x < ( BaseType_t ) configNUMBER_OF_CORES; x++ )
             {
+                #if ( configUSE_CORE_YIELD_POLICY == 1 )
+                {
+                    /* Visit the calling core last so it wins a tie for the lowest
+                     * priority, it yields without interrupting another core. */
+                    xCoreID = xThisCoreID + x + ( BaseType_t ) 1;
+
+                    if( xCoreID >= ( BaseType_t ) configNUMBER_OF_CORES )
+                    {
+                        xCoreID -= ( BaseType_t ) configNUMBER_OF_CORES;
+                    }
+                }
+                #else
+                {
+                    xCoreID = x;
+                }
+                #endif
+
                 xCurrentCoreTaskPriority = ( BaseType_t ) pxCurrentTCBs[ xCoreID ]->uxPriority;
 
                 /* System idle tasks are being assigned a priority of tskIDLE_PRIORITY - 1 here. */
@@ -923,6 +1138,13 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                                     if( pxCurrentTCBs[ xCoreID ]->xPreemptionDisable == pdFALSE )
                                 #endif
                                 {
+                                    #if ( configUSE_CORE_YIELD_POLICY == 1 ) && ( configUSE_CORE_YIELD_STATS == 1 )
+                                    {
+                                        xKeptLocal = ( ( xCoreID == xThisCoreID ) && ( xLowestPriorityCore >= 0 ) &&
+                                                       ( xCurrentCoreTaskPriority == xLowestPriorityToPreempt ) ) ? pdTRUE : pdFALSE;
+                                    }
+                                    #endif
+
                                     xLowestPriorityToPreempt = xCurrentCoreTaskPriority;
                                     xLowestPriorityCore = xCoreID;
                                 }
@@ -964,6 +1186,15 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             #endif /* #if ( configRUN_MULTIPLE_PRIORITIES == 0 ) */
             {
                 prvYieldCore( xLowestPriorityCore );
+
+                #if ( configUSE_CORE_YIELD_POLICY == 1 ) && ( configUSE_CORE_YIELD_STATS == 1 )
+                {
+                    if( xKeptLocal != pdFALSE )
+                    {
+                        taskYIELD_STATS_INCREMENT( xThisCoreID, ulLocal );
+                    }
+                }
+                #endif
             }
 
             #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
@@ -983,9 +1214,14 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 #if ( configNUMBER_OF_CORES > 1 )
     static void prvSelectHighestPriorityTask( BaseType_t xCoreID )
     {
-        UBaseType_t uxCurrentPriority = uxTopReadyPriority;
+        #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+            UBaseType_t uxCurrentPriority = uxTopReadyPriority;
+            BaseType_t xDecrementTopPriority = pdTRUE;
+        #else
+            UBaseType_t uxReadyPriorities = uxTopReadyPriority;
+            UBaseType_t uxCurrentPriority;
+        #endif
         BaseType_t xTaskScheduled = pdFALSE;
-        BaseType_t xDecrementTopPriority = pdTRUE;
         TCB_t * pxTCB = NULL;
 
         #if ( configUSE_CORE_AFFINITY == 1 )
@@ -998,6 +1234,14 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
         /* This function should be called when scheduler is running. */
         configASSERT( xSchedulerRunning == pdTRUE );
 
+        #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+        {
+            /* The idle tasks keep the bit of tskIDLE_PRIORITY set. */
+            configASSERT( uxReadyPriorities != 0U );
+            portGET_HIGHEST_PRIORITY( uxCurrentPriority, uxReadyPriorities );
+        }
+        #endif
+
         /* A new task is created and a running task with the same priority yields
          * itself to run the new task. When a running task yields itself, it is still
          * in the ready list. This running task will be selected before the new task
@@ -1036,9 +1280,13 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 const ListItem_t * pxEndMarker = listGET_END_MARKER( pxReadyList );
                 ListItem_t * pxIterator;
 
-                /* The ready task list for uxCurrentPriority is not empty, so uxTopReadyPriority
-                 * must not be decremented any further. */
-                xDecrementTopPriority = pdFALSE;
+                #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+                {
+                    /* The ready task list for uxCurrentPriority is not empty, so uxTopReadyPriority
+                     * must not be decremented any further. */
+                    xDecrementTopPriority = pdFALSE;
+                }
+                #endif
 
                 for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
                 {
@@ -1106,31 +1354,61 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             }
             else
             {
-                if( xDecrementTopPriority != pdFALSE )
+                #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
                 {
-                    uxTopReadyPriority--;
-                    #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                    if( xDecrementTopPriority != pdFALSE )
                     {
-                        xPriorityDropped = pdTRUE;
+                        uxTopReadyPriority--;
+                        #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
+                        {
+                            xPriorityDropped = pdTRUE;
+                        }
+                        #endif
                     }
-                    #endif
                 }
+                #else
+                {
+                    /* Only priorities with ready tasks are visited. */
+                    configASSERT( pdFALSE );
+                }
+                #endif
             }
 
-            /* There are configNUMBER_OF_CORES Idle tasks created when scheduler started.
-             * The scheduler should be able to select a task to run when uxCurrentPriority
-             * is tskIDLE_PRIORITY. uxCurrentPriority is never decreased to value blow
-             * tskIDLE_PRIORITY. */
-            if( uxCurrentPriority > tskIDLE_PRIORITY )
+            #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
             {
-                uxCurrentPriority--;
+                /* Every task at uxCurrentPriority runs on another core or can't run
+                 * on this one, continue with the next lower priority that has ready
+                 * tasks, however many empty priorities lie in between. */
+                uxReadyPriorities &= ( ( UBaseType_t ) 1U << uxCurrentPriority ) - ( UBaseType_t ) 1U;
+
+                if( uxReadyPriorities != 0U )
+                {
+                    portGET_HIGHEST_PRIORITY( uxCurrentPriority, uxReadyPriorities );
+                }
+                else
+                {
+                    /* This function is called when idle task is not created. */
+                    break;
+                }
             }
-            else
+            #else /* if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) */
             {
-                /* This function is called when idle task is not created. Break the
-                 * loop to prevent uxCurrentPriority overrun. */
-                break;
+                /* There are configNUMBER_OF_CORES Idle tasks created when scheduler started.
+                 * The scheduler should be able to select a task to run when uxCurrentPriority
+                 * is tskIDLE_PRIORITY. uxCurrentPriority is never decreased to value blow
+                 * tskIDLE_PRIORITY. */
+                if( uxCurrentPriority > tskIDLE_PRIORITY )
+                {
+                    uxCurrentPriority--;
+                }
+                else
+                {
+                    /* This function is called when idle task is not created. Break the
+                     * loop to prevent uxCurrentPriority overrun. */
+                    break;
+                }
             }
+            #endif /* if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 ) */
         }
 
         #if ( configRUN_MULTIPLE_PRIORITIES == 0 )
@@ -2488,8 +2766,11 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         eTaskState eReturn;
         List_t const * pxStateList;
         List_t const * pxEventList;
-        List_t const * pxDelayedList;
-        List_t const * pxOverflowedDelayedList;
+
+        #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+            List_t const * pxDelayedList;
+            List_t const * pxOverflowedDelayedList;
+        #endif
         const TCB_t * const pxTCB = xTask;
 
         traceENTER_eTaskGetState( xTask );
@@ -2509,8 +2790,13 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             {
                 pxStateList = listLIST_ITEM_CONTAINER( &( pxTCB->xStateListItem ) );
                 pxEventList = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
-                pxDelayedList = pxDelayedTaskList;
-                pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+
+                #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+                {
+                    pxDelayedList = pxDelayedTaskList;
+                    pxOverflowedDelayedList = pxOverflowDelayedTaskList;
+                }
+                #endif
             }
             taskEXIT_CRITICAL();
 
@@ -2521,7 +2807,14 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
                  * item is currently placed on. */
                 eReturn = eReady;
             }
-            else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+
+
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                else if( ( pxStateList >= &( xDelayedTaskWheel[ 0 ][ 0 ] ) ) &&
+                         ( pxStateList <= &( xDelayedTaskWheel[ configDELAYED_TASK_WHEEL_LEVELS - 1 ][ taskWHEEL_SLOT_MASK ] ) ) )
+            #else
+                else if( ( pxStateList == pxDelayedList ) || ( pxStateList == pxOverflowedDelayedList ) )
+            #endif
             {
                 /* The task being queried is referenced from one of the Blocked
                  * lists. */
@@ -3448,6 +3741,7 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
             if( prvTaskIsTaskSuspended( pxTCB ) != pdFALSE )
             {
                 traceTASK_RESUME_FROM_ISR( pxTCB );
+                taskLATENCY_MARK_READIED( pxTCB );
 
                 /* Check the ready lists can be accessed. */
                 if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
@@ -3653,6 +3947,18 @@ static BaseType_t prvCreateIdleTasks( void )
                 /* Assign idle task to each core before SMP scheduler is running. */
                 xIdleTaskHandles[ xCoreID ]->xTaskRunState = xCoreID;
                 pxCurrentTCBs[ xCoreID ] = xIdleTaskHandles[ xCoreID ];
+
+                #if ( configUSE_TICKLESS_IDLE != 0 ) && ( configUSE_CORE_AFFINITY == 1 ) && defined( portTICKLESS_IDLE_CORE )
+                {
+                    /* portSUPPRESS_TICKS_AND_SLEEP() is called by the idle
+                     * task running prvIdleTask, keep it on the core that can
+                     * stop the tick. */
+                    if( xCoreID == ( BaseType_t ) 0 )
+                    {
+                        xIdleTaskHandles[ xCoreID ]->uxCoreAffinityMask = ( UBaseType_t ) 1U << portTICKLESS_IDLE_CORE;
+                    }
+                }
+                #endif
             }
             #endif
         }
@@ -3833,6 +4139,15 @@ void vTaskSuspendAll( void )
         /* Enforces ordering for ports and optimised compilers that may otherwise place
          * the above increment elsewhere. */
         portMEMORY_BARRIER();
+
+        #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+        {
+            if( uxSchedulerSuspended == ( UBaseType_t ) 1U )
+            {
+                ulSchedulerSuspendTime[ 0 ] = portGET_RUN_TIME_COUNTER_VALUE();
+            }
+        }
+        #endif
     }
     #else /* #if ( configNUMBER_OF_CORES == 1 ) */
     {
@@ -3876,6 +4191,16 @@ void vTaskSuspendAll( void )
             /* The scheduler is suspended if uxSchedulerSuspended is non-zero. An increment
              * is used to allow calls to vTaskSuspendAll() to nest. */
             ++uxSchedulerSuspended;
+
+            #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+            {
+                if( uxSchedulerSuspended == 1U )
+                {
+                    ulSchedulerSuspendTime[ portGET_CORE_ID() ] = portGET_RUN_TIME_COUNTER_VALUE();
+                }
+            }
+            #endif
+
             portRELEASE_ISR_LOCK();
 
             portCLEAR_INTERRUPT_MASK( ulState );
@@ -3930,11 +4255,12 @@ void vTaskSuspendAll( void )
         {
             xReturn = 0;
         }
-        else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > 1U )
+        else if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUMBER_OF_CORES )
         {
             /* There are other idle priority tasks in the ready state.  If
              * time slicing is used then the very next tick interrupt must be
-             * processed. */
+             * processed.  In SMP the list also holds the idle tasks of the
+             * other cores, which are running or ready. */
             xReturn = 0;
         }
         else if( xHigherPriorityReadyTasks != pdFALSE )
@@ -3986,6 +4312,15 @@ BaseType_t xTaskResumeAll( void )
 
             if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
             {
+                #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+                {
+                    if( xSchedulerRunning != pdFALSE )
+                    {
+                        prvLatencyRecord( xCoreID, eLatencySchedulerSuspended, ( uint32_t ) ( portGET_RUN_TIME_COUNTER_VALUE() - ulSchedulerSuspendTime[ xCoreID ] ) );
+                    }
+                }
+                #endif
+
                 if( uxCurrentNumberOfTasks > ( UBaseType_t ) 0U )
                 {
                     /* Move any readied tasks from the pending list into the
@@ -4289,15 +4624,26 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
             } while( uxQueue > ( UBaseType_t ) tskIDLE_PRIORITY );
 
             /* Search the delayed lists. */
-            if( pxTCB == NULL )
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
             {
-                pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+                for( uxQueue = 0U; ( pxTCB == NULL ) && ( uxQueue < ( configDELAYED_TASK_WHEEL_LEVELS * taskWHEEL_SLOTS ) ); uxQueue++ )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( &( xDelayedTaskWheel[ uxQueue >> taskWHEEL_SLOT_BITS ][ uxQueue & taskWHEEL_SLOT_MASK ] ), pcNameToQuery );
+                }
             }
-
-            if( pxTCB == NULL )
+            #else
             {
-                pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+                if( pxTCB == NULL )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxDelayedTaskList, pcNameToQuery );
+                }
+
+                if( pxTCB == NULL )
+                {
+                    pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
+                }
             }
+            #endif /* configUSE_DELAYED_TASK_WHEEL */
 
             #if ( INCLUDE_vTaskSuspend == 1 )
             {
@@ -4408,8 +4754,19 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
 
                 /* Fill in an TaskStatus_t structure with information on each
                  * task in the Blocked state. */
-                uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
-                uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
+                #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                {
+                    for( uxQueue = 0U; uxQueue < ( configDELAYED_TASK_WHEEL_LEVELS * taskWHEEL_SLOTS ); uxQueue++ )
+                    {
+                        uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayedTaskWheel[ uxQueue >> taskWHEEL_SLOT_BITS ][ uxQueue & taskWHEEL_SLOT_MASK ] ), eBlocked ) );
+                    }
+                }
+                #else
+                {
+                    uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked ) );
+                    uxTask = ( UBaseType_t ) ( uxTask + prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked ) );
+                }
+                #endif /* configUSE_DELAYED_TASK_WHEEL */
 
                 #if ( INCLUDE_vTaskDelete == 1 )
                 {
@@ -4514,7 +4871,12 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
          * was suppressed.  Note this does *not* call the tick hook function for
          * each stepped tick. */
         xUpdatedTickCount = xTickCount + xTicksToJump;
-        configASSERT( xUpdatedTickCount <= xNextTaskUnblockTime );
+
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            configASSERT( xTicksToJump <= ( TickType_t ) ( xNextTaskUnblockTime - xTickCount ) );
+        #else
+            configASSERT( xUpdatedTickCount <= xNextTaskUnblockTime );
+        #endif
 
         if( xUpdatedTickCount == xNextTaskUnblockTime )
         {
@@ -4673,9 +5035,12 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
 BaseType_t xTaskIncrementTick( void )
 {
     TCB_t * pxTCB;
-    TickType_t xItemValue;
     BaseType_t xSwitchRequired = pdFALSE;
 
+    #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+        TickType_t xItemValue;
+    #endif
+
     #if ( configUSE_PREEMPTION == 1 ) && ( configNUMBER_OF_CORES > 1 )
     BaseType_t xYieldRequiredForCore[ configNUMBER_OF_CORES ] = { pdFALSE };
     #endif /* #if ( configUSE_PREEMPTION == 1 ) && ( configNUMBER_OF_CORES > 1 ) */
@@ -4703,7 +5068,18 @@ BaseType_t xTaskIncrementTick( void )
 
         if( xConstTickCount == ( TickType_t ) 0U )
         {
-            taskSWITCH_DELAYED_LISTS();
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            {
+                /* The wheel places wake times relative to the tick count so
+                 * has no lists to switch, only the overflow count used by the
+                 * timeout functions is updated. */
+                xNumOfOverflows = ( BaseType_t ) ( xNumOfOverflows + 1 );
+            }
+            #else
+            {
+                taskSWITCH_DELAYED_LISTS();
+            }
+            #endif
         }
         else
         {
@@ -4713,109 +5089,137 @@ BaseType_t xTaskIncrementTick( void )
         /* See if this tick has made a timeout expire.  Tasks are stored in
          * the  queue in the order of their wake time - meaning once one task
          * has been found whose block time has not expired there is no need to
-         * look any further down the list. */
-        if( xConstTickCount >= xNextTaskUnblockTime )
+         * look any further down the list.  The delayed task wheel is only
+         * visited on the ticks it has work to do, which are never skipped. */
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+            if( xConstTickCount == xNextTaskUnblockTime )
+        #else
+            if( xConstTickCount >= xNextTaskUnblockTime )
+        #endif
         {
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                List_t * const pxSlotList = prvDelayedWheelCascade( xConstTickCount );
+            #endif
+
             for( ; ; )
             {
-                if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
-                {
-                    /* The delayed list is empty.  Set xNextTaskUnblockTime
-                     * to the maximum possible value so it is extremely
-                     * unlikely that the
-                     * if( xTickCount >= xNextTaskUnblockTime ) test will pass
-                     * next time through. */
-                    xNextTaskUnblockTime = portMAX_DELAY;
-                    break;
-                }
-                else
+                #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
                 {
-                    /* The delayed list is not empty, get the value of the
-                     * item at the head of the delayed list.  This is the time
-                     * at which the task at the head of the delayed list must
-                     * be removed from the Blocked state. */
-                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
-                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-                    /* coverity[misra_c_2012_rule_11_5_violation] */
-                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
-                    xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
-
-                    if( xConstTickCount < xItemValue )
+                    if( listLIST_IS_EMPTY( pxSlotList ) != pdFALSE )
                     {
-                        /* It is not time to unblock this item yet, but the
-                         * item value is the time at which the task at the head
-                         * of the blocked list must be removed from the Blocked
-                         * state -  so record the item value in
-                         * xNextTaskUnblockTime. */
-                        xNextTaskUnblockTime = xItemValue;
+                        /* All the tasks due on this tick have been woken. */
+                        ulDelayedWheelOccupied[ 0 ] &= ~( ( uint32_t ) 1U << ( xConstTickCount & taskWHEEL_SLOT_MASK ) );
+                        xNextTaskUnblockTime = prvDelayedWheelNextEvent();
                         break;
                     }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    /* It is time to remove the item from the Blocked state. */
-                    listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
 
-                    /* Is the task waiting on an event also?  If so remove
-                     * it from the event list. */
-                    if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxSlotList );
+                }
+                #else /* configUSE_DELAYED_TASK_WHEEL */
+                {
+                    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
                     {
-                        listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+                        /* The delayed list is empty.  Set xNextTaskUnblockTime
+                         * to the maximum possible value so it is extremely
+                         * unlikely that the
+                         * if( xTickCount >= xNextTaskUnblockTime ) test will pass
+                         * next time through. */
+                        xNextTaskUnblockTime = portMAX_DELAY;
+                        break;
                     }
                     else
                     {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    /* Place the unblocked task into the appropriate ready
-                     * list. */
-                    prvAddTaskToReadyList( pxTCB );
+                        /* The delayed list is not empty, get the value of the
+                         * item at the head of the delayed list.  This is the time
+                         * at which the task at the head of the delayed list must
+                         * be removed from the Blocked state. */
+                        /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                        /* coverity[misra_c_2012_rule_11_5_violation] */
+                        pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList );
+                        xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
 
-                    /* A task being unblocked cannot cause an immediate
-                     * context switch if preemption is turned off. */
-                    #if ( configUSE_PREEMPTION == 1 )
-                    {
-                        #if ( configNUMBER_OF_CORES == 1 )
+                        if( xConstTickCount < xItemValue )
                         {
-                            /* Preemption is on, but a context switch should
-                             * only be performed if the unblocked task's
-                             * priority is higher than the currently executing
-                             * task.
-                             * The case of equal priority tasks sharing
-                             * processing time (which happens when both
-                             * preemption and time slicing are on) is
-                             * handled below.*/
-                            if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
-                            {
-                                xSwitchRequired = pdTRUE;
-                            }
-                            else
-                            {
-                                mtCOVERAGE_TEST_MARKER();
-                            }
+                            /* It is not time to unblock this item yet, but the
+                             * item value is the time at which the task at the head
+                             * of the blocked list must be removed from the Blocked
+                             * state -  so record the item value in
+                             * xNextTaskUnblockTime. */
+                            xNextTaskUnblockTime = xItemValue;
+                            break;
                         }
-                        #else /* #if( configNUMBER_OF_CORES == 1 ) */
+                        else
                         {
-                            prvYieldForTask( pxTCB );
+                            mtCOVERAGE_TEST_MARKER();
                         }
-                        #endif /* #if( configNUMBER_OF_CORES == 1 ) */
                     }
-                    #endif /* #if ( configUSE_PREEMPTION == 1 ) */
                 }
-            }
-        }
+                #endif /* configUSE_DELAYED_TASK_WHEEL */
 
-        /* Tasks of equal priority to the currently running task will share
-         * processing time (time slice) if preemption is on, and the application
-         * writer has not explicitly turned time slicing off. */
-        #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
-        {
-            #if ( configNUMBER_OF_CORES == 1 )
-            {
-                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > 1U )
-                {
+                /* It is time to remove the item from the Blocked state. */
+                listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+
+                /* Is the task waiting on an event also?  If so remove
+                 * it from the event list. */
+                if( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) != NULL )
+                {
+                    listREMOVE_ITEM( &( pxTCB->xEventListItem ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                /* Place the unblocked task into the appropriate ready
+                 * list. */
+                prvAddTaskToReadyList( pxTCB );
+
+                /* A task being unblocked cannot cause an immediate
+                 * context switch if preemption is turned off. */
+                #if ( configUSE_PREEMPTION == 1 )
+                {
+                    #if ( configNUMBER_OF_CORES == 1 )
+                    {
+                        /* Preemption is on, but a context switch should
+                         * only be performed if the unblocked task's
+                         * priority is higher than the currently executing
+                         * task.
+                         * The case of equal priority tasks sharing
+                         * processing time (which happens when both
+                         * preemption and time slicing are on) is
+                         * handled below.*/
+                        if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                        {
+                            xSwitchRequired = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    #else /* #if( configNUMBER_OF_CORES == 1 ) */
+                    {
+                        prvYieldForTask( pxTCB );
+                    }
+                    #endif /* #if( configNUMBER_OF_CORES == 1 ) */
+                }
+                #endif /* #if ( configUSE_PREEMPTION == 1 ) */
+            }
+        }
+
+        /* Tasks of equal priority to the currently running task will share
+         * processing time (time slice) if preemption is on, and the application
+         * writer has not explicitly turned time slicing off. */
+        #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+        {
+            #if ( configNUMBER_OF_CORES == 1 )
+            {
+                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > 1U )
+                {
                     xSwitchRequired = pdTRUE;
                 }
                 else
@@ -5117,6 +5521,12 @@ BaseType_t xTaskIncrementTick( void )
             taskSELECT_HIGHEST_PRIORITY_TASK();
             traceTASK_SWITCHED_IN();
 
+            #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+            {
+                prvLatencyTaskSwitchedIn( 0 );
+            }
+            #endif
+
             /* Macro to inject port specific behaviour immediately after
              * switching tasks, such as setting an end of stack watchpoint
              * or reconfiguring the MPU. */
@@ -5143,6 +5553,10 @@ BaseType_t xTaskIncrementTick( void )
 #else /* if ( configNUMBER_OF_CORES == 1 ) */
     void vTaskSwitchContext( BaseType_t xCoreID )
     {
+        #if ( configUSE_CORE_YIELD_STATS == 1 )
+            const TCB_t * pxPreviousTCB;
+        #endif
+
         traceENTER_vTaskSwitchContext();
 
         /* Acquire both locks:
@@ -5153,6 +5567,14 @@ BaseType_t xTaskIncrementTick( void )
          *   and move on if another core suspended the scheduler. We should only
          *   do that if the current core has suspended the scheduler. */
 
+        #if ( configUSE_CORE_YIELD_POLICY == 1 )
+        {
+            /* Other cores don't interrupt this core while it waits for the locks,
+             * the task they ready is seen by the selection below. */
+            xSelectingTask[ xCoreID ] = pdTRUE;
+        }
+        #endif
+
         portGET_TASK_LOCK(); /* Must always acquire the task lock first. */
         portGET_ISR_LOCK();
         {
@@ -5210,10 +5632,45 @@ BaseType_t xTaskIncrementTick( void )
                 }
                 #endif
 
+                #if ( configUSE_CORE_YIELD_STATS == 1 )
+                {
+                    pxPreviousTCB = pxCurrentTCBs[ xCoreID ];
+                }
+                #endif
+
                 /* Select a new task to run. */
                 taskSELECT_HIGHEST_PRIORITY_TASK( xCoreID );
                 traceTASK_SWITCHED_IN();
 
+                #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+                {
+                    prvLatencyTaskSwitchedIn( xCoreID );
+                }
+                #endif
+
+                #if ( configUSE_CORE_YIELD_STATS == 1 )
+                {
+                    /* The first switch after a request decides whether it was needed. */
+                    if( xYieldRequested[ xCoreID ] != pdFALSE )
+                    {
+                        xYieldRequested[ xCoreID ] = pdFALSE;
+
+                        if( pxCurrentTCBs[ xCoreID ] != pxPreviousTCB )
+                        {
+                            xCoreYieldStats[ xCoreID ].ulUseful++;
+                        }
+                        else
+                        {
+                            xCoreYieldStats[ xCoreID ].ulWasted++;
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif
+
                 /* Macro to inject port specific behaviour immediately after
                  * switching tasks, such as setting an end of stack watchpoint
                  * or reconfiguring the MPU. */
@@ -5234,6 +5691,12 @@ BaseType_t xTaskIncrementTick( void )
                 }
                 #endif
             }
+
+            #if ( configUSE_CORE_YIELD_POLICY == 1 )
+            {
+                xSelectingTask[ xCoreID ] = pdFALSE;
+            }
+            #endif
         }
         portRELEASE_ISR_LOCK();
         portRELEASE_TASK_LOCK();
@@ -5367,6 +5830,7 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
     pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList );
     configASSERT( pxUnblockedTCB );
     listREMOVE_ITEM( &( pxUnblockedTCB->xEventListItem ) );
+    taskLATENCY_MARK_READIED( pxUnblockedTCB );
 
     if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
     {
@@ -5837,7 +6301,9 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
                     /* Now the scheduler is suspended, the expected idle
                      * time can be sampled again, and this time its value can
                      * be used. */
-                    configASSERT( xNextTaskUnblockTime >= xTickCount );
+                    #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+                        configASSERT( xNextTaskUnblockTime >= xTickCount );
+                    #endif
                     xExpectedIdleTime = prvGetExpectedIdleTime();
 
                     /* Define the following macro to set xExpectedIdleTime to 0
@@ -5850,6 +6316,13 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
                         traceLOW_POWER_IDLE_BEGIN();
                         portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime );
                         traceLOW_POWER_IDLE_END();
+
+                        #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+                        {
+                            /* Time spent asleep is not scheduler latency. */
+                            ulSchedulerSuspendTime[ portGET_CORE_ID() ] = portGET_RUN_TIME_COUNTER_VALUE();
+                        }
+                        #endif
                     }
                     else
                     {
@@ -5884,6 +6357,26 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 
 #if ( configUSE_TICKLESS_IDLE != 0 )
 
+    static BaseType_t prvYieldPendingOnAnyCore( void )
+    {
+        BaseType_t xReturn = pdFALSE;
+        BaseType_t xCoreID;
+
+        /* In SMP an interrupt on another core can pend a yield for that core
+         * while this core sleeps with the scheduler suspended. */
+        for( xCoreID = ( BaseType_t ) 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+        {
+            if( xYieldPendings[ xCoreID ] != pdFALSE )
+            {
+                xReturn = pdTRUE;
+                break;
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
     eSleepModeStatus eTaskConfirmSleepModeStatus( void )
     {
         #if ( INCLUDE_vTaskSuspend == 1 )
@@ -5902,7 +6395,7 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
             /* A task was made ready while the scheduler was suspended. */
             eReturn = eAbortSleep;
         }
-        else if( xYieldPendings[ portGET_CORE_ID() ] != pdFALSE )
+        else if( prvYieldPendingOnAnyCore() != pdFALSE )
         {
             /* A yield was pended while the scheduler was suspended. */
             eReturn = eAbortSleep;
@@ -6020,8 +6513,26 @@ static void prvInitialiseTaskLists( void )
         vListInitialise( &( pxReadyTasksLists[ uxPriority ] ) );
     }
 
-    vListInitialise( &xDelayedTaskList1 );
-    vListInitialise( &xDelayedTaskList2 );
+    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+    {
+        UBaseType_t uxLevel, uxSlot;
+
+        for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configDELAYED_TASK_WHEEL_LEVELS; uxLevel++ )
+        {
+            for( uxSlot = ( UBaseType_t ) 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+            {
+                vListInitialise( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ) );
+            }
+
+            ulDelayedWheelOccupied[ uxLevel ] = 0U;
+        }
+    }
+    #else
+    {
+        vListInitialise( &xDelayedTaskList1 );
+        vListInitialise( &xDelayedTaskList2 );
+    }
+    #endif /* configUSE_DELAYED_TASK_WHEEL */
     vListInitialise( &xPendingReadyList );
 
     #if ( INCLUDE_vTaskDelete == 1 )
@@ -6036,10 +6547,14 @@ static void prvInitialiseTaskLists( void )
     }
     #endif /* INCLUDE_vTaskSuspend */
 
-    /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
-     * using list2. */
-    pxDelayedTaskList = &xDelayedTaskList1;
-    pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+    {
+        /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
+         * using list2. */
+        pxDelayedTaskList = &xDelayedTaskList1;
+        pxOverflowDelayedTaskList = &xDelayedTaskList2;
+    }
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -6458,25 +6973,326 @@ static void prvCheckTasksWaitingTermination( void )
 
 static void prvResetNextTaskUnblockTime( void )
 {
-    if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
     {
-        /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
-         * the maximum possible value so it is  extremely unlikely that the
-         * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
-         * there is an item in the delayed list. */
-        xNextTaskUnblockTime = portMAX_DELAY;
+        xNextTaskUnblockTime = prvDelayedWheelNextEvent();
     }
-    else
+    #else
     {
-        /* The new current delayed list is not empty, get the value of
-         * the item at the head of the delayed list.  This is the time at
-         * which the task at the head of the delayed list should be removed
-         * from the Blocked state. */
-        xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+        {
+            /* The new current delayed list is empty.  Set xNextTaskUnblockTime to
+             * the maximum possible value so it is  extremely unlikely that the
+             * if( xTickCount >= xNextTaskUnblockTime ) test will pass until
+             * there is an item in the delayed list. */
+            xNextTaskUnblockTime = portMAX_DELAY;
+        }
+        else
+        {
+            /* The new current delayed list is not empty, get the value of
+             * the item at the head of the delayed list.  This is the time at
+             * which the task at the head of the delayed list should be removed
+             * from the Blocked state. */
+            xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
+        }
     }
+    #endif /* configUSE_DELAYED_TASK_WHEEL */
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+    static void prvDelayedWheelInsert( TCB_t * const pxTCB,
+                                       const TickType_t xTimeToWake )
+    {
+        const TickType_t xConstTickCount = xTickCount;
+        const TickType_t xDelta = xTimeToWake - xConstTickCount;
+        TickType_t xSlotTime = xTimeToWake;
+        TickType_t xSlotStart;
+        UBaseType_t uxLevel = 0U;
+        UBaseType_t uxSlot;
+
+        /* Use the lowest level that spans the remaining time. */
+        while( ( uxLevel < ( UBaseType_t ) ( configDELAYED_TASK_WHEEL_LEVELS - 1 ) ) && ( ( xDelta >> taskWHEEL_SHIFT( uxLevel + 1U ) ) != ( TickType_t ) 0U ) )
+        {
+            uxLevel++;
+        }
+
+        if( ( xDelta >> taskWHEEL_SHIFT( uxLevel + 1U ) ) != ( TickType_t ) 0U )
+        {
+            /* Beyond the range of the wheel.  Use the last slot of the top
+             * level, the task is placed again when that slot is reached. */
+            xSlotTime = xConstTickCount + ( ( TickType_t ) taskWHEEL_SLOT_MASK << taskWHEEL_SHIFT( uxLevel ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxSlot = ( UBaseType_t ) ( xSlotTime >> taskWHEEL_SHIFT( uxLevel ) ) & taskWHEEL_SLOT_MASK;
+        listINSERT_END( &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] ), &( pxTCB->xStateListItem ) );
+        ulDelayedWheelOccupied[ uxLevel ] |= ( uint32_t ) 1U << uxSlot;
+
+        /* The slot is next reached at the start of the span that holds the
+         * wake time, which is after the current tick unless the task is due
+         * now. */
+        xSlotStart = xSlotTime & ~( ( ( TickType_t ) 1U << taskWHEEL_SHIFT( uxLevel ) ) - 1U );
+
+        if( ( TickType_t ) ( xSlotStart - xConstTickCount ) < ( TickType_t ) ( xNextTaskUnblockTime - xConstTickCount ) )
+        {
+            xNextTaskUnblockTime = xSlotStart;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvDelayedWheelNextEvent( void )
+    {
+        const TickType_t xConstTickCount = xTickCount;
+        TickType_t xNearest = portMAX_DELAY;
+        TickType_t xIndex, xDelta;
+        UBaseType_t uxLevel, uxFirst, uxDistance;
+        uint32_t ulOccupied;
+
+        for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configDELAYED_TASK_WHEEL_LEVELS; uxLevel++ )
+        {
+            if( ulDelayedWheelOccupied[ uxLevel ] != 0U )
+            {
+                /* Rotate the occupied slots so the slot after the current one
+                 * is bit 0, the first set bit is then the distance to the next
+                 * occupied slot.  The current slot itself is reached last, one
+                 * full turn later.  The lowest set bit on its own is also the
+                 * highest. */
+                xIndex = xConstTickCount >> taskWHEEL_SHIFT( uxLevel );
+                uxFirst = ( UBaseType_t ) ( xIndex + 1U ) & taskWHEEL_SLOT_MASK;
+                ulOccupied = ulDelayedWheelOccupied[ uxLevel ];
+                ulOccupied = ( ulOccupied >> uxFirst ) | ( ulOccupied << ( ( taskWHEEL_SLOTS - uxFirst ) & taskWHEEL_SLOT_MASK ) );
+                uxDistance = ( UBaseType_t ) portHIGHEST_SET_BIT( ulOccupied & ( 0U - ulOccupied ) ) + 1U;
+
+                xDelta = ( ( xIndex + uxDistance ) << taskWHEEL_SHIFT( uxLevel ) ) - xConstTickCount;
+
+                if( xDelta < xNearest )
+                {
+                    xNearest = xDelta;
+                }
+            }
+        }
+
+        /* With an empty wheel this is a full turn of the tick count away, when
+         * nothing is done but looking again. */
+        return xConstTickCount + xNearest;
+    }
+/*-----------------------------------------------------------*/
+
+    static List_t * prvDelayedWheelCascade( const TickType_t xConstTickCount )
+    {
+        UBaseType_t uxLevel, uxSlot;
+        List_t * pxSlotList;
+        TCB_t * pxTCB;
+
+        for( uxLevel = ( UBaseType_t ) ( configDELAYED_TASK_WHEEL_LEVELS - 1 ); uxLevel > 0U; uxLevel-- )
+        {
+            if( ( xConstTickCount & ( ( ( TickType_t ) 1U << taskWHEEL_SHIFT( uxLevel ) ) - 1U ) ) == ( TickType_t ) 0U )
+            {
+                uxSlot = ( UBaseType_t ) ( xConstTickCount >> taskWHEEL_SHIFT( uxLevel ) ) & taskWHEEL_SLOT_MASK;
+                pxSlotList = &( xDelayedTaskWheel[ uxLevel ][ uxSlot ] );
+
+                /* A task is never placed back in the slot being re-placed, as
+                 * its remaining time is less than a full turn of this level. */
+                while( listLIST_IS_EMPTY( pxSlotList ) == pdFALSE )
+                {
+                    /* MISRA Ref 11.5.3 [Void pointer assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxSlotList );
+                    listREMOVE_ITEM( &( pxTCB->xStateListItem ) );
+                    prvDelayedWheelInsert( pxTCB, listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) ) );
+                }
+
+                ulDelayedWheelOccupied[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return &( xDelayedTaskWheel[ 0 ][ xConstTickCount & taskWHEEL_SLOT_MASK ] );
+    }
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+
+    static void prvLatencyRecord( BaseType_t xCoreID,
+                                  eLatencyHistogram eHistogram,
+                                  uint32_t ulElapsed )
+    {
+        LatencyHistogram_t * const pxHistogram = &( xLatencyHistograms[ xCoreID ][ eHistogram ] );
+        UBaseType_t uxBucket = 0U;
+
+        if( ulElapsed != 0U )
+        {
+            uxBucket = ( UBaseType_t ) portHIGHEST_SET_BIT( ulElapsed ) + 1U;
+
+            if( uxBucket >= ( UBaseType_t ) configLATENCY_HISTOGRAM_BUCKETS )
+            {
+                uxBucket = ( UBaseType_t ) configLATENCY_HISTOGRAM_BUCKETS - 1U;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxHistogram->ulBuckets[ uxBucket ]++;
+
+        if( ulElapsed > pxHistogram->ulMax )
+        {
+            pxHistogram->ulMax = ulElapsed;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvLatencyTaskSwitchedIn( BaseType_t xCoreID )
+    {
+        const configRUN_TIME_COUNTER_TYPE ulNow = portGET_RUN_TIME_COUNTER_VALUE();
+
+        #if ( configNUMBER_OF_CORES == 1 )
+            TCB_t * const pxTCB = pxCurrentTCB;
+        #else
+            TCB_t * const pxTCB = pxCurrentTCBs[ xCoreID ];
+        #endif
+
+        if( xYieldFromISRPending[ xCoreID ] != pdFALSE )
+        {
+            xYieldFromISRPending[ xCoreID ] = pdFALSE;
+            prvLatencyRecord( xCoreID, eLatencyYieldFromISR, ( uint32_t ) ( ulNow - ulYieldFromISRTime[ xCoreID ] ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pxTCB->xReadiedFromISR != pdFALSE )
+        {
+            pxTCB->xReadiedFromISR = pdFALSE;
+            prvLatencyRecord( xCoreID, eLatencyISRToTask, ( uint32_t ) ( ulNow - pxTCB->ulReadiedFromISRTime ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskLatencyYieldFromISR( void )
+    {
+        const BaseType_t xCoreID = ( BaseType_t ) portGET_CORE_ID();
+
+        ulYieldFromISRTime[ xCoreID ] = portGET_RUN_TIME_COUNTER_VALUE();
+        xYieldFromISRPending[ xCoreID ] = pdTRUE;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTaskGetLatencyHistogram( BaseType_t xCoreID,
+                                         eLatencyHistogram eHistogram,
+                                         LatencyHistogram_t * pxHistogram )
+    {
+        BaseType_t xReturn = pdFAIL;
+
+        traceENTER_xTaskGetLatencyHistogram( xCoreID, eHistogram, pxHistogram );
+
+        configASSERT( pxHistogram );
+
+        if( ( xCoreID >= 0 ) && ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) &&
+            ( eHistogram >= eLatencyISRToTask ) && ( eHistogram < eLatencyHistogramCount ) )
+        {
+            /* The critical section keeps the core from recording while the
+             * histogram is copied. */
+            taskENTER_CRITICAL();
+            {
+                *pxHistogram = xLatencyHistograms[ xCoreID ][ eHistogram ];
+            }
+            taskEXIT_CRITICAL();
+
+            xReturn = pdPASS;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceRETURN_xTaskGetLatencyHistogram( xReturn );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskResetLatencyHistograms( void )
+    {
+        traceENTER_vTaskResetLatencyHistograms();
+
+        taskENTER_CRITICAL();
+        {
+            ( void ) memset( ( void * ) xLatencyHistograms, 0x00, sizeof( xLatencyHistograms ) );
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskResetLatencyHistograms();
+    }
+
+#endif /* configUSE_LATENCY_HISTOGRAMS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_CORE_YIELD_STATS == 1 )
+
+    void vTaskGetCoreYieldStats( BaseType_t xCoreID,
+                                 CoreYieldStats_t * pxStats )
+    {
+        traceENTER_vTaskGetCoreYieldStats( xCoreID, pxStats );
+
+        configASSERT( taskVALID_CORE_ID( xCoreID ) == pdTRUE );
+        configASSERT( pxStats );
+
+        taskENTER_CRITICAL();
+        {
+            *pxStats = xCoreYieldStats[ xCoreID ];
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskGetCoreYieldStats();
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskResetCoreYieldStats( void )
+    {
+        traceENTER_vTaskResetCoreYieldStats();
+
+        taskENTER_CRITICAL();
+        {
+            ( void ) memset( ( void * ) xCoreYieldStats, 0x00, sizeof( xCoreYieldStats ) );
+        }
+        taskEXIT_CRITICAL();
+
+        traceRETURN_vTaskResetCoreYieldStats();
+    }
+
+#endif /* configUSE_CORE_YIELD_STATS */
+/*-----------------------------------------------------------*/
+
 #if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) || ( configNUMBER_OF_CORES > 1 )
 
     #if ( configNUMBER_OF_CORES == 1 )
@@ -6941,6 +7757,12 @@ static void prvResetNextTaskUnblockTime( void )
             if( pxCurrentTCB->uxCriticalNesting == 1U )
             {
                 portASSERT_IF_IN_ISR();
+
+                #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+                {
+                    ulCriticalEnterTime[ 0 ] = portGET_RUN_TIME_COUNTER_VALUE();
+                }
+                #endif
             }
         }
         else
@@ -6982,6 +7804,12 @@ static void prvResetNextTaskUnblockTime( void )
             {
                 portASSERT_IF_IN_ISR();
 
+                #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+                {
+                    ulCriticalEnterTime[ portGET_CORE_ID() ] = portGET_RUN_TIME_COUNTER_VALUE();
+                }
+                #endif
+
                 if( uxSchedulerSuspended == 0U )
                 {
                     /* The only time there would be a problem is if this is called
@@ -7058,6 +7886,12 @@ static void prvResetNextTaskUnblockTime( void )
 
                 if( pxCurrentTCB->uxCriticalNesting == 0U )
                 {
+                    #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+                    {
+                        prvLatencyRecord( 0, eLatencyCritical, ( uint32_t ) ( portGET_RUN_TIME_COUNTER_VALUE() - ulCriticalEnterTime[ 0 ] ) );
+                    }
+                    #endif
+
                     portENABLE_INTERRUPTS();
                 }
                 else
@@ -7108,6 +7942,12 @@ static void prvResetNextTaskUnblockTime( void )
                     /* Get the xYieldPending stats inside the critical section. */
                     xYieldCurrentTask = xYieldPendings[ portGET_CORE_ID() ];
 
+                    #if ( configUSE_LATENCY_HISTOGRAMS == 1 )
+                    {
+                        prvLatencyRecord( ( BaseType_t ) portGET_CORE_ID(), eLatencyCritical, ( uint32_t ) ( portGET_RUN_TIME_COUNTER_VALUE() - ulCriticalEnterTime[ portGET_CORE_ID() ] ) );
+                    }
+                    #endif
+
                     portRELEASE_ISR_LOCK();
                     portRELEASE_TASK_LOCK();
                     portENABLE_INTERRUPTS();
@@ -8053,6 +8893,7 @@ TickType_t uxTaskResetEventItemValue( void )
             {
                 /* The task should not have been on an event list. */
                 configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+                taskLATENCY_MARK_READIED( pxTCB );
 
                 if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
                 {
@@ -8171,6 +9012,7 @@ TickType_t uxTaskResetEventItemValue( void )
             {
                 /* The task should not have been on an event list. */
                 configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+                taskLATENCY_MARK_READIED( pxTCB );
 
                 if( uxSchedulerSuspended == ( UBaseType_t ) 0U )
                 {
@@ -8420,8 +9262,11 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
 {
     TickType_t xTimeToWake;
     const TickType_t xConstTickCount = xTickCount;
-    List_t * const pxDelayedList = pxDelayedTaskList;
-    List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+
+    #if ( configUSE_DELAYED_TASK_WHEEL == 0 )
+        List_t * const pxDelayedList = pxDelayedTaskList;
+        List_t * const pxOverflowDelayedList = pxOverflowDelayedTaskList;
+    #endif
 
     #if ( INCLUDE_xTaskAbortDelay == 1 )
     {
@@ -8461,35 +9306,57 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
              * kernel will manage it correctly. */
             xTimeToWake = xConstTickCount + xTicksToWait;
 
-            /* The list item will be inserted in wake time order. */
-            listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
-
-            if( xTimeToWake < xConstTickCount )
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
             {
-                /* Wake time has overflowed.  Place this item in the overflow
-                 * list. */
-                traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
-                vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
+                /* The wheel is placed relative to the tick count, so the wake
+                 * time overflowing needs no special handling.  A task blocking
+                 * for no time is woken by the next tick, as from the lists. */
+                if( xTimeToWake == xConstTickCount )
+                {
+                    xTimeToWake++;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
+                traceMOVED_TASK_TO_DELAYED_LIST();
+                prvDelayedWheelInsert( pxCurrentTCB, xTimeToWake );
             }
-            else
+            #else /* configUSE_DELAYED_TASK_WHEEL */
             {
-                /* The wake time has not overflowed, so the current block list
-                 * is used. */
-                traceMOVED_TASK_TO_DELAYED_LIST();
-                vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+                /* The list item will be inserted in wake time order. */
+                listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-                /* If the task entering the blocked state was placed at the
-                 * head of the list of blocked tasks then xNextTaskUnblockTime
-                 * needs to be updated too. */
-                if( xTimeToWake < xNextTaskUnblockTime )
+                if( xTimeToWake < xConstTickCount )
                 {
-                    xNextTaskUnblockTime = xTimeToWake;
+                    /* Wake time has overflowed.  Place this item in the overflow
+                     * list. */
+                    traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
+                    vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
                 }
                 else
                 {
-                    mtCOVERAGE_TEST_MARKER();
+                    /* The wake time has not overflowed, so the current block list
+                     * is used. */
+                    traceMOVED_TASK_TO_DELAYED_LIST();
+                    vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+
+                    /* If the task entering the blocked state was placed at the
+                     * head of the list of blocked tasks then xNextTaskUnblockTime
+                     * needs to be updated too. */
+                    if( xTimeToWake < xNextTaskUnblockTime )
+                    {
+                        xNextTaskUnblockTime = xTimeToWake;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
                 }
             }
+            #endif /* configUSE_DELAYED_TASK_WHEEL */
         }
     }
     #else /* INCLUDE_vTaskSuspend */
@@ -8499,33 +9366,53 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
          * will manage it correctly. */
         xTimeToWake = xConstTickCount + xTicksToWait;
 
-        /* The list item will be inserted in wake time order. */
-        listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
-
-        if( xTimeToWake < xConstTickCount )
+        #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
         {
-            traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
-            /* Wake time has overflowed.  Place this item in the overflow list. */
-            vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
+            /* A task blocking for no time is woken by the next tick. */
+            if( xTimeToWake == xConstTickCount )
+            {
+                xTimeToWake++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
+            traceMOVED_TASK_TO_DELAYED_LIST();
+            prvDelayedWheelInsert( pxCurrentTCB, xTimeToWake );
         }
-        else
+        #else /* configUSE_DELAYED_TASK_WHEEL */
         {
-            traceMOVED_TASK_TO_DELAYED_LIST();
-            /* The wake time has not overflowed, so the current block list is used. */
-            vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+            /* The list item will be inserted in wake time order. */
+            listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
-            /* If the task entering the blocked state was placed at the head of the
-             * list of blocked tasks then xNextTaskUnblockTime needs to be updated
-             * too. */
-            if( xTimeToWake < xNextTaskUnblockTime )
+            if( xTimeToWake < xConstTickCount )
             {
-                xNextTaskUnblockTime = xTimeToWake;
+                traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST();
+                /* Wake time has overflowed.  Place this item in the overflow list. */
+                vListInsert( pxOverflowDelayedList, &( pxCurrentTCB->xStateListItem ) );
             }
             else
             {
-                mtCOVERAGE_TEST_MARKER();
+                traceMOVED_TASK_TO_DELAYED_LIST();
+                /* The wake time has not overflowed, so the current block list is used. */
+                vListInsert( pxDelayedList, &( pxCurrentTCB->xStateListItem ) );
+
+                /* If the task entering the blocked state was placed at the head of the
+                 * list of blocked tasks then xNextTaskUnblockTime needs to be updated
+                 * too. */
+                if( xTimeToWake < xNextTaskUnblockTime )
+                {
+                    xNextTaskUnblockTime = xTimeToWake;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
             }
         }
+        #endif /* configUSE_DELAYED_TASK_WHEEL */
 
         /* Avoid compiler warning when INCLUDE_vTaskSuspend is not 1. */
         ( void ) xCanBlockIndefinitely;
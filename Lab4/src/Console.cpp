@@ -0,0 +1,24 @@
+//
+// Shared use of stdout.
+//
+
+#include "Console.h"
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+// mutex, so a low priority task holding the console is raised to the priority of the one waiting
+static SemaphoreHandle_t consoleMutex;
+
+void consoleInit() {
+    consoleMutex = xSemaphoreCreateMutex();
+    configASSERT(consoleMutex);
+}
+
+void consoleLock() {
+    xSemaphoreTake(consoleMutex, portMAX_DELAY);
+}
+
+void consoleUnlock() {
+    xSemaphoreGive(consoleMutex);
+}
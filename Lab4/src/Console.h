@@ -0,0 +1,21 @@
+//
+// Shared use of stdout.
+//
+// debugTask, latencyStatsTask, taskStatsTask and traceTask all write to stdout
+// and the trace frames are binary, so text that lands in the middle of a frame
+// breaks the parsing of a capture. A task takes the console for a whole
+// message, stats block or trace dump.
+//
+
+#ifndef LAB4_CONSOLE_H
+#define LAB4_CONSOLE_H
+
+// Creates the console lock, call before starting the scheduler
+void consoleInit();
+
+// Waits until the console is free and takes it, tasks only
+void consoleLock();
+
+void consoleUnlock();
+
+#endif //LAB4_CONSOLE_H
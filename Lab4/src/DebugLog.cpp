@@ -0,0 +1,173 @@
+//
+// Deferred logging for debug() messages.
+//
+
+#include "DebugLog.h"
+
+#include <cstdio>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mpsc_ring.h"
+#include "Console.h"
+#include "WorkPool.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+static_assert((DEBUG_LOG_RING_SIZE & (DEBUG_LOG_RING_SIZE - 1)) == 0, "DEBUG_LOG_RING_SIZE must be a power of two");
+
+// Notification index of debugTask that counts formatted chunks
+#define DEBUG_NOTIFY_FORMATTED 1
+static_assert(configTASK_NOTIFICATION_ARRAY_ENTRIES > DEBUG_NOTIFY_FORMATTED, "debugTask needs a notification for formatted chunks");
+
+// Producers on either core claim a slot with a short compare and swap and copy the message with
+// interrupts enabled, debugTask is the only consumer.
+static MpscRingHandle_t ring;
+
+// debugTask has found the ring empty and blocks, the next message notifies it
+static TaskHandle_t consumer;
+static volatile bool sleeping;
+
+void debugInit() {
+    ring = xMpscRingCreate(DEBUG_LOG_RING_SIZE, sizeof(debugEvent));
+    configASSERT(ring);
+}
+
+static void wakeConsumer() {
+    sleeping = false;
+    if (portCHECK_IF_IN_ISR()) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(consumer, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        xTaskNotifyGive(consumer);
+    }
+}
+
+void debug(const char *format, uint32_t d1, uint32_t d2, uint32_t d3) {
+    debugEvent e{format, {d1, d2, d3}, timer_hw->timerawl};
+    xMpscRingSend(ring, &e);  // a full ring counts the drop
+
+    // the message is published before sleeping is read, debugTask sets sleeping before it looks at the ring
+    __dmb();
+    if (sleeping) wakeConsumer();
+}
+
+uint32_t debugDropped() {
+    return uxMpscRingDropped(ring);
+}
+
+#if DEBUG_LOG_BINARY
+static void putWord(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        putchar_raw(static_cast<int>(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+static void printEvent(const debugEvent &e) {
+    putchar_raw(0x55);
+    putchar_raw(0xAA);
+    putWord(e.timestamp);
+    putWord(reinterpret_cast<uint32_t>(e.format));
+    putWord(e.data[0]);
+    putWord(e.data[1]);
+    putWord(e.data[2]);
+}
+
+static void printDropped(uint32_t timestamp, uint32_t count) {
+    printEvent(debugEvent{nullptr, {count, 0, 0}, timestamp});
+}
+
+static void printEvents(const debugEvent *events, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        printEvent(events[i]);
+    }
+}
+#else
+// A burst of messages is formatted by the work pool on both cores, DEBUG_LOG_CHUNK messages per
+// job. debugTask prints the text in log order once every chunk is done.
+struct formatBatch {
+    const debugEvent *events;
+    uint32_t count;
+    char text[DEBUG_LOG_BATCH][DEBUG_LOG_TEXT_SIZE];
+    TaskHandle_t owner;
+};
+
+static formatBatch batch;
+
+static void formatChunk(formatBatch &b, uint32_t first) {
+    uint32_t end = first + DEBUG_LOG_CHUNK < b.count ? first + DEBUG_LOG_CHUNK : b.count;
+    for (uint32_t i = first; i < end; ++i) {
+        const debugEvent &e = b.events[i];
+        snprintf(b.text[i], DEBUG_LOG_TEXT_SIZE, e.format, e.data[0], e.data[1], e.data[2]);
+    }
+}
+
+static void formatJob(void *arg, uint32_t first) {
+    auto &b = *static_cast<formatBatch *>(arg);
+    formatChunk(b, first);
+    xTaskNotifyGiveIndexed(b.owner, DEBUG_NOTIFY_FORMATTED);
+}
+
+static void printEvents(const debugEvent *events, uint32_t count) {
+    uint32_t jobs = 0;
+
+    batch.events = events;
+    batch.count = count;
+    batch.owner = xTaskGetCurrentTaskHandle();
+    for (uint32_t first = 0; first < count; first += DEBUG_LOG_CHUNK) {
+        // a single chunk is cheaper to format here than to hand over
+        if (count <= DEBUG_LOG_CHUNK || !workSubmit(formatJob, &batch, first)) {
+            formatChunk(batch, first);
+        } else {
+            ++jobs;
+        }
+    }
+    for (uint32_t done = 0; done < jobs;) {
+        done += ulTaskNotifyTakeIndexed(DEBUG_NOTIFY_FORMATTED, pdTRUE, portMAX_DELAY);
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        printf("%lu: %s", events[i].timestamp, batch.text[i]);
+    }
+}
+
+static void printDropped(uint32_t timestamp, uint32_t count) {
+    printf("%lu: [%lu debug messages dropped]\n", timestamp, count);
+}
+#endif
+
+// Debug Task: Reads from the ring and prints the debug messages
+void debugTask(void *pvParameters) {
+    static debugEvent events[DEBUG_LOG_BATCH];
+    uint32_t reported = 0;
+
+    consumer = xTaskGetCurrentTaskHandle();
+    while (1) {
+        uint32_t count;
+        consoleLock();
+        do {
+            count = 0;
+            while (count < DEBUG_LOG_BATCH && xMpscRingReceive(ring, &events[count]) == pdPASS) {
+                ++count;
+            }
+            printEvents(events, count);
+        } while (count == DEBUG_LOG_BATCH);
+
+        uint32_t dropped = uxMpscRingDropped(ring);
+        if (dropped != reported) {
+            printDropped(timer_hw->timerawl, dropped - reported);
+            reported = dropped;
+        }
+        consoleUnlock();
+
+        sleeping = true;
+        __dmb();
+        // a message published before sleeping was seen doesn't notify, so look once more
+        if (xMpscRingIsEmpty(ring)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        sleeping = false;
+    }
+}
@@ -0,0 +1,63 @@
+//
+// Deferred logging for debug() messages.
+//
+// debug() stores the format pointer and arguments in an MPSC ring shared by
+// both cores and returns immediately, formatting is done later by debugTask.
+// Messages come out in the order they were logged. When the ring is full the
+// message is dropped and counted. debugTask blocks until a message arrives
+// in an empty ring, it doesn't wake up on a timer. It takes up to DEBUG_LOG_BATCH
+// messages at a time and a burst that is longer than DEBUG_LOG_CHUNK messages
+// is formatted by the work pool (WorkPool.h) on both cores.
+//
+// Setting DEBUG_LOG_BINARY to 1 makes debugTask write raw records instead of
+// text. Each record is 22 bytes: sync bytes 0x55 0xAA followed by little endian
+// 32-bit timestamp (us), format string address and three arguments. The host
+// expands the record by looking up the format string at that address in the
+// ELF file. A record with format address 0 reports the number of dropped
+// messages in the first argument.
+//
+
+#ifndef LAB4_DEBUGLOG_H
+#define LAB4_DEBUGLOG_H
+
+#include <cstdint>
+
+#ifndef DEBUG_LOG_BINARY
+#define DEBUG_LOG_BINARY 0
+#endif
+
+#ifndef DEBUG_LOG_RING_SIZE
+#define DEBUG_LOG_RING_SIZE 128  // messages, must be a power of two
+#endif
+
+#ifndef DEBUG_LOG_BATCH
+#define DEBUG_LOG_BATCH 32       // messages taken from the ring at a time
+#endif
+
+#ifndef DEBUG_LOG_CHUNK
+#define DEBUG_LOG_CHUNK 8        // messages formatted by one work pool job
+#endif
+
+#ifndef DEBUG_LOG_TEXT_SIZE
+#define DEBUG_LOG_TEXT_SIZE 64   // formatted message, longer ones are cut
+#endif
+
+struct debugEvent {
+    const char *format;
+    uint32_t data[3];
+    uint32_t timestamp;  // microseconds
+};
+
+// Creates the log ring, must be called before the first debug()
+void debugInit();
+
+// Send formatted message to the log, never blocks. Can be called from tasks and interrupts.
+void debug(const char *format, uint32_t d1, uint32_t d2, uint32_t d3);
+
+// Number of messages dropped because the ring was full
+uint32_t debugDropped();
+
+// Reads messages from the ring and prints them
+void debugTask(void *pvParameters);
+
+#endif //LAB4_DEBUGLOG_H
@@ -42,16 +42,17 @@
 
 /* Scheduler Related */
 #define configUSE_PREEMPTION                    1
-#define configUSE_TICKLESS_IDLE                 0
+#define configUSE_TICKLESS_IDLE                 1
 #define configUSE_IDLE_HOOK                     0
 #define configUSE_TICK_HOOK                     0
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES                    32
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
 #define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 256
 #define configUSE_16_BIT_TICKS                  0
 
 #define configIDLE_SHOULD_YIELD                 1
-#define configUSE_PASSIVE_IDLE_HOOK             0
+#define configUSE_PASSIVE_IDLE_HOOK             1
 
 /* Synchronization Related */
 #define configUSE_MUTEXES                       1
@@ -65,6 +66,7 @@
 // todo need this for lwip FreeRTOS sys_arch to compile
 #define configENABLE_BACKWARD_COMPATIBILITY     1
 #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2
 
 /* System */
 #define configSTACK_DEPTH_TYPE                  uint32_t
@@ -75,6 +77,8 @@
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
 #define configTOTAL_HEAP_SIZE                   (128*1024)
 #define configAPPLICATION_ALLOCATED_HEAP        0
+/* heap_pool size classes: small objects, TCB, queues, idle/timer and application stacks */
+#define configHEAP_POOL_CLASS_SIZES             32, 64, 128, 256, 1024, 4000
 
 /* Hook function related definitions. */
 #define configCHECK_FOR_STACK_OVERFLOW          0
@@ -86,6 +90,7 @@
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    1
 #define configRECORD_STACK_HIGH_ADDRESS         1
+#define configUSE_LATENCY_HISTOGRAMS            1
 
 #ifdef __cplusplus
 extern "C" {
@@ -124,6 +129,8 @@ uint32_t read_runtime_ctr(void);
 #define configTICK_CORE                         0
 #define configRUN_MULTIPLE_PRIORITIES           1
 #define configUSE_CORE_AFFINITY                 1
+#define configUSE_CORE_YIELD_POLICY             1
+#define configUSE_CORE_YIELD_STATS              1
 #endif
 
 /* RP2040 specific */
@@ -154,5 +161,6 @@ to exclude the API function. */
 #define INCLUDE_xQueueGetMutexHolder            1
 
 /* A header file that defines trace macro can be included here. */
+#include "TraceRecorder.h"
 
 #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
@@ -0,0 +1,97 @@
+//
+// Console dump of the kernel latency histograms.
+//
+
+#include "LatencyStats.h"
+
+#include <cstdio>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "WorkPool.h"
+#include "Console.h"
+
+static const char *const histogramNames[eLatencyHistogramCount] = {
+    "isr->task",
+    "yield->task",
+    "critical",
+    "suspended",
+};
+
+void printLatencyStats() {
+    for (BaseType_t core = 0; core < configNUMBER_OF_CORES; ++core) {
+        for (int h = 0; h < eLatencyHistogramCount; ++h) {
+            LatencyHistogram_t histogram;
+            xTaskGetLatencyHistogram(core, static_cast<eLatencyHistogram>(h), &histogram);
+
+            uint32_t count = 0;
+            for (auto bucket : histogram.ulBuckets) {
+                count += bucket;
+            }
+            printf("core %ld %-11s n %-7lu max %-6lu", core, histogramNames[h], count, histogram.ulMax);
+
+            // bucket b holds times below 2^b us, the last one everything longer
+            for (int b = 0; b < configLATENCY_HISTOGRAM_BUCKETS; ++b) {
+                if (histogram.ulBuckets[b] == 0) continue;
+                if (b == configLATENCY_HISTOGRAM_BUCKETS - 1) {
+                    printf(" >=%lu:%lu", 1UL << (b - 1), histogram.ulBuckets[b]);
+                } else {
+                    printf(" <%lu:%lu", 1UL << b, histogram.ulBuckets[b]);
+                }
+            }
+            printf("\n");
+        }
+    }
+}
+
+void printTicklessStats() {
+#if configUSE_TICKLESS_IDLE == 1
+    TicklessStats_t stats;
+    vPortGetTicklessStats(&stats);
+
+    uint32_t timed = stats.ulSleeps - stats.ulEarlyWakes;
+    uint32_t residency = stats.ullElapsedTime ? stats.ullSleepTime * 1000 / stats.ullElapsedTime : 0;  // per mille
+    printf("tickless asleep %lu.%lu%% sleeps %lu early %lu aborted %lu ticks %lu wake latency avg %lu max %lu\n",
+           residency / 10, residency % 10, stats.ulSleeps, stats.ulEarlyWakes, stats.ulAborted, stats.ulTicksStepped,
+           timed ? stats.ulWakeLatencyTotal / timed : 0UL, stats.ulWakeLatencyMax);
+#endif
+}
+
+void printCoreYieldStats() {
+#if configUSE_CORE_YIELD_STATS == 1
+    for (BaseType_t core = 0; core < configNUMBER_OF_CORES; ++core) {
+        CoreYieldStats_t stats;
+        vTaskGetCoreYieldStats(core, &stats);
+        printf("core %ld yield requests %lu useful %lu wasted %lu skipped %lu kept local %lu\n", core,
+               stats.ulRequests, stats.ulUseful, stats.ulWasted, stats.ulSkipped, stats.ulLocal);
+    }
+#endif
+}
+
+void printWorkPoolStats() {
+    for (int core = 0; core < NUM_CORES; ++core) {
+        workStats stats = workPoolStats(core);
+        printf("core %d work pool executed %lu stolen %lu dropped %lu\n", core, stats.executed, stats.stolen,
+               stats.dropped);
+    }
+}
+
+void latencyStatsTask(void *pvParameters) {
+    TickType_t lastWake = xTaskGetTickCount();
+
+    while (1) {
+        xTaskDelayUntil(&lastWake, pdMS_TO_TICKS(LATENCY_STATS_PERIOD_MS));
+        consoleLock();
+        printLatencyStats();
+        vTaskResetLatencyHistograms();
+#if configUSE_TICKLESS_IDLE == 1
+        printTicklessStats();
+        vPortResetTicklessStats();
+#endif
+#if configUSE_CORE_YIELD_STATS == 1
+        printCoreYieldStats();
+        vTaskResetCoreYieldStats();
+#endif
+        printWorkPoolStats();
+        consoleUnlock();
+    }
+}
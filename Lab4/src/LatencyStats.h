@@ -0,0 +1,40 @@
+//
+// Console dump of the kernel latency histograms.
+//
+// With configUSE_LATENCY_HISTOGRAMS set the kernel keeps, per core, log2
+// histograms of ISR to task wake latency, portYIELD_FROM_ISR() to task switch
+// latency, critical section length and scheduler suspension length.
+// latencyStatsTask prints them every LATENCY_STATS_PERIOD_MS so the longest
+// latencies of a running system can be found without a trace probe. Times are
+// in microseconds, the unit of read_runtime_ctr().
+//
+// With configUSE_TICKLESS_IDLE the time spent with the tick suppressed and the
+// latency from a sleep's wake time to the tick running again are printed too.
+// With configUSE_CORE_YIELD_STATS the yield requests each core received from
+// the other core are printed, split into the ones that made it switch task and
+// the wasted ones. The job counters of the work pool follow, they count from start.
+//
+
+#ifndef LAB4_LATENCYSTATS_H
+#define LAB4_LATENCYSTATS_H
+
+#ifndef LATENCY_STATS_PERIOD_MS
+#define LATENCY_STATS_PERIOD_MS 10000
+#endif
+
+// Prints the histograms of all cores
+void printLatencyStats();
+
+// Prints idle residency and wake latency of tickless idle
+void printTicklessStats();
+
+// Prints the cross-core yield request counters of each core
+void printCoreYieldStats();
+
+// Prints the jobs run, stolen and dropped by the work pool on each core
+void printWorkPoolStats();
+
+// Prints the histograms periodically and starts each period from empty histograms
+void latencyStatsTask(void *pvParameters);
+
+#endif //LAB4_LATENCYSTATS_H
@@ -0,0 +1,123 @@
+//
+// Console dump of per-task CPU load and stack use.
+//
+
+#include "TaskStats.h"
+
+#include <cstdio>
+#include <cstring>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "Console.h"
+
+#define MAX_TASKS 16
+
+struct TaskRow {
+    UBaseType_t number;  // xTaskNumber, unique for the lifetime of the system
+    char name[configMAX_TASK_NAME_LEN];
+    eTaskState state;
+    UBaseType_t priority;
+    configRUN_TIME_COUNTER_TYPE runtime;  // counter value at the sample
+    configRUN_TIME_COUNTER_TYPE delta;    // run time during the period
+    configSTACK_DEPTH_TYPE stackFree;     // words
+};
+
+static const char stateNames[] = "XRBSD";  // running, ready, blocked, suspended, deleted
+
+// static so the collector doesn't need a stack the size of the task list
+static TaskStatus_t status[MAX_TASKS];
+static TaskRow rows[MAX_TASKS];
+static TaskRow previous[MAX_TASKS];
+static int count;
+static int previousCount;
+static configRUN_TIME_COUNTER_TYPE total;     // run time counter at the latest sample
+static configRUN_TIME_COUNTER_TYPE interval;  // counter ticks (us) between the samples
+static configRUN_TIME_COUNTER_TYPE idleDelta;  // run time of all idle tasks during the period
+
+// returns the share of one core during the period, per mille
+static uint32_t permille(configRUN_TIME_COUNTER_TYPE time) {
+    if (interval == 0) return 0;
+    // a task can't run longer than the period, clamp rounding errors at the edges of the samples
+    uint64_t result = static_cast<uint64_t>(time) * 1000 / interval;
+    return static_cast<uint32_t>(result > 1000 ? 1000 : result);
+}
+
+static configRUN_TIME_COUNTER_TYPE previousRuntime(UBaseType_t number) {
+    for (int i = 0; i < previousCount; ++i) {
+        if (previous[i].number == number) return previous[i].runtime;
+    }
+    return 0;  // task was created during the period
+}
+
+static bool isIdleTask(TaskHandle_t task) {
+    for (BaseType_t core = 0; core < configNUMBER_OF_CORES; ++core) {
+        if (task == xTaskGetIdleTaskHandleForCore(core)) return true;
+    }
+    return false;
+}
+
+bool sampleTaskStats() {
+    memcpy(previous, rows, sizeof(rows));
+    previousCount = count;
+
+    // the scheduler is suspended only while the kernel fills the array
+    configRUN_TIME_COUNTER_TYPE now;
+    UBaseType_t tasks = uxTaskGetSystemState(status, MAX_TASKS, &now);
+    if (tasks == 0) {  // more tasks than rows
+        count = 0;
+        return false;
+    }
+
+    interval = now - total;  // unsigned, so a wrap of the 32 bit us counter between samples is fine
+    total = now;
+    idleDelta = 0;
+
+    count = static_cast<int>(tasks);
+    for (int i = 0; i < count; ++i) {
+        const TaskStatus_t &s = status[i];
+        TaskRow &row = rows[i];
+        row.number = s.xTaskNumber;
+        // name is copied while the task surely exists
+        strncpy(row.name, s.pcTaskName, sizeof(row.name) - 1);
+        row.name[sizeof(row.name) - 1] = '\0';
+        row.state = s.eCurrentState;
+        row.priority = s.uxCurrentPriority;
+        row.runtime = s.ulRunTimeCounter;
+        row.delta = s.ulRunTimeCounter - previousRuntime(s.xTaskNumber);
+        row.stackFree = s.usStackHighWaterMark;
+        if (isIdleTask(s.xHandle)) idleDelta += row.delta;
+    }
+    return true;
+}
+
+void printTaskStats() {
+    printf("Task            State Prio   CPU%%  Stack free\n");
+    for (int i = 0; i < count; ++i) {
+        const TaskRow &row = rows[i];
+        uint32_t load = permille(row.delta);
+        printf("%-16s%-6c%-5lu%3lu.%lu  %lu\n", row.name, stateNames[row.state <= eDeleted ? row.state : eDeleted],
+               static_cast<unsigned long>(row.priority), load / 10, load % 10,
+               static_cast<unsigned long>(row.stackFree));
+    }
+    // load of both cores together, idle time of the cores is the run time of the idle tasks
+    uint32_t idle = permille(idleDelta / configNUMBER_OF_CORES);
+    uint32_t load = interval ? 1000 - idle : 0;
+    printf("CPU load %lu.%lu%% of %d cores\n", load / 10, load % 10, configNUMBER_OF_CORES);
+}
+
+void taskStatsTask(void *pvParameters) {
+    TickType_t lastWake = xTaskGetTickCount();
+    sampleTaskStats();  // start of the first period
+
+    while (1) {
+        xTaskDelayUntil(&lastWake, pdMS_TO_TICKS(TASK_STATS_PERIOD_MS));
+        bool complete = sampleTaskStats();
+        consoleLock();
+        if (complete) {
+            printTaskStats();
+        } else {
+            printf("task stats: more than %d tasks\n", MAX_TASKS);
+        }
+        consoleUnlock();
+    }
+}
@@ -0,0 +1,33 @@
+//
+// Console dump of per-task CPU load and stack use.
+//
+// taskStatsTask copies the kernel task list with uxTaskGetSystemState() into a
+// preallocated array every TASK_STATS_PERIOD_MS. The scheduler is suspended
+// only for that copy, the table is formatted afterwards with only the console
+// held. CPU percentages are of one core and cover the period since the
+// previous sample, not the time since boot. The idle tasks aren't pinned to a
+// core, so the load line is of both cores together.
+//
+// The stack column is the high-water mark: the fewest words that have been
+// free on the task's stack since it was created. The 256 to 1000 word stacks
+// in main.cpp can be cut down to the used part plus a margin.
+//
+
+#ifndef LAB4_TASKSTATS_H
+#define LAB4_TASKSTATS_H
+
+#ifndef TASK_STATS_PERIOD_MS
+#define TASK_STATS_PERIOD_MS 10000
+#endif
+
+// Copies the task list and computes the loads since the previous sample,
+// returns false if there are more tasks than fit in the array
+bool sampleTaskStats();
+
+// Prints the rows of the latest sample, the caller holds the console
+void printTaskStats();
+
+// Samples and prints periodically
+void taskStatsTask(void *pvParameters);
+
+#endif //LAB4_TASKSTATS_H
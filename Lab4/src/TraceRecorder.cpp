@@ -0,0 +1,281 @@
+//
+// Binary trace recorder implementing the FreeRTOS trace hook macros.
+//
+
+#include "TraceRecorder.h"
+
+#include <cstring>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "Console.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of two");
+
+static constexpr uint32_t TRACE_FORMAT_VERSION = 1;
+static constexpr int TRACE_NAME_LENGTH = 16;
+
+// Frame types, each frame starts with the sync bytes 0x55 0xAA
+static constexpr uint8_t FRAME_HEADER = 'H';   // version, overhead ns, ring size, cores
+static constexpr uint8_t FRAME_NAME = 'N';     // object, 16 name bytes
+static constexpr uint8_t FRAME_RECORD = 'R';   // core, record
+static constexpr uint8_t FRAME_DROPPED = 'D';  // core, dropped count
+static constexpr uint8_t FRAME_END = 'E';      // end of a dump
+
+struct traceRecordData {
+    uint32_t timestamp;  // microseconds
+    uint32_t task;       // task running on the core
+    uint32_t object;
+    uint32_t info;       // event code in the top byte, value in the low 24 bits
+};
+
+// Records are written by the owning core with interrupts masked, so no lock is shared between
+// the cores. When streaming, traceTask is the only consumer of the rings.
+struct traceRing {
+    traceRecordData records[TRACE_RING_SIZE];
+    volatile uint32_t head;     // written by the owning core
+    volatile uint32_t tail;     // written by traceTask
+    volatile uint32_t dropped;  // written by the owning core
+    volatile bool writing;      // owning core is between its check of paused and the end of its record
+    const void *current;        // task running on the owning core
+    const void *shown;          // task of the latest switch in record, when streaming
+};
+
+struct traceName {
+    uint32_t object;
+    char name[TRACE_NAME_LENGTH];
+};
+
+static traceRing rings[NUM_CORES];
+// Set while a snapshot is written out. A writer raises its ring's writing flag before it looks at
+// paused and traceTask raises paused before it looks at the flags, with a barrier in between on
+// both sides, so either the writer sees paused or traceTask waits for the record to be finished.
+static volatile bool paused;
+
+static traceName names[TRACE_NAME_COUNT];
+static volatile uint32_t nameCount;
+static volatile uint32_t nameGeneration;  // changes when a name is added or replaced
+static spin_lock_t *nameLock;
+
+static uint32_t overheadNs;
+static TaskHandle_t traceTaskHandle;
+
+// When streaming, traceTask wakes every TRACE_FLUSH_MS and takes the console, its own records would
+// keep the stream from ever going quiet. They are left out, its run time shows as the task before it.
+static inline bool isRecorderActivity(const traceRing &ring, const void *object) {
+    return TRACE_RECORDER_STREAMING && traceTaskHandle &&
+           (ring.current == traceTaskHandle || object == traceTaskHandle);
+}
+
+void traceRecord(uint32_t event, const void *object, uint32_t value) {
+    // while interrupts are masked the caller can't be moved to the other core
+    uint32_t status = save_and_disable_interrupts();
+    traceRing &ring = rings[get_core_num()];
+    if (isRecorderActivity(ring, object)) {
+        restore_interrupts(status);
+        return;
+    }
+    ring.writing = true;
+    __dmb();  // flag must be visible before paused is read
+    uint32_t head = ring.head;
+    if (paused) {
+        // the snapshot being written out is kept intact
+    } else if (TRACE_RECORDER_STREAMING && head - ring.tail >= TRACE_RING_SIZE) {
+        ring.dropped = ring.dropped + 1;
+    } else {
+        traceRecordData &r = ring.records[head & (TRACE_RING_SIZE - 1)];
+        r.timestamp = timer_hw->timerawl;
+        r.task = reinterpret_cast<uint32_t>(ring.current);
+        r.object = reinterpret_cast<uint32_t>(object);
+        r.info = (event << 24) | (value & 0xFFFFFF);
+        __dmb();  // record must be visible before the consumer sees the new head
+        ring.head = head + 1;
+    }
+    __dmb();  // record is complete before the flag drops
+    ring.writing = false;
+    restore_interrupts(status);
+}
+
+void traceSwitchedIn(const void *task) {
+    traceRing &ring = rings[get_core_num()];
+    ring.current = task;
+    if (TRACE_RECORDER_STREAMING && !isRecorderActivity(ring, task)) {
+        // after traceTask the core usually goes back to the task the stream still shows running
+        if (task == ring.shown) return;
+        ring.shown = task;
+    }
+    traceRecord(TRACE_EVENT_TASK_SWITCHED_IN, task, 0);
+}
+
+void traceObjectName(const void *object, const char *name) {
+    uint32_t status = nameLock ? spin_lock_blocking(nameLock) : save_and_disable_interrupts();
+    uint32_t i = 0;
+    // a handle that is reused gets the new name
+    while (i < nameCount && names[i].object != reinterpret_cast<uint32_t>(object)) ++i;
+    if (i < TRACE_NAME_COUNT) {
+        names[i].object = reinterpret_cast<uint32_t>(object);
+        strncpy(names[i].name, name ? name : "", TRACE_NAME_LENGTH);
+        if (i == nameCount) nameCount = i + 1;
+        nameGeneration = nameGeneration + 1;
+    }
+    if (nameLock) {
+        spin_unlock(nameLock, status);
+    } else {
+        restore_interrupts(status);
+    }
+}
+
+void traceRecorderInit() {
+    nameLock = spin_lock_init(spin_lock_claim_unused(true));
+
+    // time a burst of records to report what recording costs
+    constexpr uint32_t samples = 1000;
+    uint32_t start = timer_hw->timerawl;
+    for (uint32_t i = 0; i < samples; ++i) {
+        traceRecord(TRACE_EVENT_TASK_READY, nullptr, i);
+    }
+    overheadNs = (timer_hw->timerawl - start) * 1000 / samples;
+
+    for (auto &ring : rings) {
+        ring.head = 0;
+        ring.tail = 0;
+        ring.dropped = 0;
+        ring.writing = false;
+    }
+}
+
+uint32_t traceRecorderOverhead() {
+    return overheadNs;
+}
+
+void traceRequestDump() {
+    if (traceTaskHandle) xTaskNotifyGive(traceTaskHandle);
+}
+
+static void putWord(uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        putchar_raw(static_cast<int>(value & 0xFF));
+        value >>= 8;
+    }
+}
+
+static void putFrame(uint8_t type) {
+    putchar_raw(0x55);
+    putchar_raw(0xAA);
+    putchar_raw(type);
+}
+
+static void writeHeader() {
+    putFrame(FRAME_HEADER);
+    putWord(TRACE_FORMAT_VERSION);
+    putWord(overheadNs);
+    putWord(TRACE_RING_SIZE);
+    putWord(NUM_CORES);
+}
+
+static void writeNames() {
+    for (uint32_t i = 0; i < nameCount; ++i) {
+        traceName name;
+        uint32_t status = spin_lock_blocking(nameLock);
+        name = names[i];
+        spin_unlock(nameLock, status);
+
+        putFrame(FRAME_NAME);
+        putWord(name.object);
+        for (char c : name.name) putchar_raw(c);
+    }
+}
+
+static void writeRecord(int core, const traceRecordData &r) {
+    putFrame(FRAME_RECORD);
+    putchar_raw(core);
+    putWord(r.timestamp);
+    putWord(r.task);
+    putWord(r.object);
+    putWord(r.info);
+}
+
+static void writeDropped(int core, uint32_t dropped) {
+    putFrame(FRAME_DROPPED);
+    putchar_raw(core);
+    putWord(dropped);
+}
+
+#if TRACE_RECORDER_STREAMING
+// Trace Task: writes the records out as the rings fill
+void traceTask(void *pvParameters) {
+    uint32_t generation = nameGeneration - 1;
+    uint32_t reported[NUM_CORES] = {};
+
+    traceTaskHandle = xTaskGetCurrentTaskHandle();
+    consoleLock();
+    writeHeader();
+    consoleUnlock();
+
+    while (1) {
+        consoleLock();
+        if (generation != nameGeneration) {
+            generation = nameGeneration;
+            writeNames();
+        }
+
+        for (int core = 0; core < NUM_CORES; ++core) {
+            traceRing &ring = rings[core];
+            while (ring.tail != ring.head) {
+                __dmb();  // head was read before the record
+                traceRecordData r = ring.records[ring.tail & (TRACE_RING_SIZE - 1)];
+                __dmb();  // record is copied before the slot is given back
+                ring.tail = ring.tail + 1;
+                writeRecord(core, r);
+            }
+
+            uint32_t dropped = ring.dropped;
+            if (dropped != reported[core]) {
+                writeDropped(core, dropped);
+                reported[core] = dropped;
+            }
+        }
+        consoleUnlock();
+
+        vTaskDelay(pdMS_TO_TICKS(TRACE_FLUSH_MS));
+    }
+}
+#else
+// Trace Task: writes the latest records out when a dump is requested
+void traceTask(void *pvParameters) {
+    traceTaskHandle = xTaskGetCurrentTaskHandle();
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        consoleLock();
+        paused = true;
+        __dmb();  // paused must be visible before the flags are read
+        for (auto &ring : rings) {
+            // a record that was started before paused was seen is finished first, this only
+            // spins on the other core's ring as the own core's writers can't interrupt a task
+            // while they are writing
+            while (ring.writing) tight_loop_contents();
+        }
+        __dmb();  // records are read after the writers are done
+
+        writeHeader();
+        writeNames();
+        for (int core = 0; core < NUM_CORES; ++core) {
+            traceRing &ring = rings[core];
+            uint32_t head = ring.head;
+            uint32_t count = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+            for (uint32_t i = head - count; i != head; ++i) {
+                writeRecord(core, ring.records[i & (TRACE_RING_SIZE - 1)]);
+            }
+        }
+        putFrame(FRAME_END);
+
+        __dmb();
+        paused = false;
+        consoleUnlock();
+    }
+}
+#endif
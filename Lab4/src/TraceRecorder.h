@@ -0,0 +1,145 @@
+//
+// Binary trace recorder implementing the FreeRTOS trace hook macros.
+//
+// FreeRTOSConfig.h includes this header so the kernel records task switches,
+// queue, semaphore, event group and notification activity as 16 byte records
+// in a ring per core. A record holds a microsecond timestamp, the task running
+// on the core, the object the event refers to and the event code with a 24-bit
+// value. Tasks are named when they are created, queues and semaphores when they
+// are added to the queue registry, other objects with traceObjectName().
+//
+// With TRACE_RECORDER_STREAMING set to 0 the rings keep the latest records and
+// traceTask writes them out when traceRequestDump() is called. With it set to
+// 1 traceTask writes the records out as they come and records that do not fit
+// are dropped and counted. The output is written to stdout as frames that
+// start with the sync bytes 0x55 0xAA, so it can share the port with text.
+// traceTask takes the console (Console.h) while it writes, so the text of
+// other tasks never lands inside a frame. When streaming, the records of
+// traceTask itself are left out, so the stream is quiet while the system is;
+// its run time shows as part of the task it interrupted.
+// Lab4/tools/trace2chrome.py converts a capture to Chrome trace JSON.
+//
+// This header is also included by the kernel C sources, keep it C compatible.
+//
+
+#ifndef LAB4_TRACERECORDER_H
+#define LAB4_TRACERECORDER_H
+
+#include <stdint.h>
+
+#ifndef TRACE_RECORDER_ENABLED
+#define TRACE_RECORDER_ENABLED 1
+#endif
+
+#ifndef TRACE_RECORDER_STREAMING
+#define TRACE_RECORDER_STREAMING 0
+#endif
+
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 256      // records per core, must be a power of two
+#endif
+
+#ifndef TRACE_NAME_COUNT
+#define TRACE_NAME_COUNT 32      // named objects
+#endif
+
+#ifndef TRACE_FLUSH_MS
+#define TRACE_FLUSH_MS 10        // how often traceTask drains the rings when streaming
+#endif
+
+// Event codes, kept in step with EVENTS in tools/trace2chrome.py
+#define TRACE_EVENT_TASK_SWITCHED_IN        1   // object: task
+#define TRACE_EVENT_TASK_READY              2   // object: task, value: priority
+#define TRACE_EVENT_TASK_CREATE             3   // object: task, value: priority
+#define TRACE_EVENT_TASK_DELETE             4   // object: task
+#define TRACE_EVENT_TASK_DELAY              5   // value: ticks
+#define TRACE_EVENT_TASK_DELAY_UNTIL        6   // value: wake tick
+#define TRACE_EVENT_PRIORITY_INHERIT        7   // object: mutex holder, value: inherited priority
+#define TRACE_EVENT_PRIORITY_DISINHERIT     8   // object: mutex holder, value: restored priority
+#define TRACE_EVENT_QUEUE_SEND              9   // object: queue, value: messages waiting before
+#define TRACE_EVENT_QUEUE_SEND_FAILED       10
+#define TRACE_EVENT_QUEUE_RECEIVE           11
+#define TRACE_EVENT_QUEUE_RECEIVE_FAILED    12
+#define TRACE_EVENT_QUEUE_SEND_FROM_ISR     13
+#define TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR  14
+#define TRACE_EVENT_QUEUE_BLOCK_SEND        15
+#define TRACE_EVENT_QUEUE_BLOCK_RECEIVE     16
+#define TRACE_EVENT_GROUP_SET_BITS          17  // object: event group, value: bits
+#define TRACE_EVENT_GROUP_SET_BITS_FROM_ISR 18
+#define TRACE_EVENT_GROUP_WAIT_BLOCK        19  // object: event group, value: bits
+#define TRACE_EVENT_GROUP_WAIT_END          20  // object: event group, value: 1 on timeout
+#define TRACE_EVENT_TASK_NOTIFY             21  // object: task, value: index
+#define TRACE_EVENT_TASK_NOTIFY_FROM_ISR    22
+#define TRACE_EVENT_TASK_NOTIFY_BLOCK       23  // value: index
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Adds a record to the ring of the calling core. Can be called from tasks and interrupts.
+void traceRecord(uint32_t event, const void *object, uint32_t value);
+
+// Records a task switch and makes task the running task of the calling core
+void traceSwitchedIn(const void *task);
+
+// Names an object for the decoder, the name is copied
+void traceObjectName(const void *object, const char *name);
+
+#ifdef __cplusplus
+}
+
+// Measures the recording overhead and starts recording from empty rings, call before creating tasks
+void traceRecorderInit();
+
+// Time in nanoseconds that recording one event takes, measured by traceRecorderInit()
+uint32_t traceRecorderOverhead();
+
+// Asks traceTask to write the rings out
+void traceRequestDump();
+
+// Writes the records out, either on request or continuously
+void traceTask(void *pvParameters);
+#endif
+
+#if TRACE_RECORDER_ENABLED
+
+#define traceTASK_SWITCHED_IN() traceSwitchedIn(pxCurrentTCB)
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB) traceRecord(TRACE_EVENT_TASK_READY, (pxTCB), (pxTCB)->uxPriority)
+#define traceTASK_CREATE(pxNewTCB)                                                    \
+    do {                                                                              \
+        traceObjectName((pxNewTCB), (pxNewTCB)->pcTaskName);                          \
+        traceRecord(TRACE_EVENT_TASK_CREATE, (pxNewTCB), (pxNewTCB)->uxPriority);     \
+    } while (0)
+#define traceTASK_DELETE(pxTaskToDelete) traceRecord(TRACE_EVENT_TASK_DELETE, (pxTaskToDelete), 0)
+#define traceTASK_DELAY() traceRecord(TRACE_EVENT_TASK_DELAY, 0, xTicksToDelay)
+#define traceTASK_DELAY_UNTIL(x) traceRecord(TRACE_EVENT_TASK_DELAY_UNTIL, 0, (x))
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority) \
+    traceRecord(TRACE_EVENT_PRIORITY_INHERIT, (pxTCBOfMutexHolder), (uxInheritedPriority))
+#define traceTASK_PRIORITY_DISINHERIT(pxTCBOfMutexHolder, uxOriginalPriority) \
+    traceRecord(TRACE_EVENT_PRIORITY_DISINHERIT, (pxTCBOfMutexHolder), (uxOriginalPriority))
+
+#define traceQUEUE_SEND(pxQueue) traceRecord(TRACE_EVENT_QUEUE_SEND, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_SEND_FAILED(pxQueue) traceRecord(TRACE_EVENT_QUEUE_SEND_FAILED, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE(pxQueue) traceRecord(TRACE_EVENT_QUEUE_RECEIVE, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE_FAILED(pxQueue) traceRecord(TRACE_EVENT_QUEUE_RECEIVE_FAILED, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) traceRecord(TRACE_EVENT_QUEUE_SEND_FROM_ISR, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) traceRecord(TRACE_EVENT_QUEUE_RECEIVE_FROM_ISR, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) traceRecord(TRACE_EVENT_QUEUE_BLOCK_SEND, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) traceRecord(TRACE_EVENT_QUEUE_BLOCK_RECEIVE, (pxQueue), (pxQueue)->uxMessagesWaiting)
+#define traceQUEUE_REGISTRY_ADD(xQueue, pcQueueName) traceObjectName((xQueue), (pcQueueName))
+
+#define traceEVENT_GROUP_SET_BITS(xEventGroup, uxBitsToSet) traceRecord(TRACE_EVENT_GROUP_SET_BITS, (xEventGroup), (uxBitsToSet))
+#define traceEVENT_GROUP_SET_BITS_FROM_ISR(xEventGroup, uxBitsToSet) traceRecord(TRACE_EVENT_GROUP_SET_BITS_FROM_ISR, (xEventGroup), (uxBitsToSet))
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK(xEventGroup, uxBitsToWaitFor) traceRecord(TRACE_EVENT_GROUP_WAIT_BLOCK, (xEventGroup), (uxBitsToWaitFor))
+#define traceEVENT_GROUP_WAIT_BITS_END(xEventGroup, uxBitsToWaitFor, xTimeoutOccurred) \
+    traceRecord(TRACE_EVENT_GROUP_WAIT_END, (xEventGroup), (xTimeoutOccurred))
+
+#define traceTASK_NOTIFY(uxIndexToNotify) traceRecord(TRACE_EVENT_TASK_NOTIFY, pxTCB, (uxIndexToNotify))
+#define traceTASK_NOTIFY_FROM_ISR(uxIndexToNotify) traceRecord(TRACE_EVENT_TASK_NOTIFY_FROM_ISR, pxTCB, (uxIndexToNotify))
+#define traceTASK_NOTIFY_GIVE_FROM_ISR(uxIndexToNotify) traceRecord(TRACE_EVENT_TASK_NOTIFY_FROM_ISR, pxTCB, (uxIndexToNotify))
+#define traceTASK_NOTIFY_WAIT_BLOCK(uxIndexToWait) traceRecord(TRACE_EVENT_TASK_NOTIFY_BLOCK, 0, (uxIndexToWait))
+#define traceTASK_NOTIFY_TAKE_BLOCK(uxIndexToWait) traceRecord(TRACE_EVENT_TASK_NOTIFY_BLOCK, 0, (uxIndexToWait))
+
+#endif // TRACE_RECORDER_ENABLED
+
+#endif //LAB4_TRACERECORDER_H
@@ -0,0 +1,183 @@
+//
+// Worker pool for short jobs on both cores.
+//
+
+#include "WorkPool.h"
+
+#include "task.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+static_assert((WORK_POOL_DEQUE_SIZE & (WORK_POOL_DEQUE_SIZE - 1)) == 0, "WORK_POOL_DEQUE_SIZE must be a power of two");
+static_assert(configUSE_CORE_AFFINITY == 1, "workers are pinned to their cores");
+
+struct workJob {
+    workFunction function;
+    void *arg;
+    uint32_t data;
+};
+
+struct workDeque {
+    workJob jobs[WORK_POOL_DEQUE_SIZE];
+    uint32_t head;  // oldest job
+    uint32_t tail;  // one past the newest job
+};
+
+// The M0+ has no exclusive load/store, so each core's queues are guarded by a
+// hardware spin lock. It also masks interrupts, which makes submitting from
+// interrupt handlers safe.
+struct workCore {
+    workDeque shared;  // taken by the owner from the head and by the other core from the tail
+    workDeque pinned;  // taken only by the owner
+    spin_lock_t *lock;
+    TaskHandle_t worker;
+    volatile bool idle;  // worker is waiting for a notification
+    volatile uint32_t executed;
+    volatile uint32_t stolen;
+    volatile uint32_t dropped;
+};
+
+static workCore cores[NUM_CORES];
+
+static bool push(workDeque &deque, const workJob &job) {
+    if (deque.tail - deque.head >= WORK_POOL_DEQUE_SIZE) return false;
+    deque.jobs[deque.tail & (WORK_POOL_DEQUE_SIZE - 1)] = job;
+    ++deque.tail;
+    return true;
+}
+
+static bool popHead(workDeque &deque, workJob &job) {
+    if (deque.head == deque.tail) return false;
+    job = deque.jobs[deque.head & (WORK_POOL_DEQUE_SIZE - 1)];
+    ++deque.head;
+    return true;
+}
+
+static bool popTail(workDeque &deque, workJob &job) {
+    if (deque.head == deque.tail) return false;
+    --deque.tail;
+    job = deque.jobs[deque.tail & (WORK_POOL_DEQUE_SIZE - 1)];
+    return true;
+}
+
+// Adds the job and returns the worker that should be woken, nullptr if the job was dropped.
+// A second worker to wake is returned in thief when the owner is busy and the other core is idle.
+static TaskHandle_t enqueue(const workJob &job, int core, TaskHandle_t &thief) {
+    bool pinned = core != WORK_ANY_CORE;
+    configASSERT(core >= WORK_ANY_CORE && core < NUM_CORES);
+    uint32_t status = save_and_disable_interrupts();
+    // while interrupts are masked the caller can't be moved to the other core
+    if (!pinned) core = static_cast<int>(get_core_num());
+    workCore &c = cores[core];
+
+    spin_lock_unsafe_blocking(c.lock);
+    bool added = push(pinned ? c.pinned : c.shared, job);
+    if (!added) c.dropped = c.dropped + 1;
+    spin_unlock_unsafe(c.lock);
+    restore_interrupts(status);
+
+    thief = nullptr;
+    if (!added) return nullptr;
+    if (!pinned && !c.idle) {
+        for (auto &other : cores) {
+            if (&other != &c && other.idle) {
+                thief = other.worker;
+                break;
+            }
+        }
+    }
+    return c.worker;
+}
+
+bool workSubmit(workFunction function, void *arg, uint32_t data, int core) {
+    TaskHandle_t thief;
+    TaskHandle_t worker = enqueue(workJob{function, arg, data}, core, thief);
+    if (!worker) return false;
+    xTaskNotifyGive(worker);
+    if (thief) xTaskNotifyGive(thief);
+    return true;
+}
+
+bool workSubmitFromISR(workFunction function, void *arg, uint32_t data, int core,
+                       BaseType_t *higherPriorityTaskWoken) {
+    TaskHandle_t thief;
+    TaskHandle_t worker = enqueue(workJob{function, arg, data}, core, thief);
+    if (!worker) return false;
+    vTaskNotifyGiveFromISR(worker, higherPriorityTaskWoken);
+    if (thief) vTaskNotifyGiveFromISR(thief, higherPriorityTaskWoken);
+    return true;
+}
+
+// Takes a job of the own core, pinned ones first, or steals one from the other core
+static bool take(int core, workJob &job) {
+    workCore &own = cores[core];
+    uint32_t status = spin_lock_blocking(own.lock);
+    bool found = popHead(own.pinned, job) || popHead(own.shared, job);
+    spin_unlock(own.lock, status);
+    if (found) return true;
+
+    for (auto &other : cores) {
+        if (&other == &own) continue;
+        status = spin_lock_blocking(other.lock);
+        // the newest job, the owner is working from the other end
+        found = popTail(other.shared, job);
+        spin_unlock(other.lock, status);
+        if (found) {
+            own.stolen = own.stolen + 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hasWork(int core) {
+    for (int i = 0; i < NUM_CORES; ++i) {
+        const workCore &c = cores[i];
+        if (c.shared.head != c.shared.tail) return true;
+        if (i == core && c.pinned.head != c.pinned.tail) return true;
+    }
+    return false;
+}
+
+// Worker Task: runs jobs of its core and steals when it has none
+static void workerTask(void *pvParameters) {
+    int core = static_cast<int>(reinterpret_cast<intptr_t>(pvParameters));
+    workCore &own = cores[core];
+
+    while (1) {
+        workJob job;
+        if (take(core, job)) {
+            job.function(job.arg, job.data);
+            own.executed = own.executed + 1;
+            continue;
+        }
+
+        own.idle = true;
+        __dmb();
+        // a job submitted before idle was seen has to be checked for, submitters only wake idle thieves
+        if (!hasWork(core)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        own.idle = false;
+    }
+}
+
+void workPoolInit(UBaseType_t priority) {
+    static const char *const names[] = {"Worker 0", "Worker 1"};
+    static_assert(sizeof(names) / sizeof(names[0]) >= NUM_CORES, "name for each worker");
+
+    // workers steal from each other, so every lock exists before the first worker
+    for (auto &c : cores) {
+        c.lock = spin_lock_init(spin_lock_claim_unused(true));
+    }
+    for (int core = 0; core < NUM_CORES; ++core) {
+        xTaskCreateAffinitySet(workerTask, names[core], WORK_POOL_STACK_SIZE,
+                               reinterpret_cast<void *>(static_cast<intptr_t>(core)), priority,
+                               1 << core, &cores[core].worker);
+    }
+}
+
+workStats workPoolStats(int core) {
+    const workCore &c = cores[core];
+    return workStats{c.executed, c.stolen, c.dropped};
+}
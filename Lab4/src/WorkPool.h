@@ -0,0 +1,60 @@
+//
+// Worker pool for short jobs on both cores.
+//
+// workPoolInit() creates one worker task per core, pinned with core affinity.
+// Each core has a deque of jobs: workSubmit() adds to the deque of the core it
+// runs on and the worker of that core takes the oldest job first. A worker
+// that runs out of jobs steals the newest job from the other core's deque, so
+// a burst submitted on one core is spread over both.
+//
+// A job submitted with a core number goes to a separate queue of that core
+// that is never stolen from, for example to keep the processing of an
+// interrupt's data on the core that owns the interrupt. Jobs can be submitted
+// from tasks and interrupts. Nothing is allocated, a job that doesn't fit is
+// dropped and counted.
+//
+// Jobs run at the priority of the workers and must not block for long, other
+// jobs of the same core wait behind them.
+//
+// debugTask hands bursts of log messages to the pool for formatting.
+//
+
+#ifndef LAB4_WORKPOOL_H
+#define LAB4_WORKPOOL_H
+
+#include <cstdint>
+#include "FreeRTOS.h"
+
+#ifndef WORK_POOL_DEQUE_SIZE
+#define WORK_POOL_DEQUE_SIZE 32    // jobs per core and queue, must be a power of two
+#endif
+
+#ifndef WORK_POOL_STACK_SIZE
+#define WORK_POOL_STACK_SIZE 512   // words per worker
+#endif
+
+// Core argument of workSubmit() for a job that can run on any core
+constexpr int WORK_ANY_CORE = -1;
+
+using workFunction = void (*)(void *arg, uint32_t data);
+
+struct workStats {
+    uint32_t executed;  // jobs run by the worker of the core
+    uint32_t stolen;    // of those, jobs taken from the other core
+    uint32_t dropped;   // jobs submitted to the core that didn't fit
+};
+
+// Creates the workers, call before starting the scheduler
+void workPoolInit(UBaseType_t priority);
+
+// Queues function(arg, data) to run on a worker, returns false if the job was dropped
+bool workSubmit(workFunction function, void *arg, uint32_t data, int core = WORK_ANY_CORE);
+
+// Same as workSubmit() for interrupt handlers
+bool workSubmitFromISR(workFunction function, void *arg, uint32_t data, int core,
+                       BaseType_t *higherPriorityTaskWoken);
+
+// Counters of a core since start
+workStats workPoolStats(int core);
+
+#endif //LAB4_WORKPOOL_H
@@ -7,10 +7,26 @@
 #include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include "hardware/timer.h"
+#include "Console.h"
+#include "DebugLog.h"
+#include "LatencyStats.h"
+#include "TaskStats.h"
+#include "TraceRecorder.h"
+#include "WorkPool.h"
+#include "PublishedState.h"
 
 extern "C" {
 uint32_t read_runtime_ctr() {
-    return 0;  // Return a dummy value for now
+    return timer_hw->timerawl;  // microseconds
+}
+
+// Called by the idle tasks of both cores. The core that doesn't take the tick sleeps until an interrupt
+// or the other core wakes it, the tick core sleeps in tickless idle instead.
+void vApplicationPassiveIdleHook() {
+    if (get_core_num() != configTICK_CORE) {
+        __wfe();
+    }
 }
 }
 
@@ -19,47 +35,24 @@ uint32_t read_runtime_ctr() {
 #define LED_PIN 22           // D0 LED pin
 
 #define DEBUG_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define LATENCY_STATS_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define TRACE_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define TASK_STATS_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
+#define WORK_POOL_PRIORITY (tskIDLE_PRIORITY + 2)
 #define BUTTON_TASK_PRIORITY (DEBUG_TASK_PRIORITY + 1)
 #define TASK2_PRIORITY (DEBUG_TASK_PRIORITY + 1)
 #define TASK3_PRIORITY (DEBUG_TASK_PRIORITY + 1)
 
 EventGroupHandle_t eventGroup;
-QueueHandle_t syslog_q;
 SemaphoreHandle_t randMutex;
 
-struct debugEvent {
-    const char *format;
-    uint32_t data[3];
-    TickType_t timestamp;
+// Random delay of tasks 2 and 3, they read it on whichever core they run on
+struct WorkerTiming {
+    uint32_t min_ms;
+    uint32_t spread_ms;
 };
 
-// Debug function to send formatted messages to the queue
-void debug(const char *format, uint32_t d1, uint32_t d2, uint32_t d3) {
-    struct debugEvent e;
-    e.format = format;
-    e.data[0] = d1;
-    e.data[1] = d2;
-    e.data[2] = d3;
-    e.timestamp = xTaskGetTickCount();
-
-    // Send the event to the queue
-    xQueueSend(syslog_q, &e, portMAX_DELAY);
-}
-
-// Debug Task: Reads from the queue and prints the debug message
-
-void debugTask(void *pvParameters) {
-    char buffer[64];
-    struct debugEvent e;
-
-    while (1) {
-        // Receive the event from the queue and print with timestamp
-        if (xQueueReceive(syslog_q, &e, portMAX_DELAY) == pdPASS) {
-            snprintf(buffer, 64, e.format, e.data[0], e.data[1], e.data[2]);
-            printf("%lu: %s", e.timestamp, buffer);
-        }
-    }
-}
+static PublishedState<WorkerTiming> workerTiming({1000, 1000});  // 1-2 seconds
 
 // Button Debouncing Function
 bool debounceButton(uint pin) {
@@ -78,6 +71,7 @@ void buttonTask(void *pvParameters) {
         // Check for a debounced button press
         if (debounceButton(SW1_PIN)) {
             debug("Debounced button press detected.\n", 0, 0, 0);
+            traceRequestDump();  // Write out the trace leading up to the press
 
             // Set event bit for Tasks 2 and 3 (bit 0)
             xEventGroupSetBits(eventGroup, BUTTON_BIT);  // Set bit 0
@@ -100,7 +94,11 @@ void task2(void *pvParameters) {
     while (1) {
         // Wait for BUTTON_BIT, clear the bit after processing
         // Execute task logic
-        vTaskDelay(pdMS_TO_TICKS(1000 + rand() % 1000));  // Random delay between 1-2 seconds
+        WorkerTiming timing = workerTiming.read();
+        xSemaphoreTake(randMutex, portMAX_DELAY);  // rand() state is shared by the tasks on both cores
+        uint32_t delay = timing.min_ms + rand() % timing.spread_ms;
+        xSemaphoreGive(randMutex);
+        vTaskDelay(pdMS_TO_TICKS(delay));  // Random delay between 1-2 seconds
         TickType_t now = xTaskGetTickCount();
         debug("Task 2 running. Elapsed ticks: %u\n", now - lastTick, 0, 0);
         lastTick = now;
@@ -116,7 +114,11 @@ void task3(void *pvParameters) {
     while (1) {
         // Wait for BUTTON_BIT, clear the bit after processing
         // Execute task logic
-        vTaskDelay(pdMS_TO_TICKS(1000 + rand() % 1000));  // Random delay between 1-2 seconds
+        WorkerTiming timing = workerTiming.read();
+        xSemaphoreTake(randMutex, portMAX_DELAY);  // rand() state is shared by the tasks on both cores
+        uint32_t delay = timing.min_ms + rand() % timing.spread_ms;
+        xSemaphoreGive(randMutex);
+        vTaskDelay(pdMS_TO_TICKS(delay));  // Random delay between 1-2 seconds
         TickType_t now = xTaskGetTickCount();
         debug("Task 3 running. Elapsed ticks: %u\n", now - lastTick, 0, 0);
         lastTick = now;
@@ -140,14 +142,18 @@ int main(void) {
     // Initialize the standard I/O and pins
     stdio_init_all();  // Initialize UART for serial communication
     init_pins();       // Initialize GPIO pins
+    traceRecorderInit();  // Measure trace overhead before any kernel objects exist
+    consoleInit();
+    debugInit();
 
-    // Initialize event group and queue
+    // Initialize event group
     eventGroup = xEventGroupCreate();
-    syslog_q = xQueueCreate(10, sizeof(struct debugEvent));
+    traceObjectName(eventGroup, "eventGroup");
 
     // Initialize the random number generator and mutex
     srand(time(NULL));
     randMutex = xSemaphoreCreateMutex();
+    vQueueAddToRegistry(randMutex, "randMutex");
 
     // Send initialization message via debug task
     debug("System Initialized\n", 0, 0, 0);
@@ -157,6 +163,10 @@ int main(void) {
     xTaskCreate(task2, "Task 2", 1000, NULL, TASK2_PRIORITY, NULL);
     xTaskCreate(task3, "Task 3", 1000, NULL, TASK3_PRIORITY, NULL);
     xTaskCreate(debugTask, "Debug Task", 1000, NULL, DEBUG_TASK_PRIORITY, NULL);
+    xTaskCreate(latencyStatsTask, "Latency Stats", 1000, NULL, LATENCY_STATS_TASK_PRIORITY, NULL);
+    xTaskCreate(traceTask, "Trace Task", 1000, NULL, TRACE_TASK_PRIORITY, NULL);
+    xTaskCreate(taskStatsTask, "Task Stats", 1000, NULL, TASK_STATS_TASK_PRIORITY, NULL);
+    workPoolInit(WORK_POOL_PRIORITY);  // One worker per core for short jobs
 
     // Start the scheduler
     vTaskStartScheduler();
@@ -0,0 +1,49 @@
+/*
+ * Kernel configuration of delayed_wheel_test: the host test configuration
+ * with the delayed task wheel, tickless idle that skips idle time at once and
+ * trace hooks that tell the test when each task was due and when it was made
+ * ready.  The hooks are expanded in tasks.c, so they can pass the kernel's
+ * own view of the tick count.
+ *
+ * Built a second time with configUSE_DELAYED_TASK_WHEEL set to 0 to compare
+ * with the delayed task lists.
+ */
+
+#ifndef DELAYED_WHEEL_CONFIG_H
+#define DELAYED_WHEEL_CONFIG_H
+
+#include <stdint.h>
+
+#ifndef configUSE_DELAYED_TASK_WHEEL
+#define configUSE_DELAYED_TASK_WHEEL            1
+#endif
+
+/* 4096 ticks before the tick count wraps */
+#define configINITIAL_TICK_COUNT                0xFFFFF000UL
+
+#define configUSE_TICKLESS_IDLE                 1
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vTestSkipIdleTicks( xExpectedIdleTime )
+
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS 1
+#define INCLUDE_xTaskAbortDelay                 1
+#define INCLUDE_eTaskGetState                   1
+
+void vTestSkipIdleTicks( uint32_t ulExpectedIdleTime );
+void vTestTaskDelayed( void * pvTask, uint32_t ulTickCount, uint32_t ulTimeToWake );
+void vTestTaskReady( void * pvTask, uint32_t ulTickCount );
+void vTestBlockPathStart( void );
+void vTestBlockPathEnd( void );
+void vTestTickPathStart( int iSchedulerRunning );
+void vTestTickPathEnd( void );
+
+#define traceMOVED_TASK_TO_DELAYED_LIST()             vTestTaskDelayed( pxCurrentTCB, xConstTickCount, xTimeToWake )
+#define traceMOVED_TASK_TO_OVERFLOW_DELAYED_LIST()    vTestTaskDelayed( pxCurrentTCB, xConstTickCount, xTimeToWake )
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB )       vTestTaskReady( ( pxTCB ), xTickCount )
+#define traceTASK_DELAY()                             vTestBlockPathStart()
+#define traceENTER_xTaskResumeAll()                   vTestBlockPathEnd()
+#define traceENTER_xTaskIncrementTick()               vTestTickPathStart( uxSchedulerSuspended == 0U )
+#define traceRETURN_xTaskIncrementTick( xSwitchRequired )    vTestTickPathEnd()
+
+#include "../FreeRTOSConfig.h"
+
+#endif /* DELAYED_WHEEL_CONFIG_H */
@@ -0,0 +1,432 @@
+/*
+ * Test of the delayed task wheel (configUSE_DELAYED_TASK_WHEEL).
+ *
+ * The tick count starts 4096 ticks before it wraps, and idle time is skipped
+ * with vTaskStepTick(), so delays of millions of ticks pass in moments.
+ *
+ * Worker tasks block with vTaskDelay() and with queue receive timeouts, for
+ * delays within level 0 up to well beyond the 2^20 ticks the four levels
+ * cover directly, while another task aborts some of the waits with
+ * xTaskAbortDelay().  The kernel's trace hooks record the tick at which each
+ * wait is due and the tick at which the task is made ready again.  A task
+ * that times out has to be made ready exactly at the tick it was due, and an
+ * aborted one has to be made ready before that.
+ *
+ * Then 10, 100 and 1000 tasks block in a loop and the time the kernel spends
+ * placing a delaying task (block path, scheduler suspended) and processing a
+ * tick (tick path, interrupts masked) is reported.  The same source is built
+ * with the delayed task lists as delayed_list_test to compare.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+#define CHECK_WORKERS       200
+#define CHECK_WAITS         40      /* per worker */
+#define ABORTER_ROUNDS      2000    /* then the longest waits run to the end */
+#define TIMING_BLOCKS       20000   /* per task count */
+#define WORKER_PRIORITY     2
+#define ABORTER_PRIORITY    3
+#define CONTROL_PRIORITY    4
+#define WATCHDOG_SECONDS    120     /* the test takes about 10 s */
+
+/* What the hooks know about a worker's current wait */
+typedef struct WaitRecord
+{
+    volatile TickType_t xDue;      /* tick at which the wait times out */
+    volatile TickType_t xWait;     /* ticks from the start of the wait to xDue */
+    volatile TickType_t xReady;    /* tick at which the task was made ready */
+    volatile TickType_t xAborted;  /* tick at which the wait was aborted */
+    volatile BaseType_t xWasAborted;
+    volatile BaseType_t xLongWait; /* worth aborting */
+} WaitRecord_t;
+
+typedef struct TimingStats
+{
+    uint64_t ullCount;
+    uint64_t ullTotalNs;
+    uint64_t ullMaxNs;
+} TimingStats_t;
+
+static TaskHandle_t xControlTask;
+static TaskHandle_t xCheckWorkers[ CHECK_WORKERS ];
+static QueueHandle_t xSilentQueue; /* never written, receives on it time out */
+static volatile BaseType_t xChecking;
+static volatile BaseType_t xTiming;
+
+static uint32_t ulEarly, ulLate, ulBadAbort, ulAborts, ulTimeouts, ulLongWaits, ulHalfRangeWaits;
+static TimingStats_t xBlockPath, xTickPath;
+static uint64_t ullBlockStart, ullTickStart;
+static int iTickCounted;
+
+static uint64_t prvNowNs( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( uint64_t ) xNow.tv_sec * 1000000000ULL + ( uint64_t ) xNow.tv_nsec;
+}
+
+static void prvAddTiming( TimingStats_t * pxStats,
+                          uint64_t ullStartNs )
+{
+    uint64_t ullNs = prvNowNs() - ullStartNs;
+
+    pxStats->ullCount++;
+    pxStats->ullTotalNs += ullNs;
+
+    if( ullNs > pxStats->ullMaxNs )
+    {
+        pxStats->ullMaxNs = ullNs;
+    }
+}
+
+static WaitRecord_t * prvRecordOf( void * pvTask )
+{
+    return ( WaitRecord_t * ) pvTaskGetThreadLocalStoragePointer( ( TaskHandle_t ) pvTask, 0 );
+}
+
+/*-----------------------------------------------------------*/
+/* Kernel hooks, see delayed_wheel/FreeRTOSConfig.h */
+
+void vTestSkipIdleTicks( uint32_t ulExpectedIdleTime )
+{
+    /* Called with the scheduler suspended.  Jumping to the wake time leaves
+     * the last tick pending, it is processed when the scheduler resumes. */
+    portDISABLE_INTERRUPTS();
+
+    if( eTaskConfirmSleepModeStatus() == eStandardSleep )
+    {
+        vTaskStepTick( ulExpectedIdleTime );
+    }
+
+    portENABLE_INTERRUPTS();
+}
+
+void vTestTaskDelayed( void * pvTask,
+                       uint32_t ulTickCount,
+                       uint32_t ulTimeToWake )
+{
+    WaitRecord_t * pxRecord = prvRecordOf( pvTask );
+
+    if( pxRecord != NULL )
+    {
+        /* A wait for no time ends at the next tick. */
+        pxRecord->xDue = ( ulTimeToWake == ulTickCount ) ? ulTickCount + 1U : ulTimeToWake;
+        pxRecord->xWait = pxRecord->xDue - ulTickCount;
+        pxRecord->xReady = 0;
+    }
+}
+
+void vTestTaskReady( void * pvTask,
+                     uint32_t ulTickCount )
+{
+    WaitRecord_t * pxRecord = prvRecordOf( pvTask );
+
+    if( pxRecord != NULL )
+    {
+        pxRecord->xReady = ulTickCount;
+    }
+}
+
+void vTestBlockPathStart( void )
+{
+    ullBlockStart = xTiming ? prvNowNs() : 0U;
+}
+
+void vTestBlockPathEnd( void )
+{
+    if( ullBlockStart != 0U )
+    {
+        prvAddTiming( &xBlockPath, ullBlockStart );
+        ullBlockStart = 0U;
+    }
+}
+
+void vTestTickPathStart( int iSchedulerRunning )
+{
+    /* Ticks that arrive while the scheduler is suspended are only counted. */
+    iTickCounted = iSchedulerRunning && xTiming;
+
+    if( iTickCounted )
+    {
+        ullTickStart = prvNowNs();
+    }
+}
+
+void vTestTickPathEnd( void )
+{
+    if( iTickCounted )
+    {
+        prvAddTiming( &xTickPath, ullTickStart );
+        iTickCounted = 0;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/* Mostly short waits, some over several levels and some beyond the range of
+ * the wheel, which are re-placed when its end is reached. */
+static TickType_t prvRandomDelay( void )
+{
+    int iKind = rand() % 100;
+
+    if( iKind < 60 )
+    {
+        return ( TickType_t ) ( 1 + rand() % 64 );
+    }
+    else if( iKind < 85 )
+    {
+        return ( TickType_t ) ( 64 + rand() % 40000 );
+    }
+    else if( iKind < 98 )
+    {
+        return ( TickType_t ) ( ( 1UL << 20 ) + ( uint32_t ) rand() % ( 3UL << 20 ) );
+    }
+    else
+    {
+        /* More than half a turn of the tick count */
+        return ( TickType_t ) ( 0x80000000UL + ( ( uint32_t ) rand() % 0x10000000UL ) );
+    }
+}
+
+/* Checks the wait that just ended against what the hooks recorded. */
+static void prvCheckWait( WaitRecord_t * pxRecord )
+{
+    if( pxRecord->xWasAborted != pdFALSE )
+    {
+        /* Made ready at the abort, which was before the wait was due.  The
+         * tick count wraps and waits can be longer than half its range, so
+         * this is measured from the start of the wait. */
+        if( ( pxRecord->xReady != pxRecord->xAborted ) ||
+            ( ( TickType_t ) ( pxRecord->xReady - ( pxRecord->xDue - pxRecord->xWait ) ) >= pxRecord->xWait ) )
+        {
+            ulBadAbort++;
+        }
+
+        ulAborts++;
+        pxRecord->xWasAborted = pdFALSE;
+    }
+    else if( pxRecord->xReady != pxRecord->xDue )
+    {
+        if( ( TickType_t ) ( pxRecord->xReady - ( pxRecord->xDue - pxRecord->xWait ) ) < pxRecord->xWait )
+        {
+            ulEarly++;
+        }
+        else
+        {
+            ulLate++;
+        }
+
+        printf( "wait due at %lu made ready at %lu\n", ( unsigned long ) pxRecord->xDue, ( unsigned long ) pxRecord->xReady );
+    }
+}
+
+static void prvCheckWorker( void * pvParameters )
+{
+    WaitRecord_t * pxRecord = ( WaitRecord_t * ) pvParameters;
+    TickType_t xDelay;
+    uint32_t ulValue;
+    int iWait;
+
+    for( iWait = 0; iWait < CHECK_WAITS; iWait++ )
+    {
+        xDelay = prvRandomDelay();
+        pxRecord->xLongWait = ( xDelay > 1000U ) ? pdTRUE : pdFALSE;
+
+        if( ( rand() % 4 ) == 0 )
+        {
+            if( xQueueReceive( xSilentQueue, &ulValue, xDelay ) != errQUEUE_EMPTY )
+            {
+                ulBadAbort++;
+            }
+
+            ulTimeouts++;
+        }
+        else
+        {
+            vTaskDelay( xDelay );
+        }
+
+        pxRecord->xLongWait = pdFALSE;
+
+        if( xDelay >= ( 1UL << 20 ) )
+        {
+            ulLongWaits++;
+        }
+
+        if( ( xDelay > 0x7FFFFFFFUL ) && ( pxRecord->xWasAborted == pdFALSE ) )
+        {
+            ulHalfRangeWaits++;
+        }
+
+        prvCheckWait( pxRecord );
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+/* Aborts a random long wait now and then while the workers run, for a while. */
+static void prvAborterTask( void * pvParameters )
+{
+    WaitRecord_t * pxRecords = ( WaitRecord_t * ) pvParameters;
+    TaskHandle_t xWorker;
+    int iWorker, iRound;
+
+    for( iRound = 0; ( iRound < ABORTER_ROUNDS ) && ( xChecking != pdFALSE ); iRound++ )
+    {
+        vTaskDelay( ( TickType_t ) ( 1 + rand() % 5000 ) );
+        iWorker = rand() % CHECK_WORKERS;
+        xWorker = xCheckWorkers[ iWorker ];
+
+        /* Workers run at a lower priority, so one that is blocked stays
+         * blocked until the abort. */
+        if( ( pxRecords[ iWorker ].xLongWait != pdFALSE ) && ( eTaskGetState( xWorker ) == eBlocked ) )
+        {
+            pxRecords[ iWorker ].xWasAborted = pdTRUE;
+            pxRecords[ iWorker ].xAborted = xTaskGetTickCount();
+
+            if( xTaskAbortDelay( xWorker ) == pdFAIL )
+            {
+                pxRecords[ iWorker ].xWasAborted = pdFALSE;
+            }
+        }
+    }
+
+    vTaskDelete( NULL );
+}
+
+static void prvWaitForWorkers( int iWorkers )
+{
+    int iDone = 0;
+
+    while( iDone < iWorkers )
+    {
+        iDone += ( int ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    }
+}
+
+static void prvCheckWakes( void )
+{
+    static WaitRecord_t xRecords[ CHECK_WORKERS ];
+    int iWorker;
+
+    xSilentQueue = xQueueCreate( 1, sizeof( uint32_t ) );
+    configASSERT( xSilentQueue != NULL );
+    xChecking = pdTRUE;
+
+    /* The workers wait for the control task to block before they start. */
+    for( iWorker = 0; iWorker < CHECK_WORKERS; iWorker++ )
+    {
+        xTaskCreate( prvCheckWorker, "Worker", configMINIMAL_STACK_SIZE * 4, &xRecords[ iWorker ], WORKER_PRIORITY, &xCheckWorkers[ iWorker ] );
+        vTaskSetThreadLocalStoragePointer( xCheckWorkers[ iWorker ], 0, &xRecords[ iWorker ] );
+    }
+
+    xTaskCreate( prvAborterTask, "Aborter", configMINIMAL_STACK_SIZE * 4, xRecords, ABORTER_PRIORITY, NULL );
+
+    prvWaitForWorkers( CHECK_WORKERS );
+    xChecking = pdFALSE;
+
+    printf( "wakes: %d waits, %lu queue timeouts, %lu beyond 2^20 ticks, %lu over half the tick range that ran out, %lu aborted\n",
+            CHECK_WORKERS * CHECK_WAITS, ( unsigned long ) ulTimeouts, ( unsigned long ) ulLongWaits,
+            ( unsigned long ) ulHalfRangeWaits, ( unsigned long ) ulAborts );
+    printf( "wakes: %lu early, %lu late, %lu wrong aborts\n",
+            ( unsigned long ) ulEarly, ( unsigned long ) ulLate, ( unsigned long ) ulBadAbort );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvTimingWorker( void * pvParameters )
+{
+    int iBlocks = ( int ) ( intptr_t ) pvParameters;
+    WaitRecord_t xRecord = { 0 };
+
+    vTaskSetThreadLocalStoragePointer( NULL, 0, &xRecord );
+
+    while( iBlocks-- > 0 )
+    {
+        vTaskDelay( ( TickType_t ) ( 1 + rand() % 40000 ) );
+        prvCheckWait( &xRecord );
+    }
+
+    vTaskSetThreadLocalStoragePointer( NULL, 0, NULL );
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+static void prvMeasure( int iTasks )
+{
+    static const TimingStats_t xZero = { 0 };
+    int iTask;
+
+    xBlockPath = xZero;
+    xTickPath = xZero;
+    xTiming = pdTRUE;
+
+    for( iTask = 0; iTask < iTasks; iTask++ )
+    {
+        xTaskCreate( prvTimingWorker, "Timing", configMINIMAL_STACK_SIZE * 4,
+                     ( void * ) ( intptr_t ) ( TIMING_BLOCKS / iTasks ), WORKER_PRIORITY, NULL );
+    }
+
+    prvWaitForWorkers( iTasks );
+    xTiming = pdFALSE;
+
+    printf( "%s %4d tasks: block path %6.0f ns mean %7lu ns max, tick path %6.0f ns mean %7lu ns max\n",
+            ( configUSE_DELAYED_TASK_WHEEL == 1 ) ? "wheel" : "lists", iTasks,
+            ( double ) xBlockPath.ullTotalNs / ( double ) xBlockPath.ullCount, ( unsigned long ) xBlockPath.ullMaxNs,
+            ( double ) xTickPath.ullTotalNs / ( double ) xTickPath.ullCount, ( unsigned long ) xTickPath.ullMaxNs );
+}
+
+static void prvControlTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    prvCheckWakes();
+
+    /* Host times, on the target they scale with the clock but keep their
+     * shape over the task counts. */
+    prvMeasure( 10 );
+    prvMeasure( 100 );
+    prvMeasure( 1000 );
+    printf( "wakes: %lu early, %lu late after the timing runs\n", ( unsigned long ) ulEarly, ( unsigned long ) ulLate );
+    fflush( stdout );
+
+    /* Ends the process from the task, with this many tasks vTaskEndScheduler()
+     * of the POSIX port now and then never returns to main(). */
+    _exit( ( ulEarly + ulLate + ulBadAbort ) ? 1 : 0 );
+}
+
+/* A task that is never woken keeps the test waiting, so it is failed on the
+ * host's clock. */
+static void * prvWatchdog( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    sleep( WATCHDOG_SECONDS );
+    printf( "wakes: still waiting after %d s, %lu early, %lu late so far\n", WATCHDOG_SECONDS,
+            ( unsigned long ) ulEarly, ( unsigned long ) ulLate );
+    fflush( stdout );
+    _exit( 1 );
+
+    return NULL;
+}
+
+int main( void )
+{
+    pthread_t xWatchdog;
+
+    pthread_create( &xWatchdog, NULL, prvWatchdog, NULL );
+    srand( 1 );
+    xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 4, NULL, CONTROL_PRIORITY, &xControlTask );
+    vTaskStartScheduler();
+
+    return 1;
+}
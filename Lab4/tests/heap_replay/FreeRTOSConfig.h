@@ -0,0 +1,16 @@
+/*
+ * Kernel configuration of heap_replay_test: the host test configuration with
+ * the heap of the Lab4 application build, 128 KB and the size classes of
+ * src/FreeRTOSConfig.h.  The allocators are built without the kernel, the
+ * test provides the few kernel functions they call.
+ */
+
+#ifndef HEAP_REPLAY_CONFIG_H
+#define HEAP_REPLAY_CONFIG_H
+
+#define configTOTAL_HEAP_SIZE                   ( 128 * 1024 )
+#define configHEAP_POOL_CLASS_SIZES             32, 64, 128, 256, 1024, 4000
+
+#include "../FreeRTOSConfig.h"
+
+#endif /* HEAP_REPLAY_CONFIG_H */
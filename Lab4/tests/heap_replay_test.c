@@ -0,0 +1,424 @@
+/*
+ * Replay of an allocation trace through heap_pool.c and heap_4.c.
+ *
+ * Both allocators are built into this test with their functions renamed, see
+ * CMakeLists.txt, and with the 128 KB heap and the size classes of the Lab4
+ * application, see heap_replay/FreeRTOSConfig.h.  The trace is made up in
+ * advance from the objects the application creates: tasks with 4000 byte
+ * stacks, semaphores, queues and their storage, small objects and buffers of
+ * odd sizes, most of them short lived and some living for most of the trace.
+ * It is the same for both allocators, an allocation that fails is counted and
+ * its free skipped.
+ *
+ * Each block is filled with a pattern of its own that has to be intact when it
+ * is freed, and has to be aligned.  Once everything is freed the whole heap
+ * has to be available again, in one block.  The fragmentation of the free space
+ * is sampled along the way, and the trace is replayed once more without the
+ * checks to time the allocators.
+ *
+ * The blocks of the host are not those of the RP2040: a block header is 16
+ * bytes instead of 8, so the same heap holds a little less.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define ALLOCATIONS         100000
+#define MAX_LIFETIME        2048    /* in allocations */
+#define PERMANENT_BLOCKS    20
+#define SAMPLE_INTERVAL     1000    /* operations between fragmentation samples */
+
+/* An operation of the trace frees the block if xSize is 0. */
+typedef struct Operation
+{
+    uint32_t ulBlock;
+    uint32_t ulSize;
+} Operation_t;
+
+/* The functions of an allocator under their renamed names */
+typedef struct Allocator
+{
+    const char * pcName;
+    void * ( * pvMalloc )( size_t xWantedSize );
+    void ( * vFree )( void * pv );
+    size_t ( * xGetFreeHeapSize )( void );
+    void ( * vGetHeapStats )( HeapStats_t * pxHeapStats );
+    void ( * vHeapResetState )( void );
+} Allocator_t;
+
+void * pvPoolMalloc( size_t xWantedSize );
+void vPoolFree( void * pv );
+size_t xPoolGetFreeHeapSize( void );
+void vPoolGetHeapStats( HeapStats_t * pxHeapStats );
+void vPoolHeapResetState( void );
+
+void * pvHeap4Malloc( size_t xWantedSize );
+void vHeap4Free( void * pv );
+size_t xHeap4GetFreeHeapSize( void );
+void vHeap4GetHeapStats( HeapStats_t * pxHeapStats );
+void vHeap4HeapResetState( void );
+
+static const Allocator_t xAllocators[] =
+{
+    { "heap_4",    pvHeap4Malloc, vHeap4Free, xHeap4GetFreeHeapSize, vHeap4GetHeapStats, vHeap4HeapResetState },
+    { "heap_pool", pvPoolMalloc,  vPoolFree,  xPoolGetFreeHeapSize,  vPoolGetHeapStats,  vPoolHeapResetState  },
+};
+
+static Operation_t xTrace[ 2 * ALLOCATIONS ];
+static uint32_t ulTraceLength;
+static uint32_t ulBlockSizes[ ALLOCATIONS ];
+static void * pvBlocks[ ALLOCATIONS ];
+static uint32_t ulFailures;
+
+/* The allocators only suspend the scheduler and enter critical sections,
+ * which the replay on a single thread does not need. */
+void vTaskSuspendAll( void )
+{
+}
+
+BaseType_t xTaskResumeAll( void )
+{
+    return pdFALSE;
+}
+
+void vPortEnterCritical( void )
+{
+}
+
+void vPortExitCritical( void )
+{
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( uint32_t ulMin,
+                           uint32_t ulMax )
+{
+    return ulMin + ( uint32_t ) rand() % ( ulMax - ulMin + 1U );
+}
+
+/* Sizes of the Lab4 objects on the RP2040: a TCB with its thread local
+ * storage and notification arrays, a 1000 word stack, a queue structure. */
+#define TCB_SIZE      136U
+#define STACK_SIZE    4000U
+#define QUEUE_SIZE    80U
+
+static uint32_t prvRandomSize( void )
+{
+    int iKind = rand() % 100;
+
+    if( iKind < 30 )
+    {
+        return prvRandom( 4, 32 );          /* strings, small records */
+    }
+    else if( iKind < 50 )
+    {
+        return QUEUE_SIZE;                  /* semaphores and mutexes */
+    }
+    else if( iKind < 70 )
+    {
+        return prvRandom( 33, 256 );        /* queue storage */
+    }
+    else if( iKind < 85 )
+    {
+        return prvRandom( 257, 1024 );      /* message and stream buffers */
+    }
+    else
+    {
+        return prvRandom( 1025, 3000 );     /* buffers of no class */
+    }
+}
+
+static uint32_t prvRandomLifetime( void )
+{
+    int iKind = rand() % 100;
+
+    if( iKind < 70 )
+    {
+        return prvRandom( 1, 16 );
+    }
+    else if( iKind < 97 )
+    {
+        return prvRandom( 16, 256 );
+    }
+    else
+    {
+        return prvRandom( 1024, MAX_LIFETIME );
+    }
+}
+
+/* Allocations are made one after the other, each block is freed a lifetime
+ * of allocations later.  One allocation in twenty is the TCB of a task, its
+ * stack comes next and lives as long.  The first blocks are the tasks and
+ * queues that the application creates at start up, they are freed at the
+ * end. */
+static void prvMakeTrace( void )
+{
+    static int32_t lDueFirst[ ALLOCATIONS + MAX_LIFETIME + 1 ];
+    static int32_t lDueNext[ ALLOCATIONS ];
+    uint32_t ulBlock, ulDue, ulTime, ulLifetime = 0;
+    int32_t lBlock;
+
+    for( ulTime = 0; ulTime <= ALLOCATIONS + MAX_LIFETIME; ulTime++ )
+    {
+        lDueFirst[ ulTime ] = -1;
+    }
+
+    for( ulBlock = 0; ulBlock < ALLOCATIONS; ulBlock++ )
+    {
+        if( ulBlock < PERMANENT_BLOCKS )
+        {
+            ulBlockSizes[ ulBlock ] = ( ulBlock % 2U == 0U ) ? TCB_SIZE : ( ulBlock < 12U ) ? STACK_SIZE : QUEUE_SIZE;
+            ulDue = ALLOCATIONS + MAX_LIFETIME;
+        }
+        else if( ( ( ulBlock % 2U ) == 1U ) && ( ulBlockSizes[ ulBlock - 1U ] == TCB_SIZE ) )
+        {
+            ulBlockSizes[ ulBlock ] = STACK_SIZE;
+            ulDue = ulBlock + ulLifetime;
+        }
+        else
+        {
+            ulBlockSizes[ ulBlock ] = ( ( ulBlock % 2U ) == 0U ) && ( ( rand() % 10 ) == 0 ) ? TCB_SIZE : prvRandomSize();
+            ulLifetime = prvRandomLifetime();
+            ulDue = ulBlock + ulLifetime;
+        }
+
+        lDueNext[ ulBlock ] = lDueFirst[ ulDue ];
+        lDueFirst[ ulDue ] = ( int32_t ) ulBlock;
+    }
+
+    ulTraceLength = 0;
+
+    for( ulTime = 0; ulTime <= ALLOCATIONS + MAX_LIFETIME; ulTime++ )
+    {
+        for( lBlock = lDueFirst[ ulTime ]; lBlock >= 0; lBlock = lDueNext[ lBlock ] )
+        {
+            xTrace[ ulTraceLength ].ulBlock = ( uint32_t ) lBlock;
+            xTrace[ ulTraceLength ].ulSize = 0;
+            ulTraceLength++;
+        }
+
+        if( ulTime < ALLOCATIONS )
+        {
+            xTrace[ ulTraceLength ].ulBlock = ulTime;
+            xTrace[ ulTraceLength ].ulSize = ulBlockSizes[ ulTime ];
+            ulTraceLength++;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvFail( const Allocator_t * pxAllocator,
+                     const char * pcWhat )
+{
+    if( ulFailures++ < 10U )
+    {
+        printf( "%s: %s\n", pxAllocator->pcName, pcWhat );
+    }
+}
+
+static uint8_t prvPattern( uint32_t ulBlock,
+                           uint32_t ulIndex )
+{
+    return ( uint8_t ) ( ( ulBlock * 2654435761U + ulIndex ) >> 8 );
+}
+
+static void prvFill( uint32_t ulBlock )
+{
+    uint8_t * pucBlock = ( uint8_t * ) pvBlocks[ ulBlock ];
+    uint32_t ul;
+
+    for( ul = 0; ul < ulBlockSizes[ ulBlock ]; ul++ )
+    {
+        pucBlock[ ul ] = prvPattern( ulBlock, ul );
+    }
+}
+
+static BaseType_t prvIntact( uint32_t ulBlock )
+{
+    const uint8_t * pucBlock = ( const uint8_t * ) pvBlocks[ ulBlock ];
+    uint32_t ul;
+
+    for( ul = 0; ul < ulBlockSizes[ ulBlock ]; ul++ )
+    {
+        if( pucBlock[ ul ] != prvPattern( ulBlock, ul ) )
+        {
+            return pdFALSE;
+        }
+    }
+
+    return pdTRUE;
+}
+
+/* Replays the trace with the checks, and reports the failed allocations and
+ * how fragmented the free space was. */
+static void prvReplayChecked( const Allocator_t * pxAllocator )
+{
+    HeapStats_t xStats;
+    size_t xInitialFree, xRequested = 0, xPeakRequested = 0;
+    uint32_t ulOperation, ulFailed = 0, ulSamples = 0;
+    double dLargestShare = 0.0, dFreeBlocks = 0.0;
+    const Operation_t * pxOperation;
+    void * pvWhole;
+
+    pxAllocator->vHeapResetState();
+    pxAllocator->vFree( pxAllocator->pvMalloc( 1 ) );
+    xInitialFree = pxAllocator->xGetFreeHeapSize();
+
+    for( ulOperation = 0; ulOperation < ulTraceLength; ulOperation++ )
+    {
+        pxOperation = &xTrace[ ulOperation ];
+
+        if( pxOperation->ulSize != 0U )
+        {
+            pvBlocks[ pxOperation->ulBlock ] = pxAllocator->pvMalloc( pxOperation->ulSize );
+
+            if( pvBlocks[ pxOperation->ulBlock ] == NULL )
+            {
+                ulFailed++;
+            }
+            else if( ( ( uintptr_t ) pvBlocks[ pxOperation->ulBlock ] & portBYTE_ALIGNMENT_MASK ) != 0U )
+            {
+                prvFail( pxAllocator, "block not aligned" );
+            }
+            else
+            {
+                prvFill( pxOperation->ulBlock );
+                xRequested += pxOperation->ulSize;
+                xPeakRequested = configMAX( xPeakRequested, xRequested );
+            }
+        }
+        else if( pvBlocks[ pxOperation->ulBlock ] != NULL )
+        {
+            if( prvIntact( pxOperation->ulBlock ) == pdFALSE )
+            {
+                prvFail( pxAllocator, "block overwritten while in use" );
+            }
+
+            pxAllocator->vFree( pvBlocks[ pxOperation->ulBlock ] );
+            pvBlocks[ pxOperation->ulBlock ] = NULL;
+            xRequested -= ulBlockSizes[ pxOperation->ulBlock ];
+        }
+
+        if( ( ulOperation % SAMPLE_INTERVAL ) == 0U )
+        {
+            pxAllocator->vGetHeapStats( &xStats );
+
+            if( xStats.xAvailableHeapSpaceInBytes != 0U )
+            {
+                dLargestShare += ( double ) xStats.xSizeOfLargestFreeBlockInBytes / ( double ) xStats.xAvailableHeapSpaceInBytes;
+                dFreeBlocks += ( double ) xStats.xNumberOfFreeBlocks;
+                ulSamples++;
+            }
+        }
+    }
+
+    pxAllocator->vGetHeapStats( &xStats );
+
+    printf( "%-9s %lu operations, %lu allocations failed, peak %lu bytes requested, least free %lu of %lu bytes\n",
+            pxAllocator->pcName, ( unsigned long ) ulTraceLength, ( unsigned long ) ulFailed,
+            ( unsigned long ) xPeakRequested, ( unsigned long ) xStats.xMinimumEverFreeBytesRemaining,
+            ( unsigned long ) xInitialFree );
+    printf( "%-9s on average %.1f free blocks, the largest %.0f%% of the free bytes\n", pxAllocator->pcName,
+            dFreeBlocks / ulSamples, 100.0 * dLargestShare / ulSamples );
+
+    if( pxAllocator->xGetFreeHeapSize() != xInitialFree )
+    {
+        prvFail( pxAllocator, "heap not all free at the end" );
+    }
+
+    /* Blocks cached by the size classes have to go back to the heap. */
+    pvWhole = pxAllocator->pvMalloc( xInitialFree - 2U * portBYTE_ALIGNMENT );
+
+    if( pvWhole == NULL )
+    {
+        prvFail( pxAllocator, "free heap not in one block at the end" );
+    }
+
+    pxAllocator->vFree( pvWhole );
+}
+
+static double prvNanoseconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( double ) xNow.tv_sec * 1e9 + ( double ) xNow.tv_nsec;
+}
+
+static void prvReplayTimed( const Allocator_t * pxAllocator )
+{
+    uint32_t ulOperation;
+    const Operation_t * pxOperation;
+    double dStart, dBest = 0.0, dTime;
+    int iRound;
+
+    /* The best of a few rounds, the host is not quiet */
+    for( iRound = 0; iRound < 5; iRound++ )
+    {
+        pxAllocator->vHeapResetState();
+        memset( pvBlocks, 0, sizeof( pvBlocks ) );
+        dStart = prvNanoseconds();
+
+        for( ulOperation = 0; ulOperation < ulTraceLength; ulOperation++ )
+        {
+            pxOperation = &xTrace[ ulOperation ];
+
+            if( pxOperation->ulSize != 0U )
+            {
+                pvBlocks[ pxOperation->ulBlock ] = pxAllocator->pvMalloc( pxOperation->ulSize );
+            }
+            else if( pvBlocks[ pxOperation->ulBlock ] != NULL )
+            {
+                pxAllocator->vFree( pvBlocks[ pxOperation->ulBlock ] );
+            }
+        }
+
+        dTime = ( prvNanoseconds() - dStart ) / ulTraceLength;
+        dBest = ( iRound == 0 ) ? dTime : configMIN( dBest, dTime );
+    }
+
+    printf( "%-9s %.1f ns per operation\n", pxAllocator->pcName, dBest );
+}
+
+static void prvPrintClasses( void )
+{
+    HeapClassStats_t xClassStats[ 7 ];
+    UBaseType_t ux, uxClasses = uxPortGetHeapClassStats( xClassStats, 7 );
+
+    for( ux = 0; ux < uxClasses; ux++ )
+    {
+        printf( "heap_pool class %4lu: %6lu allocations, %4lu of them from the heap\n",
+                ( unsigned long ) xClassStats[ ux ].xRequestSize, ( unsigned long ) xClassStats[ ux ].xNumberOfAllocations,
+                ( unsigned long ) xClassStats[ ux ].xNumberOfCacheMisses );
+    }
+}
+
+int main( void )
+{
+    size_t x;
+
+    srand( 1 );
+    prvMakeTrace();
+
+    for( x = 0; x < sizeof( xAllocators ) / sizeof( xAllocators[ 0 ] ); x++ )
+    {
+        prvReplayChecked( &xAllocators[ x ] );
+    }
+
+    prvPrintClasses();
+
+    for( x = 0; x < sizeof( xAllocators ) / sizeof( xAllocators[ 0 ] ); x++ )
+    {
+        prvReplayTimed( &xAllocators[ x ] );
+    }
+
+    printf( "heap replay: %lu failures\n", ( unsigned long ) ulFailures );
+
+    return ulFailures ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+//
+// Stress test of PublishedState: one writer thread publishes as fast as it
+// can while reader threads check that every copy they get is one complete
+// publish and that the versions they see never go backwards.
+//
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include "PublishedState.h"
+
+static constexpr uint32_t PUBLISHES = 2000000;
+static constexpr int READERS = 3;
+
+// every word holds the same number, a torn copy mixes two publishes
+struct Setting {
+    uint32_t words[15];
+};
+
+static PublishedState<Setting> state(Setting{});
+static std::atomic<bool> done{false};
+
+static void writer() {
+    for (uint32_t n = 1; n <= PUBLISHES; ++n) {
+        Setting s;
+        for (auto &w : s.words) w = n;
+        state.publish(s);
+    }
+    done = true;
+}
+
+static void reader(uint32_t &torn, uint32_t &backwards, uint32_t &reads) {
+    uint32_t last = 0;
+    while (!done) {
+        uint32_t version;
+        Setting s = state.read(&version);
+        for (auto w : s.words) {
+            if (w != s.words[0]) {
+                ++torn;
+                break;
+            }
+        }
+        // publish n is version n
+        if (s.words[0] != version || version < last) ++backwards;
+        last = version;
+        ++reads;
+    }
+}
+
+int main() {
+    uint32_t torn[READERS] = {}, backwards[READERS] = {}, reads[READERS] = {};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < READERS; ++i) {
+        threads.emplace_back(reader, std::ref(torn[i]), std::ref(backwards[i]), std::ref(reads[i]));
+    }
+    threads.emplace_back(writer);
+    for (auto &t : threads) t.join();
+
+    int failures = 0;
+    for (int i = 0; i < READERS; ++i) {
+        printf("reader %d: %u reads, %u torn, %u out of order\n", i, reads[i], torn[i], backwards[i]);
+        failures += torn[i] + backwards[i];
+    }
+    if (state.get_version() != PUBLISHES) {
+        printf("version %u after %u publishes\n", state.get_version(), PUBLISHES);
+        ++failures;
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Simulation of the tickless idle tick accounting of the RP2040 port.
+ *
+ * A simulated 1 MHz timer, started just below the 32-bit wrap, is driven
+ * through random tick interrupts that come in late, sometimes by several
+ * periods, and random sleeps that end either early or at the wake time plus
+ * a latency.  The port's arithmetic from tick_timer.h counts the ticks and
+ * after every event the kernel tick count must equal the whole tick periods
+ * that have passed on the timer, so no tick is lost or counted twice.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "tick_timer.h"
+
+#define COUNTS_PER_TICK    1000U  /* 1 kHz tick */
+#define EVENTS             1000000
+
+static TickTimer_t timer;
+static uint32_t now;            /* simulated timer */
+static uint64_t elapsed;        /* timer counts since the start, without wrap */
+static uint64_t kernelTicks;    /* ticks counted by the simulated kernel */
+static int failures;
+
+static void check( int condition,
+                   const char * what,
+                   int event )
+{
+    if( !condition && ( failures++ < 10 ) )
+    {
+        printf( "event %d: %s (ticks %llu, elapsed %llu)\n", event, what,
+                ( unsigned long long ) kernelTicks, ( unsigned long long ) elapsed );
+    }
+}
+
+static void advance( uint32_t counts )
+{
+    now += counts;
+    elapsed += counts;
+}
+
+static uint32_t randomBelow( uint32_t limit )
+{
+    return ( ( ( uint32_t ) rand() << 16 ) ^ ( uint32_t ) rand() ) % limit;
+}
+
+/* xPortTickAlarmHandler() */
+static void tickInterrupt( int event )
+{
+    kernelTicks += ulTickTimerAdvance( &timer, now, UINT32_MAX );
+
+    check( kernelTicks == elapsed / COUNTS_PER_TICK, "tick count differs from the timer", event );
+    check( ( now - timer.ulLastTickTime ) < COUNTS_PER_TICK, "latest tick is more than a period old", event );
+}
+
+/* vPortSuppressTicksAndSleep() */
+static void sleep( int event )
+{
+    uint32_t expectedIdle = 2 + randomBelow( randomBelow( 10 ) == 0 ? 3000000 : 2000 );
+    uint32_t wakeTime, stepped;
+
+    if( expectedIdle > ulTickTimerMaxSuppressedTicks( &timer ) )
+    {
+        expectedIdle = ulTickTimerMaxSuppressedTicks( &timer );
+    }
+
+    wakeTime = ulTickTimerWakeTime( &timer, expectedIdle );
+    check( ( wakeTime - timer.ulLastTickTime ) <= 0x7fffffffUL, "wake time out of the alarm's reach", event );
+
+    if( randomBelow( 2 ) == 0 )
+    {
+        /* an interrupt ends the sleep early */
+        advance( randomBelow( wakeTime - now ) );
+    }
+    else
+    {
+        /* the alarm ends it, the core takes a while to wake up */
+        advance( ( wakeTime - now ) + randomBelow( 3 * COUNTS_PER_TICK ) );
+    }
+
+    check( xTickTimerReached( now, wakeTime ) == ( ( int32_t ) ( now - wakeTime ) >= 0 ), "reached wrong across wrap", event );
+
+    stepped = ulTickTimerAdvance( &timer, now, expectedIdle );
+    check( stepped <= expectedIdle, "stepped past the expected idle time", event );
+    kernelTicks += stepped;
+    check( kernelTicks <= elapsed / COUNTS_PER_TICK, "stepped over a tick that hasn't passed", event );
+
+    /* a tick that is due fires as soon as interrupts are enabled */
+    if( xTickTimerReached( now, ulTickTimerNextTick( &timer ) ) != 0 )
+    {
+        tickInterrupt( event );
+    }
+}
+
+int main( void )
+{
+    int event;
+    uint32_t wraps = 0, previous;
+
+    srand( 1 );
+    now = 0xffffffffU - 5000U;
+    timer.ulTimerCountsForOneTick = COUNTS_PER_TICK;
+    timer.ulLastTickTime = now;
+
+    for( event = 0; event < EVENTS; event++ )
+    {
+        previous = now;
+
+        if( randomBelow( 4 ) == 0 )
+        {
+            sleep( event );
+        }
+        else
+        {
+            /* the alarm fires at the next tick, the handler runs late, rarely by several periods */
+            advance( ( ulTickTimerNextTick( &timer ) - now ) +
+                     randomBelow( randomBelow( 20 ) == 0 ? 5 * COUNTS_PER_TICK : COUNTS_PER_TICK / 2 ) );
+            tickInterrupt( event );
+        }
+
+        if( now < previous )
+        {
+            wraps++;
+        }
+    }
+
+    printf( "%d events, %llu ticks, timer wrapped %u times, %d failures\n", EVENTS,
+            ( unsigned long long ) kernelTicks, wraps, failures );
+
+    return ( failures == 0 && wraps > 0 ) ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+//
+// Test of WorkPool on host threads standing in for the two cores and their
+// workers, see workpool_stub. Checks that every job runs exactly once, that
+// a burst submitted on a busy core is shared by stealing, that pinned jobs
+// stay on their core and that jobs that don't fit are dropped and counted. Then times
+// formatting bursts of log messages in the pool against formatting them
+// inline, the way debugTask does.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "WorkPool.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "task.h"
+
+static constexpr uint32_t JOBS = 200000;
+static constexpr uint32_t BURST = 16;
+static constexpr int OVERFLOW = 8;
+
+static std::atomic<uint32_t> runs[JOBS];
+static std::atomic<uint32_t> finished{0};
+static std::atomic<uint32_t> wrongCore{0};
+
+static void waitFinished(uint32_t count) {
+    while (finished < count) std::this_thread::yield();
+}
+
+// a little work so that the owner is still busy when the next job comes in
+static void countJob(void *, uint32_t data) {
+    char text[64];
+    snprintf(text, sizeof(text), "job %lu", static_cast<unsigned long>(data));
+    runs[data] += 1;
+    ++finished;
+}
+
+static void pinnedJob(void *arg, uint32_t) {
+    if (get_core_num() != static_cast<unsigned int>(reinterpret_cast<intptr_t>(arg))) ++wrongCore;
+    ++finished;
+}
+
+// runs on worker 0, which is busy until it returns, so its pinned queue fills up
+static std::atomic<int> refused{0};
+static void floodJob(void *, uint32_t) {
+    for (int i = 0; i < WORK_POOL_DEQUE_SIZE + OVERFLOW; ++i) {
+        if (!workSubmit(pinnedJob, reinterpret_cast<void *>(0), 0, 0)) ++refused;
+    }
+    ++finished;
+}
+
+static int checkAllRunOnce() {
+    uint32_t submitted = 0;
+    for (uint32_t n = 0; n < JOBS; n += BURST) {
+        for (uint32_t i = n; i < n + BURST; ++i) {
+            // a full deque drops the job, so it is submitted again once there is room
+            while (!workSubmit(countJob, nullptr, i)) std::this_thread::yield();
+            ++submitted;
+        }
+    }
+    waitFinished(submitted);
+
+    int failures = 0;
+    for (auto &r : runs) {
+        if (r != 1) ++failures;
+    }
+    workStats s0 = workPoolStats(0), s1 = workPoolStats(1);
+    printf("any core: %lu jobs, %d not run once, core 0 ran %lu, core 1 ran %lu\n",
+           static_cast<unsigned long>(JOBS), failures, static_cast<unsigned long>(s0.executed),
+           static_cast<unsigned long>(s1.executed));
+    if (s0.executed + s1.executed != JOBS) ++failures;
+    return failures;
+}
+
+// runs on worker 0 and stays busy until worker 1 took a job of the burst, or gives up after a second
+static void burstJob(void *, uint32_t) {
+    uint32_t stolen = workPoolStats(1).stolen;
+    for (uint32_t i = 0; i < BURST; ++i) {
+        while (!workSubmit(countJob, nullptr, i)) std::this_thread::yield();
+    }
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (workPoolStats(1).stolen == stolen && std::chrono::steady_clock::now() < end) {
+        std::this_thread::yield();
+    }
+    ++finished;
+}
+
+static int checkStealing() {
+    constexpr uint32_t BURSTS = 1000;
+    for (auto &r : runs) r = 0;
+    uint32_t start = finished;
+    uint32_t before = workPoolStats(1).stolen;
+    for (uint32_t n = 0; n < BURSTS; ++n) {
+        while (!workSubmit(burstJob, nullptr, 0, 0)) std::this_thread::yield();
+        waitFinished(start + (n + 1) * (BURST + 1));
+    }
+    uint32_t stolen = workPoolStats(1).stolen - before;
+    printf("busy core: %lu bursts of %lu, %lu jobs stolen by core 1\n", static_cast<unsigned long>(BURSTS),
+           static_cast<unsigned long>(BURST), static_cast<unsigned long>(stolen));
+
+    int failures = 0;
+    for (uint32_t i = 0; i < BURST; ++i) {
+        if (runs[i] != BURSTS) ++failures;
+    }
+    // every burst waits for a steal
+    if (stolen < BURSTS) ++failures;
+    return failures;
+}
+
+static int checkPinned() {
+    uint32_t start = finished;
+    for (int n = 0; n < 1000; ++n) {
+        for (intptr_t core = 0; core < NUM_CORES; ++core) {
+            while (!workSubmit(pinnedJob, reinterpret_cast<void *>(core), 0, static_cast<int>(core))) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    waitFinished(start + 1000 * NUM_CORES);
+    printf("pinned: %lu jobs on the wrong core\n", static_cast<unsigned long>(wrongCore.load()));
+    return wrongCore ? 1 : 0;
+}
+
+static int checkDropped() {
+    uint32_t before = workPoolStats(0).dropped;
+    uint32_t start = finished;
+    while (!workSubmit(floodJob, nullptr, 0, 0)) std::this_thread::yield();
+    waitFinished(start + 1 + WORK_POOL_DEQUE_SIZE);
+    uint32_t dropped = workPoolStats(0).dropped - before;
+    printf("full queue: %d refused, %lu counted as dropped\n", refused.load(), static_cast<unsigned long>(dropped));
+    return refused == OVERFLOW && dropped == OVERFLOW ? 0 : 1;
+}
+
+// same sizes as DebugLog.h
+static constexpr int MESSAGES = 32;
+static constexpr int CHUNK = 8;
+static constexpr int TEXT_SIZE = 64;
+static constexpr int BURSTS = 20000;
+
+static char text[MESSAGES][TEXT_SIZE];
+static std::atomic<uint32_t> chunksDone{0};
+
+static void formatChunk(uint32_t first) {
+    for (uint32_t i = first; i < first + CHUNK; ++i) {
+        snprintf(text[i], TEXT_SIZE, "%lu: button %lu pressed, %lu ms since the last one",
+                 static_cast<unsigned long>(i * 1000), static_cast<unsigned long>(i), static_cast<unsigned long>(i * 7));
+    }
+}
+
+static void formatJob(void *, uint32_t first) {
+    formatChunk(first);
+    ++chunksDone;
+}
+
+static void benchmark() {
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for (int b = 0; b < BURSTS; ++b) {
+        for (uint32_t first = 0; first < MESSAGES; first += CHUNK) formatChunk(first);
+    }
+    double inlineSeconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    start = clock::now();
+    for (int b = 0; b < BURSTS; ++b) {
+        chunksDone = 0;
+        for (uint32_t first = 0; first < MESSAGES; first += CHUNK) {
+            while (!workSubmit(formatJob, nullptr, first)) std::this_thread::yield();
+        }
+        while (chunksDone < MESSAGES / CHUNK) std::this_thread::yield();
+    }
+    double poolSeconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    double messages = static_cast<double>(BURSTS) * MESSAGES;
+    printf("format %d bursts of %d messages: inline %.2f M/s, pool %.2f M/s on %u host cpus\n",
+           BURSTS, MESSAGES, messages / inlineSeconds / 1e6, messages / poolSeconds / 1e6,
+           std::thread::hardware_concurrency());
+}
+
+int main() {
+    // the test itself submits from core 0 like a task would
+    stubSetCore(0);
+    workPoolInit(1);
+
+    int failures = checkAllRunOnce();
+    failures += checkStealing();
+    failures += checkPinned();
+    failures += checkDropped();
+    benchmark();
+
+    fflush(stdout);
+    // the workers never return
+    _Exit(failures ? 1 : 0);
+}
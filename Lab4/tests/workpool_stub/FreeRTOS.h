@@ -0,0 +1,25 @@
+//
+// Stand-in for the kernel, just enough of it for WorkPool.cpp to run on
+// host threads. Each task is a thread and a core is a number the thread
+// carries, see stub.cpp.
+//
+
+#ifndef WORKPOOL_STUB_FREERTOS_H
+#define WORKPOOL_STUB_FREERTOS_H
+
+#include <cassert>
+#include <cstdint>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t configSTACK_DEPTH_TYPE;
+
+#define pdFALSE                  ((BaseType_t) 0)
+#define pdTRUE                   ((BaseType_t) 1)
+#define pdPASS                   pdTRUE
+#define portMAX_DELAY            ((TickType_t) 0xffffffffUL)
+#define configASSERT(x)          assert(x)
+#define configUSE_CORE_AFFINITY  1
+
+#endif //WORKPOOL_STUB_FREERTOS_H
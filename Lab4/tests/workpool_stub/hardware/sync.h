@@ -0,0 +1,40 @@
+//
+// Hardware spin locks and interrupt masking of the RP2040 as used by
+// WorkPool.cpp. A spin lock is an atomic flag, interrupts don't exist on the
+// host so masking them does nothing.
+//
+
+#ifndef WORKPOOL_STUB_HARDWARE_SYNC_H
+#define WORKPOOL_STUB_HARDWARE_SYNC_H
+
+#include <atomic>
+#include <cstdint>
+
+struct spin_lock_t {
+    std::atomic_flag flag;
+};
+
+spin_lock_t *spin_lock_init(unsigned int lock_num);
+int spin_lock_claim_unused(bool required);
+void spin_lock_unsafe_blocking(spin_lock_t *lock);
+void spin_unlock_unsafe(spin_lock_t *lock);
+
+inline uint32_t save_and_disable_interrupts() { return 0; }
+inline void restore_interrupts(uint32_t) {}
+
+inline uint32_t spin_lock_blocking(spin_lock_t *lock) {
+    spin_lock_unsafe_blocking(lock);
+    return 0;
+}
+
+inline void spin_unlock(spin_lock_t *lock, uint32_t) {
+    spin_unlock_unsafe(lock);
+}
+
+inline void __dmb() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+unsigned int get_core_num();
+
+#endif //WORKPOOL_STUB_HARDWARE_SYNC_H
@@ -0,0 +1,10 @@
+//
+// Stand-in for the Pico SDK, see stub.cpp.
+//
+
+#ifndef WORKPOOL_STUB_PICO_STDLIB_H
+#define WORKPOOL_STUB_PICO_STDLIB_H
+
+#define NUM_CORES 2
+
+#endif //WORKPOOL_STUB_PICO_STDLIB_H
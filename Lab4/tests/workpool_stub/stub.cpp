@@ -0,0 +1,85 @@
+//
+// Threads standing in for the tasks and cores of WorkPool.cpp.
+//
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hardware/sync.h"
+
+struct stubTask {
+    std::mutex mutex;
+    std::condition_variable wake;
+    uint32_t count = 0;
+};
+
+static thread_local int core;
+static thread_local stubTask *current;
+
+static spin_lock_t locks[32];
+static std::atomic<int> nextLock{0};
+
+void stubSetCore(int number) {
+    core = number;
+}
+
+unsigned int get_core_num() {
+    return static_cast<unsigned int>(core);
+}
+
+BaseType_t xTaskCreateAffinitySet(TaskFunction_t function, const char *, configSTACK_DEPTH_TYPE, void *parameters,
+                                  UBaseType_t, UBaseType_t coreAffinityMask, TaskHandle_t *createdTask) {
+    auto *task = new stubTask;
+    int number = 0;
+    while (!(coreAffinityMask & (1u << number))) ++number;
+    if (createdTask) *createdTask = task;
+
+    std::thread([=] {
+        core = number;
+        current = task;
+        function(parameters);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> lock(task->mutex);
+        ++task->count;
+    }
+    task->wake.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *) {
+    xTaskNotifyGive(task);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t) {
+    std::unique_lock<std::mutex> lock(current->mutex);
+    current->wake.wait(lock, [] { return current->count > 0; });
+    uint32_t count = current->count;
+    current->count = clearCountOnExit ? 0 : count - 1;
+    return count;
+}
+
+int spin_lock_claim_unused(bool) {
+    return nextLock++;
+}
+
+spin_lock_t *spin_lock_init(unsigned int lock_num) {
+    locks[lock_num].flag.clear();
+    return &locks[lock_num];
+}
+
+void spin_lock_unsafe_blocking(spin_lock_t *lock) {
+    while (lock->flag.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+void spin_unlock_unsafe(spin_lock_t *lock) {
+    lock->flag.clear(std::memory_order_release);
+}
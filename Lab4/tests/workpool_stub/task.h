@@ -0,0 +1,26 @@
+//
+// Task calls used by WorkPool.cpp, implemented with threads in stub.cpp.
+//
+
+#ifndef WORKPOOL_STUB_TASK_H
+#define WORKPOOL_STUB_TASK_H
+
+#include "FreeRTOS.h"
+
+struct stubTask;
+typedef stubTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// runs the task on a new thread that reports the lowest core of the mask as its core
+BaseType_t xTaskCreateAffinitySet(TaskFunction_t function, const char *name, configSTACK_DEPTH_TYPE stackDepth,
+                                  void *parameters, UBaseType_t priority, UBaseType_t coreAffinityMask,
+                                  TaskHandle_t *createdTask);
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait);
+
+// core the calling thread is on, for threads that are not tasks
+void stubSetCore(int core);
+
+#endif //WORKPOOL_STUB_TASK_H
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Convert a Lab4 trace capture to Chrome trace JSON.
+
+The capture is the raw serial output of the board. Text printed by the other
+tasks is skipped, only frames starting with the sync bytes 0x55 0xAA are
+decoded. Open the result in chrome://tracing or https://ui.perfetto.dev.
+
+    python3 trace2chrome.py capture.bin trace.json
+"""
+
+import json
+import struct
+import sys
+
+SYNC = b"\x55\xaa"
+
+# Kept in step with the TRACE_EVENT_ codes in src/TraceRecorder.h
+EVENTS = {
+    1: "switched in",
+    2: "ready",
+    3: "create",
+    4: "delete",
+    5: "delay",
+    6: "delay until",
+    7: "priority inherit",
+    8: "priority disinherit",
+    9: "queue send",
+    10: "queue send failed",
+    11: "queue receive",
+    12: "queue receive failed",
+    13: "queue send from ISR",
+    14: "queue receive from ISR",
+    15: "queue block send",
+    16: "queue block receive",
+    17: "group set bits",
+    18: "group set bits from ISR",
+    19: "group wait block",
+    20: "group wait end",
+    21: "notify",
+    22: "notify from ISR",
+    23: "notify block",
+}
+SWITCHED_IN = 1
+
+# payload length of each frame type
+FRAMES = {b"H": 16, b"N": 20, b"R": 17, b"D": 5, b"E": 0}
+
+
+def frames(data):
+    """Yield (type, payload) for each frame in the capture."""
+    i = data.find(SYNC)
+    while i >= 0 and i + 3 <= len(data):
+        kind = data[i + 2:i + 3]
+        length = FRAMES.get(kind)
+        if length is None or i + 3 + length > len(data):
+            i = data.find(SYNC, i + 1)
+            continue
+        yield kind, data[i + 3:i + 3 + length]
+        i = data.find(SYNC, i + 3 + length)
+
+
+class Clock:
+    """Extends the 32-bit microsecond timestamps of one core."""
+
+    def __init__(self):
+        self.last = None
+        self.high = 0
+
+    def extend(self, stamp):
+        if self.last is not None and stamp < self.last and self.last - stamp > 0x80000000:
+            self.high += 1 << 32
+        self.last = stamp
+        return self.high + stamp
+
+
+def convert(data):
+    names = {}
+    records = []
+    dropped = {}
+    header = None
+
+    for kind, payload in frames(data):
+        if kind == b"H":
+            header = struct.unpack("<4I", payload)
+        elif kind == b"N":
+            handle, = struct.unpack_from("<I", payload)
+            names[handle] = payload[4:].split(b"\0", 1)[0].decode("ascii", "replace")
+        elif kind == b"R":
+            records.append((payload[0],) + struct.unpack_from("<4I", payload, 1))
+        elif kind == b"D":
+            dropped[payload[0]] = struct.unpack_from("<I", payload, 1)[0]
+
+    def name(handle):
+        if handle == 0:
+            return "-"
+        return names.get(handle, "0x%08x" % handle)
+
+    clocks = {}
+    events = []
+    running = {}  # core -> (task, start)
+    for core, stamp, task, obj, info in records:
+        clock = clocks.setdefault(core, Clock())
+        ts = clock.extend(stamp)
+        code = info >> 24
+        value = info & 0xFFFFFF
+
+        if code == SWITCHED_IN:
+            previous = running.get(core)
+            if previous is not None:
+                events.append({"name": name(previous[0]), "ph": "X", "pid": 0, "tid": core,
+                               "ts": previous[1], "dur": ts - previous[1]})
+            running[core] = (obj, ts)
+            continue
+
+        events.append({"name": EVENTS.get(code, "event %d" % code), "ph": "i", "s": "t",
+                       "pid": 0, "tid": core, "ts": ts,
+                       "args": {"task": name(task), "object": name(obj), "value": value}})
+
+    for core in sorted(clocks):
+        events.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": core,
+                       "args": {"name": "Core %d" % core}})
+
+    if header is not None:
+        version, overhead, ring_size, cores = header
+        print("format %d, %d cores, %d records per core, %d ns per record"
+              % (version, cores, ring_size, overhead), file=sys.stderr)
+    for core, count in sorted(dropped.items()):
+        print("core %d dropped %d records" % (core, count), file=sys.stderr)
+    print("%d records" % len(records), file=sys.stderr)
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip(), file=sys.stderr)
+        sys.exit(1)
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    with open(sys.argv[2], "w") as f:
+        json.dump(convert(data), f)
+
+
+if __name__ == "__main__":
+    main()
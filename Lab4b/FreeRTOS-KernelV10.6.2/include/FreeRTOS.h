@@ -619,6 +619,46 @@
     #define traceQUEUE_PEEK_FROM_ISR_FAILED( pxQueue )
 #endif
 
+#ifndef traceQUEUE_SEND_MULTIPLE
+    #define traceQUEUE_SEND_MULTIPLE( pxQueue, uxCount )    traceQUEUE_SEND( pxQueue )
+#endif
+
+#ifndef traceQUEUE_SEND_MULTIPLE_FROM_ISR
+    #define traceQUEUE_SEND_MULTIPLE_FROM_ISR( pxQueue, uxCount )    traceQUEUE_SEND_FROM_ISR( pxQueue )
+#endif
+
+#ifndef traceQUEUE_RECEIVE_MULTIPLE
+    #define traceQUEUE_RECEIVE_MULTIPLE( pxQueue, uxCount )    traceQUEUE_RECEIVE( pxQueue )
+#endif
+
+#ifndef traceQUEUE_RECEIVE_MULTIPLE_FROM_ISR
+    #define traceQUEUE_RECEIVE_MULTIPLE_FROM_ISR( pxQueue, uxCount )    traceQUEUE_RECEIVE_FROM_ISR( pxQueue )
+#endif
+
+#ifndef traceQUEUE_RESERVE
+    #define traceQUEUE_RESERVE( pxQueue )
+#endif
+
+#ifndef traceQUEUE_RESERVE_FAILED
+    #define traceQUEUE_RESERVE_FAILED( pxQueue )    traceQUEUE_SEND_FAILED( pxQueue )
+#endif
+
+#ifndef traceQUEUE_COMMIT
+    #define traceQUEUE_COMMIT( pxQueue )    traceQUEUE_SEND( pxQueue )
+#endif
+
+#ifndef traceQUEUE_PEEK_IN_PLACE
+    #define traceQUEUE_PEEK_IN_PLACE( pxQueue )    traceQUEUE_PEEK( pxQueue )
+#endif
+
+#ifndef traceQUEUE_PEEK_IN_PLACE_FAILED
+    #define traceQUEUE_PEEK_IN_PLACE_FAILED( pxQueue )    traceQUEUE_PEEK_FAILED( pxQueue )
+#endif
+
+#ifndef traceQUEUE_RELEASE
+    #define traceQUEUE_RELEASE( pxQueue )    traceQUEUE_RECEIVE( pxQueue )
+#endif
+
 #ifndef traceQUEUE_DELETE
     #define traceQUEUE_DELETE( pxQueue )
 #endif
@@ -827,6 +867,50 @@
     #define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceSPSC_QUEUE_CREATE
+    #define traceSPSC_QUEUE_CREATE( pxQueue )
+#endif
+
+#ifndef traceSPSC_QUEUE_CREATE_FAILED
+    #define traceSPSC_QUEUE_CREATE_FAILED()
+#endif
+
+#ifndef traceSPSC_QUEUE_DELETE
+    #define traceSPSC_QUEUE_DELETE( xQueue )
+#endif
+
+#ifndef traceBLOCKING_ON_SPSC_QUEUE_SEND
+    #define traceBLOCKING_ON_SPSC_QUEUE_SEND( xQueue )
+#endif
+
+#ifndef traceSPSC_QUEUE_SEND
+    #define traceSPSC_QUEUE_SEND( xQueue )
+#endif
+
+#ifndef traceSPSC_QUEUE_SEND_FAILED
+    #define traceSPSC_QUEUE_SEND_FAILED( xQueue )
+#endif
+
+#ifndef traceSPSC_QUEUE_SEND_FROM_ISR
+    #define traceSPSC_QUEUE_SEND_FROM_ISR( xQueue )
+#endif
+
+#ifndef traceBLOCKING_ON_SPSC_QUEUE_RECEIVE
+    #define traceBLOCKING_ON_SPSC_QUEUE_RECEIVE( xQueue )
+#endif
+
+#ifndef traceSPSC_QUEUE_RECEIVE
+    #define traceSPSC_QUEUE_RECEIVE( xQueue )
+#endif
+
+#ifndef traceSPSC_QUEUE_RECEIVE_FAILED
+    #define traceSPSC_QUEUE_RECEIVE_FAILED( xQueue )
+#endif
+
+#ifndef traceSPSC_QUEUE_RECEIVE_FROM_ISR
+    #define traceSPSC_QUEUE_RECEIVE_FROM_ISR( xQueue )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
     #define configGENERATE_RUN_TIME_STATS    0
 #endif
@@ -893,6 +977,14 @@
     #define configUSE_QUEUE_SETS    0
 #endif
 
+/* Set configUSE_QUEUE_ZERO_COPY to 1 to include pvQueueReserve(),
+ * vQueueCommit(), pvQueuePeekInPlace() and vQueueRelease(), which let tasks
+ * build and read queue items in the queue storage area instead of copying
+ * them in and out. */
+#ifndef configUSE_QUEUE_ZERO_COPY
+    #define configUSE_QUEUE_ZERO_COPY    0
+#endif
+
 #ifndef portTASK_USES_FLOATING_POINT
     #define portTASK_USES_FLOATING_POINT()
 #endif
@@ -1363,6 +1455,10 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
     #endif
+
+    #if ( configUSE_QUEUE_ZERO_COPY == 1 )
+        uint8_t ucDummy10[ 2 ];
+    #endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
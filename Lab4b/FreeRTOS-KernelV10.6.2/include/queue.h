@@ -1447,6 +1447,333 @@ BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
                                  void * const pvBuffer,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendMultiple(
+ *                                QueueHandle_t xQueue,
+ *                                const void * const pvItemsToQueue,
+ *                                const UBaseType_t uxItemCount,
+ *                                TickType_t xTicksToWait
+ *                           );
+ * @endcode
+ *
+ * Post uxItemCount items, stored next to each other in pvItemsToQueue, to the
+ * back of a queue.  Each time there is room the items that fit are copied in
+ * one critical section, with at most two memcpy() calls, and the tasks
+ * waiting to receive are unblocked once for the whole batch.  The result is
+ * the same as calling xQueueSendToBack() for each item, the order of the items
+ * is kept.
+ *
+ * Can not be used with semaphores or mutexes.  This function must not be
+ * called from an interrupt service routine.  See xQueueSendMultipleFromISR()
+ * for an alternative which may be used in an ISR.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items, each the
+ * size defined when the queue was created.
+ *
+ * @param uxItemCount The number of items to post.  It can be larger than the
+ * queue length, the items are then posted as the receivers make room.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for room for all of the items.  The call will return immediately
+ * after posting the items that fit if this is set to 0.
+ *
+ * @return The number of items posted, uxItemCount unless the block time
+ * expired first.
+ *
+ * Example usage:
+ * @code{c}
+ * struct AMessage xMessages[ 4 ];
+ *
+ * void vATask( void *pvParameters )
+ * {
+ * QueueHandle_t xQueue;
+ *
+ *  xQueue = xQueueCreate( 10, sizeof( struct AMessage ) );
+ *
+ *  // ... Fill in xMessages.
+ *
+ *  // Post all four messages, blocking for up to 10 ticks for room.
+ *  if( xQueueSendMultiple( xQueue, xMessages, 4, ( TickType_t ) 10 ) != 4 )
+ *  {
+ *      // Some messages were not posted.
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueSendMultiple xQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultiple( QueueHandle_t xQueue,
+                               const void * const pvItemsToQueue,
+                               const UBaseType_t uxItemCount,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueSendMultipleFromISR(
+ *                                       QueueHandle_t xQueue,
+ *                                       const void * const pvItemsToQueue,
+ *                                       const UBaseType_t uxItemCount,
+ *                                       BaseType_t * const pxHigherPriorityTaskWoken
+ *                                  );
+ * @endcode
+ *
+ * Version of xQueueSendMultiple() that can be used in an interrupt service
+ * routine.  The items that fit are posted, the rest are not.
+ *
+ * @param xQueue The handle to the queue on which the items are to be posted.
+ *
+ * @param pvItemsToQueue A pointer to an array of uxItemCount items.
+ *
+ * @param uxItemCount The number of items to post.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueSendMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if posting the items unblocked a task
+ * with a priority higher than the currently running task.  A context switch
+ * should then be requested before the interrupt is exited.
+ *
+ * @return The number of items posted.
+ *
+ * \defgroup xQueueSendMultipleFromISR xQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                      const void * const pvItemsToQueue,
+                                      const UBaseType_t uxItemCount,
+                                      BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueReceiveMultiple(
+ *                                   QueueHandle_t xQueue,
+ *                                   void * const pvBuffer,
+ *                                   const UBaseType_t uxMaxItems,
+ *                                   TickType_t xTicksToWait
+ *                              );
+ * @endcode
+ *
+ * Receive up to uxMaxItems items from a queue in one critical section.  The
+ * task blocks only while the queue is empty, once any items are available
+ * they are all taken, up to uxMaxItems, and the tasks waiting to send are
+ * unblocked once for the whole batch.
+ *
+ * Can not be used with semaphores or mutexes.  This function must not be
+ * used in an interrupt service routine.  See xQueueReceiveMultipleFromISR()
+ * for an alternative that can.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to an array of at least uxMaxItems items into which
+ * the received items are copied, oldest first.
+ *
+ * @param uxMaxItems The most items to receive, must not be 0.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item should the queue be empty at the time of the call.
+ *
+ * @return The number of items received, 0 if the block time expired with the
+ * queue empty.
+ *
+ * Example usage:
+ * @code{c}
+ * void vADifferentTask( void *pvParameters )
+ * {
+ * struct AMessage xRxedMessages[ 8 ];
+ * BaseType_t x, xReceived;
+ *
+ *  for( ;; )
+ *  {
+ *      xReceived = xQueueReceiveMultiple( xQueue, xRxedMessages, 8, portMAX_DELAY );
+ *
+ *      for( x = 0; x < xReceived; x++ )
+ *      {
+ *          // Process xRxedMessages[ x ].
+ *      }
+ *  }
+ * }
+ * @endcode
+ * \defgroup xQueueReceiveMultiple xQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultiple( QueueHandle_t xQueue,
+                                  void * const pvBuffer,
+                                  const UBaseType_t uxMaxItems,
+                                  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * BaseType_t xQueueReceiveMultipleFromISR(
+ *                                          QueueHandle_t xQueue,
+ *                                          void * const pvBuffer,
+ *                                          const UBaseType_t uxMaxItems,
+ *                                          BaseType_t * const pxHigherPriorityTaskWoken
+ *                                     );
+ * @endcode
+ *
+ * Version of xQueueReceiveMultiple() that can be used in an interrupt service
+ * routine.
+ *
+ * @param xQueue The handle to the queue from which the items are to be
+ * received.
+ *
+ * @param pvBuffer Pointer to an array of at least uxMaxItems items.
+ *
+ * @param uxMaxItems The most items to receive.
+ *
+ * @param pxHigherPriorityTaskWoken xQueueReceiveMultipleFromISR() will set
+ * *pxHigherPriorityTaskWoken to pdTRUE if making room unblocked a task with a
+ * priority higher than the currently running task.
+ *
+ * @return The number of items received, 0 if the queue was empty.
+ *
+ * \defgroup xQueueReceiveMultipleFromISR xQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+BaseType_t xQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                         void * const pvBuffer,
+                                         const UBaseType_t uxMaxItems,
+                                         BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * void * pvQueueReserve( QueueHandle_t xQueue, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Reserve the next free slot at the back of a queue so an item can be built
+ * directly in the queue storage area, then post it with vQueueCommit().
+ * Together they replace xQueueSendToBack() for large items, which would
+ * otherwise be built in a local variable and copied into the queue.
+ *
+ * configUSE_QUEUE_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Only one slot of a queue can be reserved at a time, a task that calls
+ * pvQueueReserve() while another item is being built waits as if the queue
+ * was full.  Items are posted in the order they were reserved.  While a slot
+ * is reserved the queue must not be written by any other function, so a
+ * queue should be written either only with pvQueueReserve()/vQueueCommit()
+ * or only with the other send functions.  Keep the time between reserve and
+ * commit short, other writers wait for it.
+ *
+ * This function must not be called from an interrupt service routine.
+ *
+ * @param xQueue The handle to the queue on which the item is to be posted.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for a free slot.
+ *
+ * @return A pointer to the reserved slot, uxItemSize bytes, or NULL if no
+ * slot became free within the block time.
+ *
+ * Example usage:
+ * @code{c}
+ * void vATask( void *pvParameters )
+ * {
+ * struct AMessage *pxMessage;
+ *
+ *  pxMessage = ( struct AMessage * ) pvQueueReserve( xQueue, portMAX_DELAY );
+ *  pxMessage->ucMessageID = 1;
+ *  // ... Fill in the rest of the message.
+ *  vQueueCommit( xQueue );
+ * }
+ * @endcode
+ * \defgroup pvQueueReserve pvQueueReserve
+ * \ingroup QueueManagement
+ */
+void * pvQueueReserve( QueueHandle_t xQueue,
+                       TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueCommit( QueueHandle_t xQueue );
+ * @endcode
+ *
+ * Post the item built in the slot returned by pvQueueReserve().  Tasks
+ * waiting to receive are unblocked as by xQueueSendToBack().  The slot must
+ * not be written after this call.
+ *
+ * @param xQueue The handle to the queue with the reserved slot.
+ *
+ * \defgroup vQueueCommit vQueueCommit
+ * \ingroup QueueManagement
+ */
+void vQueueCommit( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * const void * pvQueuePeekInPlace( QueueHandle_t xQueue, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Get a pointer to the oldest item of a queue without copying it out.  The
+ * item stays in the queue, and its slot is not reused, until vQueueRelease()
+ * removes it.  Together they replace xQueueReceive() for large items.
+ *
+ * configUSE_QUEUE_ZERO_COPY must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Only one item of a queue can be peeked in place at a time, and while it is
+ * the queue must not be read by any other function.  Use it on queues with a
+ * single reading task.
+ *
+ * This function must not be called from an interrupt service routine.
+ *
+ * @param xQueue The handle to the queue from which the item is to be read.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item should the queue be empty.
+ *
+ * @return A pointer to the oldest item, or NULL if the queue stayed empty
+ * for the block time.
+ *
+ * Example usage:
+ * @code{c}
+ * void vADifferentTask( void *pvParameters )
+ * {
+ * const struct AMessage *pxMessage;
+ *
+ *  for( ;; )
+ *  {
+ *      pxMessage = ( const struct AMessage * ) pvQueuePeekInPlace( xQueue, portMAX_DELAY );
+ *
+ *      // ... Process the message where it is.
+ *
+ *      vQueueRelease( xQueue );
+ *  }
+ * }
+ * @endcode
+ * \defgroup pvQueuePeekInPlace pvQueuePeekInPlace
+ * \ingroup QueueManagement
+ */
+const void * pvQueuePeekInPlace( QueueHandle_t xQueue,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueRelease( QueueHandle_t xQueue );
+ * @endcode
+ *
+ * Remove the item returned by pvQueuePeekInPlace() from the queue.  Tasks
+ * waiting to send are unblocked as by xQueueReceive().  The item must not be
+ * accessed after this call.
+ *
+ * @param xQueue The handle to the queue with the peeked item.
+ *
+ * \defgroup vQueueRelease vQueueRelease
+ * \ingroup QueueManagement
+ */
+void vQueueRelease( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
 /*
  * Utilities to query queues that are safe to use from an ISR.  These utilities
  * should be used only from within an ISR, or within a critical section.
@@ -0,0 +1,301 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/*
+ * SPSC queues pass fixed size items by copy from one task or interrupt (the
+ * sender) to one other task or interrupt (the receiver), in FIFO order.
+ *
+ * Unlike queues created with xQueueCreate(), sending and receiving do not
+ * enter a critical section.  The sender only writes the write index and the
+ * receiver only writes the read index, so an item is added or removed with a
+ * memcpy() and an index update.  The kernel is only entered when a task has
+ * to block because the queue is full or empty, and by the other side when it
+ * finds that task waiting and has to unblock it.
+ *
+ * ***NOTE***:  As with stream buffers, it is not safe to have more than one
+ * sender or more than one receiver.  If there are multiple senders or
+ * receivers use a queue created with xQueueCreate() instead.
+ *
+ * A blocked task waits on its direct to task notification, as tasks blocked
+ * on a stream buffer do, so the sender and receiver tasks must not use
+ * xTaskNotifyWait() or ulTaskNotifyTake() for another purpose while they can
+ * block on the queue.
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h must appear in source files before include spsc_queue.h"
+#endif
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Type by which SPSC queues are referenced.  For example, a call to
+ * xSpscQueueCreate() returns an SpscQueueHandle_t variable that can then be
+ * used as a parameter to xSpscQueueSend(), xSpscQueueReceive(), etc.
+ */
+struct SpscQueueDefinition;
+typedef struct SpscQueueDefinition * SpscQueueHandle_t;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * SpscQueueHandle_t xSpscQueueCreate( UBaseType_t uxQueueLength, UBaseType_t uxItemSize );
+ * @endcode
+ *
+ * Creates a new SPSC queue and returns a handle by which it can be referenced.
+ * The queue structure and its storage area are allocated in one call to
+ * pvPortMalloc().
+ *
+ * configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 or left undefined in
+ * FreeRTOSConfig.h for xSpscQueueCreate() to be available.
+ *
+ * @param uxQueueLength The maximum number of items the queue can hold at any
+ * one time.
+ *
+ * @param uxItemSize The size, in bytes, of each item.  Must not be 0.
+ *
+ * @return If the queue is created successfully then a handle to the queue is
+ * returned.  If the memory required could not be allocated then NULL is
+ * returned.
+ *
+ * Example use:
+ * @code{c}
+ * struct AMessage
+ * {
+ *  char ucMessageID;
+ *  char ucData[ 20 ];
+ * };
+ *
+ * void vATask( void *pvParameters )
+ * {
+ * SpscQueueHandle_t xQueue;
+ *
+ *  // Create a queue capable of containing 10 AMessage structures, for one
+ *  // sender and one receiver.
+ *  xQueue = xSpscQueueCreate( 10, sizeof( struct AMessage ) );
+ *
+ *  if( xQueue == NULL )
+ *  {
+ *      // There was not enough heap memory space available to create the
+ *      // queue.
+ *  }
+ * }
+ * @endcode
+ * \defgroup xSpscQueueCreate xSpscQueueCreate
+ * \ingroup SpscQueueManagement
+ */
+SpscQueueHandle_t xSpscQueueCreate( const UBaseType_t uxQueueLength,
+                                    const UBaseType_t uxItemSize ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * void vSpscQueueDelete( SpscQueueHandle_t xQueue );
+ * @endcode
+ *
+ * Deletes an SPSC queue that was created with xSpscQueueCreate().  No task may
+ * be blocked on the queue when it is deleted.
+ *
+ * @param xQueue The handle of the queue to be deleted.
+ *
+ * \defgroup vSpscQueueDelete vSpscQueueDelete
+ * \ingroup SpscQueueManagement
+ */
+void vSpscQueueDelete( SpscQueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSpscQueueSend( SpscQueueHandle_t xQueue,
+ *                            const void * pvItemToQueue,
+ *                            TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Posts an item to the back of an SPSC queue.  If the receiver is blocked
+ * waiting for an item it is unblocked.
+ *
+ * ***NOTE***:  Only one task or interrupt may send to a given SPSC queue.  Use
+ * xSpscQueueSendFromISR() to send from an interrupt service routine.
+ *
+ * @param xQueue The handle of the queue to which the item is posted.
+ *
+ * @param pvItemToQueue A pointer to the item to copy into the queue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in
+ * the Blocked state to wait for space in the queue.  The call returns
+ * immediately if the queue is full and xTicksToWait is 0.
+ *
+ * @return pdPASS if the item was posted, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xSpscQueueSend xSpscQueueSend
+ * \ingroup SpscQueueManagement
+ */
+BaseType_t xSpscQueueSend( SpscQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSpscQueueSendFromISR( SpscQueueHandle_t xQueue,
+ *                                   const void * pvItemToQueue,
+ *                                   BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Interrupt safe version of xSpscQueueSend().  The item is dropped if the
+ * queue is full.
+ *
+ * @param xQueue The handle of the queue to which the item is posted.
+ *
+ * @param pvItemToQueue A pointer to the item to copy into the queue.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if posting the item
+ * unblocked a receiver with a priority above the interrupted task.  A context
+ * switch should then be requested before the interrupt is exited.
+ *
+ * @return pdPASS if the item was posted, otherwise errQUEUE_FULL.
+ *
+ * \defgroup xSpscQueueSendFromISR xSpscQueueSendFromISR
+ * \ingroup SpscQueueManagement
+ */
+BaseType_t xSpscQueueSendFromISR( SpscQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSpscQueueReceive( SpscQueueHandle_t xQueue,
+ *                               void * pvBuffer,
+ *                               TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Receives the oldest item from an SPSC queue.  If the sender is blocked
+ * waiting for space it is unblocked.
+ *
+ * ***NOTE***:  Only one task or interrupt may receive from a given SPSC queue.
+ * Use xSpscQueueReceiveFromISR() to receive in an interrupt service routine.
+ *
+ * @param xQueue The handle of the queue from which the item is received.
+ *
+ * @param pvBuffer A pointer to the buffer into which the item is copied.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in
+ * the Blocked state to wait for an item.  The call returns immediately if the
+ * queue is empty and xTicksToWait is 0.
+ *
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ *
+ * Example use:
+ * @code{c}
+ * void vAReceivingTask( void *pvParameters )
+ * {
+ * struct AMessage xMessage;
+ *
+ *  for( ;; )
+ *  {
+ *      if( xSpscQueueReceive( xQueue, &xMessage, portMAX_DELAY ) == pdPASS )
+ *      {
+ *          // Process xMessage.
+ *      }
+ *  }
+ * }
+ * @endcode
+ * \defgroup xSpscQueueReceive xSpscQueueReceive
+ * \ingroup SpscQueueManagement
+ */
+BaseType_t xSpscQueueReceive( SpscQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * BaseType_t xSpscQueueReceiveFromISR( SpscQueueHandle_t xQueue,
+ *                                      void * pvBuffer,
+ *                                      BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Interrupt safe version of xSpscQueueReceive().
+ *
+ * @param xQueue The handle of the queue from which the item is received.
+ *
+ * @param pvBuffer A pointer to the buffer into which the item is copied.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if making space unblocked a
+ * sender with a priority above the interrupted task.
+ *
+ * @return pdPASS if an item was received, otherwise errQUEUE_EMPTY.
+ *
+ * \defgroup xSpscQueueReceiveFromISR xSpscQueueReceiveFromISR
+ * \ingroup SpscQueueManagement
+ */
+BaseType_t xSpscQueueReceiveFromISR( SpscQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * spsc_queue.h
+ *
+ * @code{c}
+ * UBaseType_t uxSpscQueueMessagesWaiting( SpscQueueHandle_t xQueue );
+ * @endcode
+ *
+ * Returns the number of items in an SPSC queue.  Can be called from the
+ * sender, the receiver or an interrupt, the value may be out of date by the
+ * time it is used if the other side is active.
+ *
+ * @param xQueue The handle of the queue being queried.
+ *
+ * @return The number of items in the queue.
+ *
+ * \defgroup uxSpscQueueMessagesWaiting uxSpscQueueMessagesWaiting
+ * \ingroup SpscQueueManagement
+ */
+UBaseType_t uxSpscQueueMessagesWaiting( SpscQueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* !defined( SPSC_QUEUE_H ) */
@@ -0,0 +1,463 @@
+/*
+ * FreeRTOS Kernel V10.6.2
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "spsc_queue.h"
+
+#if ( configUSE_TASK_NOTIFICATIONS != 1 )
+    #error configUSE_TASK_NOTIFICATIONS must be set to 1 to build spsc_queue.c
+#endif
+
+#if ( INCLUDE_xTaskGetCurrentTaskHandle != 1 )
+    #error INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 to build spsc_queue.c
+#endif
+
+/* Lint e961, e9021 and e750 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021. */
+
+/* The index of the slot after uxIndex.  A compare is used rather than a
+ * modulo as the Cortex-M0+ has no divide instruction. */
+#define spscNEXT_INDEX( pxQueue, uxIndex ) \
+    ( ( ( ( uxIndex ) + ( UBaseType_t ) 1 ) == ( pxQueue )->uxSlots ) ? ( UBaseType_t ) 0 : ( ( uxIndex ) + ( UBaseType_t ) 1 ) )
+
+/* Unblocks the task waiting on the other side of the queue, if there is one.
+ * The handle is read before the scheduler is suspended so the common case,
+ * no task waiting, does not enter the kernel.  It is read again with the
+ * scheduler suspended as the waiting task may have timed out in between. */
+#define spscUNBLOCK_WAITING_TASK( xWaitingTask )                 \
+    do {                                                         \
+        if( ( xWaitingTask ) != NULL )                           \
+        {                                                        \
+            vTaskSuspendAll();                                   \
+            {                                                    \
+                if( ( xWaitingTask ) != NULL )                   \
+                {                                                \
+                    ( void ) xTaskNotify( ( xWaitingTask ),      \
+                                         ( uint32_t ) 0,         \
+                                         eNoAction );            \
+                    ( xWaitingTask ) = NULL;                     \
+                }                                                \
+            }                                                    \
+            ( void ) xTaskResumeAll();                           \
+        }                                                        \
+    } while( 0 )
+
+#define spscUNBLOCK_WAITING_TASK_FROM_ISR( xWaitingTask, pxHigherPriorityTaskWoken ) \
+    do {                                                                             \
+        if( ( xWaitingTask ) != NULL )                                               \
+        {                                                                            \
+            UBaseType_t uxSavedInterruptStatus;                                      \
+                                                                                     \
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();              \
+            {                                                                        \
+                if( ( xWaitingTask ) != NULL )                                       \
+                {                                                                    \
+                    ( void ) xTaskNotifyFromISR( ( xWaitingTask ),                   \
+                                                 ( uint32_t ) 0,                     \
+                                                 eNoAction,                          \
+                                                 ( pxHigherPriorityTaskWoken ) );    \
+                    ( xWaitingTask ) = NULL;                                         \
+                }                                                                    \
+            }                                                                        \
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );             \
+        }                                                                            \
+    } while( 0 )
+
+/*-----------------------------------------------------------*/
+
+/* Structure that hold state information on the queue. */
+typedef struct SpscQueueDefinition
+{
+    volatile UBaseType_t uxReadIndex;            /**< Index of the oldest item, only written by the receiver. */
+    volatile UBaseType_t uxWriteIndex;           /**< Index of the slot the next item goes to, only written by the sender. */
+    UBaseType_t uxSlots;                         /**< One more than the queue length, one slot is always free so a full queue can be told from an empty one. */
+    UBaseType_t uxItemSize;                      /**< The size of each item in bytes. */
+    volatile TaskHandle_t xTaskWaitingToReceive; /**< Holds the handle of a receiver blocked on an empty queue, otherwise NULL. */
+    volatile TaskHandle_t xTaskWaitingToSend;    /**< Holds the handle of a sender blocked on a full queue, otherwise NULL. */
+    uint8_t * pucStorage;                        /**< Points to the storage area, uxSlots items. */
+} SpscQueue_t;
+
+/*
+ * Copies the item into the slot at the write index and publishes it.  The
+ * caller has checked the slot is free.
+ */
+static void prvWriteItem( SpscQueue_t * const pxQueue,
+                          const void * pvItemToQueue,
+                          const UBaseType_t uxWriteIndex,
+                          const UBaseType_t uxNextWriteIndex ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copies the item at the read index out and frees its slot.  The caller has
+ * checked the queue is not empty.
+ */
+static void prvReadItem( SpscQueue_t * const pxQueue,
+                         void * pvBuffer,
+                         const UBaseType_t uxReadIndex ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    SpscQueueHandle_t xSpscQueueCreate( const UBaseType_t uxQueueLength,
+                                        const UBaseType_t uxItemSize )
+    {
+        SpscQueue_t * pxQueue = NULL;
+        size_t xStorageSize;
+
+        configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+        configASSERT( uxItemSize > ( UBaseType_t ) 0 );
+
+        /* Check for multiplication and addition overflow, the storage area
+         * has one slot more than the queue length. */
+        if( ( uxQueueLength < ( UBaseType_t ) ~( ( UBaseType_t ) 0 ) ) &&
+            ( ( ( SIZE_MAX - sizeof( SpscQueue_t ) ) / ( ( size_t ) uxQueueLength + ( size_t ) 1 ) ) >= ( size_t ) uxItemSize ) )
+        {
+            xStorageSize = ( ( size_t ) uxQueueLength + ( size_t ) 1 ) * ( size_t ) uxItemSize;
+
+            /* The storage area follows the structure.  sizeof( SpscQueue_t )
+             * is a multiple of the pointer size, so the items are aligned as
+             * well as the block returned by pvPortMalloc(). */
+            pxQueue = ( SpscQueue_t * ) pvPortMalloc( sizeof( SpscQueue_t ) + xStorageSize ); /*lint !e9087 !e9079 Casting from void * is ok for heap allocation. */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( pxQueue != NULL )
+        {
+            ( void ) memset( ( void * ) pxQueue, 0x00, sizeof( SpscQueue_t ) );
+            pxQueue->uxSlots = uxQueueLength + ( UBaseType_t ) 1;
+            pxQueue->uxItemSize = uxItemSize;
+            pxQueue->pucStorage = ( ( uint8_t * ) pxQueue ) + sizeof( SpscQueue_t ); /*lint !e9016 Pointer arithmetic allowed on char types. */
+
+            traceSPSC_QUEUE_CREATE( pxQueue );
+        }
+        else
+        {
+            traceSPSC_QUEUE_CREATE_FAILED();
+        }
+
+        return pxQueue;
+    }
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+void vSpscQueueDelete( SpscQueueHandle_t xQueue )
+{
+    SpscQueue_t * pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->xTaskWaitingToReceive == NULL );
+    configASSERT( pxQueue->xTaskWaitingToSend == NULL );
+
+    traceSPSC_QUEUE_DELETE( xQueue );
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    {
+        vPortFree( ( void * ) pxQueue ); /*lint !e9087 Standard free() semantics require void *. */
+    }
+    #else
+    {
+        /* Only dynamically created queues exist. */
+        ( void ) pxQueue;
+    }
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscQueueSend( SpscQueueHandle_t xQueue,
+                           const void * pvItemToQueue,
+                           TickType_t xTicksToWait )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    UBaseType_t uxWriteIndex, uxNextWriteIndex;
+    TimeOut_t xTimeOut;
+    BaseType_t xReturn;
+
+    configASSERT( pxQueue );
+    configASSERT( pvItemToQueue );
+
+    /* Only this function changes the write index, so it can be read without
+     * protection. */
+    uxWriteIndex = pxQueue->uxWriteIndex;
+    uxNextWriteIndex = spscNEXT_INDEX( pxQueue, uxWriteIndex );
+
+    if( ( uxNextWriteIndex == pxQueue->uxReadIndex ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+    {
+        vTaskSetTimeOutState( &xTimeOut );
+
+        do
+        {
+            /* The queue is full.  The check is repeated with interrupts
+             * masked, so the receiver either frees a slot before the handle
+             * is published or sees the handle after freeing the slot. */
+            taskENTER_CRITICAL();
+            {
+                if( uxNextWriteIndex != pxQueue->uxReadIndex )
+                {
+                    taskEXIT_CRITICAL();
+                    break;
+                }
+
+                /* Clear notification state as going to wait for space. */
+                ( void ) xTaskNotifyStateClear( NULL );
+
+                /* Should only be one sender. */
+                configASSERT( pxQueue->xTaskWaitingToSend == NULL );
+                pxQueue->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+            }
+            taskEXIT_CRITICAL();
+
+            traceBLOCKING_ON_SPSC_QUEUE_SEND( xQueue );
+            ( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxQueue->xTaskWaitingToSend = NULL;
+        } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( uxNextWriteIndex != pxQueue->uxReadIndex )
+    {
+        prvWriteItem( pxQueue, pvItemToQueue, uxWriteIndex, uxNextWriteIndex );
+        traceSPSC_QUEUE_SEND( xQueue );
+
+        /* Was the receiver waiting for the item? */
+        spscUNBLOCK_WAITING_TASK( pxQueue->xTaskWaitingToReceive );
+        xReturn = pdPASS;
+    }
+    else
+    {
+        traceSPSC_QUEUE_SEND_FAILED( xQueue );
+        xReturn = errQUEUE_FULL;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscQueueSendFromISR( SpscQueueHandle_t xQueue,
+                                  const void * pvItemToQueue,
+                                  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    UBaseType_t uxWriteIndex, uxNextWriteIndex;
+    BaseType_t xReturn;
+
+    configASSERT( pxQueue );
+    configASSERT( pvItemToQueue );
+
+    uxWriteIndex = pxQueue->uxWriteIndex;
+    uxNextWriteIndex = spscNEXT_INDEX( pxQueue, uxWriteIndex );
+
+    if( uxNextWriteIndex != pxQueue->uxReadIndex )
+    {
+        prvWriteItem( pxQueue, pvItemToQueue, uxWriteIndex, uxNextWriteIndex );
+        traceSPSC_QUEUE_SEND_FROM_ISR( xQueue );
+
+        spscUNBLOCK_WAITING_TASK_FROM_ISR( pxQueue->xTaskWaitingToReceive, pxHigherPriorityTaskWoken );
+        xReturn = pdPASS;
+    }
+    else
+    {
+        traceSPSC_QUEUE_SEND_FAILED( xQueue );
+        xReturn = errQUEUE_FULL;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscQueueReceive( SpscQueueHandle_t xQueue,
+                              void * pvBuffer,
+                              TickType_t xTicksToWait )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    UBaseType_t uxReadIndex;
+    TimeOut_t xTimeOut;
+    BaseType_t xReturn;
+
+    configASSERT( pxQueue );
+    configASSERT( pvBuffer );
+
+    /* Only this function changes the read index, so it can be read without
+     * protection. */
+    uxReadIndex = pxQueue->uxReadIndex;
+
+    if( ( uxReadIndex == pxQueue->uxWriteIndex ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+    {
+        vTaskSetTimeOutState( &xTimeOut );
+
+        do
+        {
+            /* The queue is empty, see the comment in xSpscQueueSend(). */
+            taskENTER_CRITICAL();
+            {
+                if( uxReadIndex != pxQueue->uxWriteIndex )
+                {
+                    taskEXIT_CRITICAL();
+                    break;
+                }
+
+                /* Clear notification state as going to wait for an item. */
+                ( void ) xTaskNotifyStateClear( NULL );
+
+                /* Should only be one receiver. */
+                configASSERT( pxQueue->xTaskWaitingToReceive == NULL );
+                pxQueue->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+            }
+            taskEXIT_CRITICAL();
+
+            traceBLOCKING_ON_SPSC_QUEUE_RECEIVE( xQueue );
+            ( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxQueue->xTaskWaitingToReceive = NULL;
+        } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( uxReadIndex != pxQueue->uxWriteIndex )
+    {
+        prvReadItem( pxQueue, pvBuffer, uxReadIndex );
+        traceSPSC_QUEUE_RECEIVE( xQueue );
+
+        /* Was the sender waiting for space? */
+        spscUNBLOCK_WAITING_TASK( pxQueue->xTaskWaitingToSend );
+        xReturn = pdPASS;
+    }
+    else
+    {
+        traceSPSC_QUEUE_RECEIVE_FAILED( xQueue );
+        xReturn = errQUEUE_EMPTY;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSpscQueueReceiveFromISR( SpscQueueHandle_t xQueue,
+                                     void * pvBuffer,
+                                     BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    SpscQueue_t * const pxQueue = xQueue;
+    UBaseType_t uxReadIndex;
+    BaseType_t xReturn;
+
+    configASSERT( pxQueue );
+    configASSERT( pvBuffer );
+
+    uxReadIndex = pxQueue->uxReadIndex;
+
+    if( uxReadIndex != pxQueue->uxWriteIndex )
+    {
+        prvReadItem( pxQueue, pvBuffer, uxReadIndex );
+        traceSPSC_QUEUE_RECEIVE_FROM_ISR( xQueue );
+
+        spscUNBLOCK_WAITING_TASK_FROM_ISR( pxQueue->xTaskWaitingToSend, pxHigherPriorityTaskWoken );
+        xReturn = pdPASS;
+    }
+    else
+    {
+        traceSPSC_QUEUE_RECEIVE_FAILED( xQueue );
+        xReturn = errQUEUE_EMPTY;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSpscQueueMessagesWaiting( SpscQueueHandle_t xQueue )
+{
+    const SpscQueue_t * const pxQueue = xQueue;
+    UBaseType_t uxReadIndex, uxWriteIndex;
+
+    configASSERT( pxQueue );
+
+    uxReadIndex = pxQueue->uxReadIndex;
+    uxWriteIndex = pxQueue->uxWriteIndex;
+
+    if( uxWriteIndex < uxReadIndex )
+    {
+        uxWriteIndex += pxQueue->uxSlots;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return uxWriteIndex - uxReadIndex;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteItem( SpscQueue_t * const pxQueue,
+                          const void * pvItemToQueue,
+                          const UBaseType_t uxWriteIndex,
+                          const UBaseType_t uxNextWriteIndex )
+{
+    ( void ) memcpy( ( void * ) &( pxQueue->pucStorage[ uxWriteIndex * pxQueue->uxItemSize ] ), pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e9087 memcpy() requires void *. */
+
+    /* The item must be complete before the receiver can see the new write
+     * index, and the receiver's handle must be read after the index is
+     * updated.  The queue is only shared between tasks and interrupts of one
+     * core, so a compiler barrier is enough. */
+    portMEMORY_BARRIER();
+    pxQueue->uxWriteIndex = uxNextWriteIndex;
+    portMEMORY_BARRIER();
+}
+/*-----------------------------------------------------------*/
+
+static void prvReadItem( SpscQueue_t * const pxQueue,
+                         void * pvBuffer,
+                         const UBaseType_t uxReadIndex )
+{
+    ( void ) memcpy( pvBuffer, ( const void * ) &( pxQueue->pucStorage[ uxReadIndex * pxQueue->uxItemSize ] ), ( size_t ) pxQueue->uxItemSize ); /*lint !e9087 memcpy() requires void *. */
+
+    /* The item must be copied out before the sender can reuse the slot. */
+    portMEMORY_BARRIER();
+    pxQueue->uxReadIndex = spscNEXT_INDEX( pxQueue, uxReadIndex );
+    portMEMORY_BARRIER();
+}
@@ -0,0 +1,69 @@
+//
+// Interrupt driven button input.
+//
+// All buttons are served by one task. GPIO edge interrupts only record the
+// time of the edge and wake the task, debouncing is done by comparing
+// timestamps. Debounced press, release and long press events are sent to a
+// single producer single consumer queue of ButtonEvent items, the service task
+// is its only sender.
+//
+
+#ifndef BUTTONSERVICE_H
+#define BUTTONSERVICE_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "spsc_queue.h"
+#include "pico/stdlib.h"
+
+enum class ButtonEventType : uint8_t {
+    Pressed,
+    Released,
+    LongPress
+};
+
+struct ButtonEvent {
+    uint8_t id;
+    ButtonEventType type;
+    uint32_t time_us;  // time of the edge that started the debounced state
+};
+
+class ButtonService {
+    friend void button_service_gpio_callback(uint gpio, uint32_t events);
+public:
+    static constexpr int max_buttons = 8;
+    // events must be an SPSC queue of ButtonEvent items with one receiving task
+    explicit ButtonService(SpscQueueHandle_t events, uint32_t debounce_ms = 20, uint32_t long_press_ms = 1000);
+    ButtonService(const ButtonService &) = delete; // owns the gpio callback
+    // add an active low button, must be called before start()
+    bool add(uint8_t id, uint pin);
+    bool start(UBaseType_t priority, configSTACK_DEPTH_TYPE stack_size = 256);
+    // events lost because the queue was full
+    uint32_t get_dropped() const { return dropped; }
+    // number of times the service task has woken up
+    uint32_t get_wakeups() const { return wakeups; }
+private:
+    struct PinState {
+        uint pin;
+        uint8_t id;
+        bool stable;          // debounced state, true = pressed
+        bool long_sent;
+        volatile bool raw;    // state after the latest edge
+        volatile uint32_t edge_us;
+        uint32_t pressed_us;
+    };
+    static void task_entry(void *param);
+    void run();
+    void gpio_irq(uint gpio);
+    void publish(const PinState &state, ButtonEventType type, uint32_t time_us);
+    SpscQueueHandle_t events;
+    TaskHandle_t task;
+    uint32_t debounce_us;
+    uint32_t long_press_us;
+    PinState pins[max_buttons];
+    int count;
+    uint32_t dropped;
+    uint32_t wakeups;
+};
+
+#endif //BUTTONSERVICE_H
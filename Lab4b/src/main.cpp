@@ -1,11 +1,13 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "spsc_queue.h"
 #include "event_groups.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
 #include <string.h>
 #include "hardware/timer.h"
+#include "ButtonService.h"
 
 extern "C" {
 uint32_t read_runtime_ctr(void) {
@@ -28,9 +30,13 @@ uint32_t read_runtime_ctr(void) {
 #define DEBUG_TASK_PRIORITY (tskIDLE_PRIORITY + 1)
 #define TASK_PRIORITY (DEBUG_TASK_PRIORITY + 1)
 
+// Debug events printed per queue receive
+#define DEBUG_BATCH_SIZE 4
+
 // Event group and queue handles
 EventGroupHandle_t eventGroup;
 QueueHandle_t syslog_q;
+SpscQueueHandle_t buttonQueue;
 
 // Structure for debug messages
 struct debugEvent {
@@ -50,57 +56,31 @@ void debug(const char *format, uint32_t d1, uint32_t d2, uint32_t d3) {
     xQueueSend(syslog_q, &e, portMAX_DELAY);
 }
 
-// Debug Task: Reads from the queue and prints the debug message
+// Debug Task: Reads from the queue and prints the debug messages
 void debugTask(void *pvParameters) {
     char buffer[64];
-    struct debugEvent e;
+    struct debugEvent events[DEBUG_BATCH_SIZE];
 
     while (1) {
-        // Receive the event from the queue
-        if (xQueueReceive(syslog_q, &e, portMAX_DELAY) == pdPASS) {
+        // Take up to DEBUG_BATCH_SIZE queued events at once, waits only while the queue is empty
+        BaseType_t count = xQueueReceiveMultiple(syslog_q, events, DEBUG_BATCH_SIZE, portMAX_DELAY);
+        for (BaseType_t i = 0; i < count; ++i) {
+            const debugEvent &e = events[i];
             snprintf(buffer, 64, e.format, e.data[0], e.data[1], e.data[2]);
             printf("%u: %s", xTaskGetTickCount(), buffer);
         }
     }
 }
 
-bool debounceButton(uint pin) {
-    if (!gpio_get(pin)) {  // Active low button press detected
-        vTaskDelay(pdMS_TO_TICKS(20));  // Short delay to debounce
-        if (!gpio_get(pin)) {  // Check again after debounce delay
-            return true;  // Button press is valid
-        }
-    }
-    return false;  // No valid press detected
-}
-
-// Task 1-3: monitor button presses
+// Buttons 1-3: handle debounced button events from the button service
 void buttonTask(void *pvParameters) {
-    uint pin = (uint)pvParameters;
-    uint32_t taskBit;
-    uint32_t taskNumber;
-
-    if (pin == SW0_PIN) {
-        taskBit = TASK1_BIT;
-        taskNumber = 1;
-    } else if (pin == SW1_PIN) {
-        taskBit = TASK2_BIT;
-        taskNumber = 2;
-    } else if (pin == SW2_PIN) {
-        taskBit = TASK3_BIT;
-        taskNumber = 3;
-    } else {
-        // Invalid pin
-        vTaskDelete(NULL);
-    }
+    ButtonEvent event;
 
     while (1) {
-        // Wait for a debounced button press
-        if (debounceButton(pin)) {
-            // Wait for button release (holding the button blocks the loop)
-            while (!gpio_get(pin)) {
-                vTaskDelay(pdMS_TO_TICKS(10));  // Wait for button release
-            }
+        if (xSpscQueueReceive(buttonQueue, &event, portMAX_DELAY) == pdPASS && event.type == ButtonEventType::Released) {
+            // button id is the task number
+            uint32_t taskNumber = event.id;
+            uint32_t taskBit = 1 << (taskNumber - 1);
 
             // Set event bit for the watchdog task
             xEventGroupSetBits(eventGroup, taskBit);
@@ -108,7 +88,6 @@ void buttonTask(void *pvParameters) {
             // Send debug message
             debug("Task %u: Button pressed and released.\n", taskNumber, 0, 0);
         }
-        vTaskDelay(pdMS_TO_TICKS(10));  // Polling delay
     }
 }
 
@@ -166,18 +145,7 @@ void watchdogTask(void *pvParameters) {
 
 // Initialize GPIO Pins
 void init_pins(void) {
-    // Initialize tactile switches
-    gpio_init(SW0_PIN);
-    gpio_set_dir(SW0_PIN, GPIO_IN);
-    gpio_pull_up(SW0_PIN);  // Active Low
-
-    gpio_init(SW1_PIN);
-    gpio_set_dir(SW1_PIN, GPIO_IN);
-    gpio_pull_up(SW1_PIN);  // Active Low
-
-    gpio_init(SW2_PIN);
-    gpio_set_dir(SW2_PIN, GPIO_IN);
-    gpio_pull_up(SW2_PIN);  // Active Low
+    // Tactile switches are initialized by the button service
 
     // Initialize LED pin (if needed)
     gpio_init(LED_PIN);
@@ -193,14 +161,18 @@ int main(void) {
     // Initialize event group and queue
     eventGroup = xEventGroupCreate();
     syslog_q = xQueueCreate(10, sizeof(struct debugEvent));
+    buttonQueue = xSpscQueueCreate(10, sizeof(ButtonEvent));
 
     // Send initialization message via debug task
     debug("System Initialized\n", 0, 0, 0);
 
     // Create tasks
-    xTaskCreate(buttonTask, "Button Task 1", 1000, (void *)SW0_PIN, TASK_PRIORITY, NULL);
-    xTaskCreate(buttonTask, "Button Task 2", 1000, (void *)SW1_PIN, TASK_PRIORITY, NULL);
-    xTaskCreate(buttonTask, "Button Task 3", 1000, (void *)SW2_PIN, TASK_PRIORITY, NULL);
+    static ButtonService buttons(buttonQueue);
+    buttons.add(1, SW0_PIN);  // Task 1
+    buttons.add(2, SW1_PIN);  // Task 2
+    buttons.add(3, SW2_PIN);  // Task 3
+    buttons.start(TASK_PRIORITY + 1);
+    xTaskCreate(buttonTask, "Button Task", 1000, NULL, TASK_PRIORITY, NULL);
     xTaskCreate(watchdogTask, "Watchdog Task", 1000, NULL, TASK_PRIORITY, NULL);
     xTaskCreate(debugTask, "Debug Task", 1000, NULL, DEBUG_TASK_PRIORITY, NULL);
 
@@ -0,0 +1,50 @@
+/*
+ * Kernel configuration of the host tests, built with the POSIX port.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#define configUSE_PREEMPTION                    1
+#ifndef configUSE_IDLE_HOOK
+#define configUSE_IDLE_HOOK                     0
+#endif
+#define configUSE_TICK_HOOK                     0
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                    8
+#define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 256
+#define configMAX_TASK_NAME_LEN                 16
+#define configUSE_16_BIT_TICKS                  0
+#define configUSE_MUTEXES                       1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_TIMERS                        0
+#define configSTACK_DEPTH_TYPE                  uint32_t
+
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configTOTAL_HEAP_SIZE                   ( 16 * 1024 * 1024 )
+
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_TRACE_FACILITY                1
+
+/* Kernel additions of this lab that are off in the application build */
+#define configUSE_QUEUE_ZERO_COPY               1
+
+/* The queue hook of kernel_counters.h */
+void vKernelQueueBlocking( void * pvQueue,
+                           int iSending );
+#define traceBLOCKING_ON_QUEUE_SEND( pxQueue )       vKernelQueueBlocking( ( pxQueue ), 1 )
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )    vKernelQueueBlocking( ( pxQueue ), 0 )
+#define traceBLOCKING_ON_SPSC_QUEUE_SEND( xQueue )       vKernelQueueBlocking( ( xQueue ), 1 )
+#define traceBLOCKING_ON_SPSC_QUEUE_RECEIVE( xQueue )    vKernelQueueBlocking( ( xQueue ), 0 )
+
+#include <assert.h>
+#define configASSERT(x)                         assert(x)
+
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+
+#endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,27 @@
+/*
+ * Kernel configuration of button_service_test: the host test configuration
+ * with a tick that only moves on while the tasks are idle.  The idle hook
+ * advances it by one and tickless idle skips straight to the next wake, see
+ * button_service_test.cpp, so the simulated button timings hold to the tick.
+ */
+
+#ifndef BUTTON_SERVICE_CONFIG_H
+#define BUTTON_SERVICE_CONFIG_H
+
+#include <stdint.h>
+
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICKLESS_IDLE                 1
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vTestSkipIdleTicks( xExpectedIdleTime )
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void vTestSkipIdleTicks( uint32_t ulExpectedIdleTime );
+#ifdef __cplusplus
+}
+#endif
+
+#include "../FreeRTOSConfig.h"
+
+#endif /* BUTTON_SERVICE_CONFIG_H */
@@ -0,0 +1,58 @@
+/*
+ * Wrappers counting the kernel's copies and critical sections, see
+ * kernel_counters.h.
+ */
+
+#include <stddef.h>
+#include "kernel_counters.h"
+
+void * __real_memcpy( void * pvDestination,
+                      const void * pvSource,
+                      size_t xLength );
+void __real_vPortEnterCritical( void );
+
+/* Tasks of the POSIX port run one at a time, plain counters are enough. */
+static KernelCounters_t xCounters;
+static KernelQueueHook_t pxQueueHook;
+
+void * __wrap_memcpy( void * pvDestination,
+                      const void * pvSource,
+                      size_t xLength )
+{
+    xCounters.ullCopies++;
+    xCounters.ullBytesCopied += xLength;
+
+    return __real_memcpy( pvDestination, pvSource, xLength );
+}
+
+void __wrap_vPortEnterCritical( void )
+{
+    xCounters.ullCriticalSections++;
+    __real_vPortEnterCritical();
+}
+
+void vKernelCountersReset( void )
+{
+    KernelCounters_t xZero = { 0 };
+
+    xCounters = xZero;
+}
+
+KernelCounters_t xKernelCountersGet( void )
+{
+    return xCounters;
+}
+
+void vKernelCountersSetQueueHook( KernelQueueHook_t pxHook )
+{
+    pxQueueHook = pxHook;
+}
+
+void vKernelQueueBlocking( void * pvQueue,
+                           int iSending )
+{
+    if( pxQueueHook != NULL )
+    {
+        pxQueueHook( pvQueue, iSending );
+    }
+}
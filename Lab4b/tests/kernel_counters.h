@@ -0,0 +1,35 @@
+/*
+ * Counts what the kernel does on behalf of a test: calls to memcpy() and the
+ * bytes they move, and critical sections entered.  The test executables are
+ * linked with --wrap for both functions, so only calls made from the kernel
+ * and the test's own objects are seen, not those inside the C library.
+ *
+ * A test can also set a hook that the kernel calls when a task is about to
+ * block on a queue, see traceBLOCKING_ON_QUEUE_SEND in FreeRTOSConfig.h.  A
+ * queue is locked then and an SPSC queue has the task's handle published, so
+ * the hook can stand in for an interrupt that uses the queue before the task
+ * waits.
+ */
+
+#ifndef KERNEL_COUNTERS_H
+#define KERNEL_COUNTERS_H
+
+#include <stdint.h>
+
+typedef struct KernelCounters
+{
+    uint64_t ullCopies;           /* memcpy() calls */
+    uint64_t ullBytesCopied;      /* bytes moved by them */
+    uint64_t ullCriticalSections; /* vPortEnterCritical() calls */
+} KernelCounters_t;
+
+void vKernelCountersReset( void );
+KernelCounters_t xKernelCountersGet( void );
+
+/* iSending is 1 for a task waiting for room, 0 for one waiting for items.
+ * NULL removes the hook. */
+typedef void ( * KernelQueueHook_t )( void * pvQueue,
+                                      int iSending );
+void vKernelCountersSetQueueHook( KernelQueueHook_t pxHook );
+
+#endif /* KERNEL_COUNTERS_H */
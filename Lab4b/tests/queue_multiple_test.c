@@ -0,0 +1,685 @@
+/*
+ * Test of the batched queue API, xQueueSendMultiple() and
+ * xQueueReceiveMultiple() and their FromISR variants.
+ *
+ * First one task mixes batches of random size, the ISR variants and the
+ * single-item calls on a 7-item queue, so batches wrap around the end of the
+ * storage at every position.  Every call has to move as many items as fit or
+ * are there, up to its count, and the items have to come out in order.
+ *
+ * Then the ISR variants are called from the queue hook of kernel_counters.h,
+ * while a task about to block holds the queue locked.  A batch sent or
+ * received there has to unblock as many waiting tasks as it has items, the
+ * same as single calls would, when the queue is unlocked.  Random batches
+ * between a producer and a consumer task, with the hook adding and taking
+ * items, have to keep the order of both sources.
+ *
+ * Last the items per second and critical sections per item of batches of 1
+ * to 16 items are compared with a loop of xQueueSend()/xQueueReceive().
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "kernel_counters.h"
+
+#define FIFO_QUEUE_SIZE     7
+#define FIFO_STEPS          200000
+#define MAX_BATCH           12
+#define WAITERS             3
+#define WAIT_TICKS          pdMS_TO_TICKS( 200 )
+#define RANDOM_ITEMS        100000
+#define BENCH_ITEMS         400000
+#define BENCH_TASK_ITEMS    50000   /* every wake is a thread switch on the host */
+#define BENCH_QUEUE_SIZE    16
+
+/* 16 bytes like the Lab4b debug events */
+typedef struct Item
+{
+    uint32_t ulSource;
+    uint32_t ulNumber;
+    uint32_t ulCheck[ 2 ];
+} Item_t;
+
+enum
+{
+    eTaskSource,
+    eIsrSource,
+    eSources
+};
+
+static TaskHandle_t xControlTask;
+static uint32_t ulFailures;
+
+/* Next number to send and to receive of each source */
+static uint32_t ulSent[ eSources ], ulReceived[ eSources ];
+
+static void prvFail( const char * pcWhat )
+{
+    if( ulFailures++ < 10U )
+    {
+        printf( "%s\n", pcWhat );
+    }
+}
+
+static uint32_t prvCheckWord( uint32_t ulNumber )
+{
+    return ulNumber * 2654435761U;
+}
+
+static void prvMakeItems( Item_t * pxItems,
+                          uint32_t ulCount,
+                          uint32_t ulSource )
+{
+    uint32_t ul;
+
+    for( ul = 0; ul < ulCount; ul++ )
+    {
+        pxItems[ ul ].ulSource = ulSource;
+        pxItems[ ul ].ulNumber = ulSent[ ulSource ] + ul;
+        pxItems[ ul ].ulCheck[ 0 ] = ~pxItems[ ul ].ulNumber;
+        pxItems[ ul ].ulCheck[ 1 ] = prvCheckWord( pxItems[ ul ].ulNumber );
+    }
+}
+
+/* Items have to be whole and follow the ones received before from their source. */
+static void prvCheckItems( const Item_t * pxItems,
+                           uint32_t ulCount )
+{
+    uint32_t ul;
+
+    for( ul = 0; ul < ulCount; ul++ )
+    {
+        const Item_t * pxItem = &pxItems[ ul ];
+
+        if( ( pxItem->ulSource >= eSources ) ||
+            ( pxItem->ulCheck[ 0 ] != ~pxItem->ulNumber ) ||
+            ( pxItem->ulCheck[ 1 ] != prvCheckWord( pxItem->ulNumber ) ) )
+        {
+            prvFail( "torn item" );
+        }
+        else
+        {
+            if( pxItem->ulNumber != ulReceived[ pxItem->ulSource ] )
+            {
+                prvFail( "item out of order" );
+            }
+
+            ulReceived[ pxItem->ulSource ] = pxItem->ulNumber + 1U;
+        }
+    }
+}
+
+static void prvResetSources( void )
+{
+    uint32_t ul;
+
+    for( ul = 0; ul < eSources; ul++ )
+    {
+        ulSent[ ul ] = 0;
+        ulReceived[ ul ] = 0;
+    }
+}
+
+static uint32_t prvMin( uint32_t ulA,
+                        uint32_t ulB )
+{
+    return ( ulA < ulB ) ? ulA : ulB;
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvCheckFifo( void )
+{
+    QueueHandle_t xQueue = xQueueCreate( FIFO_QUEUE_SIZE, sizeof( Item_t ) );
+    Item_t xItems[ MAX_BATCH ];
+    uint32_t ulStep, ulCount, ulWaiting = 0, ulExpected, ulDone;
+    BaseType_t xWoken = pdFALSE;
+
+    configASSERT( xQueue != NULL );
+    prvResetSources();
+
+    for( ulStep = 0; ulStep < FIFO_STEPS; ulStep++ )
+    {
+        ulCount = 1U + ( uint32_t ) rand() % MAX_BATCH;
+
+        switch( rand() % 6 )
+        {
+            case 0:
+                prvMakeItems( xItems, ulCount, eTaskSource );
+                ulDone = ( uint32_t ) xQueueSendMultiple( xQueue, xItems, ulCount, 0 );
+                ulExpected = prvMin( ulCount, FIFO_QUEUE_SIZE - ulWaiting );
+                ulSent[ eTaskSource ] += ulDone;
+                ulWaiting += ulDone;
+                break;
+
+            case 1:
+                prvMakeItems( xItems, ulCount, eTaskSource );
+                ulDone = ( uint32_t ) xQueueSendMultipleFromISR( xQueue, xItems, ulCount, &xWoken );
+                ulExpected = prvMin( ulCount, FIFO_QUEUE_SIZE - ulWaiting );
+                ulSent[ eTaskSource ] += ulDone;
+                ulWaiting += ulDone;
+                break;
+
+            case 2:
+                prvMakeItems( xItems, 1, eTaskSource );
+                ulDone = ( xQueueSendToBack( xQueue, xItems, 0 ) == pdPASS ) ? 1U : 0U;
+                ulExpected = prvMin( 1, FIFO_QUEUE_SIZE - ulWaiting );
+                ulSent[ eTaskSource ] += ulDone;
+                ulWaiting += ulDone;
+                break;
+
+            case 3:
+                ulDone = ( uint32_t ) xQueueReceiveMultiple( xQueue, xItems, ulCount, 0 );
+                ulExpected = prvMin( ulCount, ulWaiting );
+                prvCheckItems( xItems, ulDone );
+                ulWaiting -= ulDone;
+                break;
+
+            case 4:
+                ulDone = ( uint32_t ) xQueueReceiveMultipleFromISR( xQueue, xItems, ulCount, &xWoken );
+                ulExpected = prvMin( ulCount, ulWaiting );
+                prvCheckItems( xItems, ulDone );
+                ulWaiting -= ulDone;
+                break;
+
+            default:
+                ulDone = ( xQueueReceive( xQueue, xItems, 0 ) == pdPASS ) ? 1U : 0U;
+                ulExpected = prvMin( 1, ulWaiting );
+                prvCheckItems( xItems, ulDone );
+                ulWaiting -= ulDone;
+                break;
+        }
+
+        if( ( ulDone != ulExpected ) || ( uxQueueMessagesWaiting( xQueue ) != ulWaiting ) )
+        {
+            prvFail( "wrong number of items moved" );
+        }
+    }
+
+    /* No task waits on the queue, so no call may report one woken. */
+    if( xWoken != pdFALSE )
+    {
+        prvFail( "ISR variant woke a task that was not there" );
+    }
+
+    printf( "fifo: %d random calls on %d slots, %lu items\n", FIFO_STEPS, FIFO_QUEUE_SIZE,
+            ( unsigned long ) ulSent[ eTaskSource ] );
+    vQueueDelete( xQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+/* The queue the hook acts on and what it does there, once */
+static QueueHandle_t xHookQueue;
+static int iHookSending;
+static uint32_t ulHookItems;
+static uint32_t ulHookCalls;
+static uint32_t ulHookTaken;
+
+static void prvLockedHook( void * pvQueue,
+                           int iSending )
+{
+    Item_t xItems[ MAX_BATCH ];
+    uint32_t ulDone;
+
+    if( ( pvQueue != ( void * ) xHookQueue ) || ( iSending != iHookSending ) || ( ulHookItems == 0U ) )
+    {
+        return;
+    }
+
+    /* A task waiting for items gets a batch, one waiting for room gets it made. */
+    if( iSending == 0 )
+    {
+        prvMakeItems( xItems, ulHookItems, eIsrSource );
+        ulDone = ( uint32_t ) xQueueSendMultipleFromISR( xHookQueue, xItems, ulHookItems, NULL );
+        ulSent[ eIsrSource ] += ulDone;
+    }
+    else
+    {
+        ulDone = ( uint32_t ) xQueueReceiveMultipleFromISR( xHookQueue, xItems, ulHookItems, NULL );
+        prvCheckItems( xItems, ulDone );
+        ulHookTaken += ulDone;
+    }
+
+    if( ulDone != ulHookItems )
+    {
+        prvFail( "ISR batch on the locked queue moved too few items" );
+    }
+
+    ulHookItems = 0;
+    ulHookCalls++;
+}
+
+/* Result of a waiting task */
+typedef struct Waiter
+{
+    BaseType_t xBatch;      /* waits with the batch call, not the single one */
+    BaseType_t xDone;
+    TickType_t xWaited;
+    TaskHandle_t xHandle;
+} Waiter_t;
+
+static Waiter_t xWaiters[ WAITERS ];
+
+static void prvReceiverTask( void * pvParameters )
+{
+    Waiter_t * pxWaiter = ( Waiter_t * ) pvParameters;
+    TickType_t xStart = xTaskGetTickCount();
+    Item_t xItem;
+
+    if( pxWaiter->xBatch != pdFALSE )
+    {
+        pxWaiter->xDone = ( xQueueReceiveMultiple( xHookQueue, &xItem, 1, WAIT_TICKS ) == 1 );
+    }
+    else
+    {
+        pxWaiter->xDone = ( xQueueReceive( xHookQueue, &xItem, WAIT_TICKS ) == pdPASS );
+    }
+
+    pxWaiter->xWaited = xTaskGetTickCount() - xStart;
+
+    if( pxWaiter->xDone != pdFALSE )
+    {
+        prvCheckItems( &xItem, 1 );
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+static void prvSenderTask( void * pvParameters )
+{
+    Waiter_t * pxWaiter = ( Waiter_t * ) pvParameters;
+    TickType_t xStart = xTaskGetTickCount();
+    Item_t xItem;
+
+    /* The items are numbered when they are queued, the tasks take turns. */
+    prvMakeItems( &xItem, 1, eTaskSource );
+    ulSent[ eTaskSource ]++;
+
+    if( pxWaiter->xBatch != pdFALSE )
+    {
+        pxWaiter->xDone = ( xQueueSendMultiple( xHookQueue, &xItem, 1, WAIT_TICKS ) == 1 );
+    }
+    else
+    {
+        pxWaiter->xDone = ( xQueueSend( xHookQueue, &xItem, WAIT_TICKS ) == pdPASS );
+    }
+
+    pxWaiter->xWaited = xTaskGetTickCount() - xStart;
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+static void prvWaitUntilBlocked( TaskHandle_t xTask )
+{
+    while( eTaskGetState( xTask ) != eBlocked )
+    {
+        vTaskDelay( 1 );
+    }
+}
+
+/* WAITERS tasks wait on the queue, the last one with the batch call.  While it
+ * holds the queue locked the hook moves one item for each of them. */
+static void prvCheckLockedWakes( int iSending )
+{
+    const char * pcSide = ( iSending != 0 ) ? "senders" : "receivers";
+    Item_t xItems[ WAITERS ];
+    uint32_t ul, ulWoken = 0;
+
+    xHookQueue = xQueueCreate( WAITERS, sizeof( Item_t ) );
+    configASSERT( xHookQueue != NULL );
+    prvResetSources();
+
+    if( iSending != 0 )
+    {
+        /* Full, the senders have to wait for room. */
+        prvMakeItems( xItems, WAITERS, eTaskSource );
+        ulSent[ eTaskSource ] += ( uint32_t ) xQueueSendMultiple( xHookQueue, xItems, WAITERS, 0 );
+    }
+
+    vKernelCountersSetQueueHook( prvLockedHook );
+    iHookSending = iSending;
+
+    for( ul = 0; ul < WAITERS; ul++ )
+    {
+        xWaiters[ ul ].xBatch = ( ul == WAITERS - 1U ) ? pdTRUE : pdFALSE;
+        xWaiters[ ul ].xDone = pdFALSE;
+
+        if( ul == WAITERS - 1U )
+        {
+            /* The tasks before are on the event list already, the last one
+             * only blocks if the hook's batch did not unblock it. */
+            ulHookItems = WAITERS;
+        }
+
+        xTaskCreate( ( iSending != 0 ) ? prvSenderTask : prvReceiverTask, "Waiter", configMINIMAL_STACK_SIZE * 4,
+                     &xWaiters[ ul ], 2, &xWaiters[ ul ].xHandle );
+
+        if( ul < WAITERS - 1U )
+        {
+            prvWaitUntilBlocked( xWaiters[ ul ].xHandle );
+        }
+    }
+
+    for( ul = 0; ul < WAITERS; ul++ )
+    {
+        ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    }
+
+    vKernelCountersSetQueueHook( NULL );
+
+    for( ul = 0; ul < WAITERS; ul++ )
+    {
+        if( ( xWaiters[ ul ].xDone != pdFALSE ) && ( xWaiters[ ul ].xWaited < WAIT_TICKS ) )
+        {
+            ulWoken++;
+        }
+    }
+
+    printf( "locked queue: %lu of %d waiting %s unblocked by a batch from an interrupt\n", ( unsigned long ) ulWoken,
+            WAITERS, pcSide );
+
+    if( ( ulWoken != WAITERS ) || ( ulHookCalls == 0U ) )
+    {
+        prvFail( "ISR batch on the locked queue did not unblock a task per item" );
+    }
+
+    /* The senders' items took the place of the ones the hook took, in the
+     * order the senders ran. */
+    if( ( iSending != 0 ) && ( ( uint32_t ) xQueueReceiveMultiple( xHookQueue, xItems, WAITERS, 0 ) != WAITERS ) )
+    {
+        prvFail( "senders' items missing" );
+    }
+
+    ulHookCalls = 0;
+    ulHookTaken = 0;
+    vQueueDelete( xHookQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+/* The hook takes part at random while the producer or consumer blocks. */
+static void prvRandomHook( void * pvQueue,
+                           int iSending )
+{
+    if( ( pvQueue == ( void * ) xHookQueue ) && ( ( rand() % 4 ) == 0 ) )
+    {
+        iHookSending = iSending;
+        ulHookItems = 1U + ( uint32_t ) rand() % 3U;
+
+        if( ( iSending != 0 ) && ( ulHookItems > uxQueueMessagesWaiting( xHookQueue ) ) )
+        {
+            ulHookItems = ( uint32_t ) uxQueueMessagesWaiting( xHookQueue );
+        }
+
+        prvLockedHook( pvQueue, iSending );
+    }
+}
+
+static void prvProducerTask( void * pvParameters )
+{
+    Item_t xItems[ MAX_BATCH ];
+    uint32_t ulCount, ulDone;
+
+    ( void ) pvParameters;
+
+    while( ulSent[ eTaskSource ] < RANDOM_ITEMS )
+    {
+        ulCount = prvMin( 1U + ( uint32_t ) rand() % MAX_BATCH, RANDOM_ITEMS - ulSent[ eTaskSource ] );
+        prvMakeItems( xItems, ulCount, eTaskSource );
+        ulDone = ( uint32_t ) xQueueSendMultiple( xHookQueue, xItems, ulCount, portMAX_DELAY );
+
+        if( ulDone != ulCount )
+        {
+            prvFail( "blocking batch send returned early" );
+        }
+
+        ulSent[ eTaskSource ] += ulDone;
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+static void prvConsumerTask( void * pvParameters )
+{
+    Item_t xItems[ MAX_BATCH ];
+    uint32_t ulDone;
+
+    ( void ) pvParameters;
+
+    while( ulReceived[ eTaskSource ] < RANDOM_ITEMS )
+    {
+        ulDone = ( uint32_t ) xQueueReceiveMultiple( xHookQueue, xItems, 1U + ( uint32_t ) rand() % MAX_BATCH, portMAX_DELAY );
+
+        if( ulDone == 0U )
+        {
+            prvFail( "blocking batch receive returned nothing" );
+        }
+
+        prvCheckItems( xItems, ulDone );
+
+        /* Lets the producer fill the queue and block. */
+        if( ( rand() % 8 ) == 0 )
+        {
+            vTaskDelay( 1 );
+        }
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+static void prvCheckRandomTasks( void )
+{
+    Item_t xItems[ MAX_BATCH ];
+    uint32_t ulDone;
+
+    xHookQueue = xQueueCreate( FIFO_QUEUE_SIZE, sizeof( Item_t ) );
+    configASSERT( xHookQueue != NULL );
+    prvResetSources();
+    vKernelCountersSetQueueHook( prvRandomHook );
+
+    /* The consumer runs before the producer, so it is never preempted
+     * between taking a batch and checking it, while the hook takes items in
+     * the producer's call. */
+    xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL );
+    xTaskCreate( prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE * 4, NULL, 3, NULL );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    vKernelCountersSetQueueHook( NULL );
+
+    /* Items the hook sent after the last of the producer's */
+    do
+    {
+        ulDone = ( uint32_t ) xQueueReceiveMultiple( xHookQueue, xItems, MAX_BATCH, 0 );
+        prvCheckItems( xItems, ulDone );
+    } while( ulDone > 0U );
+
+    printf( "tasks: %d items in random batches, interrupts on the locked queue sent %lu and took %lu\n",
+            RANDOM_ITEMS, ( unsigned long ) ulSent[ eIsrSource ], ( unsigned long ) ulHookTaken );
+
+    if( ( ulReceived[ eTaskSource ] != RANDOM_ITEMS ) || ( ulReceived[ eIsrSource ] != ulSent[ eIsrSource ] ) )
+    {
+        prvFail( "items lost" );
+    }
+
+    ulHookCalls = 0;
+    ulHookTaken = 0;
+    vQueueDelete( xHookQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+static double prvSeconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( double ) xNow.tv_sec + ( double ) xNow.tv_nsec * 1e-9;
+}
+
+static void prvReport( const char * pcPath,
+                       uint32_t ulBatch,
+                       uint32_t ulItems,
+                       double dSeconds )
+{
+    KernelCounters_t xCounters = xKernelCountersGet();
+
+    printf( "batch %2lu %-9s %6.2f M items/s, %5.2f critical sections per item\n", ( unsigned long ) ulBatch, pcPath,
+            ulItems / dSeconds / 1e6, ( double ) xCounters.ullCriticalSections / ulItems );
+}
+
+/* One task fills the queue with a batch and empties it again, no blocking. */
+static void prvBenchmarkSingleTask( uint32_t ulBatch )
+{
+    static Item_t xItems[ BENCH_QUEUE_SIZE ];
+    QueueHandle_t xQueue = xQueueCreate( BENCH_QUEUE_SIZE, sizeof( Item_t ) );
+    uint32_t ulItems, ul;
+    double dStart;
+
+    configASSERT( xQueue != NULL );
+
+    vKernelCountersReset();
+    dStart = prvSeconds();
+
+    for( ulItems = 0; ulItems < BENCH_ITEMS; ulItems += ulBatch )
+    {
+        for( ul = 0; ul < ulBatch; ul++ )
+        {
+            ( void ) xQueueSend( xQueue, &xItems[ ul ], 0 );
+        }
+
+        for( ul = 0; ul < ulBatch; ul++ )
+        {
+            ( void ) xQueueReceive( xQueue, &xItems[ ul ], 0 );
+        }
+    }
+
+    prvReport( "per item", ulBatch, BENCH_ITEMS, prvSeconds() - dStart );
+
+    vKernelCountersReset();
+    dStart = prvSeconds();
+
+    for( ulItems = 0; ulItems < BENCH_ITEMS; ulItems += ulBatch )
+    {
+        ( void ) xQueueSendMultiple( xQueue, xItems, ulBatch, 0 );
+        ( void ) xQueueReceiveMultiple( xQueue, xItems, ulBatch, 0 );
+    }
+
+    prvReport( "batched", ulBatch, BENCH_ITEMS, prvSeconds() - dStart );
+    vQueueDelete( xQueue );
+}
+
+static QueueHandle_t xBenchQueue;
+static uint32_t ulBenchBatch;
+static BaseType_t xBenchBatched;
+
+static void prvBenchConsumerTask( void * pvParameters )
+{
+    Item_t xItems[ BENCH_QUEUE_SIZE ];
+    uint32_t ulItems = 0;
+
+    ( void ) pvParameters;
+
+    while( ulItems < BENCH_TASK_ITEMS )
+    {
+        if( xBenchBatched != pdFALSE )
+        {
+            ulItems += ( uint32_t ) xQueueReceiveMultiple( xBenchQueue, xItems, ulBenchBatch, portMAX_DELAY );
+        }
+        else
+        {
+            ulItems += ( xQueueReceive( xBenchQueue, xItems, portMAX_DELAY ) == pdPASS ) ? 1U : 0U;
+        }
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+/* The control task produces for a consumer of higher priority, which blocks
+ * whenever the queue is empty. */
+static void prvBenchmarkTasks( BaseType_t xBatched,
+                               uint32_t ulBatch )
+{
+    static Item_t xItems[ BENCH_QUEUE_SIZE ];
+    uint32_t ulItems, ul;
+    double dStart;
+
+    xBenchQueue = xQueueCreate( BENCH_QUEUE_SIZE, sizeof( Item_t ) );
+    configASSERT( xBenchQueue != NULL );
+    xBenchBatched = xBatched;
+    ulBenchBatch = ulBatch;
+
+    vKernelCountersReset();
+    dStart = prvSeconds();
+    xTaskCreate( prvBenchConsumerTask, "Consumer", configMINIMAL_STACK_SIZE * 4, NULL, 3, NULL );
+
+    for( ulItems = 0; ulItems < BENCH_TASK_ITEMS; ulItems += ulBatch )
+    {
+        if( xBatched != pdFALSE )
+        {
+            ( void ) xQueueSendMultiple( xBenchQueue, xItems, ulBatch, portMAX_DELAY );
+        }
+        else
+        {
+            for( ul = 0; ul < ulBatch; ul++ )
+            {
+                ( void ) xQueueSend( xBenchQueue, &xItems[ ul ], portMAX_DELAY );
+            }
+        }
+    }
+
+    ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    prvReport( ( xBatched != pdFALSE ) ? "batched" : "per item", ulBatch, BENCH_TASK_ITEMS, prvSeconds() - dStart );
+    vQueueDelete( xBenchQueue );
+}
+
+static void prvControlTask( void * pvParameters )
+{
+    static const uint32_t ulBatches[] = { 1, 4, 8, 16 };
+    size_t x;
+
+    ( void ) pvParameters;
+
+    prvCheckFifo();
+    prvCheckLockedWakes( 0 );
+    prvCheckLockedWakes( 1 );
+    prvCheckRandomTasks();
+
+    /* Host numbers: a critical section of the POSIX port is a signal mask
+     * change, which makes the per-item path look worse than on the target.
+     * The critical sections per item carry over. */
+    printf( "one task, no blocking:\n" );
+
+    for( x = 0; x < sizeof( ulBatches ) / sizeof( ulBatches[ 0 ] ); x++ )
+    {
+        prvBenchmarkSingleTask( ulBatches[ x ] );
+    }
+
+    printf( "producer to a blocking consumer task:\n" );
+
+    for( x = 1; x < sizeof( ulBatches ) / sizeof( ulBatches[ 0 ] ); x++ )
+    {
+        prvBenchmarkTasks( pdFALSE, ulBatches[ x ] );
+        prvBenchmarkTasks( pdTRUE, ulBatches[ x ] );
+    }
+
+    vTaskEndScheduler();
+}
+
+int main( void )
+{
+    srand( 1 );
+    xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 4, NULL, 1, &xControlTask );
+    vTaskStartScheduler();
+
+    return ulFailures ? 1 : 0;
+}
@@ -0,0 +1,492 @@
+/*
+ * Test of the single producer single consumer queue (spsc_queue.c).
+ *
+ * First two plain pthreads, started before the scheduler, pass numbered items
+ * through a 16-slot queue without blocking, retrying when it is full or
+ * empty.  The threads run truly in parallel on a host with more than one
+ * core, otherwise the host preempts them anywhere.  Items have to arrive
+ * whole and in order, and no critical section may be entered.
+ *
+ * Then, as tasks: receive and send time out on an empty and a full queue, a
+ * blocked receiver or sender is woken by the other side, also by an
+ * interrupt that comes in after the task published its handle and before it
+ * waits (the queue hook of kernel_counters.h).  Last a producer and a
+ * consumer task block on full and empty queues of 4 to 64 slots.  The items
+ * have to keep their order, and items/s and critical sections per item are
+ * compared with a queue created by xQueueCreate().
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "spsc_queue.h"
+#include "kernel_counters.h"
+
+#define THREAD_ITEMS        1000000
+#define THREAD_QUEUE_SIZE   16
+#define WAIT_TICKS          pdMS_TO_TICKS( 500 )
+#define TIMEOUT_TICKS       pdMS_TO_TICKS( 20 )
+#define TASK_ITEMS          200000
+
+/* 16 bytes like the Lab4b button events, the check words tell a torn item */
+typedef struct Item
+{
+    uint32_t ulNumber;
+    uint32_t ulCheck[ 3 ];
+} Item_t;
+
+static TaskHandle_t xControlTask;
+static uint32_t ulFailures;
+
+static void prvFail( const char * pcWhat )
+{
+    if( ulFailures++ < 10U )
+    {
+        printf( "%s\n", pcWhat );
+    }
+}
+
+static void prvMakeItem( Item_t * pxItem,
+                         uint32_t ulNumber )
+{
+    pxItem->ulNumber = ulNumber;
+    pxItem->ulCheck[ 0 ] = ~ulNumber;
+    pxItem->ulCheck[ 1 ] = ulNumber * 2654435761U;
+    pxItem->ulCheck[ 2 ] = ulNumber ^ 0x5A5A5A5AU;
+}
+
+/* Counts the items that are torn or not the expected number. */
+static uint32_t prvCheckItem( const Item_t * pxItem,
+                              uint32_t ulExpected )
+{
+    Item_t xGood;
+
+    prvMakeItem( &xGood, ulExpected );
+
+    return ( ( pxItem->ulNumber != xGood.ulNumber ) || ( pxItem->ulCheck[ 0 ] != xGood.ulCheck[ 0 ] ) ||
+             ( pxItem->ulCheck[ 1 ] != xGood.ulCheck[ 1 ] ) || ( pxItem->ulCheck[ 2 ] != xGood.ulCheck[ 2 ] ) ) ? 1U : 0U;
+}
+
+static double prvSeconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( double ) xNow.tv_sec + ( double ) xNow.tv_nsec * 1e-9;
+}
+
+/*-----------------------------------------------------------*/
+
+static SpscQueueHandle_t xThreadQueue;
+static uint64_t ullFullRetries, ullEmptyRetries;
+static uint32_t ulThreadErrors;
+
+static void * prvProducerThread( void * pvParameters )
+{
+    Item_t xItem;
+    uint32_t ulNumber;
+
+    ( void ) pvParameters;
+
+    for( ulNumber = 0; ulNumber < THREAD_ITEMS; ulNumber++ )
+    {
+        prvMakeItem( &xItem, ulNumber );
+
+        while( xSpscQueueSend( xThreadQueue, &xItem, 0 ) != pdPASS )
+        {
+            ullFullRetries++;
+            sched_yield();
+        }
+    }
+
+    return NULL;
+}
+
+static void * prvConsumerThread( void * pvParameters )
+{
+    Item_t xItem;
+    uint32_t ulNumber;
+
+    ( void ) pvParameters;
+
+    for( ulNumber = 0; ulNumber < THREAD_ITEMS; ulNumber++ )
+    {
+        while( xSpscQueueReceive( xThreadQueue, &xItem, 0 ) != pdPASS )
+        {
+            ullEmptyRetries++;
+            sched_yield();
+        }
+
+        ulThreadErrors += prvCheckItem( &xItem, ulNumber );
+    }
+
+    return NULL;
+}
+
+/* Runs before the scheduler starts, the calls that do not block never enter
+ * the kernel. */
+static void prvCheckThreads( void )
+{
+    pthread_t xProducer, xConsumer;
+    KernelCounters_t xCounters;
+    double dStart, dSeconds;
+
+    xThreadQueue = xSpscQueueCreate( THREAD_QUEUE_SIZE, sizeof( Item_t ) );
+    configASSERT( xThreadQueue != NULL );
+
+    vKernelCountersReset();
+    dStart = prvSeconds();
+    pthread_create( &xConsumer, NULL, prvConsumerThread, NULL );
+    pthread_create( &xProducer, NULL, prvProducerThread, NULL );
+    pthread_join( xProducer, NULL );
+    pthread_join( xConsumer, NULL );
+    dSeconds = prvSeconds() - dStart;
+    xCounters = xKernelCountersGet();
+
+    printf( "threads: %d items through %d slots, %.2f M items/s, %.3f full and %.3f empty retries per item\n",
+            THREAD_ITEMS, THREAD_QUEUE_SIZE, THREAD_ITEMS / dSeconds / 1e6,
+            ( double ) ullFullRetries / THREAD_ITEMS, ( double ) ullEmptyRetries / THREAD_ITEMS );
+    printf( "threads: %lu torn or out of order, %lu critical sections\n", ( unsigned long ) ulThreadErrors,
+            ( unsigned long ) xCounters.ullCriticalSections );
+
+    if( ( ulThreadErrors != 0U ) || ( xCounters.ullCriticalSections != 0U ) ||
+        ( uxSpscQueueMessagesWaiting( xThreadQueue ) != 0U ) )
+    {
+        prvFail( "threads: items lost or critical sections entered" );
+    }
+
+    vSpscQueueDelete( xThreadQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvCheckTimeouts( void )
+{
+    SpscQueueHandle_t xQueue = xSpscQueueCreate( 2, sizeof( Item_t ) );
+    TickType_t xStart;
+    Item_t xItem;
+
+    configASSERT( xQueue != NULL );
+    prvMakeItem( &xItem, 0 );
+
+    xStart = xTaskGetTickCount();
+
+    if( ( xSpscQueueReceive( xQueue, &xItem, TIMEOUT_TICKS ) != errQUEUE_EMPTY ) ||
+        ( ( xTaskGetTickCount() - xStart ) < TIMEOUT_TICKS ) )
+    {
+        prvFail( "receive on an empty queue did not time out" );
+    }
+
+    ( void ) xSpscQueueSend( xQueue, &xItem, 0 );
+    ( void ) xSpscQueueSend( xQueue, &xItem, 0 );
+    xStart = xTaskGetTickCount();
+
+    if( ( xSpscQueueSend( xQueue, &xItem, TIMEOUT_TICKS ) != errQUEUE_FULL ) ||
+        ( ( xTaskGetTickCount() - xStart ) < TIMEOUT_TICKS ) )
+    {
+        prvFail( "send on a full queue did not time out" );
+    }
+
+    if( uxSpscQueueMessagesWaiting( xQueue ) != 2U )
+    {
+        prvFail( "items lost by the timeouts" );
+    }
+
+    printf( "timeouts: checked\n" );
+
+    ( void ) xSpscQueueReceive( xQueue, &xItem, 0 );
+    ( void ) xSpscQueueReceive( xQueue, &xItem, 0 );
+    vSpscQueueDelete( xQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+static SpscQueueHandle_t xWakeQueue;
+static BaseType_t xWaiterDone;
+static TickType_t xWaited;
+
+/* Stands in for an interrupt on the other side of the queue. */
+static void prvInterruptHook( void * pvQueue,
+                              int iSending )
+{
+    BaseType_t xWoken = pdFALSE;
+    Item_t xItem;
+
+    if( pvQueue != ( void * ) xWakeQueue )
+    {
+        return;
+    }
+
+    if( iSending == 0 )
+    {
+        prvMakeItem( &xItem, 0 );
+        ( void ) xSpscQueueSendFromISR( xWakeQueue, &xItem, &xWoken );
+    }
+    else
+    {
+        ( void ) xSpscQueueReceiveFromISR( xWakeQueue, &xItem, &xWoken );
+    }
+
+    /* The waiting task is the running one. */
+    if( xWoken != pdFALSE )
+    {
+        prvFail( "interrupt woke a higher priority task" );
+    }
+}
+
+static void prvWaitingReceiverTask( void * pvParameters )
+{
+    TickType_t xStart = xTaskGetTickCount();
+    Item_t xItem;
+
+    ( void ) pvParameters;
+
+    xWaiterDone = ( xSpscQueueReceive( xWakeQueue, &xItem, WAIT_TICKS ) == pdPASS );
+    xWaited = xTaskGetTickCount() - xStart;
+
+    if( ( xWaiterDone != pdFALSE ) && ( prvCheckItem( &xItem, 0 ) != 0U ) )
+    {
+        prvFail( "woken receiver got a wrong item" );
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+static void prvWaitingSenderTask( void * pvParameters )
+{
+    TickType_t xStart = xTaskGetTickCount();
+    Item_t xItem;
+
+    ( void ) pvParameters;
+
+    prvMakeItem( &xItem, 1 );
+    xWaiterDone = ( xSpscQueueSend( xWakeQueue, &xItem, WAIT_TICKS ) == pdPASS );
+    xWaited = xTaskGetTickCount() - xStart;
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+/* A task of higher priority blocks on the queue and the control task, or the
+ * hook, does what it waits for.  It has to run again well before its block
+ * time ends. */
+static void prvCheckWake( BaseType_t xSending,
+                          BaseType_t xFromInterrupt )
+{
+    const char * pcWaiter = ( xSending != pdFALSE ) ? "sender" : "receiver";
+    const char * pcWaker = ( xFromInterrupt != pdFALSE ) ? "an interrupt before it waits" : "a task";
+    Item_t xItem;
+
+    xWakeQueue = xSpscQueueCreate( 1, sizeof( Item_t ) );
+    configASSERT( xWakeQueue != NULL );
+    xWaiterDone = pdFALSE;
+
+    if( xSending != pdFALSE )
+    {
+        prvMakeItem( &xItem, 0 );
+        ( void ) xSpscQueueSend( xWakeQueue, &xItem, 0 );
+    }
+
+    vKernelCountersSetQueueHook( ( xFromInterrupt != pdFALSE ) ? prvInterruptHook : NULL );
+    xTaskCreate( ( xSending != pdFALSE ) ? prvWaitingSenderTask : prvWaitingReceiverTask, "Waiter",
+                 configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL );
+
+    if( xFromInterrupt == pdFALSE )
+    {
+        vTaskDelay( 10 );
+
+        if( xSending != pdFALSE )
+        {
+            if( ( xSpscQueueReceive( xWakeQueue, &xItem, 0 ) != pdPASS ) || ( prvCheckItem( &xItem, 0 ) != 0U ) )
+            {
+                prvFail( "item of the full queue lost" );
+            }
+        }
+        else
+        {
+            prvMakeItem( &xItem, 0 );
+            ( void ) xSpscQueueSend( xWakeQueue, &xItem, 0 );
+        }
+    }
+
+    ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    vKernelCountersSetQueueHook( NULL );
+
+    printf( "wake: blocked %s woken by %s after %lu ticks\n", pcWaiter, pcWaker, ( unsigned long ) xWaited );
+
+    if( ( xWaiterDone == pdFALSE ) || ( xWaited >= WAIT_TICKS / 2U ) )
+    {
+        prvFail( "blocked task not woken" );
+    }
+
+    /* What the sender posted after the wake */
+    if( xSending != pdFALSE )
+    {
+        if( ( xSpscQueueReceive( xWakeQueue, &xItem, 0 ) != pdPASS ) || ( prvCheckItem( &xItem, 1 ) != 0U ) )
+        {
+            prvFail( "woken sender's item missing" );
+        }
+    }
+
+    vSpscQueueDelete( xWakeQueue );
+}
+
+/*-----------------------------------------------------------*/
+
+static SpscQueueHandle_t xSpscQueue;
+static QueueHandle_t xKernelQueue;
+static uint32_t ulBlocks;
+
+static void prvCountBlocks( void * pvQueue,
+                            int iSending )
+{
+    ( void ) pvQueue;
+    ( void ) iSending;
+    ulBlocks++;
+}
+
+static BaseType_t prvSend( const Item_t * pxItem )
+{
+    return ( xSpscQueue != NULL ) ? xSpscQueueSend( xSpscQueue, pxItem, portMAX_DELAY ) :
+           xQueueSend( xKernelQueue, pxItem, portMAX_DELAY );
+}
+
+static BaseType_t prvReceive( Item_t * pxItem )
+{
+    return ( xSpscQueue != NULL ) ? xSpscQueueReceive( xSpscQueue, pxItem, portMAX_DELAY ) :
+           xQueueReceive( xKernelQueue, pxItem, portMAX_DELAY );
+}
+
+static void prvProducerTask( void * pvParameters )
+{
+    Item_t xItem;
+    uint32_t ulNumber;
+
+    ( void ) pvParameters;
+
+    for( ulNumber = 0; ulNumber < TASK_ITEMS; ulNumber++ )
+    {
+        prvMakeItem( &xItem, ulNumber );
+
+        if( prvSend( &xItem ) != pdPASS )
+        {
+            prvFail( "blocking send failed" );
+        }
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+static void prvConsumerTask( void * pvParameters )
+{
+    Item_t xItem;
+    uint32_t ulNumber, ulErrors = 0;
+
+    ( void ) pvParameters;
+
+    for( ulNumber = 0; ulNumber < TASK_ITEMS; ulNumber++ )
+    {
+        if( prvReceive( &xItem ) != pdPASS )
+        {
+            prvFail( "blocking receive failed" );
+        }
+
+        ulErrors += prvCheckItem( &xItem, ulNumber );
+    }
+
+    if( ulErrors != 0U )
+    {
+        prvFail( "tasks: items torn or out of order" );
+    }
+
+    xTaskNotifyGive( xControlTask );
+    vTaskDelete( NULL );
+}
+
+/* Producer and consumer at the same priority, the producer runs until the
+ * queue is full and the consumer until it is empty, a tick can switch them
+ * in between. */
+static void prvBenchmark( UBaseType_t uxLength,
+                          BaseType_t xSpsc )
+{
+    KernelCounters_t xCounters;
+    double dStart, dSeconds;
+
+    xSpscQueue = ( xSpsc != pdFALSE ) ? xSpscQueueCreate( uxLength, sizeof( Item_t ) ) : NULL;
+    xKernelQueue = ( xSpsc != pdFALSE ) ? NULL : xQueueCreate( uxLength, sizeof( Item_t ) );
+    configASSERT( ( xSpscQueue != NULL ) || ( xKernelQueue != NULL ) );
+
+    ulBlocks = 0;
+    vKernelCountersSetQueueHook( prvCountBlocks );
+    vKernelCountersReset();
+    dStart = prvSeconds();
+
+    xTaskCreate( prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL );
+    xTaskCreate( prvProducerTask, "Producer", configMINIMAL_STACK_SIZE * 4, NULL, 2, NULL );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+    ( void ) ulTaskNotifyTake( pdFALSE, portMAX_DELAY );
+
+    dSeconds = prvSeconds() - dStart;
+    xCounters = xKernelCountersGet();
+    vKernelCountersSetQueueHook( NULL );
+
+    printf( "len %2lu %-5s %5.2f M items/s, %5.2f critical sections, %5.3f blocks per item\n", ( unsigned long ) uxLength,
+            ( xSpsc != pdFALSE ) ? "spsc" : "queue", TASK_ITEMS / dSeconds / 1e6,
+            ( double ) xCounters.ullCriticalSections / TASK_ITEMS, ( double ) ulBlocks / TASK_ITEMS );
+
+    if( xSpsc != pdFALSE )
+    {
+        vSpscQueueDelete( xSpscQueue );
+    }
+    else
+    {
+        vQueueDelete( xKernelQueue );
+    }
+}
+
+static void prvControlTask( void * pvParameters )
+{
+    static const UBaseType_t uxLengths[] = { 4, 16, 64 };
+    size_t x;
+
+    ( void ) pvParameters;
+
+    prvCheckTimeouts();
+    prvCheckWake( pdFALSE, pdFALSE );
+    prvCheckWake( pdTRUE, pdFALSE );
+    prvCheckWake( pdFALSE, pdTRUE );
+    prvCheckWake( pdTRUE, pdTRUE );
+
+    /* Tasks that are not woken would block the benchmark for ever. */
+    if( ulFailures != 0U )
+    {
+        vTaskEndScheduler();
+    }
+
+    /* Host numbers: a critical section of the POSIX port is a signal mask
+     * change and a switch between tasks is a switch between threads. */
+    for( x = 0; x < sizeof( uxLengths ) / sizeof( uxLengths[ 0 ] ); x++ )
+    {
+        prvBenchmark( uxLengths[ x ], pdFALSE );
+        prvBenchmark( uxLengths[ x ], pdTRUE );
+    }
+
+    vTaskEndScheduler();
+}
+
+int main( void )
+{
+    prvCheckThreads();
+
+    xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE * 4, NULL, 1, &xControlTask );
+    vTaskStartScheduler();
+
+    return ulFailures ? 1 : 0;
+}
@@ -0,0 +1,124 @@
+//
+// Interrupt driven button input.
+//
+
+#include "ButtonService.h"
+
+static ButtonService *service;
+
+void button_service_gpio_callback(uint gpio, uint32_t) {
+    if(service) service->gpio_irq(gpio);
+}
+
+ButtonService::ButtonService(QueueHandle_t events, uint32_t debounce_ms, uint32_t long_press_ms) :
+        events{events}, task{nullptr}, debounce_us{debounce_ms * 1000}, long_press_us{long_press_ms * 1000},
+        pins{}, count{0}, dropped{0}, wakeups{0} {
+    service = this;
+}
+
+bool ButtonService::add(uint8_t id, uint pin) {
+    if(count >= max_buttons || task) return false;
+
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_up(pin);
+
+    PinState &state = pins[count++];
+    state.pin = pin;
+    state.id = id;
+    state.raw = !gpio_get(pin);  // Active low
+    state.stable = state.raw;
+    state.long_sent = true;  // no long press for a button that was down at start
+    state.edge_us = time_us_32();
+    state.pressed_us = state.edge_us;
+    return true;
+}
+
+bool ButtonService::start(UBaseType_t priority, configSTACK_DEPTH_TYPE stack_size) {
+    if(xTaskCreate(task_entry, "Buttons", stack_size, this, priority, &task) != pdPASS) {
+        return false;
+    }
+    // the same callback serves all pins, interrupts are enabled on the calling core
+    for(int i = 0; i < count; ++i) {
+        gpio_set_irq_enabled_with_callback(pins[i].pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true,
+                                           &button_service_gpio_callback);
+    }
+    return true;
+}
+
+void ButtonService::gpio_irq(uint gpio) {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    for(int i = 0; i < count; ++i) {
+        PinState &state = pins[i];
+        if(state.pin == gpio) {
+            // just remember when the pin last moved, the task decides when it is stable
+            UBaseType_t status = taskENTER_CRITICAL_FROM_ISR();
+            state.edge_us = time_us_32();
+            state.raw = !gpio_get(gpio);
+            taskEXIT_CRITICAL_FROM_ISR(status);
+            if(task) xTaskNotifyFromISR(task, 1u << i, eSetBits, &xHigherPriorityTaskWoken);
+            break;
+        }
+    }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void ButtonService::task_entry(void *param) {
+    static_cast<ButtonService *>(param)->run();
+}
+
+void ButtonService::run() {
+    TickType_t timeout = portMAX_DELAY;
+
+    for(;;) {
+        xTaskNotifyWait(0, UINT32_MAX, nullptr, timeout);
+        ++wakeups;
+        timeout = portMAX_DELAY;
+        uint32_t now = time_us_32();
+        uint32_t next_us = UINT32_MAX; // time until the nearest pending deadline
+
+        for(int i = 0; i < count; ++i) {
+            PinState &state = pins[i];
+            // take a consistent copy of the values written by the interrupt
+            taskENTER_CRITICAL();
+            bool raw = state.raw;
+            uint32_t edge_us = state.edge_us;
+            taskEXIT_CRITICAL();
+
+            if(raw != state.stable) {
+                uint32_t elapsed = now - edge_us;
+                if(elapsed >= debounce_us) {
+                    state.stable = raw;
+                    if(raw) {
+                        state.pressed_us = edge_us;
+                        state.long_sent = false;
+                    }
+                    publish(state, raw ? ButtonEventType::Pressed : ButtonEventType::Released, edge_us);
+                } else if(debounce_us - elapsed < next_us) {
+                    next_us = debounce_us - elapsed;
+                }
+            }
+            if(state.stable && !state.long_sent) {
+                uint32_t held = now - state.pressed_us;
+                if(held >= long_press_us) {
+                    state.long_sent = true;
+                    publish(state, ButtonEventType::LongPress, now);
+                } else if(long_press_us - held < next_us) {
+                    next_us = long_press_us - held;
+                }
+            }
+        }
+
+        if(next_us != UINT32_MAX) {
+            // round up so that we never wake before the deadline
+            timeout = (static_cast<uint64_t>(next_us) * configTICK_RATE_HZ + 999999) / 1000000;
+        }
+    }
+}
+
+void ButtonService::publish(const PinState &state, ButtonEventType type, uint32_t time_us) {
+    ButtonEvent e{state.id, type, time_us};
+    if(xQueueSendToBack(events, &e, 0) != pdPASS) {
+        ++dropped;
+    }
+}
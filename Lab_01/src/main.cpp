@@ -2,6 +2,7 @@
 #include "task.h"
 #include "queue.h"
 #include "pico/stdlib.h"
+#include "ButtonService.h"
 #include <cstdio>
 
 extern "C" {
@@ -13,68 +14,14 @@ uint32_t read_runtime_ctr(void) {
 const uint LED_PIN = 21;
 const uint DEBOUNCE_DELAY_MS = 20;
 const uint QUEUE_SIZE = 20;
-const uint POLL_DELAY_MS = 10;
 
 const uint8_t unlockSequence[] = {0, 0, 2, 1, 2};
 const size_t unlockSequenceLength = sizeof(unlockSequence) / sizeof(unlockSequence[0]);
 
 QueueHandle_t buttonQueue;
 
-class Button {
-public:
-    Button(uint8_t id, uint pin) : buttonId(id), buttonPin(pin) {
-        gpio_init(buttonPin);
-        gpio_set_dir(buttonPin, GPIO_IN);
-        gpio_pull_up(buttonPin);
-    }
-
-    [[nodiscard]] bool isPressed() const {
-        return !gpio_get(buttonPin);  // Active low
-    }
-
-    [[nodiscard]] uint8_t getId() const {
-        return buttonId;
-    }
-
-    [[nodiscard]] bool debounce() const {
-        if (isPressed()) {
-            vTaskDelay(pdMS_TO_TICKS(DEBOUNCE_DELAY_MS));  // Debounce delay
-            if (isPressed()) {
-                return true;
-            }
-        }
-        return false;
-    }
-
-private:
-    uint8_t buttonId;
-    uint buttonPin;
-};
-
-void button_task(void *param) {
-    auto *button = (Button *)param;
-
-    while (true) {
-        // Wait for button press and debounce
-        if (button->debounce()) {
-            printf("Button %d pressed\n", button->getId());
-            while (button->isPressed()) {
-                vTaskDelay(pdMS_TO_TICKS(POLL_DELAY_MS));  //check for release
-            }
-
-            // send the button press event to the queue
-            uint8_t buttonId = button->getId();
-            if (xQueueSend(buttonQueue, &buttonId, portMAX_DELAY) != pdPASS) {
-                printf("Failed to send button press to queue\n");
-            }
-        }
-
-        vTaskDelay(pdMS_TO_TICKS(POLL_DELAY_MS));
-    }
-}
-
 void sequence_task(void *param) {
-    uint8_t receivedButton;
+    ButtonEvent event;
     size_t sequenceIndex = 0;
     bool sequenceStarted = false;
 
@@ -83,7 +30,15 @@ void sequence_task(void *param) {
     gpio_put(LED_PIN, false);  // Set LED off
 
     while (true) {
-        if (xQueueReceive(buttonQueue, &receivedButton, pdMS_TO_TICKS(5000)) == pdPASS) {
+        if (xQueueReceive(buttonQueue, &event, pdMS_TO_TICKS(5000)) == pdPASS) {
+            if (event.type == ButtonEventType::Pressed) {
+                printf("Button %d pressed\n", event.id);
+            }
+            // button counts when it is released
+            if (event.type != ButtonEventType::Released) {
+                continue;
+            }
+            uint8_t receivedButton = event.id;
             sequenceStarted = true;
             printf("Received button %d\n", receivedButton);
 
@@ -119,20 +74,18 @@ void sequence_task(void *param) {
 int main() {
     stdio_init_all();
 
-    buttonQueue = xQueueCreate(QUEUE_SIZE, sizeof(uint8_t));
+    buttonQueue = xQueueCreate(QUEUE_SIZE, sizeof(ButtonEvent));
 
     if (buttonQueue == nullptr) {
         printf("Failed to create buttonQueue\n");
         while (true);
     }
 
-    static Button button0(0, 9);  // SW0
-    static Button button1(1, 8);  // SW1
-    static Button button2(2, 7);  // SW2
-
-    xTaskCreate(button_task, "Button_SW0", 256, (void *)&button0, tskIDLE_PRIORITY + 3, nullptr);
-    xTaskCreate(button_task, "Button_SW1", 256, (void *)&button1, tskIDLE_PRIORITY + 3, nullptr);
-    xTaskCreate(button_task, "Button_SW2", 256, (void *)&button2, tskIDLE_PRIORITY + 3, nullptr);
+    static ButtonService buttons(buttonQueue, DEBOUNCE_DELAY_MS);
+    buttons.add(0, 9);  // SW0
+    buttons.add(1, 8);  // SW1
+    buttons.add(2, 7);  // SW2
+    buttons.start(tskIDLE_PRIORITY + 3);
 
     xTaskCreate(sequence_task, "Sequence", 256, nullptr, tskIDLE_PRIORITY + 2, nullptr);
 
@@ -0,0 +1,54 @@
+/*
+ * Kernel configuration of the host tests, built with the POSIX port.
+ *
+ * The tick only moves on while the tasks are idle.  The idle hook advances it
+ * by one and tickless idle skips straight to the next wake, see
+ * button_service_test.cpp, so the simulated timings hold to the tick.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     0
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                    8
+#define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 256
+#define configMAX_TASK_NAME_LEN                 16
+#define configUSE_16_BIT_TICKS                  0
+#define configUSE_MUTEXES                       1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_TIMERS                        0
+#define configSTACK_DEPTH_TYPE                  uint32_t
+
+#define configUSE_TICKLESS_IDLE                 1
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vTestSkipIdleTicks( xExpectedIdleTime )
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void vTestSkipIdleTicks( uint32_t ulExpectedIdleTime );
+#ifdef __cplusplus
+}
+#endif
+
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configTOTAL_HEAP_SIZE                   ( 16 * 1024 * 1024 )
+
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_TRACE_FACILITY                1
+
+#include <assert.h>
+#define configASSERT(x)                         assert(x)
+
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+
+#endif /* FREERTOS_CONFIG_H */
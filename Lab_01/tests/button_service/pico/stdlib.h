@@ -0,0 +1,25 @@
+//
+// Stand-in for the Pico SDK calls of ButtonService.cpp. The pin levels and
+// the microsecond timer are simulated by button_service_test.cpp.
+//
+
+#ifndef BUTTON_SERVICE_STUB_STDLIB_H
+#define BUTTON_SERVICE_STUB_STDLIB_H
+
+#include <cstdint>
+
+typedef unsigned int uint;
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+#define GPIO_IN             false
+#define GPIO_IRQ_EDGE_FALL  0x4u
+#define GPIO_IRQ_EDGE_RISE  0x8u
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+bool gpio_get(uint gpio);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback);
+uint32_t time_us_32();
+
+#endif //BUTTON_SERVICE_STUB_STDLIB_H
@@ -0,0 +1,288 @@
+//
+// Test of ButtonService on the host with simulated bouncing contacts. Two
+// buttons are pressed and released for five simulated minutes: presses short
+// and long, each edge followed by up to four pairs of chatter edges, and
+// glitches shorter than the debounce time. The pins and time_us_32() are
+// simulated, a driver task raises the GPIO interrupt on each edge. The tick
+// only moves on while the tasks are idle, so the timings hold to the tick.
+//
+// Checks that every press gives exactly one Pressed and one Released event
+// with the time of the edge the contact settled on, long presses one
+// LongPress, glitches nothing, and that each event is received no earlier
+// than the debounce (or long press) time after that edge and at most two
+// ticks later. The service task may wake once per edge and twice per pending
+// deadline; the wakeups are reported against polling every 10 ms.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "ButtonService.h"
+
+static constexpr int BUTTONS = 2;
+static constexpr uint PINS[BUTTONS] = {9, 8};
+static constexpr uint32_t DEBOUNCE_MS = 20;
+static constexpr uint32_t LONG_PRESS_MS = 1000;
+static constexpr uint64_t SIMULATED_US = 300 * 1000000ull;
+static constexpr uint32_t MAX_CHATTER_GAP_US = 3000;
+static constexpr uint64_t LATENCY_LIMIT_US = 2 * 1000000 / configTICK_RATE_HZ;
+static constexpr uint32_t POLL_MS = 10;  // the polling button tasks ButtonService replaced
+static constexpr unsigned WATCHDOG_SECONDS = 20;  // the test takes well under a second
+
+static constexpr UBaseType_t SERVICE_PRIORITY = 2;
+static constexpr UBaseType_t CONSUMER_PRIORITY = 3;
+static constexpr UBaseType_t DRIVER_PRIORITY = 4;
+
+struct Edge {
+    uint64_t time_us;
+    int button;
+    bool pressed;
+};
+
+struct Expected {
+    ButtonEventType type;
+    uint64_t edge_us;  // time the event carries, for LongPress the earliest one
+    uint64_t due_us;   // earliest time the event may be received
+};
+
+struct Received {
+    ButtonEvent event;
+    uint64_t time_us;
+};
+
+static int failures = 0;
+
+static void check(bool ok, int button, size_t event, const char *what) {
+    if (!ok) {
+        if (failures < 10) printf("button %d event %zu: %s\n", button, event, what);
+        ++failures;
+    }
+}
+
+//-----------------------------------------------------------
+// Simulated pins and timer, see button_service/pico/stdlib.h
+
+static bool levels[32];  // true is high, the buttons are active low
+static gpio_irq_callback_t irqCallback;
+static uint64_t edgeTime;  // time of the latest edge, ahead of the tick within the tick
+
+void gpio_init(uint) {}
+void gpio_set_dir(uint, bool) {}
+
+void gpio_pull_up(uint gpio) {
+    levels[gpio] = true;
+}
+
+bool gpio_get(uint gpio) {
+    return levels[gpio];
+}
+
+void gpio_set_irq_enabled_with_callback(uint, uint32_t, bool, gpio_irq_callback_t callback) {
+    irqCallback = callback;
+}
+
+static uint64_t nowUs() {
+    uint64_t tick = static_cast<uint64_t>(xTaskGetTickCount()) * (1000000 / configTICK_RATE_HZ);
+    return std::max(tick, edgeTime);
+}
+
+uint32_t time_us_32() {
+    return static_cast<uint32_t>(nowUs());
+}
+
+//-----------------------------------------------------------
+// Virtual tick, see FreeRTOSConfig.h
+
+extern "C" void vApplicationIdleHook() {
+    static bool tickStopped = false;
+
+    if (!tickStopped) {
+        // the port's tick thread raises the tick interrupt as SIGALRM
+        signal(SIGALRM, SIG_IGN);
+        tickStopped = true;
+    }
+    xTaskCatchUpTicks(1);
+}
+
+extern "C" void vTestSkipIdleTicks(uint32_t expectedIdleTime) {
+    // called with the scheduler suspended, the last tick is processed when it resumes
+    portDISABLE_INTERRUPTS();
+    if (eTaskConfirmSleepModeStatus() == eStandardSleep) {
+        vTaskStepTick(expectedIdleTime);
+    }
+    portENABLE_INTERRUPTS();
+}
+
+//-----------------------------------------------------------
+// Script of the edges and the events they have to give
+
+static std::vector<Edge> edges;
+static std::vector<Expected> expected[BUTTONS];
+static std::vector<Received> received[BUTTONS];
+
+static uint32_t randomBetween(uint32_t low, uint32_t high) {
+    return low + static_cast<uint32_t>(rand()) % (high - low + 1);
+}
+
+// the contact chatters a few times before it settles on the new level, returns the time it settled
+static uint64_t bounce(int button, uint64_t &t, bool pressed) {
+    edges.push_back({t, button, pressed});
+    int chatter = rand() % 5;
+    for (int i = 0; i < chatter; ++i) {
+        t += randomBetween(50, MAX_CHATTER_GAP_US);
+        edges.push_back({t, button, !pressed});
+        t += randomBetween(50, MAX_CHATTER_GAP_US);
+        edges.push_back({t, button, pressed});
+    }
+    return t;
+}
+
+static void makeScript() {
+    for (int button = 0; button < BUTTONS; ++button) {
+        uint64_t t = 100000 + button * 37000;
+        while (t < SIMULATED_US) {
+            if (rand() % 10 == 0) {
+                // glitch, back to the released level before the debounce time
+                edges.push_back({t, button, true});
+                t += randomBetween(100, (DEBOUNCE_MS - 2) * 1000);
+                edges.push_back({t, button, false});
+            } else {
+                uint64_t pressed = bounce(button, t, true);
+                expected[button].push_back({ButtonEventType::Pressed, pressed, pressed + DEBOUNCE_MS * 1000});
+                // hold from the first release edge, clear of the long press time so the outcome is certain
+                bool longPress = rand() % 3 == 0;
+                uint32_t hold_ms = longPress ? randomBetween(LONG_PRESS_MS + 100, 2500) : randomBetween(60, 900);
+                if (longPress) {
+                    uint64_t due = pressed + LONG_PRESS_MS * 1000;
+                    expected[button].push_back({ButtonEventType::LongPress, due, due});
+                }
+                t = pressed + hold_ms * 1000;
+                uint64_t released = bounce(button, t, false);
+                expected[button].push_back({ButtonEventType::Released, released, released + DEBOUNCE_MS * 1000});
+            }
+            t += randomBetween(60, 400) * 1000;
+        }
+    }
+    std::stable_sort(edges.begin(), edges.end(), [](const Edge &a, const Edge &b) { return a.time_us < b.time_us; });
+}
+
+//-----------------------------------------------------------
+
+static QueueHandle_t events;
+static ButtonService *service;
+
+static void consumerTask(void *) {
+    for (;;) {
+        ButtonEvent event;
+        if (xQueueReceive(events, &event, portMAX_DELAY) == pdPASS) {
+            configASSERT(event.id < BUTTONS);
+            received[event.id].push_back({event, nowUs()});
+        }
+    }
+}
+
+static void checkEvents(uint64_t &latencyTotal, uint64_t &latencyMax, size_t &count) {
+    for (int button = 0; button < BUTTONS; ++button) {
+        check(received[button].size() == expected[button].size(), button, received[button].size(),
+              "wrong number of events");
+        size_t n = std::min(received[button].size(), expected[button].size());
+        for (size_t i = 0; i < n; ++i) {
+            const Expected &e = expected[button][i];
+            const Received &r = received[button][i];
+            check(r.event.type == e.type, button, i, "wrong event");
+            if (e.type == ButtonEventType::LongPress) {
+                uint32_t late = r.event.time_us - static_cast<uint32_t>(e.edge_us);
+                check(late <= LATENCY_LIMIT_US, button, i, "long press time wrong");
+            } else {
+                check(r.event.time_us == static_cast<uint32_t>(e.edge_us), button, i, "not the settling edge");
+            }
+            check(r.time_us >= e.due_us, button, i, "received before the debounce time");
+            check(r.time_us <= e.due_us + LATENCY_LIMIT_US, button, i, "received late");
+            uint64_t latency = r.time_us >= e.due_us ? r.time_us - e.due_us : 0;
+            latencyTotal += latency;
+            latencyMax = std::max(latencyMax, latency);
+        }
+        count += n;
+    }
+}
+
+static void driverTask(void *) {
+    for (const Edge &edge : edges) {
+        TickType_t due = static_cast<TickType_t>(edge.time_us * configTICK_RATE_HZ / 1000000);
+        TickType_t now = xTaskGetTickCount();
+        if (due > now) vTaskDelay(due - now);
+        configASSERT(xTaskGetTickCount() == due);
+
+        // the interrupt of the edge
+        edgeTime = edge.time_us;
+        levels[PINS[edge.button]] = !edge.pressed;
+        irqCallback(PINS[edge.button], edge.pressed ? GPIO_IRQ_EDGE_FALL : GPIO_IRQ_EDGE_RISE);
+    }
+    vTaskDelay(pdMS_TO_TICKS(LONG_PRESS_MS * 3));
+
+    uint64_t latencyTotal = 0, latencyMax = 0;
+    size_t count = 0;
+    checkEvents(latencyTotal, latencyMax, count);
+    check(service->get_dropped() == 0, 0, 0, "events dropped");
+
+    uint32_t wakeups = service->get_wakeups();
+    uint64_t polls = SIMULATED_US / (POLL_MS * 1000) * BUTTONS;
+    uint32_t deadlines = static_cast<uint32_t>(count);
+    check(wakeups <= edges.size() + 2 * deadlines, 0, 0, "too many wakeups");
+
+    printf("%zu edges, %zu events, latency after the debounce time avg %llu us max %llu us\n", edges.size(), count,
+           static_cast<unsigned long long>(count ? latencyTotal / count : 0),
+           static_cast<unsigned long long>(latencyMax));
+    printf("service task wakeups %lu (%.2f per edge), polling every %lu ms %llu\n", static_cast<unsigned long>(wakeups),
+           static_cast<double>(wakeups) / edges.size(), static_cast<unsigned long>(POLL_MS),
+           static_cast<unsigned long long>(polls));
+
+    if (failures) {
+        printf("%d failures\n", failures);
+    } else {
+        printf("OK\n");
+    }
+    fflush(stdout);
+    // the scheduler of the V11 POSIX port doesn't return to main, the process is ended from the task
+    _exit(failures ? 1 : 0);
+}
+
+// a task that never blocks keeps the tick from moving, so the test is failed on the host's clock
+static void watchdog() {
+    sleep(WATCHDOG_SECONDS);
+    printf("still running after %u s\n", WATCHDOG_SECONDS);
+    fflush(stdout);
+    _exit(1);
+}
+
+int main() {
+    // the tick signal of the POSIX port has to go to the kernel's threads
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+    std::thread(watchdog).detach();
+    pthread_sigmask(SIG_SETMASK, &old, nullptr);
+
+    srand(1);
+    makeScript();
+
+    events = xQueueCreate(16, sizeof(ButtonEvent));
+    static ButtonService buttons(events, DEBOUNCE_MS, LONG_PRESS_MS);
+    service = &buttons;
+    for (int button = 0; button < BUTTONS; ++button) {
+        buttons.add(static_cast<uint8_t>(button), PINS[button]);
+    }
+    buttons.start(SERVICE_PRIORITY, configMINIMAL_STACK_SIZE * 16);
+    xTaskCreate(consumerTask, "Consumer", configMINIMAL_STACK_SIZE * 16, nullptr, CONSUMER_PRIORITY, nullptr);
+    xTaskCreate(driverTask, "Driver", configMINIMAL_STACK_SIZE * 16, nullptr, DRIVER_PRIORITY, nullptr);
+    vTaskStartScheduler();
+
+    return 1;
+}
@@ -0,0 +1,74 @@
+//
+// Blinking LED output.
+//
+
+#include "BlinkOutput.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+
+BlinkOutput::BlinkOutput(uint pin, PublishedState<BlinkSetting> &setting) : pin{pin}, setting{setting} {
+}
+
+bool BlinkOutput::start_pwm(uint32_t frequency_hz) {
+    // clock divider has 8 integer and 4 fractional bits, counter is 16 bits
+    uint64_t clock16 = static_cast<uint64_t>(clock_get_hz(clk_sys)) * 16;
+    uint64_t div16 = (clock16 + frequency_hz * 65536ull - 1) / (frequency_hz * 65536ull);
+    if (div16 < 16) div16 = 16;
+    if (div16 > 0xFFF) return false;  // too slow for the pwm
+    uint32_t wrap = clock16 / (div16 * frequency_hz) - 1;
+
+    uint slice = pwm_gpio_to_slice_num(pin);
+    pwm_set_enabled(slice, false);
+    pwm_set_clkdiv_int_frac(slice, div16 >> 4, div16 & 0xF);
+    pwm_set_wrap(slice, wrap);
+    pwm_set_chan_level(slice, pwm_gpio_to_channel(pin), (wrap + 1) / 2);
+    pwm_set_counter(slice, 0);
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    pwm_set_enabled(slice, true);
+    return true;
+}
+
+void BlinkOutput::start_gpio() {
+    pwm_set_enabled(pwm_gpio_to_slice_num(pin), false);
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_OUT);
+    gpio_put(pin, 0);
+}
+
+void BlinkOutput::run() {
+    setting.subscribe(xTaskGetCurrentTaskHandle(), 1);
+    start_gpio();
+
+    for (;;) {
+        uint32_t version;
+        BlinkSetting current = setting.read(&version);
+        uint32_t frequency = current.frequency_hz;
+
+        if (!current.on || frequency == 0) {
+            // LED is OFF until the setting changes
+            start_gpio();
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else if (start_pwm(frequency)) {
+            // hardware does the blinking
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        } else {
+            // toggle on the edges of the schedule until the setting changes
+            start_gpio();
+            BlinkSchedule schedule(xTaskGetTickCount(), frequency);
+            bool level = true;
+            gpio_put(pin, level);
+            TickType_t edge = schedule.next();
+            while (setting.get_version() == version) {
+                // waiting for the absolute edge time works like xTaskDelayUntil but a new setting wakes us
+                TickType_t wait = edge - xTaskGetTickCount();
+                if (wait > 0 && wait < portMAX_DELAY / 2) {
+                    ulTaskNotifyTake(pdTRUE, wait);
+                    continue;
+                }
+                level = !level;
+                gpio_put(pin, level);
+                edge = schedule.next();
+            }
+        }
+    }
+}
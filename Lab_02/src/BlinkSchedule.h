@@ -0,0 +1,37 @@
+//
+// Drift free blink schedule.
+//
+// Kept apart from BlinkOutput, which needs the Pico SDK, so that the
+// schedule can be simulated on the host, see tests/blink_schedule_test.cpp.
+//
+
+#ifndef BLINKSCHEDULE_H
+#define BLINKSCHEDULE_H
+
+#include <cstdint>
+#include "FreeRTOS.h"
+
+// Edge times of a square wave in ticks. Edges are rounded to the nearest
+// tick but computed from the exact start time, so the error never exceeds
+// half a tick and the average period is exact.
+class BlinkSchedule {
+public:
+    BlinkSchedule(TickType_t start, uint32_t frequency_hz) :
+            start{start}, half_period_us{500000u / frequency_hz}, half_period_rem{500000u % frequency_hz},
+            frequency{frequency_hz}, edges{0} {}
+    // tick of the next edge
+    TickType_t next() {
+        ++edges;
+        // microseconds since start, remainder of 500000 / f is included so there is no truncation drift
+        uint64_t us = edges * half_period_us + edges * half_period_rem / frequency;
+        return start + static_cast<TickType_t>((us * configTICK_RATE_HZ + 500000) / 1000000);
+    }
+private:
+    TickType_t start;
+    uint32_t half_period_us;
+    uint32_t half_period_rem;
+    uint32_t frequency;
+    uint64_t edges;
+};
+
+#endif //BLINKSCHEDULE_H
@@ -0,0 +1,91 @@
+//
+// Interrupt to task event channel.
+//
+// Events posted from interrupts go to a fixed size ring that is drained by
+// one task in batches. The consumer is woken with a direct to task
+// notification only when the ring goes from empty to non-empty, so a burst
+// of events costs one wake up. An optional merge function can fold a new
+// event into the newest pending one, for example to keep only the latest
+// button edge. Events that don't fit are counted, never blocked on.
+//
+// The consumer's notification value (index 0) is used by the channel.
+//
+
+#ifndef EVENTCHANNEL_H
+#define EVENTCHANNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "task.h"
+
+template<typename T, size_t N>
+class EventChannel {
+    static_assert((N & (N - 1)) == 0, "EventChannel size must be a power of two");
+public:
+    // return true if incoming was merged into pending and must not be stored separately
+    using Merge = bool (*)(T &pending, const T &incoming);
+
+    explicit EventChannel(Merge merge = nullptr) :
+            merge{merge}, consumer{nullptr}, head{0}, tail{0}, overflows{0}, merged{0} {}
+    EventChannel(const EventChannel &) = delete;
+
+    // task that calls receive(), must be set before events are posted
+    void set_consumer(TaskHandle_t task) { consumer = task; }
+
+    bool post_from_isr(const T &event, BaseType_t *pxHigherPriorityTaskWoken) {
+        bool stored = true;
+        bool wake = false;
+        UBaseType_t status = taskENTER_CRITICAL_FROM_ISR();
+        if (head != tail && merge && merge(events[(head - 1) % N], event)) {
+            ++merged;
+        } else if (head - tail < N) {
+            wake = head == tail;
+            events[head % N] = event;
+            ++head;
+        } else {
+            ++overflows;
+            stored = false;
+        }
+        taskEXIT_CRITICAL_FROM_ISR(status);
+        // only the first event of a batch needs to wake the consumer
+        if (wake && consumer) {
+            vTaskNotifyGiveFromISR(consumer, pxHigherPriorityTaskWoken);
+        }
+        return stored;
+    }
+
+    // wait until there are events and copy up to max of them to buffer, returns 0 on timeout
+    size_t receive(T *buffer, size_t max, TickType_t timeout) {
+        size_t count = drain(buffer, max);
+        while (count == 0 && ulTaskNotifyTake(pdTRUE, timeout) != 0) {
+            count = drain(buffer, max);
+        }
+        return count;
+    }
+
+    [[nodiscard]] uint32_t get_overflows() const { return overflows; }
+    [[nodiscard]] uint32_t get_merged() const { return merged; }
+private:
+    size_t drain(T *buffer, size_t max) {
+        size_t count = 0;
+        // merge may modify the newest event, so copying is done with the producer locked out
+        taskENTER_CRITICAL();
+        while (tail != head && count < max) {
+            buffer[count++] = events[tail % N];
+            ++tail;
+        }
+        taskEXIT_CRITICAL();
+        return count;
+    }
+
+    Merge merge;
+    TaskHandle_t consumer;
+    T events[N];
+    uint32_t head;
+    uint32_t tail;
+    volatile uint32_t overflows;
+    volatile uint32_t merged;
+};
+
+#endif //EVENTCHANNEL_H
@@ -5,6 +5,9 @@
 #include "task.h"
 #include "queue.h"
 #include "semphr.h"
+#include "QuadratureEncoder.h"
+#include "EventChannel.h"
+#include "BlinkOutput.h"
 
 extern "C" {
 uint32_t read_runtime_ctr(void) {
@@ -20,12 +23,12 @@ uint32_t read_runtime_ctr(void) {
 #define BUTTON_DEBOUNCE_MS 250  // Adjusted to 250 ms as per requirement
 #define MIN_FREQUENCY 2
 #define MAX_FREQUENCY 200
+#define EVENT_BATCH_SIZE 8
 
 // Event types
 typedef enum {
     BUTTON_PRESS,
-    ENCODER_TURN_CLOCKWISE,
-    ENCODER_TURN_COUNTERCLOCKWISE
+    ENCODER_TURN
 } EventType;
 
 // Event structure
@@ -34,12 +37,33 @@ typedef struct {
     TickType_t time;
 } Event;
 
-// Queue handle
-QueueHandle_t xEventQueue;
+// Keep only the latest of consecutive events of the same type. Encoder steps are
+// accumulated by the encoder, so one pending ENCODER_TURN is enough.
+bool mergeEvents(Event &pending, const Event &incoming) {
+    if (pending.type != incoming.type) return false;
+    pending = incoming;
+    return true;
+}
+
+// Event channel from interrupts to the event task
+EventChannel<Event, 16> xEventChannel(mergeEvents);
+
+// LED state and frequency, published by the event task (initially off, 5 Hz)
+PublishedState<BlinkSetting> blinkSetting({false, 5});
+
+// LED blinking in hardware or with a drift free schedule
+BlinkOutput blink(LED_PIN, blinkSetting);
+
+// Encoder posts one event per burst of turning, the steps are collected with take()
+bool encoderNotify(BaseType_t *pxHigherPriorityTaskWoken) {
+    Event event;
+    event.time = xTaskGetTickCountFromISR();
+    event.type = ENCODER_TURN;
+    return xEventChannel.post_from_isr(event, pxHigherPriorityTaskWoken);
+}
 
-// LED state and frequency (shared variables)
-volatile int ledState = 0;            // 0 = off, 1 = on
-volatile int blinkFrequency = 5;      // Initial blink frequency (in Hz)
+// Rotary encoder decoder
+QuadratureEncoder encoder(ROT_A_PIN, ROT_B_PIN, 4, encoderNotify);
 
 // GPIO interrupt handler
 void gpio_callback(uint gpio, uint32_t events) {
@@ -49,15 +73,9 @@ void gpio_callback(uint gpio, uint32_t events) {
 
     if (gpio == ROT_SW_PIN && (events & GPIO_IRQ_EDGE_FALL)) {
         event.type = BUTTON_PRESS;
-        xQueueSendFromISR(xEventQueue, &event, &xHigherPriorityTaskWoken);
-    } else if (gpio == ROT_A_PIN && (events & GPIO_IRQ_EDGE_RISE)) {
-        // Determine direction based on state of ROT_B_PIN
-        if (gpio_get(ROT_B_PIN) == 0) {
-            event.type = ENCODER_TURN_CLOCKWISE;
-        } else {
-            event.type = ENCODER_TURN_COUNTERCLOCKWISE;
-        }
-        xQueueSendFromISR(xEventQueue, &event, &xHigherPriorityTaskWoken);
+        xEventChannel.post_from_isr(event, &xHigherPriorityTaskWoken);
+    } else {
+        encoder.gpio_irq(gpio, &xHigherPriorityTaskWoken);
     }
 
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
@@ -66,43 +84,50 @@ void gpio_callback(uint gpio, uint32_t events) {
 // Function to enable GPIO interrupts
 void enable_gpio_interrupts() {
     // Set up GPIO interrupts
-    gpio_set_irq_enabled_with_callback(ROT_A_PIN, GPIO_IRQ_EDGE_RISE, true, &gpio_callback);
+    encoder.enable(&gpio_callback);
     gpio_set_irq_enabled(ROT_SW_PIN, GPIO_IRQ_EDGE_FALL, true);
 }
 
-// Task to process events from the queue
+// Task to process events from the event channel
 void vEventTask(void *pvParameters) {
-    Event event;
+    Event batch[EVENT_BATCH_SIZE];
     TickType_t lastButtonPressTime = 0;
+    BlinkSetting setting = blinkSetting.read();  // this task is the only writer
+
+    xEventChannel.set_consumer(xTaskGetCurrentTaskHandle());
 
     // Enable GPIO interrupts after task is running
     enable_gpio_interrupts();
 
     while (1) {
-        if (xQueueReceive(xEventQueue, &event, portMAX_DELAY)) {
+        // handle everything that arrived since the previous wake up
+        size_t count = xEventChannel.receive(batch, EVENT_BATCH_SIZE, portMAX_DELAY);
+        for (size_t i = 0; i < count; ++i) {
+            const Event &event = batch[i];
             switch (event.type) {
                 case BUTTON_PRESS:
                     // Debounce button
                     if ((event.time - lastButtonPressTime) > pdMS_TO_TICKS(BUTTON_DEBOUNCE_MS)) {
-                        ledState = !ledState;  // Toggle LED state
-                        printf("LED state: %d\n", ledState);
+                        setting.on = !setting.on;  // Toggle LED state
+                        blinkSetting.publish(setting);
+                        printf("LED state: %d\n", setting.on);
                         lastButtonPressTime = event.time;
                     }
                     break;
 
-                case ENCODER_TURN_CLOCKWISE:
-                    if (ledState) {
-                        blinkFrequency = (blinkFrequency < MAX_FREQUENCY) ? blinkFrequency + 1 : MAX_FREQUENCY;
-                        printf("Blink frequency: %d Hz\n", blinkFrequency);
-                    }
-                    break;
-
-                case ENCODER_TURN_COUNTERCLOCKWISE:
-                    if (ledState) {
-                        blinkFrequency = (blinkFrequency > MIN_FREQUENCY) ? blinkFrequency - 1 : MIN_FREQUENCY;
-                        printf("Blink frequency: %d Hz\n", blinkFrequency);
+                case ENCODER_TURN: {
+                    // All steps turned since the previous event, positive is clockwise
+                    int steps = encoder.take();
+                    if (setting.on && steps != 0) {
+                        int frequency = (int) setting.frequency_hz + steps;
+                        if (frequency > MAX_FREQUENCY) frequency = MAX_FREQUENCY;
+                        if (frequency < MIN_FREQUENCY) frequency = MIN_FREQUENCY;
+                        setting.frequency_hz = frequency;
+                        blinkSetting.publish(setting);
+                        printf("Blink frequency: %d Hz\n", frequency);
                     }
                     break;
+                }
 
                 default:
                     break;
@@ -113,22 +138,7 @@ void vEventTask(void *pvParameters) {
 
 // Task to blink the LED according to the current frequency
 void vBlinkTask(void *pvParameters) {
-    gpio_init(LED_PIN);
-    gpio_set_dir(LED_PIN, GPIO_OUT);
-    gpio_put(LED_PIN, 0);  // Ensure LED is off initially
-
-    while (1) {
-        if (ledState) {
-            gpio_put(LED_PIN, 1);
-            vTaskDelay(pdMS_TO_TICKS(500 / blinkFrequency));
-            gpio_put(LED_PIN, 0);
-            vTaskDelay(pdMS_TO_TICKS(500 / blinkFrequency));
-        } else {
-            // LED is OFF
-            gpio_put(LED_PIN, 0);
-            vTaskDelay(pdMS_TO_TICKS(100));  // Sleep for a short while
-        }
-    }
+    blink.run();
 }
 
 // GPIO setup for rotary encoder and button (without enabling interrupts)
@@ -138,12 +148,7 @@ void setup_gpio() {
     gpio_set_dir(LED_PIN, GPIO_OUT);
     gpio_put(LED_PIN, 0);  // Ensure LED is off initially
 
-    // Initialize rotary encoder pins
-    gpio_init(ROT_A_PIN);
-    gpio_init(ROT_B_PIN);
-    gpio_set_dir(ROT_A_PIN, GPIO_IN);
-    gpio_set_dir(ROT_B_PIN, GPIO_IN);
-
+    // Rotary encoder pins are initialized by the encoder
     // No pull-ups or pull-downs for ROT_A_PIN and ROT_B_PIN
     gpio_disable_pulls(ROT_A_PIN);
     gpio_disable_pulls(ROT_B_PIN);
@@ -160,15 +165,7 @@ int main() {
     // Initialize stdio
     stdio_init_all();
 
-    // Create event queue and register it
-    xEventQueue = xQueueCreate(10, sizeof(Event));
-    if (xEventQueue == NULL) {
-        printf("Failed to create event queue.\n");
-        while (1);
-    }
-    vQueueAddToRegistry(xEventQueue, "EventQueue");
-
-    // Setup GPIOs (after queue is created)
+    // Setup GPIOs
     setup_gpio();
 
     // Create tasks
@@ -0,0 +1,127 @@
+//
+// Simulation of the software blink on the host. BlinkOutput toggles the LED
+// itself below the slowest frequency the PWM reaches, 2 to 7 Hz. The blink
+// task waits for each edge of a BlinkSchedule and may wake a few ticks late
+// when other tasks run; the toggles of an hour of blinking are simulated at
+// the application's tick rate, starting also just before the tick count wraps.
+//
+// Checks that every edge is within half a tick of its exact time and every
+// period within 1% when the task wakes on time, and that late wakes delay
+// single edges but never accumulate into drift. The same is reported for the
+// vTaskDelay(500 / f) loop that BlinkOutput replaced.
+//
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "BlinkSchedule.h"
+
+static constexpr uint32_t MIN_SOFTWARE_HZ = 2;  // MIN_FREQUENCY of main.cpp
+static constexpr uint32_t MAX_SOFTWARE_HZ = 7;  // the PWM takes over at about 7.5 Hz with a 125 MHz clock
+static constexpr uint32_t SIMULATED_SECONDS = 3600;
+
+static int failures = 0;
+
+static void check(bool ok, uint32_t frequency, uint32_t latency, const char *what) {
+    if (!ok) {
+        if (failures < 10) printf("%lu Hz, latency %lu: %s\n", (unsigned long) frequency, (unsigned long) latency, what);
+        ++failures;
+    }
+}
+
+struct Result {
+    double worst_period;  // largest error of one period, percent
+    double worst_edge;    // largest distance of an edge from its exact time, ticks
+    double drift;         // distance of the last edge from its exact time, ticks
+};
+
+// exact time of edge n in ticks from the start
+static double exactTicks(uint64_t n, uint32_t frequency) {
+    return n * 0.5 / frequency * configTICK_RATE_HZ;
+}
+
+// wake of a task that was due at tick due, up to latency ticks late
+static TickType_t wake(TickType_t due, uint32_t latency) {
+    return due + (latency ? rand() % (latency + 1) : 0);
+}
+
+// edge times of the first edge and the two before it, for the period error
+struct Edges {
+    TickType_t start;
+    TickType_t previous[2];
+    Result result{};
+
+    void toggle(uint64_t n, TickType_t tick, uint32_t frequency) {
+        double exact = exactTicks(n, frequency);
+        double error = std::fabs(static_cast<TickType_t>(tick - start) - exact);
+        if (error > result.worst_edge) result.worst_edge = error;
+        result.drift = error;
+        if (n >= 2) {
+            double period = static_cast<TickType_t>(tick - previous[n % 2]);
+            double exact_period = exactTicks(2, frequency);
+            double period_error = std::fabs(period - exact_period) * 100 / exact_period;
+            if (period_error > result.worst_period) result.worst_period = period_error;
+        }
+        previous[n % 2] = tick;
+    }
+};
+
+// BlinkOutput::run(): toggle on the edges of the schedule, the edge after a late wake is still due on time
+static Result simulateSchedule(TickType_t start, uint32_t frequency, uint32_t latency) {
+    BlinkSchedule schedule(start, frequency);
+    Edges edges{start, {start, start}};
+    uint64_t count = 2ull * frequency * SIMULATED_SECONDS;
+    for (uint64_t n = 1; n <= count; ++n) {
+        edges.toggle(n, wake(schedule.next(), latency), frequency);
+    }
+    return edges.result;
+}
+
+// the loop BlinkOutput replaced: vTaskDelay(pdMS_TO_TICKS(500 / f)) counts from the late wake
+static Result simulateDelay(TickType_t start, uint32_t frequency, uint32_t latency) {
+    Edges edges{start, {start, start}};
+    TickType_t tick = start;
+    uint64_t count = 2ull * frequency * SIMULATED_SECONDS;
+    for (uint64_t n = 1; n <= count; ++n) {
+        tick = wake(tick + pdMS_TO_TICKS(500 / frequency), latency);
+        edges.toggle(n, tick, frequency);
+    }
+    return edges.result;
+}
+
+int main() {
+    srand(1);
+    const TickType_t starts[] = {0, static_cast<TickType_t>(0) - 1000};  // the second wraps after one second
+    const uint32_t latencies[] = {0, 3};
+
+    printf("Hz  late   schedule: period %%  edge   drift    vTaskDelay: period %%  drift after %lu s\n",
+           (unsigned long) SIMULATED_SECONDS);
+    for (uint32_t latency : latencies) {
+        for (uint32_t f = MIN_SOFTWARE_HZ; f <= MAX_SOFTWARE_HZ; ++f) {
+            for (TickType_t start : starts) {
+                Result schedule = simulateSchedule(start, f, latency);
+                Result delay = simulateDelay(start, f, latency);
+
+                if (latency == 0) {
+                    check(schedule.worst_edge <= 0.5, f, latency, "edge more than half a tick off");
+                    check(schedule.worst_period < 1.0, f, latency, "period off by 1% or more");
+                }
+                // a late wake moves only its own edge
+                check(schedule.worst_edge <= latency + 0.5, f, latency, "edges drift");
+
+                if (start == 0) {
+                    printf("%-3lu %-4lu %17.2f %6.1f %7.1f %20.2f %11.0f\n", (unsigned long) f,
+                           (unsigned long) latency, schedule.worst_period, schedule.worst_edge, schedule.drift,
+                           delay.worst_period, delay.drift);
+                }
+            }
+        }
+    }
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,371 @@
+//
+// Waveform replay of QuadratureEncoder on the host. A waveform is the list of
+// A/B levels with the time each was reached. The replay raises the GPIO
+// interrupt of every pin that moved, with a model of the RP2040: the handler
+// starts IRQ_LATENCY_NS after the first latched edge, takes CALLBACK_NS per
+// pin it serves and reads both pins at the time of each call, so edges that
+// come closer together than that are seen together. The consumer task takes
+// the steps CONSUMER_DELAY_NS after each notification.
+//
+// Without arguments, generated waveforms of a 20 detent encoder are replayed:
+// slow and fast turns with reversals in the middle of a detent, contact
+// chatter on the channel that moved, and notifications the event channel
+// refuses. Up to 2000 detents/s every count has to be decoded, without
+// transition errors, and the steps taken have to add up to the detents
+// turned. There may be only one notification per take, and without chatter
+// one per detent reached. Faster spins are reported, with the A-rising-edge
+// decoder QuadratureEncoder replaced for comparison.
+//
+// Recorded waveforms, one "time_us,A,B" line per sample as exported by a
+// logic analyzer, are replayed when given as arguments and checked against a
+// decoder that sees every sample.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "QuadratureEncoder.h"
+
+static constexpr uint PIN_A = 10;  // ROT_A_PIN of main.cpp
+static constexpr uint PIN_B = 11;
+static constexpr int COUNTS_PER_DETENT = 4;
+static constexpr uint64_t IRQ_LATENCY_NS = 2000;
+static constexpr uint64_t CALLBACK_NS = 2500;
+static constexpr uint64_t CONSUMER_DELAY_NS = 200000;
+static constexpr uint32_t CHECKED_DETENTS_PER_S = 2000;
+
+static int failures = 0;
+
+static void check(bool ok, const char *waveform, const char *what) {
+    if (!ok) {
+        if (failures < 10) printf("%s: %s\n", waveform, what);
+        ++failures;
+    }
+}
+
+struct Sample {
+    uint64_t time_ns;
+    uint8_t state;  // (A << 1) | B
+};
+
+using Waveform = std::vector<Sample>;
+
+//-----------------------------------------------------------
+// Simulated pins, see encoder_stub/pico/stdlib.h
+
+static uint32_t pins;
+
+void gpio_init(uint) {}
+void gpio_set_dir(uint, bool) {}
+void gpio_set_irq_enabled_with_callback(uint, uint32_t, bool, gpio_irq_callback_t) {}
+void gpio_set_irq_enabled(uint, uint32_t, bool) {}
+
+uint32_t gpio_get_all() {
+    return pins;
+}
+
+static void setPins(uint8_t state) {
+    pins = (((state >> 1) & 1u) << PIN_A) | ((state & 1u) << PIN_B);
+}
+
+//-----------------------------------------------------------
+// Reference decoders
+
+// position of a state in the clockwise cycle 00 -> 10 -> 11 -> 01
+static int phase(uint8_t state) {
+    static const int phases[4] = {0, 3, 1, 2};
+    return phases[state & 3];
+}
+
+// counts of a decoder that sees every sample, a change of both channels is an error
+static int32_t referenceCounts(const Waveform &waveform, uint32_t &errors) {
+    int32_t counts = 0;
+    errors = 0;
+    for (size_t i = 1; i < waveform.size(); ++i) {
+        int step = (phase(waveform[i].state) - phase(waveform[i - 1].state) + 4) % 4;
+        if (step == 1) ++counts;
+        if (step == 3) --counts;
+        if (step == 2) ++errors;
+    }
+    return counts;
+}
+
+// the decoder QuadratureEncoder replaced: one detent per rising edge of A, direction from B,
+// one queue post and consumer wakeup each; every edge is assumed to be seen
+static int32_t aRisingDetents(const Waveform &waveform, uint32_t &posts) {
+    int32_t detents = 0;
+    posts = 0;
+    for (size_t i = 1; i < waveform.size(); ++i) {
+        bool rose = !(waveform[i - 1].state & 2) && (waveform[i].state & 2);
+        if (rose) {
+            detents += (waveform[i].state & 1) ? -1 : 1;
+            ++posts;
+        }
+    }
+    return detents;
+}
+
+//-----------------------------------------------------------
+// Generated waveforms
+
+struct Motion {
+    int32_t counts;         // negative turns back
+    uint32_t detents_per_s;
+};
+
+static uint8_t stateOf(int32_t counts) {
+    static const uint8_t states[4] = {0b00, 0b10, 0b11, 0b01};
+    return states[((counts % 4) + 4) % 4];
+}
+
+// waveform of the motions from detent 0, with chatter of up to chatter_ns after edges,
+// counts is where it ends and moved how many counts it turned either way
+static Waveform generate(const std::vector<Motion> &motions, uint64_t chatter_ns, int32_t &counts,
+                         uint32_t &moved) {
+    Waveform waveform{{0, stateOf(0)}};
+    uint64_t t = 1000000;
+    counts = 0;
+    moved = 0;
+    for (const Motion &motion : motions) {
+        uint64_t gap = 1000000000ull / (static_cast<uint64_t>(motion.detents_per_s) * COUNTS_PER_DETENT);
+        int32_t direction = motion.counts < 0 ? -1 : 1;
+        for (int32_t i = 0; i != motion.counts; i += direction) {
+            // the hand doesn't turn evenly, +-20 %
+            t += gap * 4 / 5 + static_cast<uint64_t>(rand()) % (gap * 2 / 5 + 1);
+            uint8_t before = stateOf(counts);
+            counts += direction;
+            ++moved;
+            uint8_t after = stateOf(counts);
+            waveform.push_back({t, after});
+            // only the channel that moved chatters, and only for a part of the gap to the next edge
+            uint64_t window = std::min(chatter_ns, gap / 3);
+            if (window && rand() % 2) {
+                uint64_t c = t;
+                int pairs = 1 + rand() % 3;
+                for (int p = 0; p < pairs; ++p) {
+                    c += 1 + static_cast<uint64_t>(rand()) % (window / (2 * pairs) + 1);
+                    waveform.push_back({c, before});
+                    c += 1 + static_cast<uint64_t>(rand()) % (window / (2 * pairs) + 1);
+                    waveform.push_back({c, after});
+                }
+                t = c;
+            }
+        }
+        t += 50000000;  // 50 ms before the next motion
+    }
+    return waveform;
+}
+
+// a hand turning the knob back and forth, some of the reversals in the middle of a detent
+static std::vector<Motion> turns(uint32_t detents_per_s, int count) {
+    std::vector<Motion> motions;
+    int32_t position = 0;
+    for (int i = 0; i < count; ++i) {
+        int32_t counts = (1 + rand() % 40) * COUNTS_PER_DETENT;
+        if (rand() % 4 == 0) counts += 1 + rand() % (COUNTS_PER_DETENT - 1);
+        if (rand() % 2) counts = -counts;
+        motions.push_back({counts, detents_per_s});
+        position += counts;
+    }
+    // back to a detent, so the steps taken add up to whole detents
+    int32_t partial = ((position % COUNTS_PER_DETENT) + COUNTS_PER_DETENT) % COUNTS_PER_DETENT;
+    if (partial) motions.push_back({COUNTS_PER_DETENT - partial, detents_per_s});
+    return motions;
+}
+
+//-----------------------------------------------------------
+// Replay
+
+struct Replay {
+    int32_t position;
+    int32_t steps;
+    uint32_t errors;
+    uint32_t interrupts;
+    uint32_t notifies;
+    uint32_t refused;
+    uint32_t takes;
+    int32_t untaken;  // steps the notified takes left for the one at the end
+};
+
+static uint64_t now;
+static uint32_t refuseEvery;  // every n-th notification is refused as by a full channel
+static std::vector<uint64_t> takeTimes;
+static Replay replayed;
+
+static bool notifyConsumer(BaseType_t *) {
+    ++replayed.notifies;
+    if (refuseEvery && replayed.notifies % refuseEvery == 0) {
+        ++replayed.refused;
+        return false;
+    }
+    takeTimes.push_back(now + CONSUMER_DELAY_NS);
+    return true;
+}
+
+static Replay replay(const Waveform &waveform, uint32_t refuse) {
+    replayed = {};
+    refuseEvery = refuse;
+    takeTimes.clear();
+    setPins(waveform.front().state);
+    QuadratureEncoder encoder(PIN_A, PIN_B, COUNTS_PER_DETENT, notifyConsumer);
+    encoder.enable(nullptr);
+
+    size_t next = 1;          // next sample to reach the pins
+    size_t nextTake = 0;
+    uint32_t pending = 0;     // pins with a latched edge
+    uint64_t pendingSince = 0;
+    uint64_t cpu = 0;         // end of the latest handler
+
+    // sets the pins to the levels at time t and latches the edges
+    auto reach = [&](uint64_t t) {
+        while (next < waveform.size() && waveform[next].time_ns <= t) {
+            uint8_t moved = waveform[next].state ^ waveform[next - 1].state;
+            if (!pending) pendingSince = waveform[next].time_ns;
+            if (moved & 2) pending |= 1u << PIN_A;
+            if (moved & 1) pending |= 1u << PIN_B;
+            setPins(waveform[next].state);
+            ++next;
+        }
+    };
+    // the consumer task takes the steps while no interrupt runs
+    auto consume = [&](uint64_t t) {
+        while (nextTake < takeTimes.size() && takeTimes[nextTake] <= t) {
+            replayed.steps += encoder.take();
+            ++replayed.takes;
+            ++nextTake;
+        }
+    };
+
+    for (;;) {
+        if (!pending) {
+            if (next == waveform.size()) break;
+            reach(waveform[next].time_ns);
+        }
+        uint64_t start = std::max(cpu, pendingSince + IRQ_LATENCY_NS);
+        consume(start);
+        reach(start);
+        uint32_t serve = pending;
+        pending = 0;
+        uint64_t t = start;
+        for (uint pin : {PIN_A, PIN_B}) {
+            if (!(serve & (1u << pin))) continue;
+            reach(t);
+            now = t;
+            BaseType_t woken = pdFALSE;
+            encoder.gpio_irq(pin, &woken);
+            ++replayed.interrupts;
+            t += CALLBACK_NS;
+        }
+        cpu = t;
+        reach(cpu);
+    }
+    consume(UINT64_MAX);
+    replayed.untaken = encoder.take();
+    replayed.steps += replayed.untaken;
+
+    replayed.position = encoder.get_position();
+    replayed.errors = encoder.get_errors();
+    return replayed;
+}
+
+//-----------------------------------------------------------
+
+static void checkGenerated(const char *name, uint32_t detents_per_s, uint64_t chatter_ns, uint32_t refuse) {
+    int32_t counts;
+    uint32_t moved;
+    std::vector<Motion> motions = turns(detents_per_s, 50);
+    Waveform waveform = generate(motions, chatter_ns, counts, moved);
+    Replay r = replay(waveform, refuse);
+
+    check(r.position == counts, name, "counts missed");
+    check(r.errors == 0, name, "transition errors");
+    check(r.steps == counts / COUNTS_PER_DETENT, name, "steps taken don't add up to the detents turned");
+    check(r.notifies - r.refused <= r.takes, name, "more than one notification per take");
+    // a refused notification is retried on the next count, the last one of the waveform has none
+    check(refuse || r.untaken == 0, name, "steps left without a notification");
+    // without chatter each detent reached is notified at most once, a motion can end between two
+    check(chatter_ns || r.notifies <= moved / COUNTS_PER_DETENT + motions.size(), name,
+          "more notifications than detents");
+
+    uint32_t posts;
+    int32_t oldDetents = aRisingDetents(waveform, posts);
+    printf("%-20s %5lu detents turned, at %5ld: %5lu notifications   A-rising decoder at %5ld: %5lu posts\n",
+           name, static_cast<unsigned long>(moved / COUNTS_PER_DETENT), static_cast<long>(counts / COUNTS_PER_DETENT),
+           static_cast<unsigned long>(r.notifies), static_cast<long>(oldDetents), static_cast<unsigned long>(posts));
+}
+
+static void reportFast(uint32_t detents_per_s) {
+    int32_t counts;
+    uint32_t moved;
+    Waveform waveform = generate(turns(detents_per_s, 20), 0, counts, moved);
+    Replay r = replay(waveform, 0);
+    printf("%6lu detents/s: %7ld counts, %6ld missed, %5lu transition errors\n",
+           static_cast<unsigned long>(detents_per_s), static_cast<long>(counts),
+           static_cast<long>(counts - r.position), static_cast<unsigned long>(r.errors));
+}
+
+// "time_us,A,B" lines, other lines are skipped
+static bool load(const char *path, Waveform &waveform) {
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        double time_us;
+        int a, b;
+        if (sscanf(line, "%lf,%d,%d", &time_us, &a, &b) != 3) continue;
+        uint8_t state = static_cast<uint8_t>(((a != 0) << 1) | (b != 0));
+        if (waveform.empty() || waveform.back().state != state) {
+            waveform.push_back({static_cast<uint64_t>(time_us * 1000), state});
+        }
+    }
+    fclose(file);
+    return !waveform.empty();
+}
+
+static void checkRecorded(const char *path) {
+    Waveform waveform;
+    if (!load(path, waveform)) {
+        check(false, path, "no samples");
+        return;
+    }
+    uint32_t referenceErrors;
+    int32_t counts = referenceCounts(waveform, referenceErrors);
+    Replay r = replay(waveform, 0);
+    check(r.position == counts, path, "counts differ from the decoder that sees every sample");
+    printf("%s: %ld counts (every sample: %ld, %lu errors), %lu transition errors, %lu interrupts, "
+           "%lu notifications\n", path, static_cast<long>(r.position), static_cast<long>(counts),
+           static_cast<unsigned long>(referenceErrors), static_cast<unsigned long>(r.errors),
+           static_cast<unsigned long>(r.interrupts), static_cast<unsigned long>(r.notifies));
+}
+
+int main(int argc, char **argv) {
+    srand(1);
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) checkRecorded(argv[i]);
+    } else {
+        // the reference decoder has to agree with the generator
+        int32_t counts;
+        uint32_t moved, errors;
+        Waveform waveform = generate(turns(100, 50), 200000, counts, moved);
+        check(referenceCounts(waveform, errors) == counts && errors == 0, "generator", "reference decoder");
+
+        checkGenerated("slow", 5, 0, 0);
+        checkGenerated("slow with chatter", 5, 1000000, 0);
+        checkGenerated("fast", 200, 0, 0);
+        checkGenerated("fast with chatter", 200, 200000, 0);
+        checkGenerated("spin with chatter", CHECKED_DETENTS_PER_S, 40000, 0);
+        checkGenerated("spin, posts refused", CHECKED_DETENTS_PER_S, 40000, 3);
+
+        // edges closer than the interrupt handler, counts are missed
+        for (uint32_t detents_per_s : {5000u, 20000u, 50000u, 100000u}) reportFast(detents_per_s);
+    }
+
+    if (failures) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * Kernel configuration of event_channel_test: the host test configuration
+ * with a tick that only moves on while the tasks are idle, see
+ * event_channel_test.cpp, and a hook called each time a task blocks to wait
+ * for an event, on the queue or on its notification.
+ */
+
+#ifndef EVENT_CHANNEL_CONFIG_H
+#define EVENT_CHANNEL_CONFIG_H
+
+#include <stdint.h>
+
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICKLESS_IDLE                 1
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vTestSkipIdleTicks( xExpectedIdleTime )
+
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )       vTestConsumerBlocking()
+#define traceTASK_NOTIFY_TAKE_BLOCK( uxIndexToWait )    vTestConsumerBlocking()
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void vTestSkipIdleTicks( uint32_t ulExpectedIdleTime );
+void vTestConsumerBlocking( void );
+#ifdef __cplusplus
+}
+#endif
+
+#include "../FreeRTOSConfig.h"
+
+#endif /* EVENT_CHANNEL_CONFIG_H */
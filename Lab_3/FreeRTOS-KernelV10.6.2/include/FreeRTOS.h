@@ -375,6 +375,31 @@
 
 #endif /* configUSE_TIMERS */
 
+/* Set configUSE_TIMER_WHEEL to 1 to keep active software timers in a
+ * hierarchical timing wheel instead of sorted lists.  Each level has 32 slots,
+ * so configTIMER_WHEEL_LEVELS levels cover 2^(5 * levels) ticks directly.
+ * Timers further away are placed at the end of the range and re-placed when
+ * it is reached. */
+#ifndef configUSE_TIMER_WHEEL
+    #define configUSE_TIMER_WHEEL    0
+#endif
+
+#ifndef configTIMER_WHEEL_LEVELS
+    #define configTIMER_WHEEL_LEVELS    4
+#endif
+
+#if ( configUSE_TIMER_WHEEL == 1 )
+    #if ( configTIMER_WHEEL_LEVELS < 1 ) || ( configTIMER_WHEEL_LEVELS > 6 ) || ( ( configTICK_TYPE_WIDTH_IN_BITS == TICK_TYPE_WIDTH_16_BITS ) && ( configTIMER_WHEEL_LEVELS > 3 ) )
+        #error configTIMER_WHEEL_LEVELS must be 1 to 6, or 1 to 3 with 16 bit ticks.
+    #endif
+#endif
+
+/* Set configUSE_TIMER_TOUCH to 1 to include xTimerTouch(), which resets a
+ * running timer without posting a command to the timer service task. */
+#ifndef configUSE_TIMER_TOUCH
+    #define configUSE_TIMER_TOUCH    0
+#endif
+
 #ifndef portSET_INTERRUPT_MASK_FROM_ISR
     #define portSET_INTERRUPT_MASK_FROM_ISR()    0
 #endif
@@ -827,6 +852,14 @@
     #define traceSTREAM_BUFFER_RECEIVE_FROM_ISR( xStreamBuffer, xReceivedLength )
 #endif
 
+#ifndef traceSTREAM_BUFFER_PEEK
+    #define traceSTREAM_BUFFER_PEEK( xStreamBuffer, xPeekedLength )
+#endif
+
+#ifndef traceSTREAM_BUFFER_DISCARD
+    #define traceSTREAM_BUFFER_DISCARD( xStreamBuffer, xDiscardedLength )
+#endif
+
 #ifndef configGENERATE_RUN_TIME_STATS
     #define configGENERATE_RUN_TIME_STATS    0
 #endif
@@ -1418,7 +1451,13 @@ typedef struct xSTATIC_TIMER
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy7;
     #endif
+    #if ( configUSE_TIMER_TOUCH == 1 )
+        TickType_t xDummy9;
+    #endif
     uint8_t ucDummy8;
+    #if ( configUSE_TIMER_TOUCH == 1 )
+        uint8_t ucDummy10;
+    #endif
 } StaticTimer_t;
 
 /*
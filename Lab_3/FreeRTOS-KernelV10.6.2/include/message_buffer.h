@@ -85,6 +85,12 @@
  */
 typedef StreamBufferHandle_t MessageBufferHandle_t;
 
+/**
+ * One part of a message sent by xMessageBufferSendV().  See
+ * StreamBufferFragment_t.
+ */
+typedef StreamBufferFragment_t MessageBufferFragment_t;
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -481,6 +487,63 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
 #define xMessageBufferSendFromISR( xMessageBuffer, pvTxData, xDataLengthBytes, pxHigherPriorityTaskWoken ) \
     xStreamBufferSendFromISR( ( xMessageBuffer ), ( pvTxData ), ( xDataLengthBytes ), ( pxHigherPriorityTaskWoken ) )
 
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferSendV( MessageBufferHandle_t xMessageBuffer,
+ *                             const MessageBufferFragment_t * pxFragments,
+ *                             UBaseType_t uxFragmentCount,
+ *                             TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Sends one message made of uxFragmentCount fragments, such as a header, a
+ * payload and a CRC held in separate buffers.  The fragments are copied
+ * straight into the message buffer, so the message does not have to be
+ * assembled in a local buffer before calling xMessageBufferSend().  The
+ * receiver sees a single message, the fragments concatenated in array order.
+ *
+ * The same single writer restriction as xMessageBufferSend() applies.
+ *
+ * @param xMessageBuffer The handle of the message buffer to which the message
+ * is being sent.
+ *
+ * @param pxFragments An array of uxFragmentCount fragments.
+ *
+ * @param uxFragmentCount The number of fragments in the pxFragments array.
+ *
+ * @param xTicksToWait The maximum amount of time the calling task should
+ * remain in the Blocked state to wait for enough space to become available,
+ * as for xMessageBufferSend().
+ *
+ * @return The length of the message written, which is the sum of the fragment
+ * lengths, or 0 if there was not enough space for the whole message.
+ *
+ * \defgroup xMessageBufferSendV xMessageBufferSendV
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendV( xMessageBuffer, pxFragments, uxFragmentCount, xTicksToWait ) \
+    xStreamBufferSendV( ( xMessageBuffer ), ( pxFragments ), ( uxFragmentCount ), ( xTicksToWait ) )
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferSendVFromISR( MessageBufferHandle_t xMessageBuffer,
+ *                                    const MessageBufferFragment_t * pxFragments,
+ *                                    UBaseType_t uxFragmentCount,
+ *                                    BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Interrupt safe version of xMessageBufferSendV(), see xMessageBufferSendV()
+ * and xMessageBufferSendFromISR().
+ *
+ * \defgroup xMessageBufferSendVFromISR xMessageBufferSendVFromISR
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferSendVFromISR( xMessageBuffer, pxFragments, uxFragmentCount, pxHigherPriorityTaskWoken ) \
+    xStreamBufferSendVFromISR( ( xMessageBuffer ), ( pxFragments ), ( uxFragmentCount ), ( pxHigherPriorityTaskWoken ) )
+
 /**
  * message_buffer.h
  *
@@ -672,6 +735,66 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
 #define xMessageBufferReceiveFromISR( xMessageBuffer, pvRxData, xBufferLengthBytes, pxHigherPriorityTaskWoken ) \
     xStreamBufferReceiveFromISR( ( xMessageBuffer ), ( pvRxData ), ( xBufferLengthBytes ), ( pxHigherPriorityTaskWoken ) )
 
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferPeek( MessageBufferHandle_t xMessageBuffer,
+ *                            void * pvRxData,
+ *                            size_t xOffset,
+ *                            size_t xBufferLengthBytes );
+ * @endcode
+ *
+ * Copies up to xBufferLengthBytes bytes of the next message, starting
+ * xOffset bytes into it, without removing the message.  A large message can
+ * be read in parts this way, each part straight to its destination, and then
+ * removed with xMessageBufferDiscard().
+ *
+ * Only the reader may call xMessageBufferPeek().  It never blocks.
+ *
+ * @param xMessageBuffer The handle of the message buffer being read.
+ *
+ * @param pvRxData A pointer to the buffer into which the bytes are copied.
+ *
+ * @param xOffset The offset into the next message of the first byte copied.
+ *
+ * @param xBufferLengthBytes The maximum number of bytes to copy.
+ *
+ * @return The number of bytes copied, 0 if the message buffer is empty or the
+ * next message is not longer than xOffset.
+ *
+ * \defgroup xMessageBufferPeek xMessageBufferPeek
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferPeek( xMessageBuffer, pvRxData, xOffset, xBufferLengthBytes ) \
+    xStreamBufferPeek( ( xMessageBuffer ), ( pvRxData ), ( xOffset ), ( xBufferLengthBytes ) )
+
+/**
+ * message_buffer.h
+ *
+ * @code{c}
+ * size_t xMessageBufferDiscard( MessageBufferHandle_t xMessageBuffer,
+ *                               size_t xBytesToDiscard );
+ * @endcode
+ *
+ * Removes the next message without copying it, if its length is not more
+ * than xBytesToDiscard.  A task blocked waiting for space is unblocked.
+ *
+ * Only the reader may call xMessageBufferDiscard(), from a task.
+ *
+ * @param xMessageBuffer The handle of the message buffer.
+ *
+ * @param xBytesToDiscard The length of the longest message to remove,
+ * normally the value returned by xMessageBufferNextLengthBytes().
+ *
+ * @return The length of the message removed, or 0 if no message was removed.
+ *
+ * \defgroup xMessageBufferDiscard xMessageBufferDiscard
+ * \ingroup MessageBufferManagement
+ */
+#define xMessageBufferDiscard( xMessageBuffer, xBytesToDiscard ) \
+    xStreamBufferDiscard( ( xMessageBuffer ), ( xBytesToDiscard ) )
+
 /**
  * message_buffer.h
  *
@@ -795,7 +918,7 @@ typedef StreamBufferHandle_t MessageBufferHandle_t;
  * \ingroup MessageBufferManagement
  */
 #define xMessageBufferNextLengthBytes( xMessageBuffer ) \
-    xStreamBufferNextMessageLengthBytes( xMessageBuffer ) PRIVILEGED_FUNCTION;
+    xStreamBufferNextMessageLengthBytes( xMessageBuffer )
 
 /**
  * message_buffer.h
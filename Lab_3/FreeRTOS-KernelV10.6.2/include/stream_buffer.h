@@ -78,6 +78,16 @@ typedef void (* StreamBufferCallbackFunction_t)( StreamBufferHandle_t xStreamBuf
                                                  BaseType_t xIsInsideISR,
                                                  BaseType_t * const pxHigherPriorityTaskWoken );
 
+/**
+ * One part of the data written by xStreamBufferSendV(), such as the header,
+ * payload or CRC of a frame.
+ */
+typedef struct xSTREAM_BUFFER_FRAGMENT
+{
+    const void * pvData; /**< The bytes of this part. */
+    size_t xLengthBytes; /**< The number of bytes in this part, may be 0. */
+} StreamBufferFragment_t;
+
 /**
  * stream_buffer.h
  *
@@ -490,6 +500,93 @@ size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
                                  size_t xDataLengthBytes,
                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferSendV( StreamBufferHandle_t xStreamBuffer,
+ *                            const StreamBufferFragment_t * pxFragments,
+ *                            UBaseType_t uxFragmentCount,
+ *                            TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Sends the bytes of uxFragmentCount fragments to a stream buffer, as if they
+ * were one contiguous block passed to xStreamBufferSend().  Each fragment is
+ * copied straight into the stream buffer, so a frame made of separate header,
+ * payload and trailer buffers does not have to be assembled first.  When the
+ * stream buffer is a message buffer the fragments form a single message.
+ *
+ * The same single writer restriction as xStreamBufferSend() applies.  Use
+ * xStreamBufferSendVFromISR() to write from an interrupt service routine.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to which the fragments
+ * are being sent.
+ *
+ * @param pxFragments An array of uxFragmentCount fragments, sent in array
+ * order.
+ *
+ * @param uxFragmentCount The number of fragments in the pxFragments array.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for enough space to become available, as for
+ * xStreamBufferSend().
+ *
+ * @return The number of bytes written to the stream buffer.  As with
+ * xStreamBufferSend(), a message buffer writes the whole message or nothing.
+ *
+ * Example use:
+ * @code{c}
+ * void vSendFrame( StreamBufferHandle_t xMessageBuffer,
+ *                  const uint8_t *pucPayload,
+ *                  size_t xPayloadLength )
+ * {
+ * uint8_t ucHeader[ 4 ];
+ * uint16_t usCRC;
+ * StreamBufferFragment_t xFragments[ 3 ];
+ *
+ *  vBuildHeader( ucHeader, xPayloadLength );
+ *  usCRC = usCalculateCRC( ucHeader, pucPayload, xPayloadLength );
+ *
+ *  xFragments[ 0 ].pvData = ucHeader;
+ *  xFragments[ 0 ].xLengthBytes = sizeof( ucHeader );
+ *  xFragments[ 1 ].pvData = pucPayload;
+ *  xFragments[ 1 ].xLengthBytes = xPayloadLength;
+ *  xFragments[ 2 ].pvData = &usCRC;
+ *  xFragments[ 2 ].xLengthBytes = sizeof( usCRC );
+ *
+ *  // Send the frame as one message without copying it into a local buffer.
+ *  xStreamBufferSendV( xMessageBuffer, xFragments, 3, pdMS_TO_TICKS( 100 ) );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferSendV xStreamBufferSendV
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendV( StreamBufferHandle_t xStreamBuffer,
+                           const StreamBufferFragment_t * pxFragments,
+                           UBaseType_t uxFragmentCount,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferSendVFromISR( StreamBufferHandle_t xStreamBuffer,
+ *                                   const StreamBufferFragment_t * pxFragments,
+ *                                   UBaseType_t uxFragmentCount,
+ *                                   BaseType_t * const pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Interrupt safe version of xStreamBufferSendV(), see xStreamBufferSendV() and
+ * xStreamBufferSendFromISR().
+ *
+ * \defgroup xStreamBufferSendVFromISR xStreamBufferSendVFromISR
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferSendVFromISR( StreamBufferHandle_t xStreamBuffer,
+                                  const StreamBufferFragment_t * pxFragments,
+                                  UBaseType_t uxFragmentCount,
+                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -665,6 +762,92 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
                                     size_t xBufferLengthBytes,
                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+ *                           void * pvRxData,
+ *                           size_t xOffset,
+ *                           size_t xBufferLengthBytes );
+ * @endcode
+ *
+ * Copies bytes out of a stream buffer without removing them.  The copy starts
+ * xOffset bytes into the data, so a frame can be read in parts: for example
+ * its header into a local variable, then its payload straight to where it is
+ * needed.  When the stream buffer is a message buffer only the next message
+ * can be peeked and xOffset is an offset into that message.  Use
+ * xStreamBufferDiscard() to remove the data once it has been read.
+ *
+ * Only the reader may call xStreamBufferPeek().  It never blocks and can be
+ * called from a task or an interrupt.
+ *
+ * @param xStreamBuffer The handle of the stream buffer being read.
+ *
+ * @param pvRxData A pointer to the buffer into which the bytes are copied.
+ *
+ * @param xOffset The number of bytes to skip before the first byte copied.
+ *
+ * @param xBufferLengthBytes The maximum number of bytes to copy.
+ *
+ * @return The number of bytes copied, which is 0 if there are no more than
+ * xOffset bytes available (in the next message, for a message buffer).
+ *
+ * \defgroup xStreamBufferPeek xStreamBufferPeek
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+                          void * pvRxData,
+                          size_t xOffset,
+                          size_t xBufferLengthBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferDiscard( StreamBufferHandle_t xStreamBuffer,
+ *                              size_t xBytesToDiscard );
+ * @endcode
+ *
+ * Removes up to xBytesToDiscard bytes from a stream buffer without copying
+ * them, and unblocks a task waiting for space.  A message buffer only removes
+ * whole messages: the next message is removed if its length is not more than
+ * xBytesToDiscard, as xStreamBufferReceive() only receives a message if it
+ * fits in the buffer given.
+ *
+ * Only the reader may call xStreamBufferDiscard(), from a task.
+ *
+ * @param xStreamBuffer The handle of the stream buffer.
+ *
+ * @param xBytesToDiscard The maximum number of bytes to remove.
+ *
+ * @return The number of bytes removed.  For a message buffer this is the
+ * length of the message removed, not counting its stored length.
+ *
+ * Example use:
+ * @code{c}
+ * void vReceiveFrame( StreamBufferHandle_t xMessageBuffer )
+ * {
+ * FrameHeader_t xHeader;
+ * size_t xLength;
+ *
+ *  xLength = xStreamBufferNextMessageLengthBytes( xMessageBuffer );
+ *
+ *  if( xStreamBufferPeek( xMessageBuffer, &xHeader, 0, sizeof( xHeader ) ) == sizeof( xHeader ) )
+ *  {
+ *      // Copy the payload straight to its destination, after the header.
+ *      xStreamBufferPeek( xMessageBuffer, pucDestination( &xHeader ), sizeof( xHeader ), xLength - sizeof( xHeader ) );
+ *  }
+ *
+ *  xStreamBufferDiscard( xMessageBuffer, xLength );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferDiscard xStreamBufferDiscard
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferDiscard( StreamBufferHandle_t xStreamBuffer,
+                             size_t xBytesToDiscard ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
@@ -1343,6 +1343,47 @@ TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
                                       StaticTimer_t ** ppxTimerBuffer ) PRIVILEGED_FUNCTION;
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * BaseType_t xTimerTouch( TimerHandle_t xTimer, TickType_t xTicksToWait );
+ *
+ * Has the same effect as xTimerReset(), but is intended for timers that are
+ * reset far more often than they expire, such as inactivity timeouts.
+ *
+ * If the timer is running and the timer command queue is empty, the time of
+ * the call is recorded in the timer itself and no command is posted.  The
+ * timer service task is not woken; when the timer reaches its old expiry time
+ * it is moved to one period after the recorded time instead of expiring.
+ * Otherwise xTimerTouch() posts a reset command exactly as xTimerReset() does.
+ *
+ * configUSE_TIMER_TOUCH must be set to 1 in FreeRTOSConfig.h for
+ * xTimerTouch() to be available.  It must not be called from an interrupt
+ * service routine, use xTimerResetFromISR() there.
+ *
+ * @param xTimer The handle of the timer being reset/started/restarted.
+ *
+ * @param xTicksToWait Specifies the time, in ticks, that the calling task
+ * should be held in the Blocked state to wait for the reset command to be
+ * successfully sent to the timer command queue, should a command be needed.
+ *
+ * @return pdFAIL will be returned if a reset command was needed and could not
+ * be sent to the timer command queue before xTicksToWait ticks had passed.
+ * pdPASS will be returned otherwise.
+ */
+#if ( configUSE_TIMER_TOUCH == 1 )
+    BaseType_t xTimerTouch( TimerHandle_t xTimer,
+                            const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+#endif /* configUSE_TIMER_TOUCH */
+
+/**
+ * UBaseType_t uxTimerGetAvoidedCommandCount( void );
+ *
+ * @return The number of xTimerTouch() calls that reset their timer without
+ * posting a command to the timer service task.  The count wraps.
+ */
+#if ( configUSE_TIMER_TOUCH == 1 )
+    UBaseType_t uxTimerGetAvoidedCommandCount( void ) PRIVILEGED_FUNCTION;
+#endif /* configUSE_TIMER_TOUCH */
+
 /*
  * Functions beyond this part are not part of the public API and are intended
  * for use by the kernel only.
@@ -287,6 +287,35 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
                                        size_t xSpace,
                                        size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
 
+/*
+ * Works out how much space a send of xDataLengthBytes needs, returned in
+ * *pxRequiredSpace, and waits up to xTicksToWait for that space to become free
+ * if it is not already.  Returns the space available after waiting.
+ */
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xDataLengthBytes,
+                               size_t * const pxRequiredSpace,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * The same as prvWriteMessageToBuffer(), but the data is gathered from
+ * uxFragmentCount fragments whose lengths add up to xDataLengthBytes.  The
+ * fragments are copied straight into the buffer's data storage area, one after
+ * the other, and xHead is updated once after the last one.
+ */
+static size_t prvWriteFragmentsToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                         const StreamBufferFragment_t * pxFragments,
+                                         UBaseType_t uxFragmentCount,
+                                         size_t xDataLengthBytes,
+                                         size_t xSpace,
+                                         size_t xRequiredSpace ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the sum of the fragment lengths.
+ */
+static size_t prvFragmentsLength( const StreamBufferFragment_t * pxFragments,
+                                  UBaseType_t uxFragmentCount ) PRIVILEGED_FUNCTION;
+
 /*
  * Copies xCount bytes from the pxStreamBuffer's data storage area to pucData.
  * This function does not update the buffer's xTail pointer, so multiple reads
@@ -673,14 +702,192 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
                           TickType_t xTicksToWait )
 {
     StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-    size_t xReturn, xSpace = 0;
+    size_t xReturn, xSpace;
+    size_t xRequiredSpace;
+
+    configASSERT( pvTxData );
+    configASSERT( pxStreamBuffer );
+
+    xSpace = prvWaitForSpace( pxStreamBuffer, xDataLengthBytes, &xRequiredSpace, xTicksToWait );
+
+    xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+        traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
+                                 const void * pvTxData,
+                                 size_t xDataLengthBytes,
+                                 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn, xSpace;
     size_t xRequiredSpace = xDataLengthBytes;
-    TimeOut_t xTimeOut;
-    size_t xMaxReportedSpace = 0;
 
     configASSERT( pvTxData );
     configASSERT( pxStreamBuffer );
 
+    /* This send function is used to write to both message buffers and stream
+     * buffers.  If this is a message buffer then the space needed must be
+     * increased by the amount of bytes needed to store the length of the
+     * message. */
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+    xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendV( StreamBufferHandle_t xStreamBuffer,
+                           const StreamBufferFragment_t * pxFragments,
+                           UBaseType_t uxFragmentCount,
+                           TickType_t xTicksToWait )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn, xSpace, xDataLengthBytes;
+    size_t xRequiredSpace;
+
+    configASSERT( pxFragments );
+    configASSERT( pxStreamBuffer );
+
+    xDataLengthBytes = prvFragmentsLength( pxFragments, uxFragmentCount );
+    xSpace = prvWaitForSpace( pxStreamBuffer, xDataLengthBytes, &xRequiredSpace, xTicksToWait );
+
+    xReturn = prvWriteFragmentsToBuffer( pxStreamBuffer, pxFragments, uxFragmentCount, xDataLengthBytes, xSpace, xRequiredSpace );
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+        traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferSendVFromISR( StreamBufferHandle_t xStreamBuffer,
+                                  const StreamBufferFragment_t * pxFragments,
+                                  UBaseType_t uxFragmentCount,
+                                  BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn, xSpace, xDataLengthBytes;
+    size_t xRequiredSpace;
+
+    configASSERT( pxFragments );
+    configASSERT( pxStreamBuffer );
+
+    xDataLengthBytes = prvFragmentsLength( pxFragments, uxFragmentCount );
+    xRequiredSpace = xDataLengthBytes;
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+    xReturn = prvWriteFragmentsToBuffer( pxStreamBuffer, pxFragments, uxFragmentCount, xDataLengthBytes, xSpace, xRequiredSpace );
+
+    if( xReturn > ( size_t ) 0 )
+    {
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xDataLengthBytes,
+                               size_t * const pxRequiredSpace,
+                               TickType_t xTicksToWait )
+{
+    size_t xSpace = 0;
+    size_t xRequiredSpace = xDataLengthBytes;
+    TimeOut_t xTimeOut;
+    size_t xMaxReportedSpace = 0;
+
     /* The maximum amount of space a stream buffer will ever report is its length
      * minus 1. */
     xMaxReportedSpace = pxStreamBuffer->xLength - ( size_t ) 1;
@@ -753,7 +960,7 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
             }
             taskEXIT_CRITICAL();
 
-            traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
+            traceBLOCKING_ON_STREAM_BUFFER_SEND( pxStreamBuffer );
             ( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
             pxStreamBuffer->xTaskWaitingToSend = NULL;
         } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
@@ -772,107 +979,82 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
         mtCOVERAGE_TEST_MARKER();
     }
 
-    xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
-
-    if( xReturn > ( size_t ) 0 )
-    {
-        traceSTREAM_BUFFER_SEND( xStreamBuffer, xReturn );
+    *pxRequiredSpace = xRequiredSpace;
 
-        /* Was a task waiting for the data? */
-        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
-        {
-            prvSEND_COMPLETED( pxStreamBuffer );
-        }
-        else
-        {
-            mtCOVERAGE_TEST_MARKER();
-        }
-    }
-    else
-    {
-        mtCOVERAGE_TEST_MARKER();
-        traceSTREAM_BUFFER_SEND_FAILED( xStreamBuffer );
-    }
-
-    return xReturn;
+    return xSpace;
 }
 /*-----------------------------------------------------------*/
 
-size_t xStreamBufferSendFromISR( StreamBufferHandle_t xStreamBuffer,
-                                 const void * pvTxData,
-                                 size_t xDataLengthBytes,
-                                 BaseType_t * const pxHigherPriorityTaskWoken )
+static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                       const void * pvTxData,
+                                       size_t xDataLengthBytes,
+                                       size_t xSpace,
+                                       size_t xRequiredSpace )
 {
-    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-    size_t xReturn, xSpace;
-    size_t xRequiredSpace = xDataLengthBytes;
-
-    configASSERT( pvTxData );
-    configASSERT( pxStreamBuffer );
+    size_t xNextHead = pxStreamBuffer->xHead;
+    configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
 
-    /* This send function is used to write to both message buffers and stream
-     * buffers.  If this is a message buffer then the space needed must be
-     * increased by the amount of bytes needed to store the length of the
-     * message. */
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
     {
-        xRequiredSpace += sbBYTES_TO_STORE_MESSAGE_LENGTH;
-    }
-    else
-    {
-        mtCOVERAGE_TEST_MARKER();
-    }
+        /* This is a message buffer, as opposed to a stream buffer. */
 
-    xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
-    xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
+        /* Convert xDataLengthBytes to the message length type. */
+        xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xDataLengthBytes;
 
-    if( xReturn > ( size_t ) 0 )
-    {
-        /* Was a task waiting for the data? */
-        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        /* Ensure the data length given fits within configMESSAGE_BUFFER_LENGTH_TYPE. */
+        configASSERT( ( size_t ) xMessageLength == xDataLengthBytes );
+
+        if( xSpace >= xRequiredSpace )
         {
-            prvSEND_COMPLETE_FROM_ISR( pxStreamBuffer, pxHigherPriorityTaskWoken );
+            /* There is enough space to write both the message length and the message
+             * itself into the buffer.  Start by writing the length of the data, the data
+             * itself will be written later in this function. */
+            xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xMessageLength ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextHead );
         }
         else
         {
-            mtCOVERAGE_TEST_MARKER();
+            /* Not enough space, so do not write data to the buffer. */
+            xDataLengthBytes = 0;
         }
     }
     else
     {
-        mtCOVERAGE_TEST_MARKER();
+        /* This is a stream buffer, as opposed to a message buffer, so writing a
+         * stream of bytes rather than discrete messages.  Plan to write as many
+         * bytes as possible. */
+        xDataLengthBytes = configMIN( xDataLengthBytes, xSpace );
     }
 
-    traceSTREAM_BUFFER_SEND_FROM_ISR( xStreamBuffer, xReturn );
+    if( xDataLengthBytes != ( size_t ) 0 )
+    {
+        /* Write the data to the buffer. */
+        pxStreamBuffer->xHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alignment and access. */
+    }
 
-    return xReturn;
+    return xDataLengthBytes;
 }
 /*-----------------------------------------------------------*/
 
-static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
-                                       const void * pvTxData,
-                                       size_t xDataLengthBytes,
-                                       size_t xSpace,
-                                       size_t xRequiredSpace )
+static size_t prvWriteFragmentsToBuffer( StreamBuffer_t * const pxStreamBuffer,
+                                         const StreamBufferFragment_t * pxFragments,
+                                         UBaseType_t uxFragmentCount,
+                                         size_t xDataLengthBytes,
+                                         size_t xSpace,
+                                         size_t xRequiredSpace )
 {
     size_t xNextHead = pxStreamBuffer->xHead;
+    size_t xRemaining, xCount;
+    UBaseType_t uxFragment;
     configMESSAGE_BUFFER_LENGTH_TYPE xMessageLength;
 
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
     {
-        /* This is a message buffer, as opposed to a stream buffer. */
-
-        /* Convert xDataLengthBytes to the message length type. */
+        /* The fragments form one message, written behind a single length. */
         xMessageLength = ( configMESSAGE_BUFFER_LENGTH_TYPE ) xDataLengthBytes;
-
-        /* Ensure the data length given fits within configMESSAGE_BUFFER_LENGTH_TYPE. */
         configASSERT( ( size_t ) xMessageLength == xDataLengthBytes );
 
-        if( xSpace >= xRequiredSpace )
+        if( ( xSpace >= xRequiredSpace ) && ( xDataLengthBytes != ( size_t ) 0 ) )
         {
-            /* There is enough space to write both the message length and the message
-             * itself into the buffer.  Start by writing the length of the data, the data
-             * itself will be written later in this function. */
             xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) &( xMessageLength ), sbBYTES_TO_STORE_MESSAGE_LENGTH, xNextHead );
         }
         else
@@ -883,22 +1065,62 @@ static size_t prvWriteMessageToBuffer( StreamBuffer_t * const pxStreamBuffer,
     }
     else
     {
-        /* This is a stream buffer, as opposed to a message buffer, so writing a
-         * stream of bytes rather than discrete messages.  Plan to write as many
-         * bytes as possible. */
+        /* A stream buffer takes as many bytes as fit, the fragments are cut
+         * where the space runs out. */
         xDataLengthBytes = configMIN( xDataLengthBytes, xSpace );
     }
 
+    xRemaining = xDataLengthBytes;
+
+    for( uxFragment = 0; ( uxFragment < uxFragmentCount ) && ( xRemaining != ( size_t ) 0 ); uxFragment++ )
+    {
+        xCount = configMIN( pxFragments[ uxFragment ].xLengthBytes, xRemaining );
+
+        if( xCount != ( size_t ) 0 )
+        {
+            xNextHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pxFragments[ uxFragment ].pvData, xCount, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alignment and access. */
+            xRemaining -= xCount;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
     if( xDataLengthBytes != ( size_t ) 0 )
     {
-        /* Write the data to the buffer. */
-        pxStreamBuffer->xHead = prvWriteBytesToBuffer( pxStreamBuffer, ( const uint8_t * ) pvTxData, xDataLengthBytes, xNextHead ); /*lint !e9079 Storage buffer is implemented as uint8_t for ease of sizing, alignment and access. */
+        /* Only now is the data, and a message's length, visible to the
+         * reader. */
+        pxStreamBuffer->xHead = xNextHead;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
     }
 
     return xDataLengthBytes;
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvFragmentsLength( const StreamBufferFragment_t * pxFragments,
+                                  UBaseType_t uxFragmentCount )
+{
+    size_t xLength = 0;
+    UBaseType_t uxFragment;
+
+    for( uxFragment = 0; uxFragment < uxFragmentCount; uxFragment++ )
+    {
+        configASSERT( ( pxFragments[ uxFragment ].pvData != NULL ) || ( pxFragments[ uxFragment ].xLengthBytes == ( size_t ) 0 ) );
+
+        /* Overflow? */
+        configASSERT( ( xLength + pxFragments[ uxFragment ].xLengthBytes ) >= xLength );
+        xLength += pxFragments[ uxFragment ].xLengthBytes;
+    }
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
                              void * pvRxData,
                              size_t xBufferLengthBytes,
@@ -1043,6 +1265,150 @@ size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer )
 }
 /*-----------------------------------------------------------*/
 
+size_t xStreamBufferPeek( StreamBufferHandle_t xStreamBuffer,
+                          void * pvRxData,
+                          size_t xOffset,
+                          size_t xBufferLengthBytes )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xBytesAvailable, xReadFrom, xCount = 0;
+    configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+    configASSERT( pvRxData );
+    configASSERT( pxStreamBuffer );
+
+    xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+    xReadFrom = pxStreamBuffer->xTail;
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+        {
+            /* Only the next message can be peeked, so the bytes available are
+             * the length of that message. */
+            xReadFrom = prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, xReadFrom );
+            xBytesAvailable = ( size_t ) xTempNextMessageLength;
+        }
+        else
+        {
+            xBytesAvailable = 0;
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( xOffset < xBytesAvailable )
+    {
+        xCount = configMIN( xBytesAvailable - xOffset, xBufferLengthBytes );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( xCount != ( size_t ) 0 )
+    {
+        /* xReadFrom and xOffset are both less than the length of the buffer. */
+        xReadFrom += xOffset;
+
+        if( xReadFrom >= pxStreamBuffer->xLength )
+        {
+            xReadFrom -= pxStreamBuffer->xLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The tail is not updated, so the data stays in the buffer. */
+        ( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) pvRxData, xCount, xReadFrom ); /*lint !e9079 Data storage area is implemented as uint8_t array for ease of sizing, indexing and alignment. */
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceSTREAM_BUFFER_PEEK( xStreamBuffer, xCount );
+
+    return xCount;
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferDiscard( StreamBufferHandle_t xStreamBuffer,
+                             size_t xBytesToDiscard )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xBytesAvailable, xCount, xAdvance;
+    configMESSAGE_BUFFER_LENGTH_TYPE xTempNextMessageLength;
+
+    configASSERT( pxStreamBuffer );
+
+    xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xCount = 0;
+        xAdvance = 0;
+
+        if( xBytesAvailable > sbBYTES_TO_STORE_MESSAGE_LENGTH )
+        {
+            ( void ) prvReadBytesFromBuffer( pxStreamBuffer, ( uint8_t * ) &xTempNextMessageLength, sbBYTES_TO_STORE_MESSAGE_LENGTH, pxStreamBuffer->xTail );
+
+            /* As with xStreamBufferReceive(), a message is only removed as a
+             * whole. */
+            if( ( size_t ) xTempNextMessageLength <= xBytesToDiscard )
+            {
+                xCount = ( size_t ) xTempNextMessageLength;
+                xAdvance = xCount + sbBYTES_TO_STORE_MESSAGE_LENGTH;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        xCount = configMIN( xBytesToDiscard, xBytesAvailable );
+        xAdvance = xCount;
+    }
+
+    if( xCount != ( size_t ) 0 )
+    {
+        /* xAdvance is at most the number of bytes in the buffer. */
+        xAdvance += pxStreamBuffer->xTail;
+
+        if( xAdvance >= pxStreamBuffer->xLength )
+        {
+            xAdvance -= pxStreamBuffer->xLength;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxStreamBuffer->xTail = xAdvance;
+
+        traceSTREAM_BUFFER_DISCARD( xStreamBuffer, xCount );
+
+        /* Was a task waiting for space in the buffer? */
+        prvRECEIVE_COMPLETED( xStreamBuffer );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xCount;
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
                                     void * pvRxData,
                                     size_t xBufferLengthBytes,
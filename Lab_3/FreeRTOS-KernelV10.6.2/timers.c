@@ -82,7 +82,13 @@
         #if ( configUSE_TRACE_FACILITY == 1 )
             UBaseType_t uxTimerNumber;              /**< An ID assigned by trace tools such as FreeRTOS+Trace */
         #endif
+        #if ( configUSE_TIMER_TOUCH == 1 )
+            TickType_t xTouchTime;                  /**< The tick count of the last xTimerTouch() that the timer service task has not applied yet. */
+        #endif
         uint8_t ucStatus;                           /**< Holds bits to say if the timer was statically allocated or not, and if it is active or not. */
+        #if ( configUSE_TIMER_TOUCH == 1 )
+            volatile uint8_t ucTouched;             /**< Set by xTimerTouch().  Not part of ucStatus as the timer service task updates that outside of critical sections. */
+        #endif
     } xTIMER;
 
 /* The old xTIMER name is maintained above then typedefed to the new Timer_t
@@ -128,21 +134,52 @@
 /*lint -save -e956 A manual analysis and inspection has been used to determine
  * which static variables must be declared volatile. */
 
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/* Each level of the timing wheel has 32 slots.  A slot of level n spans
+ * 2^(5 * n) ticks, so level 0 holds the timers that expire within 32 ticks,
+ * one slot per tick.  When the wheel reaches the start of a slot of a higher
+ * level the timers in it are re-placed at the levels below, which is known as
+ * cascading.  Only the timer service task is allowed to access the wheel. */
+        #define tmrWHEEL_SLOT_BITS            ( 5U )
+        #define tmrWHEEL_SLOTS                ( ( UBaseType_t ) 1U << tmrWHEEL_SLOT_BITS )
+        #define tmrWHEEL_SLOT_MASK            ( tmrWHEEL_SLOTS - 1U )
+        #define tmrWHEEL_SHIFT( uxLevel )     ( ( UBaseType_t ) ( uxLevel ) * tmrWHEEL_SLOT_BITS )
+
+        PRIVILEGED_DATA static List_t xTimerWheel[ configTIMER_WHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+
+/* A bit per slot that is set while the slot holds timers. */
+        PRIVILEGED_DATA static uint32_t ulWheelOccupiedSlots[ configTIMER_WHEEL_LEVELS ];
+
+/* The tick up to which the wheel has been processed, and the number of timers
+ * in it. */
+        PRIVILEGED_DATA static TickType_t xWheelTime = ( TickType_t ) 0U;
+        PRIVILEGED_DATA static UBaseType_t uxWheelTimers = ( UBaseType_t ) 0U;
+
+    #else /* configUSE_TIMER_WHEEL */
+
 /* The list in which active timers are stored.  Timers are referenced in expire
  * time order, with the nearest expiry time at the front of the list.  Only the
  * timer service task is allowed to access these lists.
  * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+        PRIVILEGED_DATA static List_t xActiveTimerList1;
+        PRIVILEGED_DATA static List_t xActiveTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+
+    #endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
     PRIVILEGED_DATA static TaskHandle_t xTimerTaskHandle = NULL;
 
+    #if ( configUSE_TIMER_TOUCH == 1 )
+        /* The number of xTimerTouch() calls that did not post a command. */
+        PRIVILEGED_DATA static volatile UBaseType_t uxAvoidedTimerCommands = ( UBaseType_t ) 0U;
+    #endif
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -191,11 +228,65 @@
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+/*
+ * The timer, which is not in the active list, has reached its expire time.
+ * Reload the timer if it is an auto-reload timer, then call its callback.  A
+ * timer that was touched since it was last inserted is inserted again for the
+ * expiry time of the touch instead, if that is still in the future.
+ */
+    static void prvExpireTimer( Timer_t * const pxTimer,
+                                TickType_t xExpiredTime,
+                                const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+    #if ( configUSE_TIMER_TOUCH == 1 )
+
+/*
+ * Atomically take a pending touch of the timer.  Returns pdTRUE and the tick
+ * count of the touch if there was one, otherwise clears the ucClearIfNotTouched
+ * status bits so a later touch falls back to posting a command.
+ */
+        static BaseType_t prvTakeTouch( Timer_t * const pxTimer,
+                                        TickType_t * const pxTouchTime,
+                                        const uint8_t ucClearIfNotTouched ) PRIVILEGED_FUNCTION;
+
+    #endif /* configUSE_TIMER_TOUCH */
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+
+/*
+ * Place the timer in the slot of the timing wheel that is reached at, or
+ * before, its expiry time.  O(1).
+ */
+        static void prvWheelInsert( Timer_t * const pxTimer,
+                                    const TickType_t xExpiryTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Take the timer out of its slot of the timing wheel.  O(1).
+ */
+        static void prvWheelRemove( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the tick at which the wheel next reaches an occupied slot, either to
+ * expire the timers of a level 0 slot or to cascade a higher level slot.  The
+ * wheel must not be empty.
+ */
+        static TickType_t prvWheelNextEvent( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the wheel up to xTimeNow, cascading slots and expiring all the timers
+ * of a tick together.
+ */
+        static void prvWheelAdvance( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+    #else /* configUSE_TIMER_WHEEL */
+
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+        static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+    #endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -374,6 +465,13 @@
         pxNewTimer->pxCallbackFunction = pxCallbackFunction;
         vListInitialiseItem( &( pxNewTimer->xTimerListItem ) );
 
+        #if ( configUSE_TIMER_TOUCH == 1 )
+        {
+            pxNewTimer->xTouchTime = ( TickType_t ) 0U;
+            pxNewTimer->ucTouched = ( uint8_t ) pdFALSE;
+        }
+        #endif
+
         if( xAutoReload != pdFALSE )
         {
             pxNewTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
@@ -392,12 +490,25 @@
         BaseType_t xReturn = pdFAIL;
         DaemonTaskMessage_t xMessage;
 
+        #if ( configUSE_TIMER_TOUCH == 1 )
+            uint8_t ucWasTouched;
+        #endif
+
         configASSERT( xTimer );
 
         /* Send a message to the timer service task to perform a particular action
          * on a particular timer definition. */
         if( xTimerQueue != NULL )
         {
+            #if ( configUSE_TIMER_TOUCH == 1 )
+            {
+                /* The command supersedes an earlier touch.  A touch pending
+                 * when the command is processed was therefore made after it. */
+                ucWasTouched = xTimer->ucTouched;
+                xTimer->ucTouched = ( uint8_t ) pdFALSE;
+            }
+            #endif
+
             /* Send a command to the timer service task to start the xTimer timer. */
             xMessage.xMessageID = xCommandID;
             xMessage.u.xTimerParameters.xMessageValue = xOptionalValue;
@@ -419,6 +530,16 @@
                 xReturn = xQueueSendToBackFromISR( xTimerQueue, &xMessage, pxHigherPriorityTaskWoken );
             }
 
+            #if ( configUSE_TIMER_TOUCH == 1 )
+            {
+                /* The command was not sent, so the touch still applies. */
+                if( ( xReturn != pdPASS ) && ( ucWasTouched != ( uint8_t ) pdFALSE ) )
+                {
+                    xTimer->ucTouched = ucWasTouched;
+                }
+            }
+            #endif
+
             traceTIMER_COMMAND_SEND( xTimer, xCommandID, xOptionalValue, xReturn );
         }
         else
@@ -505,7 +626,28 @@
         TickType_t xReturn;
 
         configASSERT( xTimer );
-        xReturn = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+
+        #if ( configUSE_TIMER_TOUCH == 1 )
+        {
+            taskENTER_CRITICAL();
+            {
+                if( pxTimer->ucTouched != ( uint8_t ) pdFALSE )
+                {
+                    xReturn = pxTimer->xTouchTime + pxTimer->xTimerPeriodInTicks;
+                }
+                else
+                {
+                    xReturn = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+        #else
+        {
+            xReturn = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+        }
+        #endif /* configUSE_TIMER_TOUCH */
+
         return xReturn;
     }
 /*-----------------------------------------------------------*/
@@ -534,6 +676,66 @@
     #endif /* configSUPPORT_STATIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_TOUCH == 1 )
+
+        BaseType_t xTimerTouch( TimerHandle_t xTimer,
+                                const TickType_t xTicksToWait )
+        {
+            BaseType_t xReturn = pdFAIL;
+            Timer_t * pxTimer = xTimer;
+
+            configASSERT( xTimer );
+
+            if( xTimerQueue != NULL )
+            {
+                /* A running timer can be reset without a command while no
+                 * commands are pending, as then the timer service task holds no
+                 * command for the timer that the touch would have to follow.
+                 * The timer service task applies the touch when the timer's
+                 * old expiry time is reached. */
+                taskENTER_CRITICAL();
+                {
+                    if( ( ( pxTimer->ucStatus & tmrSTATUS_IS_ACTIVE ) != 0 ) &&
+                        ( uxQueueMessagesWaiting( xTimerQueue ) == ( UBaseType_t ) 0U ) )
+                    {
+                        pxTimer->xTouchTime = xTaskGetTickCount();
+                        pxTimer->ucTouched = ( uint8_t ) pdTRUE;
+                        uxAvoidedTimerCommands++;
+                        xReturn = pdPASS;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                taskEXIT_CRITICAL();
+
+                if( xReturn == pdFAIL )
+                {
+                    xReturn = xTimerGenericCommand( xTimer, tmrCOMMAND_RESET, xTaskGetTickCount(), NULL, xTicksToWait );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
+
+        UBaseType_t uxTimerGetAvoidedCommandCount( void )
+        {
+            return uxAvoidedTimerCommands;
+        }
+
+    #endif /* configUSE_TIMER_TOUCH */
+/*-----------------------------------------------------------*/
+
     const char * pcTimerGetName( TimerHandle_t xTimer ) /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
     {
         Timer_t * pxTimer = xTimer;
@@ -565,22 +767,75 @@
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow )
     {
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        #if ( configUSE_TIMER_WHEEL == 1 )
+            Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( xTimerWheel[ 0 ][ xNextExpireTime & tmrWHEEL_SLOT_MASK ] ) ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 
-        /* Remove the timer from the list of active timers.  A check has already
-         * been performed to ensure the list is not empty. */
+            /* Remove the timer from the wheel.  A check has already been
+             * performed to ensure the slot is not empty. */
+            prvWheelRemove( pxTimer );
+        #else
+            Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 
-        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+            /* Remove the timer from the list of active timers.  A check has already
+             * been performed to ensure the list is not empty. */
+
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+        #endif /* configUSE_TIMER_WHEEL */
+
+        prvExpireTimer( pxTimer, xNextExpireTime, xTimeNow );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvExpireTimer( Timer_t * const pxTimer,
+                                TickType_t xExpiredTime,
+                                const TickType_t xTimeNow )
+    {
+        #if ( configUSE_TIMER_TOUCH == 1 )
+            TickType_t xTouchTime;
+            uint8_t ucClearIfNotTouched;
+
+            /* A one-shot timer that was not touched stops.  It is marked as
+             * not active in the same critical section that checks for a touch,
+             * so a later xTimerTouch() posts a command to restart it instead. */
+            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+            {
+                ucClearIfNotTouched = ( uint8_t ) 0U;
+            }
+            else
+            {
+                ucClearIfNotTouched = tmrSTATUS_IS_ACTIVE;
+            }
+
+            /* The timer was touched since it was inserted, so it really expires
+             * one period after the touch.  Insert it again for that time unless
+             * that time has also passed, in which case it expires now (and may
+             * have been touched again meanwhile). */
+            while( prvTakeTouch( pxTimer, &xTouchTime, ucClearIfNotTouched ) != pdFALSE )
+            {
+                if( prvInsertTimerInActiveList( pxTimer, ( xTouchTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTouchTime ) == pdFALSE )
+                {
+                    return;
+                }
+                else
+                {
+                    xExpiredTime = xTouchTime + pxTimer->xTimerPeriodInTicks;
+                }
+            }
+        #endif /* configUSE_TIMER_TOUCH */
 
         /* If the timer is an auto-reload timer then calculate the next
          * expiry time and re-insert the timer in the list of active timers. */
         if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
         {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            prvReloadTimer( pxTimer, xExpiredTime, xTimeNow );
         }
         else
         {
-            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            #if ( configUSE_TIMER_TOUCH == 0 )
+            {
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            }
+            #endif
         }
 
         /* Call the timer callback. */
@@ -589,6 +844,36 @@
     }
 /*-----------------------------------------------------------*/
 
+    #if ( configUSE_TIMER_TOUCH == 1 )
+
+        static BaseType_t prvTakeTouch( Timer_t * const pxTimer,
+                                        TickType_t * const pxTouchTime,
+                                        const uint8_t ucClearIfNotTouched )
+        {
+            BaseType_t xReturn;
+
+            taskENTER_CRITICAL();
+            {
+                if( pxTimer->ucTouched != ( uint8_t ) pdFALSE )
+                {
+                    pxTimer->ucTouched = ( uint8_t ) pdFALSE;
+                    *pxTouchTime = pxTimer->xTouchTime;
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    pxTimer->ucStatus &= ( uint8_t ) ~ucClearIfNotTouched;
+                    xReturn = pdFALSE;
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            return xReturn;
+        }
+
+    #endif /* configUSE_TIMER_TOUCH */
+/*-----------------------------------------------------------*/
+
     static portTASK_FUNCTION( prvTimerTask, pvParameters )
     {
         TickType_t xNextExpireTime;
@@ -623,52 +908,36 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
-                                            BaseType_t xListWasEmpty )
-    {
-        TickType_t xTimeNow;
-        BaseType_t xTimerListsWereSwitched;
+    #if ( configUSE_TIMER_WHEEL == 1 )
 
-        vTaskSuspendAll();
+        static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+                                                BaseType_t xListWasEmpty )
         {
-            /* Obtain the time now to make an assessment as to whether the timer
-             * has expired or not.  If obtaining the time causes the lists to switch
-             * then don't process this timer as any timers that remained in the list
-             * when the lists were switched will have been processed within the
-             * prvSampleTimeNow() function. */
-            xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
-
-            if( xTimerListsWereSwitched == pdFALSE )
+            TickType_t xTimeNow;
+            BaseType_t xTimerListsWereSwitched;
+
+            vTaskSuspendAll();
             {
-                /* The tick count has not overflowed, has the timer expired? */
-                if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+                /* The wheel never switches lists, the flag is not used. */
+                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+                /* Times are compared relative to the tick the wheel has
+                 * reached, so the tick count overflowing needs no special
+                 * handling.  Has the next occupied slot been reached? */
+                if( ( xListWasEmpty == pdFALSE ) && ( ( TickType_t ) ( xNextExpireTime - xWheelTime ) <= ( TickType_t ) ( xTimeNow - xWheelTime ) ) )
                 {
                     ( void ) xTaskResumeAll();
-                    prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+                    prvWheelAdvance( xTimeNow );
                 }
                 else
                 {
-                    /* The tick count has not overflowed, and the next expire
-                     * time has not been reached yet.  This task should therefore
-                     * block to wait for the next expire time or a command to be
-                     * received - whichever comes first.  The following line cannot
-                     * be reached unless xNextExpireTime > xTimeNow, except in the
-                     * case when the current timer list is empty. */
-                    if( xListWasEmpty != pdFALSE )
-                    {
-                        /* The current timer list is empty - is the overflow list
-                         * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
-                    }
-
+                    /* Block until the next occupied slot is reached or a
+                     * command is received.  An empty wheel blocks
+                     * indefinitely. */
                     vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
                     if( xTaskResumeAll() == pdFALSE )
                     {
-                        /* Yield to wait for either a command to arrive, or the
-                         * block time to expire.  If a command arrived between the
-                         * critical section being exited and this yield then the yield
-                         * will not cause the task to block. */
                         portYIELD_WITHIN_API();
                     }
                     else
@@ -677,12 +946,72 @@
                     }
                 }
             }
-            else
+        }
+
+    #else /* configUSE_TIMER_WHEEL */
+
+        static void prvProcessTimerOrBlockTask( const TickType_t xNextExpireTime,
+                                                BaseType_t xListWasEmpty )
+        {
+            TickType_t xTimeNow;
+            BaseType_t xTimerListsWereSwitched;
+
+            vTaskSuspendAll();
             {
-                ( void ) xTaskResumeAll();
+                /* Obtain the time now to make an assessment as to whether the timer
+                 * has expired or not.  If obtaining the time causes the lists to switch
+                 * then don't process this timer as any timers that remained in the list
+                 * when the lists were switched will have been processed within the
+                 * prvSampleTimeNow() function. */
+                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+                if( xTimerListsWereSwitched == pdFALSE )
+                {
+                    /* The tick count has not overflowed, has the timer expired? */
+                    if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+                    {
+                        ( void ) xTaskResumeAll();
+                        prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
+                    }
+                    else
+                    {
+                        /* The tick count has not overflowed, and the next expire
+                         * time has not been reached yet.  This task should therefore
+                         * block to wait for the next expire time or a command to be
+                         * received - whichever comes first.  The following line cannot
+                         * be reached unless xNextExpireTime > xTimeNow, except in the
+                         * case when the current timer list is empty. */
+                        if( xListWasEmpty != pdFALSE )
+                        {
+                            /* The current timer list is empty - is the overflow list
+                             * also empty? */
+                            xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        }
+
+                        vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
+
+                        if( xTaskResumeAll() == pdFALSE )
+                        {
+                            /* Yield to wait for either a command to arrive, or the
+                             * block time to expire.  If a command arrived between the
+                             * critical section being exited and this yield then the yield
+                             * will not cause the task to block. */
+                            portYIELD_WITHIN_API();
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                }
+                else
+                {
+                    ( void ) xTaskResumeAll();
+                }
             }
         }
-    }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
@@ -696,11 +1025,30 @@
          * this task to unblock when the tick count overflows, at which point the
          * timer lists will be switched and the next expiry time can be
          * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+        #if ( configUSE_TIMER_WHEEL == 1 )
+        {
+            /* With the wheel the next expire time is the next tick at which
+             * there is work to do, which may be cascading a slot rather than
+             * expiring a timer. */
+            *pxListWasEmpty = ( uxWheelTimers == ( UBaseType_t ) 0U ) ? pdTRUE : pdFALSE;
+        }
+        #else
+        {
+            *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+        }
+        #endif /* configUSE_TIMER_WHEEL */
 
         if( *pxListWasEmpty == pdFALSE )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            #if ( configUSE_TIMER_WHEEL == 1 )
+            {
+                xNextExpireTime = prvWheelNextEvent();
+            }
+            #else
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            }
+            #endif /* configUSE_TIMER_WHEEL */
         }
         else
         {
@@ -715,21 +1063,43 @@
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
+
+        #if ( configUSE_TIMER_WHEEL == 0 )
+            PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
+        #endif
 
         xTimeNow = xTaskGetTickCount();
 
-        if( xTimeNow < xLastTime )
-        {
-            prvSwitchTimerLists();
-            *pxTimerListsWereSwitched = pdTRUE;
-        }
-        else
+        #if ( configUSE_TIMER_WHEEL == 1 )
         {
+            /* The wheel has no lists to switch.  An empty wheel has nothing
+             * to catch up with, so it moves on to the current time. */
             *pxTimerListsWereSwitched = pdFALSE;
+
+            if( uxWheelTimers == ( UBaseType_t ) 0U )
+            {
+                xWheelTime = xTimeNow;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
         }
+        #else
+        {
+            if( xTimeNow < xLastTime )
+            {
+                prvSwitchTimerLists();
+                *pxTimerListsWereSwitched = pdTRUE;
+            }
+            else
+            {
+                *pxTimerListsWereSwitched = pdFALSE;
+            }
 
-        xLastTime = xTimeNow;
+            xLastTime = xTimeNow;
+        }
+        #endif /* configUSE_TIMER_WHEEL */
 
         return xTimeNow;
     }
@@ -757,7 +1127,15 @@
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    prvWheelInsert( pxTimer, xNextExpiryTime );
+                }
+                #else
+                {
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
+                #endif /* configUSE_TIMER_WHEEL */
             }
         }
         else
@@ -771,7 +1149,15 @@
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    prvWheelInsert( pxTimer, xNextExpiryTime );
+                }
+                #else
+                {
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                }
+                #endif /* configUSE_TIMER_WHEEL */
             }
         }
 
@@ -821,7 +1207,15 @@
                 if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
                 {
                     /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    #if ( configUSE_TIMER_WHEEL == 1 )
+                    {
+                        prvWheelRemove( pxTimer );
+                    }
+                    #else
+                    {
+                        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    }
+                    #endif /* configUSE_TIMER_WHEEL */
                 }
                 else
                 {
@@ -851,18 +1245,7 @@
                         {
                             /* The timer expired before it was added to the active
                              * timer list.  Process it now. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
-                            {
-                                prvReloadTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
-                            }
-                            else
-                            {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
-
-                            /* Call the timer callback. */
-                            traceTIMER_EXPIRED( pxTimer );
-                            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+                            prvExpireTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
                         }
                         else
                         {
@@ -874,7 +1257,30 @@
                     case tmrCOMMAND_STOP:
                     case tmrCOMMAND_STOP_FROM_ISR:
                         /* The timer has already been removed from the active list. */
-                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                        #if ( configUSE_TIMER_TOUCH == 1 )
+                        {
+                            TickType_t xTouchTime;
+
+                            /* Posting the stop command cleared any earlier touch,
+                             * so a pending touch was made after the timer was
+                             * stopped and restarts it. */
+                            if( prvTakeTouch( pxTimer, &xTouchTime, tmrSTATUS_IS_ACTIVE ) != pdFALSE )
+                            {
+                                if( prvInsertTimerInActiveList( pxTimer, ( xTouchTime + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTouchTime ) != pdFALSE )
+                                {
+                                    prvExpireTimer( pxTimer, xTouchTime + pxTimer->xTimerPeriodInTicks, xTimeNow );
+                                }
+                                else
+                                {
+                                    mtCOVERAGE_TEST_MARKER();
+                                }
+                            }
+                        }
+                        #else
+                        {
+                            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                        }
+                        #endif /* configUSE_TIMER_TOUCH */
                         break;
 
                     case tmrCOMMAND_CHANGE_PERIOD:
@@ -927,29 +1333,184 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvSwitchTimerLists( void )
-    {
-        TickType_t xNextExpireTime;
-        List_t * pxTemp;
+    #if ( configUSE_TIMER_WHEEL == 1 )
 
-        /* The tick count has overflowed.  The timer lists must be switched.
-         * If there are any timers still referenced from the current timer list
-         * then they must have expired and should be processed before the lists
-         * are switched. */
-        while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+        static void prvWheelInsert( Timer_t * const pxTimer,
+                                    const TickType_t xExpiryTime )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            TickType_t xDelta;
+            TickType_t xSlotTime = xExpiryTime;
+            UBaseType_t uxLevel = 0;
+            UBaseType_t uxSlot;
+
+            /* The expiry time is never before the tick the wheel has reached,
+             * so the difference is the number of ticks left. */
+            xDelta = xExpiryTime - xWheelTime;
+
+            /* Use the lowest level that spans the remaining time. */
+            while( ( uxLevel < ( UBaseType_t ) ( configTIMER_WHEEL_LEVELS - 1 ) ) && ( ( xDelta >> tmrWHEEL_SHIFT( uxLevel + 1U ) ) != ( TickType_t ) 0U ) )
+            {
+                uxLevel++;
+            }
+
+            if( ( xDelta >> tmrWHEEL_SHIFT( uxLevel + 1U ) ) != ( TickType_t ) 0U )
+            {
+                /* Beyond the range of the wheel.  Use the last slot of the top
+                 * level, the timer is placed again when that slot is
+                 * cascaded. */
+                xSlotTime = xWheelTime + ( ( TickType_t ) tmrWHEEL_SLOT_MASK << tmrWHEEL_SHIFT( uxLevel ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
 
-            /* Process the expired timer.  For auto-reload timers, be careful to
-             * process only expirations that occur on the current list.  Further
-             * expirations must wait until after the lists are switched. */
-            prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            uxSlot = ( UBaseType_t ) ( xSlotTime >> tmrWHEEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK;
+            vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+            ulWheelOccupiedSlots[ uxLevel ] |= ( uint32_t ) 1U << uxSlot;
+            uxWheelTimers++;
         }
+    /*-----------------------------------------------------------*/
 
-        pxTemp = pxCurrentTimerList;
-        pxCurrentTimerList = pxOverflowTimerList;
-        pxOverflowTimerList = pxTemp;
-    }
+        static void prvWheelRemove( Timer_t * const pxTimer )
+        {
+            List_t * const pxSlotList = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+            const UBaseType_t uxIndex = ( UBaseType_t ) ( pxSlotList - &( xTimerWheel[ 0 ][ 0 ] ) );
+
+            if( uxListRemove( &( pxTimer->xTimerListItem ) ) == ( UBaseType_t ) 0U )
+            {
+                ulWheelOccupiedSlots[ uxIndex >> tmrWHEEL_SLOT_BITS ] &= ~( ( uint32_t ) 1U << ( uxIndex & tmrWHEEL_SLOT_MASK ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxWheelTimers--;
+        }
+    /*-----------------------------------------------------------*/
+
+        static TickType_t prvWheelNextEvent( void )
+        {
+            /* Position of the lowest set bit of a 32 bit word, found with a de
+             * Bruijn sequence as not all architectures count zeros in
+             * hardware. */
+            static const uint8_t ucDeBruijnBitPosition[ 32 ] =
+            {
+                0U,  1U,  28U, 2U,  29U, 14U, 24U, 3U, 30U, 22U, 20U, 15U, 25U, 17U, 4U,  8U,
+                31U, 27U, 13U, 23U, 21U, 19U, 16U, 7U, 26U, 12U, 18U, 6U,  11U, 5U,  10U, 9U
+            };
+            TickType_t xNearest = portMAX_DELAY;
+            TickType_t xIndex, xDelta;
+            UBaseType_t uxLevel, uxFirst, uxDistance;
+            uint32_t ulOccupied;
+
+            for( uxLevel = 0; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+            {
+                if( ulWheelOccupiedSlots[ uxLevel ] != 0U )
+                {
+                    /* Rotate the occupied slots so the slot after the current
+                     * one is bit 0, the first set bit is then the distance to
+                     * the next occupied slot.  The current slot itself is
+                     * reached last, one full turn later. */
+                    xIndex = xWheelTime >> tmrWHEEL_SHIFT( uxLevel );
+                    uxFirst = ( UBaseType_t ) ( xIndex + 1U ) & tmrWHEEL_SLOT_MASK;
+                    ulOccupied = ulWheelOccupiedSlots[ uxLevel ];
+                    ulOccupied = ( ulOccupied >> uxFirst ) | ( ulOccupied << ( ( tmrWHEEL_SLOTS - uxFirst ) & tmrWHEEL_SLOT_MASK ) );
+                    uxDistance = ( UBaseType_t ) ucDeBruijnBitPosition[ ( ( ulOccupied & ( 0U - ulOccupied ) ) * 0x077CB531U ) >> 27 ] + 1U;
+
+                    xDelta = ( ( xIndex + uxDistance ) << tmrWHEEL_SHIFT( uxLevel ) ) - xWheelTime;
+
+                    if( xDelta < xNearest )
+                    {
+                        xNearest = xDelta;
+                    }
+                }
+            }
+
+            return xWheelTime + xNearest;
+        }
+    /*-----------------------------------------------------------*/
+
+        static void prvWheelAdvance( const TickType_t xTimeNow )
+        {
+            TickType_t xNext;
+            UBaseType_t uxLevel;
+            List_t * pxSlotList;
+            Timer_t * pxTimer;
+
+            while( uxWheelTimers > ( UBaseType_t ) 0U )
+            {
+                xNext = prvWheelNextEvent();
+
+                if( ( TickType_t ) ( xNext - xWheelTime ) > ( TickType_t ) ( xTimeNow - xWheelTime ) )
+                {
+                    break;
+                }
+
+                /* Nothing happens on the ticks in between, skip them. */
+                xWheelTime = xNext;
+
+                /* Cascade the higher level slots that start on this tick. */
+                for( uxLevel = ( UBaseType_t ) ( configTIMER_WHEEL_LEVELS - 1 ); uxLevel > 0U; uxLevel-- )
+                {
+                    if( ( xNext & ( ( ( TickType_t ) 1U << tmrWHEEL_SHIFT( uxLevel ) ) - 1U ) ) == ( TickType_t ) 0U )
+                    {
+                        pxSlotList = &( xTimerWheel[ uxLevel ][ ( xNext >> tmrWHEEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK ] );
+
+                        /* A timer is never placed back in the slot being
+                         * cascaded, as its remaining time is less than a full
+                         * turn of this level. */
+                        while( listLIST_IS_EMPTY( pxSlotList ) == pdFALSE )
+                        {
+                            pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlotList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                            prvWheelRemove( pxTimer );
+                            prvWheelInsert( pxTimer, listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) ) );
+                        }
+                    }
+                }
+
+                /* Expire all the timers of this tick.  Reloaded timers are
+                 * placed in later slots, so the loop ends. */
+                pxSlotList = &( xTimerWheel[ 0 ][ xNext & tmrWHEEL_SLOT_MASK ] );
+
+                while( listLIST_IS_EMPTY( pxSlotList ) == pdFALSE )
+                {
+                    prvProcessExpiredTimer( xNext, xTimeNow );
+                }
+            }
+
+            /* There is nothing left to do up to xTimeNow. */
+            xWheelTime = xTimeNow;
+        }
+
+    #else /* configUSE_TIMER_WHEEL */
+
+        static void prvSwitchTimerLists( void )
+        {
+            TickType_t xNextExpireTime;
+            List_t * pxTemp;
+
+            /* The tick count has overflowed.  The timer lists must be switched.
+             * If there are any timers still referenced from the current timer list
+             * then they must have expired and should be processed before the lists
+             * are switched. */
+            while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+
+                /* Process the expired timer.  For auto-reload timers, be careful to
+                 * process only expirations that occur on the current list.  Further
+                 * expirations must wait until after the lists are switched. */
+                prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            }
+
+            pxTemp = pxCurrentTimerList;
+            pxCurrentTimerList = pxOverflowTimerList;
+            pxOverflowTimerList = pxTemp;
+        }
+
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -961,10 +1522,28 @@
         {
             if( xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                {
+                    UBaseType_t uxLevel, uxSlot;
+
+                    for( uxLevel = 0; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+                    {
+                        for( uxSlot = 0; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+                        {
+                            vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+                        }
+
+                        ulWheelOccupiedSlots[ uxLevel ] = 0U;
+                    }
+                }
+                #else
+                {
+                    vListInitialise( &xActiveTimerList1 );
+                    vListInitialise( &xActiveTimerList2 );
+                    pxCurrentTimerList = &xActiveTimerList1;
+                    pxOverflowTimerList = &xActiveTimerList2;
+                }
+                #endif /* configUSE_TIMER_WHEEL */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                 {
@@ -0,0 +1,180 @@
+//
+// Line oriented command interpreter for PicoOsUart consoles.
+//
+
+#include "Cli.h"
+
+#include <cstring>
+
+Cli::Cli(PicoOsUart &uart, const Command *commands, size_t count) :
+        uart{uart}, commands{commands}, count{count}, line{}, length{0} {
+}
+
+void Cli::receive(const uint8_t *data, int size) {
+    // printable characters are echoed in one write per chunk instead of one per character
+    int echo = length;
+    for(int i = 0; i < size; ++i) {
+        uint8_t c = data[i];
+        if (c >= 32 && c <= 126) {  // Printable characters
+            if (length < max_line - 1) {
+                line[length++] = static_cast<char>(c);
+            } else {
+                uart.write(reinterpret_cast<const uint8_t *>(line + echo), length - echo);
+                print("\r\nBuffer overflow\r\n");
+                length = echo = 0;
+            }
+        } else if (c == '\r' || c == '\n') {  // Newline or carriage return
+            uart.write(reinterpret_cast<const uint8_t *>(line + echo), length - echo);
+            end_of_line();
+            echo = 0;
+        }
+    }
+    uart.write(reinterpret_cast<const uint8_t *>(line + echo), length - echo);
+}
+
+void Cli::reset() {
+    length = 0;
+}
+
+void Cli::end_of_line() {
+    // empty lines are ignored so that CR LF line endings don't execute twice
+    if(length > 0) {
+        print("\r\n");
+        line[length] = '\0';
+        length = 0;
+        execute(line);
+    }
+}
+
+void Cli::execute(char *str) {
+    print("Processing command: ");
+    print(str);
+    print("\n");
+
+    // split in place, argv points to the line
+    char *argv[max_args];
+    int argc = 0;
+    char *p = str;
+    while(*p && argc < max_args) {
+        while(*p == ' ') ++p;
+        if(!*p) break;
+        argv[argc++] = p;
+        while(*p && *p != ' ') ++p;
+        if(*p) *p++ = '\0';
+    }
+    if(argc == 0) return;
+
+    const Command *cmd = find(argv[0]);
+    if(cmd) {
+        cmd->handler(*this, argc, argv);
+    } else {
+        print("Unknown command\n");
+    }
+}
+
+const Cli::Command *Cli::find(const char *name) const {
+    size_t first = 0;
+    size_t last = count;
+    while(first < last) {
+        size_t mid = first + (last - first) / 2;
+        int result = compare(name, commands[mid].name);
+        if(result == 0) return &commands[mid];
+        if(result < 0) last = mid;
+        else first = mid + 1;
+    }
+    return nullptr;
+}
+
+void Cli::help() {
+    print("Commands:\n");
+    for(size_t i = 0; i < count; ++i) {
+        print(commands[i].name);
+        if(*commands[i].args) {
+            print(" ");
+            print(commands[i].args);
+        }
+        print(" - ");
+        print(commands[i].help);
+        print("\n");
+    }
+}
+
+void Cli::print(const char *str) {
+    uart.send(str);
+}
+
+void Cli::print_int(int32_t value) {
+    char buffer[12];
+    char *p = buffer + sizeof(buffer);
+    uint32_t magnitude = value < 0 ? 0u - static_cast<uint32_t>(value) : value;
+    *--p = '\0';
+    do {
+        *--p = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude);
+    if(value < 0) *--p = '-';
+    print(p);
+}
+
+void Cli::print_fixed(int32_t value, int decimals, int shown) {
+    int32_t scale = 1;
+    for(int i = shown; i < decimals; ++i) scale *= 10;
+    // round to the shown number of decimals
+    int64_t scaled = (static_cast<int64_t>(value) + (value < 0 ? -scale / 2 : scale / 2)) / scale;
+    int32_t unit = 1;
+    for(int i = 0; i < shown; ++i) unit *= 10;
+
+    if(scaled < 0) {
+        print("-");
+        scaled = -scaled;
+    }
+    print_int(static_cast<int32_t>(scaled / unit));
+    if(shown > 0) {
+        char buffer[12];
+        int32_t fraction = static_cast<int32_t>(scaled % unit);
+        buffer[0] = '.';
+        for(int i = shown; i > 0; --i) {
+            buffer[i] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        buffer[shown + 1] = '\0';
+        print(buffer);
+    }
+}
+
+bool Cli::parse_int(const char *str, int32_t &value) {
+    return parse_fixed(str, 0, value) && !strchr(str, '.');
+}
+
+bool Cli::parse_fixed(const char *str, int decimals, int32_t &value) {
+    bool negative = false;
+    bool digits = false;
+    int64_t result = 0;
+    int fraction = -1; // number of decimals seen, -1 before decimal point
+
+    if(*str == '-' || *str == '+') {
+        negative = *str++ == '-';
+    }
+    for(; *str; ++str) {
+        if(*str == '.' && fraction < 0) {
+            fraction = 0;
+        } else if(*str >= '0' && *str <= '9') {
+            digits = true;
+            if(fraction < decimals) {
+                result = result * 10 + (*str - '0');
+                if(fraction >= 0) ++fraction;
+                if(result > INT32_MAX) return false;
+            }
+        } else {
+            return false;
+        }
+    }
+    if(!digits) return false;
+    // scale up if there were fewer decimals than requested
+    for(int i = fraction < 0 ? 0 : fraction; i < decimals; ++i) {
+        result *= 10;
+        if(result > INT32_MAX) return false;
+    }
+    value = static_cast<int32_t>(negative ? -result : result);
+    return true;
+}
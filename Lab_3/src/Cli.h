@@ -0,0 +1,79 @@
+//
+// Line oriented command interpreter for PicoOsUart consoles.
+//
+// Commands are kept in a constant table sorted by name so that lookup is a
+// binary search. Received lines are tokenized in place and no memory is
+// allocated at run time.
+//
+
+#ifndef RP2040_FREERTOS_IRQ_CLI_H
+#define RP2040_FREERTOS_IRQ_CLI_H
+
+#include <cstdint>
+#include <cstddef>
+#include "PicoOsUart.h"
+
+class Cli {
+public:
+    using Handler = void (*)(Cli &cli, int argc, char *argv[]);
+    struct Command {
+        const char *name;
+        const char *args;   // argument synopsis for help, empty if none
+        const char *help;
+        Handler handler;
+    };
+    static constexpr int max_line = 128;
+    static constexpr int max_args = 8;
+
+    template<size_t N>
+    Cli(PicoOsUart &uart, const Command (&commands)[N]) : Cli(uart, commands, N) {}
+    Cli(PicoOsUart &uart, const Command *commands, size_t count);
+    Cli(const Cli &) = delete;
+
+    // process received characters, every complete line is executed
+    void receive(const uint8_t *data, int size);
+    // discard partially received line
+    void reset();
+    [[nodiscard]] bool line_pending() const { return length > 0; }
+    // execute a line, line is modified by tokenization
+    void execute(char *line);
+    [[nodiscard]] const Command *find(const char *name) const;
+    void help();
+
+    // output helpers
+    void print(const char *str);
+    void print_int(int32_t value);
+    // print value that has 'decimals' decimal places with 'shown' (<= decimals) decimals, rounded
+    void print_fixed(int32_t value, int decimals, int shown);
+
+    // argument parsing without libc, return false if the whole string is not a number
+    static bool parse_int(const char *str, int32_t &value);
+    // parse decimal number to fixed point with given number of decimals, for example
+    // "2.5" with three decimals gives 2500, excess decimals are truncated
+    static bool parse_fixed(const char *str, int decimals, int32_t &value);
+
+    // for static_assert on command tables
+    template<size_t N>
+    static constexpr bool is_sorted(const Command (&commands)[N]) {
+        for(size_t i = 1; i < N; ++i) {
+            if(compare(commands[i - 1].name, commands[i].name) >= 0) return false;
+        }
+        return true;
+    }
+    static constexpr int compare(const char *a, const char *b) {
+        while(*a && *a == *b) {
+            ++a;
+            ++b;
+        }
+        return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+    }
+private:
+    void end_of_line();
+    PicoOsUart &uart;
+    const Command *commands;
+    size_t count;
+    char line[max_line];
+    int length;
+};
+
+#endif //RP2040_FREERTOS_IRQ_CLI_H
@@ -110,6 +110,8 @@ uint32_t read_runtime_ctr(void);
 #define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 1 )
 #define configTIMER_QUEUE_LENGTH                10
 #define configTIMER_TASK_STACK_DEPTH            1024
+#define configUSE_TIMER_WHEEL                   1
+#define configUSE_TIMER_TOUCH                   1
 
 /* Interrupt nesting behaviour configuration. */
 /*
@@ -3,6 +3,7 @@
 //
 
 #include "PicoOsUart.h"
+#include "PicoUartDma.h"
 
 #include <hardware/gpio.h>
 #include <cstring>
@@ -15,6 +16,10 @@ static PicoOsUart *pu1;
 
 void pico_uart0_handler(void) {
     if(pu0) {
+        if(pu0->dma) {
+            pu0->uart_irq_rx_timeout();
+            return;
+        }
         pu0->uart_irq_rx();
         pu0->uart_irq_tx();
     }
@@ -23,6 +28,10 @@ void pico_uart0_handler(void) {
 
 void pico_uart1_handler(void) {
     if(pu1) {
+        if(pu1->dma) {
+            pu1->uart_irq_rx_timeout();
+            return;
+        }
         pu1->uart_irq_rx();
         pu1->uart_irq_tx();
     }
@@ -30,9 +39,16 @@ void pico_uart1_handler(void) {
 }
 
 
-PicoOsUart::PicoOsUart(int uart_nr, int tx_pin, int rx_pin, int speed, int stop, int tx_size, int rx_size) : speed{speed} {
-    tx = xQueueCreate(tx_size, sizeof(char));
-    rx = xQueueCreate(rx_size, sizeof(char));
+PicoOsUart::PicoOsUart(int uart_nr, int tx_pin, int rx_pin, int speed, int stop, int tx_size, int rx_size,
+                       bool use_dma) :
+        tx{nullptr}, rx{nullptr}, dma{nullptr}, rx_ring{nullptr}, tx_done{nullptr}, rx_ready{nullptr},
+        speed{speed}, rx_dropped{0}, rx_overruns{0}, tx_dropped{0} {
+    if(!use_dma) {
+        // trigger level of one byte wakes the reader once per received burst
+        tx = xStreamBufferCreate(tx_size, 1);
+        rx = xStreamBufferCreate(rx_size, 1);
+    }
+    tx_lock = xSemaphoreCreateMutex();
     irqn = uart_nr==0 ? UART0_IRQ : UART1_IRQ;
     uart = uart_nr==0 ? uart0 : uart1;
     if(uart_nr == 0) {
@@ -56,43 +72,62 @@ PicoOsUart::PicoOsUart(int uart_nr, int tx_pin, int rx_pin, int speed, int stop,
 
     irq_set_exclusive_handler(irqn, uart_nr == 0 ? pico_uart0_handler : pico_uart1_handler);
 
+    if(use_dma) {
+        // dma raises one interrupt per completed transfer, the only uart interrupt is the receive timeout
+        // that tells about a partially filled block when the line goes quiet
+        tx_done = xSemaphoreCreateBinary();
+        rx_ready = xSemaphoreCreateBinary();
+        rx_ring = new DmaRxRing(new uint8_t[rx_size], rx_size / dma_rx_blocks, dma_rx_blocks);
+        dma = new PicoUartDma(uart);
+        dma->set_client(this);
+        dma->start_rx(rx_ring->current_block(), rx_ring->get_block_size());
+        hw_set_bits(&uart_get_hw(uart)->imsc, UART_UARTIMSC_RTIM_BITS);
+        irq_set_enabled(irqn, true);
+        return;
+    }
+
     // Now enable the UART to send interrupts - RX only
     uart_set_irq_enables(uart, true, false);
+    // raise rx interrupt level to half full so that each interrupt drains a burst,
+    // receive timeout interrupt takes care of the bytes that remain below the level
+    hw_write_masked(&uart_get_hw(uart)->ifls, 2 << UART_UARTIFLS_RXIFLSEL_LSB, UART_UARTIFLS_RXIFLSEL_BITS);
+    // tx interrupt level to 1/8 so that fill_tx_fifo() knows how much room there is when TXRIS is set,
+    // reset value is 1/2
+    hw_write_masked(&uart_get_hw(uart)->ifls, 0 << UART_UARTIFLS_TXIFLSEL_LSB, UART_UARTIFLS_TXIFLSEL_BITS);
     // enable UART0 interrupts on NVIC
     irq_set_enabled(irqn, true);
 }
 
 int PicoOsUart::read(uint8_t *buffer, int size, int timeout) {
+    if(dma) return dma_read(buffer, size, timeout);
     int count = 0;
-    while(count < size && xQueueReceive(rx, buffer, pdMS_TO_TICKS(timeout))==pdTRUE) {
-        ++buffer;
-        ++count;
+    size_t received;
+    // each receive returns everything that is available so we loop once per burst, not once per byte
+    while(count < size &&
+          (received = xStreamBufferReceive(rx, buffer + count, size - count, pdMS_TO_TICKS(timeout))) > 0) {
+        count += received;
     }
     return count;
 }
 
 int PicoOsUart::write(const uint8_t *buffer, int size) {
+    if(dma) return dma_write(buffer, size);
     int count = 0;
-    // write data to queue
-    while(count < size && xQueueSendToBack(tx, buffer, pdMS_TO_TICKS(500)) == pdTRUE) {
-        ++buffer;
-        ++count;
-    }
+    TickType_t wait = 0;
 
-    // disable interrupts on NVIC while managing transmit interrupts
-    irq_set_enabled(irqn, false);
-    // if transmit interrupt is not enabled we need to enable it and give fifo an initial filling
-    if(!(uart_get_hw(uart)->imsc & (1 << UART_UARTIMSC_TXIM_LSB))) {
-        uint8_t ch;
-        // enable transmit interrupt
-        uart_set_irq_enables(uart, true, true);
-        // fifo requires initial fill to get TX interrupts going
-        while(uart_is_writable(uart) && xQueueReceive(tx, &ch, 0) == pdTRUE) {
-            uart_get_hw(uart)->dr = ch;
+    xSemaphoreTake(tx_lock, portMAX_DELAY);
+    while(count < size) {
+        // copy as much as fits and get transmitter going before we block waiting for more space
+        size_t sent = xStreamBufferSend(tx, buffer + count, size - count, wait);
+        if(sent == 0 && wait != 0) {
+            break; // timed out without making progress
         }
+        count += sent;
+        start_tx();
+        wait = pdMS_TO_TICKS(500);
     }
-    // enable interrupts on NVIC
-    irq_set_enabled(irqn, true);
+    tx_dropped += size - count;
+    xSemaphoreGive(tx_lock);
 
     return count;
 }
@@ -108,38 +143,168 @@ int PicoOsUart::send(const std::string &str) {
 }
 
 int PicoOsUart::flush() {
+    if(dma) return rx_ring->flush(dma_rx_position());
     int count = 0;
-    char dummy = 0;
-    while(xQueueReceive(rx, &dummy, 0)==pdTRUE) {
-        ++count;
+    uint8_t dummy[fifo_size];
+    size_t received;
+    while((received = xStreamBufferReceive(rx, dummy, sizeof(dummy), 0)) > 0) {
+        count += received;
     }
     return count;
 }
 
+void PicoOsUart::start_tx() {
+    // disable interrupts on NVIC while managing transmit interrupts
+    irq_set_enabled(irqn, false);
+    if(!(uart_get_hw(uart)->imsc & UART_UARTIMSC_TXIM_BITS)) {
+        // fifo requires initial fill to get TX interrupts going
+        fill_tx_fifo(nullptr);
+        if(!xStreamBufferIsEmpty(tx)) {
+            // enable transmit interrupt without touching the fifo levels
+            hw_set_bits(&uart_get_hw(uart)->imsc, UART_UARTIMSC_TXIM_BITS);
+        }
+    }
+    // enable interrupts on NVIC
+    irq_set_enabled(irqn, true);
+}
+
+void PicoOsUart::fill_tx_fifo(BaseType_t *pxHigherPriorityTaskWoken) {
+    uart_hw_t *hw = uart_get_hw(uart);
+    uint8_t burst[fifo_size];
+    size_t space = 0;
+
+    if(hw->fr & UART_UARTFR_TXFE_BITS) {
+        space = fifo_size;
+    }
+    else if(hw->ris & UART_UARTRIS_TXRIS_BITS) {
+        // tx interrupt is raised when fifo level drops to 1/8 or below
+        space = fifo_size - fifo_size / 8;
+    }
+
+    if(space > 0) {
+        size_t count = xStreamBufferReceiveFromISR(tx, burst, space, pxHigherPriorityTaskWoken);
+        for(size_t i = 0; i < count; ++i) {
+            hw->dr = burst[i];
+        }
+    }
+    else {
+        // we don't know how much room there is so top up the fifo one byte at a time
+        while(uart_is_writable(uart) && xStreamBufferReceiveFromISR(tx, burst, 1, pxHigherPriorityTaskWoken) == 1) {
+            hw->dr = burst[0];
+        }
+    }
+}
+
 void PicoOsUart::uart_irq_rx() {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    while(uart_is_readable(uart)) {
-        uint8_t c = uart_getc(uart);
-        // ignoring return value for now
-        xQueueSendToBackFromISR(rx, &c, &xHigherPriorityTaskWoken);
+    uint8_t burst[fifo_size];
+    size_t count = 0;
+
+    while(count < fifo_size && uart_is_readable(uart)) {
+        uint32_t dr = uart_get_hw(uart)->dr;
+        if(dr & UART_UARTDR_OE_BITS) {
+            ++rx_overruns;
+        }
+        burst[count++] = static_cast<uint8_t>(dr);
+    }
+    if(count > 0) {
+        // whole burst goes to the buffer at once so the reader is woken only once
+        size_t sent = xStreamBufferSendFromISR(rx, burst, count, &xHigherPriorityTaskWoken);
+        rx_dropped += count - sent;
     }
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
 void PicoOsUart::uart_irq_tx() {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    uint8_t ch;
-    while(uart_is_writable(uart) && xQueueReceiveFromISR(tx, &ch, &xHigherPriorityTaskWoken) == pdTRUE) {
-        uart_get_hw(uart)->dr = ch;
+
+    if(uart_get_hw(uart)->mis & UART_UARTMIS_TXMIS_BITS) {
+        fill_tx_fifo(&xHigherPriorityTaskWoken);
+        if (xStreamBufferIsEmpty(tx)) {
+            // disable tx interrupt if transmit buffer is empty
+            hw_clear_bits(&uart_get_hw(uart)->imsc, UART_UARTIMSC_TXIM_BITS);
+        }
     }
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
 
-    if (xQueueIsQueueEmptyFromISR(tx)) {
-        // disable tx interrupt if transmit buffer is empty
-        uart_set_irq_enables(uart, true, false);
+void PicoOsUart::uart_irq_rx_timeout() {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    if(uart_get_hw(uart)->mis & UART_UARTMIS_RTMIS_BITS) {
+        uart_get_hw(uart)->icr = UART_UARTICR_RTIC_BITS;
+        xSemaphoreGiveFromISR(rx_ready, &xHigherPriorityTaskWoken);
     }
     portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
 }
 
+int PicoOsUart::dma_read(uint8_t *buffer, int size, int timeout) {
+    int count = 0;
+    TickType_t wait = pdMS_TO_TICKS(timeout);
+    TimeOut_t start;
+
+    while(count < size) {
+        // hardware flags overrun if dma could not keep the fifo drained
+        if(uart_get_hw(uart)->rsr & UART_UARTRSR_OE_BITS) {
+            ++rx_overruns;
+            uart_get_hw(uart)->rsr = UART_UARTRSR_OE_BITS;
+        }
+        size_t received = rx_ring->read(buffer + count, size - count, dma_rx_position());
+        if(received > 0) {
+            count += received;
+            wait = pdMS_TO_TICKS(timeout);
+            continue;
+        }
+        // a full block or the receive timeout wakes us up, the timeout is only raised while
+        // bytes wait in the fifo so the read timeout still bounds the delay if dma emptied it
+        vTaskSetTimeOutState(&start);
+        if(xSemaphoreTake(rx_ready, wait) != pdTRUE || xTaskCheckForTimeOut(&start, &wait) != pdFALSE) {
+            // one last look for bytes that arrived without a wake up
+            count += rx_ring->read(buffer + count, size - count, dma_rx_position());
+            break;
+        }
+    }
+    return count;
+}
+
+int PicoOsUart::dma_write(const uint8_t *buffer, int size) {
+    if(size <= 0) return 0;
+
+    xSemaphoreTake(tx_lock, portMAX_DELAY);
+    dma->start_tx(buffer, size);
+    // caller's buffer belongs to the engine until completion is signalled
+    if(xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+        while(xSemaphoreTake(tx_done, 0) != pdTRUE);
+    }
+    else {
+        xSemaphoreTake(tx_done, portMAX_DELAY);
+    }
+    xSemaphoreGive(tx_lock);
+
+    return size;
+}
+
+uint32_t PicoOsUart::dma_rx_position() {
+    // completion interrupt must not advance the ring while we combine block count and remaining count
+    taskENTER_CRITICAL();
+    uint32_t position = rx_ring->position(dma->rx_remaining());
+    taskEXIT_CRITICAL();
+    return position;
+}
+
+void PicoOsUart::dma_tx_done() {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    xSemaphoreGiveFromISR(tx_done, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
+void PicoOsUart::dma_rx_block_done() {
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    dma->start_rx(rx_ring->block_complete(), rx_ring->get_block_size());
+    xSemaphoreGiveFromISR(rx_ready, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
 int PicoOsUart::get_fifo_level() {
     const uint8_t flv[]={4, 8,16, 24, 28, 0, 0, 0, 0 };
     // figure out fifo level to calculate timeout
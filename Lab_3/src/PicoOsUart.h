@@ -9,13 +9,18 @@
 #include <hardware/irq.h>
 #include <string>
 #include "FreeRTOS.h"
-#include "queue.h"
+#include "stream_buffer.h"
+#include "semphr.h"
+#include "UartDma.h"
 
-class PicoOsUart {
+class PicoOsUart : private UartDma::Client {
     friend void pico_uart0_handler(void);
     friend void pico_uart1_handler(void);
 public:
-    PicoOsUart(int uart_nr, int tx_pin, int rx_pin, int speed, int stop = 1, int tx_size = 256, int rx_size = 256);
+    // in dma mode write() transmits straight from caller's buffer and returns when the buffer can be reused,
+    // received data goes to a ring of rx_size bytes and tx_size is not used
+    PicoOsUart(int uart_nr, int tx_pin, int rx_pin, int speed, int stop = 1, int tx_size = 256, int rx_size = 256,
+               bool use_dma = false);
     PicoOsUart(const PicoOsUart &) = delete; // prevent copying because each instance is associated with a HW peripheral
     int read(uint8_t *buffer, int size, int timeout = 500);
     int write(const uint8_t *buffer, int size);
@@ -24,14 +29,38 @@ public:
     int flush();
     int get_fifo_level();
     int get_baud();
+    // bytes received from the uart but lost because the rx buffer was full
+    uint32_t get_rx_dropped() const { return rx_ring ? rx_ring->get_dropped() : rx_dropped; }
+    // bytes lost in the hardware because the rx fifo was not drained in time
+    uint32_t get_rx_overruns() const { return rx_overruns; }
+    // bytes that write() could not queue within its timeout
+    uint32_t get_tx_dropped() const { return tx_dropped; }
 private:
+    static constexpr int fifo_size = 32; // depth of the PL011 hardware fifos
     void uart_irq_rx();
     void uart_irq_tx();
-    QueueHandle_t tx;
-    QueueHandle_t rx;
+    void uart_irq_rx_timeout();
+    void start_tx();
+    void fill_tx_fifo(BaseType_t *pxHigherPriorityTaskWoken);
+    int dma_read(uint8_t *buffer, int size, int timeout);
+    int dma_write(const uint8_t *buffer, int size);
+    uint32_t dma_rx_position();
+    void dma_tx_done() override;
+    void dma_rx_block_done() override;
+    static constexpr int dma_rx_blocks = 4;
+    StreamBufferHandle_t tx;
+    StreamBufferHandle_t rx;
+    SemaphoreHandle_t tx_lock; // stream buffers allow only one writer at a time
+    UartDma *dma;
+    DmaRxRing *rx_ring;
+    SemaphoreHandle_t tx_done;
+    SemaphoreHandle_t rx_ready;
     uart_inst_t *uart;
     int irqn;
     int speed;
+    volatile uint32_t rx_dropped;
+    volatile uint32_t rx_overruns;
+    volatile uint32_t tx_dropped;
 };
 
 
@@ -0,0 +1,76 @@
+//
+// RP2040 DMA engine for PicoOsUart
+//
+
+#include "PicoUartDma.h"
+
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+
+// one engine per uart
+static PicoUartDma *dma_engines[2];
+static bool dma_handler_installed;
+
+void pico_uart_dma_handler(void) {
+    for(auto engine : dma_engines) {
+        if(engine) engine->dma_irq();
+    }
+}
+
+PicoUartDma::PicoUartDma(uart_inst_t *uart) : uart{uart}, client{nullptr} {
+    tx_channel = dma_claim_unused_channel(true);
+    rx_channel = dma_claim_unused_channel(true);
+
+    // transmit: memory -> uart data register, paced by uart tx dreq
+    dma_channel_config c = dma_channel_get_default_config(tx_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, uart_get_dreq(uart, true));
+    dma_channel_configure(tx_channel, &c, &uart_get_hw(uart)->dr, nullptr, 0, false);
+
+    // receive: uart data register -> memory, paced by uart rx dreq
+    c = dma_channel_get_default_config(rx_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, uart_get_dreq(uart, false));
+    dma_channel_configure(rx_channel, &c, nullptr, &uart_get_hw(uart)->dr, 0, false);
+
+    dma_engines[uart_get_index(uart)] = this;
+    dma_channel_set_irq0_enabled(tx_channel, true);
+    dma_channel_set_irq0_enabled(rx_channel, true);
+    // dma irq is shared with anyone else using dma channels
+    if(!dma_handler_installed) {
+        irq_add_shared_handler(DMA_IRQ_0, pico_uart_dma_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+        dma_handler_installed = true;
+    }
+}
+
+void PicoUartDma::set_client(UartDma::Client *c) {
+    client = c;
+}
+
+void PicoUartDma::start_tx(const uint8_t *buffer, uint32_t size) {
+    dma_channel_transfer_from_buffer_now(tx_channel, buffer, size);
+}
+
+void PicoUartDma::start_rx(uint8_t *block, uint32_t size) {
+    dma_channel_transfer_to_buffer_now(rx_channel, block, size);
+}
+
+uint32_t PicoUartDma::rx_remaining() {
+    return dma_channel_hw_addr(rx_channel)->transfer_count;
+}
+
+void PicoUartDma::dma_irq() {
+    if(dma_channel_get_irq0_status(rx_channel)) {
+        dma_channel_acknowledge_irq0(rx_channel);
+        if(client) client->dma_rx_block_done();
+    }
+    if(dma_channel_get_irq0_status(tx_channel)) {
+        dma_channel_acknowledge_irq0(tx_channel);
+        if(client) client->dma_tx_done();
+    }
+}
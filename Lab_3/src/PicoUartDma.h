@@ -0,0 +1,28 @@
+//
+// RP2040 DMA engine for PicoOsUart
+//
+
+#ifndef RP2040_FREERTOS_IRQ_PICOUARTDMA_H
+#define RP2040_FREERTOS_IRQ_PICOUARTDMA_H
+
+#include <hardware/uart.h>
+#include "UartDma.h"
+
+class PicoUartDma : public UartDma {
+    friend void pico_uart_dma_handler(void);
+public:
+    explicit PicoUartDma(uart_inst_t *uart);
+    PicoUartDma(const PicoUartDma &) = delete; // owns two hardware dma channels
+    void set_client(Client *client) override;
+    void start_tx(const uint8_t *buffer, uint32_t size) override;
+    void start_rx(uint8_t *block, uint32_t size) override;
+    uint32_t rx_remaining() override;
+private:
+    void dma_irq();
+    uart_inst_t *uart;
+    Client *client;
+    uint tx_channel;
+    uint rx_channel;
+};
+
+#endif //RP2040_FREERTOS_IRQ_PICOUARTDMA_H
@@ -0,0 +1,112 @@
+//
+// Incremental per-task CPU load and stack usage collector.
+//
+
+#include "TaskStats.h"
+
+#include <cstring>
+
+static const char state_names[] = "XRBSD";  // running, ready, blocked, suspended, deleted
+
+// print str and pad with spaces to width characters
+static void print_column(Cli &cli, const char *str, size_t width) {
+    static const char spaces[] = "                ";
+    cli.print(str);
+    size_t length = strlen(str);
+    while(length < width) {
+        size_t pad = width - length;
+        if(pad > sizeof(spaces) - 1) pad = sizeof(spaces) - 1;
+        cli.print(spaces + sizeof(spaces) - 1 - pad);
+        length += pad;
+    }
+}
+
+TaskStats::TaskStats() :
+        status{}, rows{}, previous{}, count{0}, previous_count{0}, total{0}, interval{0}, idle{}, idle_delta{} {
+}
+
+bool TaskStats::sample() {
+    if(!idle[0]) {
+        // idle tasks exist only after the scheduler has been started
+#if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+        for(int core = 0; core < cores; ++core) idle[core] = xTaskGetIdleTaskHandleForCore(core);
+#else
+        idle[0] = xTaskGetIdleTaskHandle();
+#endif
+    }
+
+    memcpy(previous, rows, sizeof(rows));
+    previous_count = count;
+
+    // the scheduler is suspended only while the kernel fills the array
+    configRUN_TIME_COUNTER_TYPE now;
+    UBaseType_t tasks = uxTaskGetSystemState(status, max_tasks, &now);
+    if(tasks == 0) {  // more tasks than rows
+        count = 0;
+        return false;
+    }
+
+    interval = now - total;
+    total = now;
+    for(auto &delta : idle_delta) delta = 0;
+
+    count = static_cast<int>(tasks);
+    for(int i = 0; i < count; ++i) {
+        const TaskStatus_t &s = status[i];
+        Row &row = rows[i];
+        row.number = s.xTaskNumber;
+        // name is copied while the task surely exists
+        strncpy(row.name, s.pcTaskName, sizeof(row.name) - 1);
+        row.name[sizeof(row.name) - 1] = '\0';
+        row.state = s.eCurrentState;
+        row.priority = s.uxCurrentPriority;
+        row.runtime = s.ulRunTimeCounter;
+        row.delta = s.ulRunTimeCounter - previous_runtime(s.xTaskNumber);
+        row.stack_free = s.usStackHighWaterMark;
+        for(int core = 0; core < cores; ++core) {
+            if(s.xHandle == idle[core]) idle_delta[core] = row.delta;
+        }
+    }
+    return true;
+}
+
+void TaskStats::print(Cli &cli) {
+    cli.print("Task            State Prio   CPU%  Stack free\n");
+    for(int i = 0; i < count; ++i) {
+        const Row &row = rows[i];
+        char state[2] = {state_names[row.state <= eDeleted ? row.state : eDeleted], '\0'};
+        print_column(cli, row.name, 16);
+        print_column(cli, state, 6);
+        cli.print_int(static_cast<int32_t>(row.priority));
+        cli.print(row.priority < 10 ? "    " : "   ");
+        int32_t load = permille(row.delta);
+        // right align to "100.0"
+        if(load < 1000) cli.print(" ");
+        if(load < 100) cli.print(" ");
+        cli.print_fixed(load, 1, 1);
+        cli.print("  ");
+        cli.print_int(static_cast<int32_t>(row.stack_free));
+        cli.print("\n");
+    }
+    for(int core = 0; core < cores; ++core) {
+        cli.print("Core ");
+        cli.print_int(core);
+        cli.print(" load ");
+        cli.print_fixed(interval ? 1000 - permille(idle_delta[core]) : 0, 1, 1);
+        cli.print("%\n");
+    }
+}
+
+int32_t TaskStats::permille(configRUN_TIME_COUNTER_TYPE time) const {
+    if(interval == 0) return 0;
+    // a task can't run longer than the interval, clamp rounding errors at the edges of the samples
+    uint64_t result = static_cast<uint64_t>(time) * 1000 / interval;
+    return static_cast<int32_t>(result > 1000 ? 1000 : result);
+}
+
+configRUN_TIME_COUNTER_TYPE TaskStats::previous_runtime(UBaseType_t number) const {
+    for(int i = 0; i < previous_count; ++i) {
+        if(previous[i].number == number) return previous[i].runtime;
+    }
+    return 0;  // task was created during the interval
+}
@@ -0,0 +1,67 @@
+//
+// Incremental per-task CPU load and stack usage collector.
+//
+// sample() copies the kernel task list with uxTaskGetSystemState() into a
+// preallocated array. The scheduler is suspended only for that copy, loads
+// are computed from the run time counters of the previous sample and the
+// rows are written to the console one at a time, so printing a long table
+// doesn't hold up the other tasks. CPU percentages cover the time between
+// two samples, not the time since boot.
+//
+// The stack column is the high-water mark: the fewest words that have been
+// free on the task's stack since it was created. Stack sizes can be cut
+// down to the used part plus a margin.
+//
+
+#ifndef RP2040_FREERTOS_IRQ_TASKSTATS_H
+#define RP2040_FREERTOS_IRQ_TASKSTATS_H
+
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "Cli.h"
+
+class TaskStats {
+public:
+    static constexpr int max_tasks = 16;
+#if defined(configNUMBER_OF_CORES) && configNUMBER_OF_CORES > 1
+    static constexpr int cores = configNUMBER_OF_CORES;
+#else
+    static constexpr int cores = 1;
+#endif
+
+    TaskStats();
+    TaskStats(const TaskStats &) = delete;
+
+    // take a new sample, the interval starts from the previous sample
+    // returns false if there were more than max_tasks tasks
+    bool sample();
+    // print the rows of the latest sample
+    void print(Cli &cli);
+
+private:
+    struct Row {
+        UBaseType_t number;  // xTaskNumber, unique for the lifetime of the system
+        char name[configMAX_TASK_NAME_LEN];
+        eTaskState state;
+        UBaseType_t priority;
+        configRUN_TIME_COUNTER_TYPE runtime;  // counter value at the sample
+        configRUN_TIME_COUNTER_TYPE delta;    // run time during the interval
+        configSTACK_DEPTH_TYPE stack_free;    // words
+    };
+    // returns percentage of the interval with one decimal, as an integer
+    int32_t permille(configRUN_TIME_COUNTER_TYPE time) const;
+    configRUN_TIME_COUNTER_TYPE previous_runtime(UBaseType_t number) const;
+
+    TaskStatus_t status[max_tasks];
+    Row rows[max_tasks];
+    Row previous[max_tasks];
+    int count;
+    int previous_count;
+    configRUN_TIME_COUNTER_TYPE total;     // run time counter at the latest sample
+    configRUN_TIME_COUNTER_TYPE interval;  // run time counter ticks between the samples
+    TaskHandle_t idle[cores];
+    configRUN_TIME_COUNTER_TYPE idle_delta[cores];
+};
+
+#endif //RP2040_FREERTOS_IRQ_TASKSTATS_H
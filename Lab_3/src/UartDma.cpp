@@ -0,0 +1,58 @@
+//
+// DMA transport for PicoOsUart - hardware independent ring logic
+//
+
+#include "UartDma.h"
+
+#include <cstring>
+
+DmaRxRing::DmaRxRing(uint8_t *storage, uint32_t block_size, uint32_t block_count) :
+        storage{storage}, block_size{block_size}, block_count{block_count}, blocks_done{0}, tail{0}, dropped{0} {
+}
+
+uint8_t *DmaRxRing::current_block() const {
+    return storage + (blocks_done % block_count) * block_size;
+}
+
+uint8_t *DmaRxRing::block_complete() {
+    blocks_done = blocks_done + 1;
+    return current_block();
+}
+
+uint32_t DmaRxRing::position(uint32_t rx_remaining) const {
+    return blocks_done * block_size + (block_size - rx_remaining);
+}
+
+void DmaRxRing::discard_overwritten(uint32_t position) {
+    // the block that is being filled may overwrite the oldest block, so only
+    // block_count - 1 full blocks and the received part of the current one are valid
+    uint32_t valid = (block_count - 1) * block_size + position % block_size;
+    if(position - tail > valid) {
+        dropped += position - tail - valid;
+        tail = position - valid;
+    }
+}
+
+size_t DmaRxRing::read(uint8_t *buffer, size_t size, uint32_t position) {
+    discard_overwritten(position);
+    size_t count = position - tail;
+    if(count > size) count = size;
+
+    // copy in at most two parts: up to the end of storage and from the start
+    uint32_t capacity = block_size * block_count;
+    uint32_t offset = tail % capacity;
+    size_t first = capacity - offset;
+    if(first > count) first = count;
+    memcpy(buffer, storage + offset, first);
+    memcpy(buffer + first, storage, count - first);
+
+    tail += count;
+    return count;
+}
+
+size_t DmaRxRing::flush(uint32_t position) {
+    discard_overwritten(position);
+    size_t count = position - tail;
+    tail = position;
+    return count;
+}
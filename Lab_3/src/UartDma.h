@@ -0,0 +1,60 @@
+//
+// DMA transport for PicoOsUart.
+//
+// Hardware specific DMA handling is hidden behind UartDma so that ring and
+// completion logic in DmaRxRing can be exercised with a simulated engine.
+//
+
+#ifndef RP2040_FREERTOS_IRQ_UARTDMA_H
+#define RP2040_FREERTOS_IRQ_UARTDMA_H
+
+#include <cstdint>
+#include <cstddef>
+
+class UartDma {
+public:
+    // receives completion events, both are called in interrupt context
+    class Client {
+    public:
+        virtual void dma_tx_done() = 0;       // transmit buffer is no longer needed by the engine
+        virtual void dma_rx_block_done() = 0; // receive block given to start_rx() is full
+    };
+    virtual ~UartDma() = default;
+    virtual void set_client(Client *client) = 0;
+    // transfer size bytes straight from caller's buffer to the uart
+    virtual void start_tx(const uint8_t *buffer, uint32_t size) = 0;
+    // receive size bytes into block
+    virtual void start_rx(uint8_t *block, uint32_t size) = 0;
+    // bytes still missing from the block that is being received
+    virtual uint32_t rx_remaining() = 0;
+};
+
+// Receive ring made of equally sized blocks. The engine fills one block at a time
+// and moves to the next one on completion. Positions are free running byte counters.
+class DmaRxRing {
+public:
+    DmaRxRing(uint8_t *storage, uint32_t block_size, uint32_t block_count);
+    DmaRxRing(const DmaRxRing &) = delete;
+    uint8_t *current_block() const;
+    uint32_t get_block_size() const { return block_size; }
+    // called from completion interrupt, returns the block that engine must fill next
+    uint8_t *block_complete();
+    // total number of bytes written by the engine, rx_remaining is taken from the engine
+    // must not be preempted by block_complete() while running
+    uint32_t position(uint32_t rx_remaining) const;
+    // copy up to size bytes of data received before position to buffer
+    size_t read(uint8_t *buffer, size_t size, uint32_t position);
+    // discard everything received before position
+    size_t flush(uint32_t position);
+    uint32_t get_dropped() const { return dropped; }
+private:
+    void discard_overwritten(uint32_t position);
+    uint8_t *storage;
+    uint32_t block_size;
+    uint32_t block_count;
+    volatile uint32_t blocks_done;
+    uint32_t tail;
+    uint32_t dropped;
+};
+
+#endif //RP2040_FREERTOS_IRQ_UARTDMA_H
@@ -1,9 +1,9 @@
 #include <FreeRTOS.h>
 #include <task.h>
 #include <timers.h>
-#include <cstdio>
-#include <cstring>
 #include "PicoOsUart.h"
+#include "Cli.h"
+#include "TaskStats.h"
 #include "hardware/gpio.h"
 #include "hardware/timer.h"
 
@@ -21,12 +21,14 @@ uint32_t read_runtime_ctr(void) {
 TimerHandle_t inactivityTimer;
 TimerHandle_t ledToggleTimer;
 
-static char rxBuffer[128];
-static int bufferIndex = 0;
 static int ledToggleInterval = 5000; // Default to 5 seconds
 static TickType_t lastToggleTime = 0; // For 'time' command
+static volatile bool inactive = false; // partial command is discarded by uart task
 
-PicoOsUart myUart(0, UART_TX_PIN, UART_RX_PIN, UART_BAUD_RATE);
+// dma transport: echo and replies go out straight from the cli buffers, input wakes the uart task once per
+// block or when the line goes quiet
+PicoOsUart myUart(0, UART_TX_PIN, UART_RX_PIN, UART_BAUD_RATE, 1, 256, 256, true);
+static TaskStats taskStats; // only used by the uart task
 
 // toggle LED and send message
 void vToggleTimerCallback(TimerHandle_t) {
@@ -38,85 +40,83 @@ void vToggleTimerCallback(TimerHandle_t) {
 
 void vInactivityTimerCallback(TimerHandle_t) {
     myUart.send("[Inactive]\n");
-    bufferIndex = 0;
-    memset(rxBuffer, 0, sizeof(rxBuffer));  // Clear buffer
+    inactive = true;  // uart task owns the command buffer, let it clear it
 }
 
-void processCommand(PicoOsUart* uart, const char* command) {
-    char outputBuffer[256];
-    snprintf(outputBuffer, sizeof(outputBuffer), "Processing command: %s\n", command);
-    uart->send(outputBuffer);  // Use UART
-
-    if (strcmp(command, "help") == 0) {
-        const char* helpMessage =
-                "Commands:\n"
-                "help - display this message\n"
-                "interval <number> - set the LED toggle interval\n"
-                "time - show time since last LED toggle\n";
-        uart->send(helpMessage);
-    } else if (strncmp(command, "interval", 8) == 0) {
-        float interval = atof(command + 9) * 1000;
-        if (interval > 0) {
-            ledToggleInterval = interval;
-            if (xTimerChangePeriod(ledToggleTimer, pdMS_TO_TICKS(ledToggleInterval), portMAX_DELAY) != pdPASS) {
-                uart->send("Failed to change LED timer period\n");
-            } else {
-                snprintf(outputBuffer, sizeof(outputBuffer), "LED toggle interval set to %.2f seconds.\n", interval / 1000);
-                uart->send(outputBuffer);
-            }
+void helpCommand(Cli &cli, int, char *[]) {
+    cli.help();
+}
+
+void intervalCommand(Cli &cli, int argc, char *argv[]) {
+    int32_t interval; // milliseconds
+    if (argc > 1 && Cli::parse_fixed(argv[1], 3, interval) && interval > 0) {
+        ledToggleInterval = interval;
+        if (xTimerChangePeriod(ledToggleTimer, pdMS_TO_TICKS(ledToggleInterval), portMAX_DELAY) != pdPASS) {
+            cli.print("Failed to change LED timer period\n");
         } else {
-            uart->send("Invalid interval value.\n");
+            cli.print("LED toggle interval set to ");
+            cli.print_fixed(interval, 3, 2);
+            cli.print(" seconds.\n");
         }
-    } else if (strcmp(command, "time") == 0) {
-        TickType_t currentTime = xTaskGetTickCount();
-        TickType_t timeSinceToggle = currentTime - lastToggleTime;
-        float seconds = timeSinceToggle / (float)configTICK_RATE_HZ;
-        snprintf(outputBuffer, sizeof(outputBuffer), "Time since last LED toggle: %.1f seconds\n", seconds);
-        uart->send(outputBuffer);
     } else {
-        uart->send("Unknown command\n");
+        cli.print("Invalid interval value.\n");
     }
-
-    // Clear the buffer after processing
-    memset(rxBuffer, 0, sizeof(rxBuffer));
-    bufferIndex = 0;
 }
 
-// UART receive handler
-void uartReceiveHandler(PicoOsUart* uart) {
-    uint8_t c;
-
-    while (uart->read(&c, 1, 10) > 0) {
-        // Reset inactivity timer
-        xTimerReset(inactivityTimer, portMAX_DELAY);
-
-        if (c >= 32 && c <= 126) {  // Printable characters
-            uart->write(&c, 1);  // Echo back
-
-            if (bufferIndex < sizeof(rxBuffer) - 1) {
-                rxBuffer[bufferIndex++] = c;  // Add to buffer
-            } else {
-                uart->send("\r\nBuffer overflow\r\n");
-                bufferIndex = 0;  // Reset buffer
-            }
-        } else if (c == '\r' || c == '\n') {  // Newline or carriage return
-            uart->send("\r\n");  // Echo newline
-
-            rxBuffer[bufferIndex] = '\0';  // Null-terminate
-            processCommand(uart, rxBuffer);  // Process command
+void timeCommand(Cli &cli, int, char *[]) {
+    TickType_t currentTime = xTaskGetTickCount();
+    TickType_t timeSinceToggle = currentTime - lastToggleTime;
+    cli.print("Time since last LED toggle: ");
+    cli.print_fixed(static_cast<int32_t>(timeSinceToggle * 1000ULL / configTICK_RATE_HZ), 3, 1);
+    cli.print(" seconds\n");
+}
 
-            bufferIndex = 0;  // Reset buffer
+// without an argument the interval is the time since the previous tasks command
+void tasksCommand(Cli &cli, int argc, char *argv[]) {
+    int32_t interval; // milliseconds
+    if (argc > 1) {
+        if (!Cli::parse_fixed(argv[1], 3, interval) || interval <= 0) {
+            cli.print("Invalid interval value.\n");
+            return;
         }
+        taskStats.sample();
+        vTaskDelay(pdMS_TO_TICKS(interval));
+    }
+    if (!taskStats.sample()) {
+        cli.print("Too many tasks\n");
+        return;
     }
+    taskStats.print(cli);
 }
 
+// must be kept in alphabetical order
+static constexpr Cli::Command commands[] = {
+        {"help",     "",          "display this message",                  helpCommand},
+        {"interval", "<number>",  "set the LED toggle interval",           intervalCommand},
+        {"tasks",    "[seconds]", "show CPU load and free stack of tasks", tasksCommand},
+        {"time",     "",          "show time since last LED toggle",       timeCommand},
+};
+static_assert(Cli::is_sorted(commands), "command table must be sorted by name");
+
 // FreeRTOS task to handle UART
 void uartTask(void* pvParameters) {
     auto* uart = static_cast<PicoOsUart*>(pvParameters);
+    static Cli cli(*uart, commands);
+    uint8_t buffer[32];
 
     for (;;) {
-        uartReceiveHandler(uart);  // Continuously handle UART reception
-        //vTaskDelay(pdMS_TO_TICKS(10));
+        // read returns whatever arrived in a burst, usually a whole line
+        int count = uart->read(buffer, sizeof(buffer), 10);
+        if (inactive) {
+            inactive = false;
+            cli.reset();
+        }
+        if (count > 0) {
+            // Any input is activity, also the rest of a line that is typed slowly. The
+            // touch normally only marks the timer and does not wake the timer task
+            xTimerTouch(inactivityTimer, portMAX_DELAY);
+            cli.receive(buffer, count);
+        }
     }
 }
 
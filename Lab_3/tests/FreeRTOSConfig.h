@@ -0,0 +1,59 @@
+/*
+ * Kernel configuration of the host tests, built with the POSIX port.
+ *
+ * The tick count is 32 bits wide as on the target, see portmacro.h, and starts
+ * 4096 ticks before it wraps.  It only moves on while the tasks are idle, see
+ * virtual_tick.c, so timers of millions of ticks run out in moments.
+ */
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_IDLE_HOOK                     1
+#define configUSE_TICK_HOOK                     0
+#define configTICK_RATE_HZ                      ( ( TickType_t ) 100 )
+#define configMAX_PRIORITIES                    8
+#define configMINIMAL_STACK_SIZE                ( configSTACK_DEPTH_TYPE ) 4096    /* PTHREAD_STACK_MIN */
+#define configMAX_TASK_NAME_LEN                 16
+#define configUSE_16_BIT_TICKS                  0
+#define configINITIAL_TICK_COUNT                0xFFFFF000UL
+#define configUSE_MUTEXES                       1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configSTACK_DEPTH_TYPE                  uint32_t
+
+#define configUSE_TICKLESS_IDLE                 1
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vTestSkipIdleTicks( xExpectedIdleTime )
+void vTestSkipIdleTicks( uint32_t ulExpectedIdleTime );
+
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configTOTAL_HEAP_SIZE                   ( 16 * 1024 * 1024 )
+
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_TRACE_FACILITY                1
+
+/* Software timers as in the application build.  The queue takes the commands
+ * for all the timers of a test at once. */
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH                10240
+#define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
+#ifndef configUSE_TIMER_WHEEL
+#define configUSE_TIMER_WHEEL                   1
+#endif
+#define configUSE_TIMER_TOUCH                   1
+
+#include <assert.h>
+#define configASSERT(x)                         assert(x)
+
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_xTimerPendFunctionCall          1
+
+#endif /* FREERTOS_CONFIG_H */
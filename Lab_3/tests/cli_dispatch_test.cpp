@@ -0,0 +1,132 @@
+//
+// Test of the Cli command lookup on the host, see cli_stub. Checks that every
+// command of tables of 4 to 1024 commands is found and dispatched with its
+// arguments, that names which only share a prefix are not, and that lines
+// split over chunks or ended with CR LF run once. Then times the lookup
+// against the linear strcmp() chain that processCommand used, and whole lines
+// through receive(), for each table size.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Cli.h"
+
+static constexpr size_t sizes[] = {4, 16, 64, 256, 1024};
+static constexpr int LOOKUPS = 1000000;
+static constexpr int LINES = 200000;
+
+static int failures = 0;
+static int calls = 0;
+static int lastArgc = 0;
+static std::string lastArgs;
+
+static void countCommand(Cli &, int argc, char *argv[]) {
+    ++calls;
+    lastArgc = argc;
+    lastArgs.clear();
+    for (int i = 1; i < argc; ++i) {
+        lastArgs += argv[i];
+        lastArgs += ' ';
+    }
+}
+
+// names of the same length that sort in index order
+static std::vector<std::string> makeNames(size_t count) {
+    std::vector<std::string> names;
+    char name[16];
+    for (size_t i = 0; i < count; ++i) {
+        snprintf(name, sizeof(name), "cmd%04zu", i);
+        names.emplace_back(name);
+    }
+    return names;
+}
+
+// the if/else chain of strcmp() calls that Cli replaced
+static const Cli::Command *findLinear(const Cli::Command *commands, size_t count, const char *name) {
+    for (size_t i = 0; i < count; ++i) {
+        if (strcmp(name, commands[i].name) == 0) return &commands[i];
+    }
+    return nullptr;
+}
+
+static void check(bool ok, const char *what, size_t count) {
+    if (!ok) {
+        printf("%zu commands: %s\n", count, what);
+        ++failures;
+    }
+}
+
+static void checkTable(Cli &cli, const std::vector<std::string> &names, const std::vector<Cli::Command> &table) {
+    size_t count = table.size();
+    for (size_t i = 0; i < count; ++i) {
+        check(cli.find(names[i].c_str()) == &table[i], "command not found", count);
+    }
+    check(cli.find("cmd") == nullptr, "prefix found", count);
+    check(cli.find("cmd00000") == nullptr, "longer name found", count);
+    check(cli.find("") == nullptr, "empty name found", count);
+    check(cli.find("zzz") == nullptr, "name after the last found", count);
+
+    // arguments, repeated spaces and a line in three chunks ended by CR LF
+    std::string line = names[count / 2] + "  1.5   two\r\n";
+    calls = 0;
+    cli.receive(reinterpret_cast<const uint8_t *>(line.data()), 3);
+    cli.receive(reinterpret_cast<const uint8_t *>(line.data()) + 3, 5);
+    cli.receive(reinterpret_cast<const uint8_t *>(line.data()) + 8, static_cast<int>(line.size()) - 8);
+    check(calls == 1 && lastArgc == 3 && lastArgs == "1.5 two ", "line not dispatched once with its arguments", count);
+
+    calls = 0;
+    line = "nosuchcommand\r\n";
+    cli.receive(reinterpret_cast<const uint8_t *>(line.data()), static_cast<int>(line.size()));
+    check(calls == 0, "unknown command dispatched", count);
+}
+
+static void benchmark(Cli &cli, const std::vector<std::string> &names, const std::vector<Cli::Command> &table) {
+    using clock = std::chrono::steady_clock;
+    size_t count = table.size();
+    std::vector<size_t> order(4096);
+    for (auto &index : order) index = static_cast<size_t>(rand()) % count;
+
+    // the results are kept, so the lookups are not optimized away
+    volatile uintptr_t sink = 0;
+    auto start = clock::now();
+    for (int i = 0; i < LOOKUPS; ++i) {
+        sink += reinterpret_cast<uintptr_t>(cli.find(names[order[i & 4095]].c_str()));
+    }
+    double binary = std::chrono::duration<double, std::nano>(clock::now() - start).count() / LOOKUPS;
+
+    start = clock::now();
+    for (int i = 0; i < LOOKUPS; ++i) {
+        sink += reinterpret_cast<uintptr_t>(findLinear(table.data(), count, names[order[i & 4095]].c_str()));
+    }
+    double linear = std::chrono::duration<double, std::nano>(clock::now() - start).count() / LOOKUPS;
+
+    // whole lines as the uart task passes them in: echo, tokenize, find and run
+    std::vector<std::string> lines;
+    for (size_t i = 0; i < 4096; ++i) lines.push_back(names[order[i]] + " 1\r\n");
+    start = clock::now();
+    for (int i = 0; i < LINES; ++i) {
+        const std::string &line = lines[i & 4095];
+        cli.receive(reinterpret_cast<const uint8_t *>(line.data()), static_cast<int>(line.size()));
+    }
+    double dispatch = std::chrono::duration<double, std::nano>(clock::now() - start).count() / LINES;
+
+    printf("%5zu commands: find %5.1f ns, strcmp chain %7.1f ns, whole line %6.1f ns\n", count, binary, linear, dispatch);
+}
+
+int main() {
+    for (size_t count : sizes) {
+        std::vector<std::string> names = makeNames(count);
+        std::vector<Cli::Command> table;
+        for (const auto &name : names) table.push_back({name.c_str(), "", "", countCommand});
+
+        PicoOsUart uart;
+        Cli cli(uart, table.data(), table.size());
+        checkTable(cli, names, table);
+        benchmark(cli, names, table);
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+//
+// Stand-in for PicoOsUart on the host, it counts what Cli writes. It has the
+// include guard of the real header and is force-included ahead of it, as
+// Cli.h includes PicoOsUart.h from its own directory.
+//
+
+#ifndef RP2040_FREERTOS_IRQ_PICOOSUART_H
+#define RP2040_FREERTOS_IRQ_PICOOSUART_H
+
+#include <cstdint>
+#include <cstring>
+
+class PicoOsUart {
+public:
+    int write(const uint8_t *, int size) {
+        written += size;
+        return size;
+    }
+    int send(const char *str) {
+        return write(reinterpret_cast<const uint8_t *>(str), static_cast<int>(strlen(str)));
+    }
+    uint64_t written = 0;
+};
+
+#endif //RP2040_FREERTOS_IRQ_PICOOSUART_H
@@ -0,0 +1,257 @@
+//
+// Test of DmaRxRing on the host. A simulated engine implements UartDma: it
+// writes bytes into the block it was given and moves its write pointer, and
+// when the block is full it stops and raises the completion, which is handled
+// as PicoOsUart does it, possibly a while later. The bytes of the stream are
+// a hash of their index, so a reader can tell which byte it got.
+//
+// Checks partial blocks, reads across the end of the storage, completions that
+// are pending while the reader looks, and overruns: every byte read has to be
+// the next byte of the stream after the ones counted as dropped, and nothing
+// may be dropped while the reader is no more than block_count - 1 blocks behind.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "UartDma.h"
+
+static int failures = 0;
+
+static uint8_t streamByte(uint32_t index) {
+    index *= 2654435761u;
+    return static_cast<uint8_t>(index >> 24);
+}
+
+static void check(bool ok, const char *scenario, const char *what) {
+    if (!ok) {
+        if (failures < 10) printf("%s: %s\n", scenario, what);
+        ++failures;
+    }
+}
+
+// engine with a write pointer into the block it was last started on
+class FakeDma : public UartDma {
+public:
+    void set_client(Client *c) override { client = c; }
+    void start_tx(const uint8_t *, uint32_t) override {}
+    void start_rx(uint8_t *b, uint32_t size) override {
+        block = b;
+        block_size = size;
+        written = 0;
+    }
+    uint32_t rx_remaining() override { return block_size - written; }
+
+    // takes up to count bytes of the stream, a full block stops the engine until the completion is handled
+    uint32_t receive(uint32_t count) {
+        uint32_t taken = 0;
+        while (taken < count && !pending) {
+            block[written++] = streamByte(sent++);
+            ++taken;
+            if (written == block_size) {
+                pending = true;
+                if (!deferred) complete();
+            }
+        }
+        return taken;
+    }
+    // the completion interrupt
+    void complete() {
+        if (pending) {
+            pending = false;
+            client->dma_rx_block_done();
+        }
+    }
+    bool deferred = false;  // completion waits for complete()
+    bool pending = false;
+    uint32_t sent = 0;
+private:
+    Client *client = nullptr;
+    uint8_t *block = nullptr;
+    uint32_t block_size = 0;
+    uint32_t written = 0;
+};
+
+// the receive side of PicoOsUart with a reader that checks the stream
+class Receiver : public UartDma::Client {
+public:
+    Receiver(const char *scenario, uint32_t block_size, uint32_t block_count) :
+            scenario{scenario}, storage(block_size * block_count), ring(storage.data(), block_size, block_count),
+            block_size{block_size}, block_count{block_count} {
+        dma.set_client(this);
+        dma.start_rx(ring.current_block(), ring.get_block_size());
+    }
+    void dma_tx_done() override {}
+    void dma_rx_block_done() override { dma.start_rx(ring.block_complete(), ring.get_block_size()); }
+
+    uint32_t position() { return ring.position(dma.rx_remaining()); }
+
+    // reads up to size bytes and checks them, returns the count
+    size_t read(size_t size) {
+        uint32_t lag = dma.sent - consumed - ring.get_dropped();
+        uint32_t dropped = ring.get_dropped();
+        std::vector<uint8_t> buffer(size + 1, 0xA5);
+        size_t count = ring.read(buffer.data(), size, position());
+        uint32_t newly_dropped = ring.get_dropped() - dropped;
+
+        check(buffer[size] == 0xA5, scenario, "read past the end of the buffer");
+        check(count <= size, scenario, "read more than asked");
+        if (lag <= (block_count - 1) * block_size) {
+            check(newly_dropped == 0, scenario, "dropped bytes that were still in the ring");
+        }
+        check(count == (size < lag - newly_dropped ? size : lag - newly_dropped), scenario,
+              "did not read all the bytes it kept");
+        for (size_t i = 0; i < count; ++i) {
+            if (buffer[i] != streamByte(consumed + ring.get_dropped() + i)) {
+                check(false, scenario, "byte out of order or overwritten");
+                break;
+            }
+        }
+        consumed += count;
+        return count;
+    }
+    size_t flush() {
+        uint32_t lag = dma.sent - consumed - ring.get_dropped();
+        uint32_t dropped = ring.get_dropped();
+        size_t count = ring.flush(position());
+        check(count + (ring.get_dropped() - dropped) == lag, scenario, "flush did not discard everything");
+        consumed += count;
+        return count;
+    }
+    // every byte the engine wrote was read, flushed or counted as dropped
+    void check_totals() {
+        flush();
+        check(consumed + ring.get_dropped() == position(), scenario, "bytes lost without being counted");
+    }
+
+    const char *scenario;
+    std::vector<uint8_t> storage;
+    DmaRxRing ring;
+    FakeDma dma;
+    uint32_t block_size;
+    uint32_t block_count;
+    uint32_t consumed = 0;
+};
+
+static void partialBlocks() {
+    Receiver rx("partial blocks", 16, 4);
+    check(rx.read(8) == 0, rx.scenario, "read from an empty ring");
+    rx.dma.receive(5);
+    check(rx.read(8) == 5, rx.scenario, "part of a block not read");
+    rx.dma.receive(7);
+    check(rx.read(3) == 3 && rx.read(8) == 4, rx.scenario, "rest of a block not read");
+    // across the end of the first block, one byte at a time
+    for (int i = 0; i < 40; ++i) {
+        rx.dma.receive(1);
+        check(rx.read(8) == 1, rx.scenario, "single byte not read");
+    }
+    rx.check_totals();
+    check(rx.ring.get_dropped() == 0, rx.scenario, "dropped while reading along");
+}
+
+static void wrap() {
+    // reads of sizes that do not divide the storage start and end anywhere in it
+    Receiver rx("wrap", 16, 4);
+    for (int round = 0; round < 200; ++round) {
+        rx.dma.receive(37);
+        while (rx.read(11) > 0) {}
+    }
+    rx.check_totals();
+    check(rx.ring.get_dropped() == 0, rx.scenario, "dropped while reading along");
+
+    // the reader one block short of the ring behind, then reading it all in one copy
+    Receiver full("wrap, full ring", 16, 4);
+    for (int round = 0; round < 50; ++round) {
+        full.dma.receive(48 + round % 16 / 4);
+        full.read(64);
+    }
+    full.check_totals();
+}
+
+static void pendingCompletion() {
+    Receiver rx("pending completion", 16, 4);
+    rx.dma.deferred = true;
+    rx.dma.receive(20);
+    check(rx.dma.pending && rx.dma.sent == 16, rx.scenario, "engine did not stop at the end of the block");
+    check(rx.position() == 16, rx.scenario, "position of a full block with the completion pending");
+    check(rx.read(32) == 16, rx.scenario, "full block not read before the completion");
+    rx.dma.complete();
+    check(rx.position() == 16, rx.scenario, "position moved on the completion");
+    rx.dma.receive(4);
+    check(rx.read(32) == 4, rx.scenario, "next block not read");
+
+    // the engine runs ahead with completions late, the reader three blocks behind
+    for (int round = 0; round < 100; ++round) {
+        for (int burst = 0; burst < 6; ++burst) {
+            rx.dma.receive(7);
+            if (rx.dma.pending && rand() % 2) rx.dma.complete();
+        }
+        rx.dma.complete();
+        rx.read(64);
+    }
+    rx.check_totals();
+    check(rx.ring.get_dropped() == 0, rx.scenario, "dropped while reading along");
+}
+
+static void overrun() {
+    Receiver rx("overrun", 16, 4);
+    // 100 bytes while nobody reads: what the ring keeps is the last 3 blocks and the part of the current one
+    rx.dma.receive(100);
+    check(rx.read(200) == 3 * 16 + 100 % 16, rx.scenario, "kept bytes not read");
+    check(rx.ring.get_dropped() == 100 - (3 * 16 + 100 % 16), rx.scenario, "dropped count");
+    rx.check_totals();
+
+    // overrun in the middle of a partly read block
+    rx.dma.receive(10);
+    rx.read(3);
+    rx.dma.receive(1000);
+    rx.read(2000);
+    rx.check_totals();
+
+    // flush after an overrun counts the overwritten bytes as dropped, not flushed
+    uint32_t dropped = rx.ring.get_dropped();
+    rx.dma.receive(90);
+    check(rx.flush() == 3 * 16 + rx.position() % 16, rx.scenario, "flush discarded overwritten bytes");
+    check(rx.ring.get_dropped() > dropped, rx.scenario, "overrun before flush not counted");
+    rx.dma.receive(5);
+    check(rx.read(16) == 5, rx.scenario, "read after flush");
+    rx.check_totals();
+}
+
+// random engine bursts, late completions, reads of any size and flushes
+static void randomized() {
+    static constexpr uint32_t shapes[][2] = {{1, 2}, {4, 2}, {16, 4}, {32, 8}, {7, 3}};
+    for (const auto &shape : shapes) {
+        Receiver rx("random", shape[0], shape[1]);
+        uint32_t capacity = shape[0] * shape[1];
+        for (int step = 0; step < 100000; ++step) {
+            int action = rand() % 10;
+            if (action < 5) {
+                rx.dma.deferred = rand() % 4 == 0;
+                rx.dma.receive(1 + static_cast<uint32_t>(rand()) % capacity);
+            } else if (action < 6) {
+                rx.dma.complete();
+            } else if (action < 9) {
+                rx.read(1 + static_cast<size_t>(rand()) % (2 * capacity));
+            } else if (rand() % 20 == 0) {
+                rx.flush();
+            }
+            if (!rx.dma.deferred) rx.dma.complete();
+        }
+        rx.check_totals();
+        printf("%2u blocks of %2u bytes: %u bytes, %u read or flushed, %u dropped\n", shape[1], shape[0], rx.dma.sent,
+               rx.consumed, rx.ring.get_dropped());
+    }
+}
+
+int main() {
+    srand(1);
+    partialBlocks();
+    wrap();
+    pendingCompletion();
+    overrun();
+    randomized();
+    printf("dma rx ring: %d failures\n", failures);
+    return failures ? 1 : 0;
+}
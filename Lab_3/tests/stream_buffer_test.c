@@ -0,0 +1,747 @@
+/*
+ * Test of xStreamBufferSendV(), xStreamBufferPeek() and xStreamBufferDiscard()
+ * on stream and message buffers.
+ *
+ * Random sends of 0 to 8 fragments, some of them empty and some sends longer
+ * than the buffer, are mixed with plain sends, receives, peeks at random
+ * offsets and discards on small buffers, so the data wraps around the end of
+ * the storage all the time.  The bytes sent are numbered, and every result is
+ * checked against a model of what the buffer holds.
+ *
+ * xStreamBufferSend() and xStreamBufferSendV() wait for space in the same
+ * prvWaitForSpace(): the same sends are made through both on twin buffers,
+ * timing out or woken by a receive or a discard, and have to return the same
+ * lengths on the same ticks.  Last, frames of a header, a payload and a CRC
+ * are sent in 1 to 18 fragments and timed against assembling them first.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "message_buffer.h"
+
+#define RANDOM_STEPS        200000
+#define MAX_FRAGMENTS       8
+#define MAX_MESSAGES        64
+#define CONTROL_PRIORITY    2
+#define WRITER_PRIORITY     3
+#define BENCH_FRAMES        200000
+#define WATCHDOG_SECONDS    60      /* the test takes a few seconds */
+
+/* The length stored in front of each message */
+#define LENGTH_BYTES        sizeof( configMESSAGE_BUFFER_LENGTH_TYPE )
+
+static uint32_t ulFailures;
+
+static void prvFail( const char * pcScenario,
+                     const char * pcWhat )
+{
+    if( ulFailures++ < 10U )
+    {
+        printf( "%s: %s\n", pcScenario, pcWhat );
+    }
+}
+
+static uint8_t prvStreamByte( uint32_t ulIndex )
+{
+    ulIndex *= 2654435761U;
+    return ( uint8_t ) ( ulIndex >> 24 );
+}
+
+/* Counts the bytes that are not the stream's bytes from ulIndex on. */
+static size_t prvCheckBytes( const uint8_t * pucData,
+                             size_t xLength,
+                             uint32_t ulIndex )
+{
+    size_t x, xWrong = 0;
+
+    for( x = 0; x < xLength; x++ )
+    {
+        xWrong += ( pucData[ x ] != prvStreamByte( ulIndex + ( uint32_t ) x ) ) ? 1U : 0U;
+    }
+
+    return xWrong;
+}
+
+/*-----------------------------------------------------------*/
+
+/* What the buffer should hold: the bytes numbered ulRead to ulWritten, and
+ * for a message buffer the lengths of the messages they form. */
+typedef struct Model
+{
+    const char * pcScenario;
+    StreamBufferHandle_t xBuffer;
+    size_t xSize;
+    BaseType_t xIsMessageBuffer;
+    uint32_t ulRead;
+    uint32_t ulWritten;
+    size_t xMessages[ MAX_MESSAGES ];
+    size_t xFirstMessage;
+    size_t xMessageCount;
+} Model_t;
+
+typedef struct Counts
+{
+    uint32_t ulSends;
+    uint32_t ulFullSends;
+    uint32_t ulPartialSends;
+    uint32_t ulRefusedSends;
+    uint32_t ulEmptyFragments;
+    uint32_t ulPeeks;
+    uint32_t ulDiscards;
+    uint32_t ulReceives;
+} Counts_t;
+
+static Counts_t xCounts;
+
+static size_t prvModelSpace( const Model_t * pxModel )
+{
+    size_t xUsed = ( size_t ) ( pxModel->ulWritten - pxModel->ulRead ) + pxModel->xMessageCount * LENGTH_BYTES;
+
+    return pxModel->xSize - xUsed;
+}
+
+static size_t prvNextMessage( const Model_t * pxModel )
+{
+    return ( pxModel->xMessageCount != 0U ) ? pxModel->xMessages[ pxModel->xFirstMessage ] : 0U;
+}
+
+static void prvRemoveBytes( Model_t * pxModel,
+                            size_t xCount )
+{
+    pxModel->ulRead += ( uint32_t ) xCount;
+
+    if( pxModel->xIsMessageBuffer != pdFALSE )
+    {
+        pxModel->xFirstMessage = ( pxModel->xFirstMessage + 1U ) % MAX_MESSAGES;
+        pxModel->xMessageCount--;
+    }
+}
+
+static void prvCheckLevels( const Model_t * pxModel )
+{
+    if( ( xStreamBufferSpacesAvailable( pxModel->xBuffer ) != prvModelSpace( pxModel ) ) ||
+        ( xStreamBufferBytesAvailable( pxModel->xBuffer ) != pxModel->xSize - prvModelSpace( pxModel ) ) )
+    {
+        prvFail( pxModel->pcScenario, "space or bytes available differ from the model" );
+    }
+
+    if( ( pxModel->xIsMessageBuffer != pdFALSE ) &&
+        ( xMessageBufferNextLengthBytes( pxModel->xBuffer ) != prvNextMessage( pxModel ) ) )
+    {
+        prvFail( pxModel->pcScenario, "length of the next message differs from the model" );
+    }
+}
+
+/* Sends up to MAX_FRAGMENTS fragments of random length, 0 included, cut out of
+ * the next bytes of the stream.  Every so often the total is longer than the
+ * buffer. */
+static void prvRandomSend( Model_t * pxModel )
+{
+    static uint8_t ucSource[ MAX_FRAGMENTS * 256 ];
+    StreamBufferFragment_t xFragments[ MAX_FRAGMENTS ];
+    UBaseType_t uxCount = ( UBaseType_t ) ( rand() % ( MAX_FRAGMENTS + 1 ) );
+    size_t xLongest = ( ( rand() % 8 ) == 0 ) ? pxModel->xSize : pxModel->xSize / 3U + 1U;
+    size_t xTotal = 0, xExpected, xSent, xSpace;
+    BaseType_t xWoken = pdFALSE;
+    UBaseType_t ux;
+    int iPath = rand() % 4;
+
+    for( ux = 0; ux < uxCount; ux++ )
+    {
+        xFragments[ ux ].xLengthBytes = ( ( rand() % 5 ) == 0 ) ? 0U : ( size_t ) rand() % ( xLongest + 1U );
+        xFragments[ ux ].pvData = &ucSource[ xTotal ];
+        xTotal += xFragments[ ux ].xLengthBytes;
+        xCounts.ulEmptyFragments += ( xFragments[ ux ].xLengthBytes == 0U ) ? 1U : 0U;
+    }
+
+    configASSERT( xTotal <= sizeof( ucSource ) );
+
+    for( ux = 0; ux < xTotal; ux++ )
+    {
+        ucSource[ ux ] = prvStreamByte( pxModel->ulWritten + ( uint32_t ) ux );
+    }
+
+    xSpace = prvModelSpace( pxModel );
+
+    if( pxModel->xIsMessageBuffer != pdFALSE )
+    {
+        xExpected = ( ( xTotal != 0U ) && ( xTotal + LENGTH_BYTES <= xSpace ) ) ? xTotal : 0U;
+    }
+    else
+    {
+        xExpected = configMIN( xTotal, xSpace );
+    }
+
+    switch( iPath )
+    {
+        case 0:
+            xSent = xStreamBufferSendV( pxModel->xBuffer, xFragments, uxCount, 0 );
+            break;
+
+        case 1:
+            xSent = xStreamBufferSendVFromISR( pxModel->xBuffer, xFragments, uxCount, &xWoken );
+            break;
+
+        case 2:
+            /* Through the buffer's own send, as the fragments are contiguous */
+            xSent = xStreamBufferSend( pxModel->xBuffer, ucSource, xTotal, 0 );
+            break;
+
+        default:
+            /* A message that would not fit an empty buffer returns at once,
+             * though it may wait. */
+            xSent = xStreamBufferSendV( pxModel->xBuffer, xFragments, uxCount,
+                                        ( ( pxModel->xIsMessageBuffer != pdFALSE ) &&
+                                          ( xTotal + LENGTH_BYTES > pxModel->xSize ) ) ? portMAX_DELAY : 0 );
+            break;
+    }
+
+    xCounts.ulSends++;
+    xCounts.ulFullSends += ( ( xSent == xTotal ) && ( xTotal != 0U ) ) ? 1U : 0U;
+    xCounts.ulPartialSends += ( ( xSent != 0U ) && ( xSent < xTotal ) ) ? 1U : 0U;
+    xCounts.ulRefusedSends += ( ( xSent == 0U ) && ( xTotal != 0U ) ) ? 1U : 0U;
+
+    if( xSent != xExpected )
+    {
+        prvFail( pxModel->pcScenario, "send wrote an unexpected length" );
+        return;
+    }
+
+    if( xSent != 0U )
+    {
+        if( pxModel->xIsMessageBuffer != pdFALSE )
+        {
+            configASSERT( pxModel->xMessageCount < MAX_MESSAGES );
+            pxModel->xMessages[ ( pxModel->xFirstMessage + pxModel->xMessageCount ) % MAX_MESSAGES ] = xSent;
+            pxModel->xMessageCount++;
+        }
+
+        pxModel->ulWritten += ( uint32_t ) xSent;
+    }
+}
+
+/* Peeks at a random offset, not beyond the data by more than a few bytes. */
+static void prvRandomPeek( Model_t * pxModel )
+{
+    uint8_t ucData[ 1024 ];
+    size_t xAvailable, xOffset, xLength, xExpected, xGot;
+
+    xAvailable = ( pxModel->xIsMessageBuffer != pdFALSE ) ? prvNextMessage( pxModel ) :
+                 ( size_t ) ( pxModel->ulWritten - pxModel->ulRead );
+    xOffset = ( size_t ) rand() % ( xAvailable + 4U );
+    xLength = ( size_t ) rand() % ( pxModel->xSize + 4U );
+    xExpected = ( xOffset < xAvailable ) ? configMIN( xAvailable - xOffset, xLength ) : 0U;
+
+    memset( ucData, 0xA5, sizeof( ucData ) );
+    xGot = xStreamBufferPeek( pxModel->xBuffer, ucData, xOffset, xLength );
+    xCounts.ulPeeks++;
+
+    if( xGot != xExpected )
+    {
+        prvFail( pxModel->pcScenario, "peek copied an unexpected length" );
+    }
+    else if( prvCheckBytes( ucData, xGot, pxModel->ulRead + ( uint32_t ) xOffset ) != 0U )
+    {
+        prvFail( pxModel->pcScenario, "peek copied the wrong bytes" );
+    }
+    else if( ucData[ xGot ] != 0xA5U )
+    {
+        prvFail( pxModel->pcScenario, "peek copied past the length" );
+    }
+}
+
+static void prvRandomDiscard( Model_t * pxModel )
+{
+    size_t xAvailable = ( size_t ) ( pxModel->ulWritten - pxModel->ulRead );
+    size_t xLength = ( size_t ) rand() % ( pxModel->xSize + 1U );
+    size_t xExpected, xGot;
+
+    if( pxModel->xIsMessageBuffer != pdFALSE )
+    {
+        xExpected = ( ( pxModel->xMessageCount != 0U ) && ( prvNextMessage( pxModel ) <= xLength ) ) ?
+                    prvNextMessage( pxModel ) : 0U;
+    }
+    else
+    {
+        xExpected = configMIN( xLength, xAvailable );
+    }
+
+    xGot = xStreamBufferDiscard( pxModel->xBuffer, xLength );
+    xCounts.ulDiscards++;
+
+    if( xGot != xExpected )
+    {
+        prvFail( pxModel->pcScenario, "discard removed an unexpected length" );
+    }
+    else if( xGot != 0U )
+    {
+        prvRemoveBytes( pxModel, xGot );
+    }
+}
+
+static void prvRandomReceive( Model_t * pxModel )
+{
+    uint8_t ucData[ 1024 ];
+    size_t xAvailable = ( size_t ) ( pxModel->ulWritten - pxModel->ulRead );
+    size_t xLength = ( size_t ) rand() % ( pxModel->xSize + 1U );
+    size_t xExpected, xGot;
+
+    if( pxModel->xIsMessageBuffer != pdFALSE )
+    {
+        xExpected = ( ( pxModel->xMessageCount != 0U ) && ( prvNextMessage( pxModel ) <= xLength ) ) ?
+                    prvNextMessage( pxModel ) : 0U;
+    }
+    else
+    {
+        xExpected = configMIN( xLength, xAvailable );
+    }
+
+    xGot = xStreamBufferReceive( pxModel->xBuffer, ucData, xLength, 0 );
+    xCounts.ulReceives++;
+
+    if( xGot != xExpected )
+    {
+        prvFail( pxModel->pcScenario, "receive copied an unexpected length" );
+    }
+    else if( prvCheckBytes( ucData, xGot, pxModel->ulRead ) != 0U )
+    {
+        prvFail( pxModel->pcScenario, "receive copied the wrong bytes" );
+    }
+    else if( xGot != 0U )
+    {
+        prvRemoveBytes( pxModel, xGot );
+    }
+}
+
+static void prvCheckRandom( const char * pcScenario,
+                            size_t xSize,
+                            BaseType_t xIsMessageBuffer )
+{
+    Model_t xModel = { 0 };
+    uint32_t ulStep;
+    int iAction;
+
+    xModel.pcScenario = pcScenario;
+    xModel.xSize = xSize;
+    xModel.xIsMessageBuffer = xIsMessageBuffer;
+    xModel.xBuffer = ( xIsMessageBuffer != pdFALSE ) ? xMessageBufferCreate( xSize ) : xStreamBufferCreate( xSize, 1 );
+    configASSERT( xModel.xBuffer != NULL );
+    memset( &xCounts, 0, sizeof( xCounts ) );
+
+    for( ulStep = 0; ulStep < RANDOM_STEPS; ulStep++ )
+    {
+        iAction = rand() % 10;
+
+        if( iAction < 4 )
+        {
+            prvRandomSend( &xModel );
+        }
+        else if( iAction < 6 )
+        {
+            prvRandomPeek( &xModel );
+        }
+        else if( iAction < 8 )
+        {
+            prvRandomDiscard( &xModel );
+        }
+        else
+        {
+            prvRandomReceive( &xModel );
+        }
+
+        prvCheckLevels( &xModel );
+    }
+
+    printf( "%-14s %4u bytes: %lu sends (%lu whole, %lu partial, %lu refused, %lu empty fragments), "
+            "%lu peeks, %lu discards, %lu receives, %lu bytes through\n",
+            pcScenario, ( unsigned ) xSize, ( unsigned long ) xCounts.ulSends, ( unsigned long ) xCounts.ulFullSends,
+            ( unsigned long ) xCounts.ulPartialSends, ( unsigned long ) xCounts.ulRefusedSends,
+            ( unsigned long ) xCounts.ulEmptyFragments, ( unsigned long ) xCounts.ulPeeks,
+            ( unsigned long ) xCounts.ulDiscards, ( unsigned long ) xCounts.ulReceives, ( unsigned long ) xModel.ulWritten );
+
+    vStreamBufferDelete( xModel.xBuffer );
+}
+
+/*-----------------------------------------------------------*/
+
+typedef enum
+{
+    eSend,          /* xStreamBufferSend() */
+    eSendVOne,      /* xStreamBufferSendV(), the data in one fragment */
+    eSendVSplit,    /* xStreamBufferSendV(), the data in three, one of them empty */
+    ePaths
+} SendPath_t;
+
+static const char * const pcPaths[ ePaths ] = { "send", "sendv 1", "sendv 3" };
+
+typedef struct Writer
+{
+    StreamBufferHandle_t xBuffer;
+    SendPath_t ePath;
+    size_t xLength;
+    TickType_t xTicksToWait;
+    size_t xSent;
+    TickType_t xWaited;
+    TaskHandle_t xNotify;
+} Writer_t;
+
+static size_t prvSend( StreamBufferHandle_t xBuffer,
+                       SendPath_t ePath,
+                       const uint8_t * pucData,
+                       size_t xLength,
+                       TickType_t xTicksToWait )
+{
+    StreamBufferFragment_t xFragments[ 3 ] =
+    {
+        { pucData,               xLength / 2U           },
+        { NULL,                  0U                     },
+        { pucData + xLength / 2U, xLength - xLength / 2U }
+    };
+
+    if( ePath == eSend )
+    {
+        return xStreamBufferSend( xBuffer, pucData, xLength, xTicksToWait );
+    }
+    else if( ePath == eSendVOne )
+    {
+        xFragments[ 0 ].xLengthBytes = xLength;
+        return xStreamBufferSendV( xBuffer, xFragments, 1, xTicksToWait );
+    }
+    else
+    {
+        return xStreamBufferSendV( xBuffer, xFragments, 3, xTicksToWait );
+    }
+}
+
+static void prvWriterTask( void * pvParameters )
+{
+    Writer_t * pxWriter = ( Writer_t * ) pvParameters;
+    uint8_t ucData[ 64 ];
+    TickType_t xStart = xTaskGetTickCount();
+    size_t x;
+
+    for( x = 0; x < sizeof( ucData ); x++ )
+    {
+        ucData[ x ] = prvStreamByte( 1000U + ( uint32_t ) x );
+    }
+
+    pxWriter->xSent = prvSend( pxWriter->xBuffer, pxWriter->ePath, ucData, pxWriter->xLength, pxWriter->xTicksToWait );
+    pxWriter->xWaited = xTaskGetTickCount() - xStart;
+
+    xTaskNotifyGive( pxWriter->xNotify );
+    vTaskDelete( NULL );
+}
+
+typedef enum
+{
+    eNobody,        /* the send times out */
+    eReceive,       /* woken by a receive after 20 ticks */
+    eDiscard,       /* woken by a discard after 20 ticks */
+    eWakers
+} Waker_t;
+
+static const char * const pcWakers[ eWakers ] = { "timeout", "receive", "discard" };
+
+/* Fills a buffer of 32 bytes, then a task of higher priority sends
+ * xLength bytes with xTicksToWait through ePath, while this task frees up to
+ * xFree bytes after 20 ticks or not. */
+static void prvBlockingSend( Writer_t * pxWriter,
+                             BaseType_t xIsMessageBuffer,
+                             SendPath_t ePath,
+                             Waker_t eWaker,
+                             size_t xLength,
+                             TickType_t xTicksToWait,
+                             size_t xFree )
+{
+    uint8_t ucFill[ 32 ];
+    size_t xGot, xExpected;
+
+    pxWriter->xBuffer = ( xIsMessageBuffer != pdFALSE ) ? xMessageBufferCreate( 32 ) : xStreamBufferCreate( 32, 1 );
+    configASSERT( pxWriter->xBuffer != NULL );
+    pxWriter->ePath = ePath;
+    pxWriter->xLength = xLength;
+    pxWriter->xTicksToWait = xTicksToWait;
+    pxWriter->xNotify = xTaskGetCurrentTaskHandle();
+
+    /* Stream: 30 bytes, 2 free.  Message: 8 and 6 bytes, 2 free. */
+    memset( ucFill, 0, sizeof( ucFill ) );
+
+    if( xIsMessageBuffer != pdFALSE )
+    {
+        ( void ) xMessageBufferSend( pxWriter->xBuffer, ucFill, 16U - LENGTH_BYTES, 0 );
+        ( void ) xMessageBufferSend( pxWriter->xBuffer, ucFill, 14U - LENGTH_BYTES, 0 );
+    }
+    else
+    {
+        ( void ) xStreamBufferSend( pxWriter->xBuffer, ucFill, 30, 0 );
+    }
+
+    xTaskCreate( prvWriterTask, "Writer", configMINIMAL_STACK_SIZE, pxWriter, WRITER_PRIORITY, NULL );
+
+    if( eWaker != eNobody )
+    {
+        vTaskDelay( 20 );
+        xGot = ( eWaker == eReceive ) ? xStreamBufferReceive( pxWriter->xBuffer, ucFill, xFree, 0 ) :
+               xStreamBufferDiscard( pxWriter->xBuffer, xFree );
+
+        /* The first message, or up to the 30 bytes of the stream */
+        xExpected = ( xIsMessageBuffer != pdFALSE ) ? 16U - LENGTH_BYTES : configMIN( xFree, 30U );
+
+        if( xGot != xExpected )
+        {
+            prvFail( "blocking", "could not free the space" );
+        }
+    }
+
+    ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+    vStreamBufferDelete( pxWriter->xBuffer );
+}
+
+/* The waits of xStreamBufferSend() and xStreamBufferSendV(), which share
+ * prvWaitForSpace(), have to end on the same tick with the same length
+ * written. */
+static void prvCheckBlocking( void )
+{
+    static const struct
+    {
+        BaseType_t xIsMessageBuffer;
+        size_t xLength;
+        TickType_t xTicksToWait;
+        size_t xFree;       /* by the waker */
+        size_t xSent;       /* expected */
+        TickType_t xWaited; /* expected */
+    }
+    xCases[] =
+    {
+        { pdFALSE, 10, 50,            0,  2,  50 }, /* part of the data after the timeout */
+        { pdFALSE, 10, portMAX_DELAY, 16, 10, 20 }, /* woken once 10 bytes are free */
+        { pdFALSE, 60, 50,            0,  2,  50 }, /* longer than the buffer: waits for it all to be free */
+        { pdFALSE, 60, portMAX_DELAY, 32, 32, 20 },
+        { pdTRUE,  6,  50,            0,  0,  50 }, /* no room for the message */
+        { pdTRUE,  6,  portMAX_DELAY, 16, 6,  20 },
+        { pdTRUE,  40, portMAX_DELAY, 0,  0,  0  }, /* never fits, does not wait */
+    };
+    Writer_t xWriters[ ePaths ];
+    size_t xCase;
+    int iPath, iWaker;
+    char cScenario[ 64 ];
+
+    for( xCase = 0; xCase < sizeof( xCases ) / sizeof( xCases[ 0 ] ); xCase++ )
+    {
+        for( iWaker = eNobody; iWaker < eWakers; iWaker++ )
+        {
+            /* Waits that time out before the space is freed, or do not wait
+             * at all, are only made once. */
+            if( ( iWaker != eNobody ) && ( xCases[ xCase ].xWaited != 20U ) )
+            {
+                continue;
+            }
+
+            if( ( iWaker == eNobody ) && ( xCases[ xCase ].xWaited == 20U ) )
+            {
+                continue;
+            }
+
+            for( iPath = eSend; iPath < ePaths; iPath++ )
+            {
+                prvBlockingSend( &xWriters[ iPath ], xCases[ xCase ].xIsMessageBuffer, ( SendPath_t ) iPath,
+                                 ( Waker_t ) iWaker, xCases[ xCase ].xLength, xCases[ xCase ].xTicksToWait,
+                                 xCases[ xCase ].xFree );
+                snprintf( cScenario, sizeof( cScenario ), "blocking %s %u bytes, %s, %s",
+                          ( xCases[ xCase ].xIsMessageBuffer != pdFALSE ) ? "message" : "stream",
+                          ( unsigned ) xCases[ xCase ].xLength, pcWakers[ iWaker ], pcPaths[ iPath ] );
+
+                if( ( xWriters[ iPath ].xSent != xCases[ xCase ].xSent ) ||
+                    ( xWriters[ iPath ].xWaited != xCases[ xCase ].xWaited ) )
+                {
+                    printf( "%s: sent %u after %lu ticks\n", cScenario, ( unsigned ) xWriters[ iPath ].xSent,
+                            ( unsigned long ) xWriters[ iPath ].xWaited );
+                    prvFail( cScenario, "unexpected length or wait" );
+                }
+
+                if( ( xWriters[ iPath ].xSent != xWriters[ eSend ].xSent ) ||
+                    ( xWriters[ iPath ].xWaited != xWriters[ eSend ].xWaited ) )
+                {
+                    prvFail( cScenario, "differs from xStreamBufferSend()" );
+                }
+            }
+
+            printf( "blocking %-7s %2u bytes, %-7s: %2u bytes sent after %2lu ticks by all paths\n",
+                    ( xCases[ xCase ].xIsMessageBuffer != pdFALSE ) ? "message" : "stream",
+                    ( unsigned ) xCases[ xCase ].xLength, pcWakers[ iWaker ], ( unsigned ) xWriters[ eSend ].xSent,
+                    ( unsigned long ) xWriters[ eSend ].xWaited );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static double prvNanoseconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( double ) xNow.tv_sec * 1e9 + ( double ) xNow.tv_nsec;
+}
+
+/* Frames of an 8 byte header, a payload and a 4 byte CRC through a message
+ * buffer: assembled in a local frame and sent, or sent in 1 to 18
+ * fragments, the payload cut in equal parts.  Each frame is received and
+ * the last one checked. */
+static void prvBenchmark( size_t xPayloadLength )
+{
+    static const UBaseType_t uxCounts[] = { 1, 3, 6, 10, 18 };
+    StreamBufferFragment_t xFragments[ 18 ];
+    uint8_t ucHeader[ 8 ], ucPayload[ 256 ], ucCRC[ 4 ], ucFrame[ 268 ], ucReceived[ 268 ];
+    size_t xFrameLength = sizeof( ucHeader ) + xPayloadLength + sizeof( ucCRC );
+    size_t x, xPart, xOffset, xGot = 0;
+    MessageBufferHandle_t xBuffer = xMessageBufferCreate( 1024 );
+    UBaseType_t uxCount, uxParts;
+    uint32_t ulFrame;
+    double dStart;
+
+    configASSERT( xBuffer != NULL );
+
+    for( x = 0; x < xFrameLength; x++ )
+    {
+        ucFrame[ x ] = prvStreamByte( ( uint32_t ) x );
+    }
+
+    memcpy( ucHeader, ucFrame, sizeof( ucHeader ) );
+    memcpy( ucPayload, &ucFrame[ sizeof( ucHeader ) ], xPayloadLength );
+    memcpy( ucCRC, &ucFrame[ sizeof( ucHeader ) + xPayloadLength ], sizeof( ucCRC ) );
+
+    /* Assembled from the three parts, then sent */
+    dStart = prvNanoseconds();
+
+    for( ulFrame = 0; ulFrame < BENCH_FRAMES; ulFrame++ )
+    {
+        memcpy( ucFrame, ucHeader, sizeof( ucHeader ) );
+        memcpy( &ucFrame[ sizeof( ucHeader ) ], ucPayload, xPayloadLength );
+        memcpy( &ucFrame[ sizeof( ucHeader ) + xPayloadLength ], ucCRC, sizeof( ucCRC ) );
+        ( void ) xMessageBufferSend( xBuffer, ucFrame, xFrameLength, 0 );
+        xGot = xMessageBufferReceive( xBuffer, ucReceived, sizeof( ucReceived ), 0 );
+    }
+
+    printf( "%3u byte payload: assembled %6.0f ns", ( unsigned ) xPayloadLength,
+            ( prvNanoseconds() - dStart ) / BENCH_FRAMES );
+
+    if( ( xGot != xFrameLength ) || ( prvCheckBytes( ucReceived, xGot, 0 ) != 0U ) )
+    {
+        prvFail( "benchmark", "assembled frame received wrong" );
+    }
+
+    for( x = 0; x < sizeof( uxCounts ) / sizeof( uxCounts[ 0 ] ); x++ )
+    {
+        uxCount = uxCounts[ x ];
+
+        if( uxCount == 1U )
+        {
+            xFragments[ 0 ].pvData = ucFrame;
+            xFragments[ 0 ].xLengthBytes = xFrameLength;
+        }
+        else
+        {
+            uxParts = uxCount - 2U;
+            xPart = xPayloadLength / uxParts;
+            xFragments[ 0 ].pvData = ucHeader;
+            xFragments[ 0 ].xLengthBytes = sizeof( ucHeader );
+
+            for( xOffset = 0; xOffset < uxParts; xOffset++ )
+            {
+                xFragments[ 1U + xOffset ].pvData = &ucPayload[ xOffset * xPart ];
+                xFragments[ 1U + xOffset ].xLengthBytes = ( xOffset + 1U < uxParts ) ? xPart :
+                                                          xPayloadLength - xOffset * xPart;
+            }
+
+            xFragments[ uxCount - 1U ].pvData = ucCRC;
+            xFragments[ uxCount - 1U ].xLengthBytes = sizeof( ucCRC );
+        }
+
+        memset( ucReceived, 0, sizeof( ucReceived ) );
+        dStart = prvNanoseconds();
+
+        for( ulFrame = 0; ulFrame < BENCH_FRAMES; ulFrame++ )
+        {
+            ( void ) xMessageBufferSendV( xBuffer, xFragments, uxCount, 0 );
+            xGot = xMessageBufferReceive( xBuffer, ucReceived, sizeof( ucReceived ), 0 );
+        }
+
+        printf( ", %2u fragments %6.0f ns", ( unsigned ) uxCount, ( prvNanoseconds() - dStart ) / BENCH_FRAMES );
+
+        if( ( xGot != xFrameLength ) || ( prvCheckBytes( ucReceived, xGot, 0 ) != 0U ) )
+        {
+            prvFail( "benchmark", "fragmented frame received wrong" );
+        }
+    }
+
+    printf( "\n" );
+    vMessageBufferDelete( xBuffer );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvControlTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    /* 1 byte, and sizes that the lengths of a message do not divide */
+    prvCheckRandom( "stream", 1, pdFALSE );
+    prvCheckRandom( "stream", 7, pdFALSE );
+    prvCheckRandom( "stream", 61, pdFALSE );
+    prvCheckRandom( "message", 17, pdTRUE );
+    prvCheckRandom( "message", 45, pdTRUE );
+    prvCheckRandom( "message", 203, pdTRUE );
+    prvCheckBlocking();
+
+    /* Host numbers: the copies are cheap next to the critical sections of
+     * the POSIX port. */
+    prvBenchmark( 64 );
+    prvBenchmark( 256 );
+
+    printf( "stream buffer: %lu failures\n", ( unsigned long ) ulFailures );
+    fflush( stdout );
+
+    /* Ends the process from the task, as in the Lab4 delayed task test. */
+    _exit( ulFailures ? 1 : 0 );
+}
+
+/* A task that does not wake keeps the test waiting, so it is failed on the
+ * host's clock. */
+static void * prvWatchdog( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    sleep( WATCHDOG_SECONDS );
+    printf( "stream buffer: still running after %d s\n", WATCHDOG_SECONDS );
+    fflush( stdout );
+    _exit( 1 );
+
+    return NULL;
+}
+
+int main( void )
+{
+    pthread_t xWatchdog;
+    sigset_t xAll, xOld;
+
+    /* The tick signal of the POSIX port has to go to the kernel's threads. */
+    sigfillset( &xAll );
+    pthread_sigmask( SIG_BLOCK, &xAll, &xOld );
+    pthread_create( &xWatchdog, NULL, prvWatchdog, NULL );
+    pthread_sigmask( SIG_SETMASK, &xOld, NULL );
+
+    srand( 1 );
+    xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, CONTROL_PRIORITY, NULL );
+    vTaskStartScheduler();
+
+    return 1;
+}
@@ -0,0 +1,233 @@
+/*
+ * Test of xTimerTouch() (configUSE_TIMER_TOUCH) against xTimerReset().
+ *
+ * Timers come in pairs of the same period and mode.  The same random sequence
+ * of operations is applied to both timers of a pair on the same tick, with
+ * xTimerReset() on one and xTimerTouch() on the other, mixed with stops and
+ * starts.  Some operations are made with the scheduler suspended, so they
+ * find commands of their own or of other timers pending in the timer queue,
+ * and some land on the tick a timer expires, so a touched timer is inserted
+ * again by prvExpireTimer().  Both timers of a pair have to expire on the
+ * same ticks, and report the same state and expiry time.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#define PAIRS               8
+#define STEPS               20000
+#define CONTROL_PRIORITY    2
+#define WATCHDOG_SECONDS    60      /* the test takes a few seconds */
+
+typedef struct TestTimer
+{
+    TimerHandle_t xHandle;
+    uint32_t ulCalls;
+    TickType_t xLastCall;
+} TestTimer_t;
+
+typedef struct TimerPair
+{
+    TestTimer_t xReset;     /* restarted with xTimerReset() */
+    TestTimer_t xTouch;     /* restarted with xTimerTouch() */
+} TimerPair_t;
+
+typedef enum
+{
+    eRestart,
+    eStop,
+    eStart,
+    eOperations
+} Operation_t;
+
+static TimerPair_t xPairs[ PAIRS ];
+static uint32_t ulMismatches, ulFailures;
+
+static const char * const pcBackend = ( configUSE_TIMER_WHEEL == 1 ) ? "wheel" : "lists";
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    TestTimer_t * pxTimer = ( TestTimer_t * ) pvTimerGetTimerID( xTimer );
+
+    pxTimer->ulCalls++;
+    pxTimer->xLastCall = xTaskGetTickCount();
+}
+
+static void prvOperate( TestTimer_t * pxTimer,
+                        Operation_t eOperation,
+                        BaseType_t xTouch )
+{
+    BaseType_t xResult = pdPASS;
+
+    /* With the scheduler suspended the commands are queued without blocking. */
+    switch( eOperation )
+    {
+        case eRestart:
+            xResult = ( xTouch != pdFALSE ) ? xTimerTouch( pxTimer->xHandle, 0 ) : xTimerReset( pxTimer->xHandle, 0 );
+            break;
+
+        case eStop:
+            xResult = xTimerStop( pxTimer->xHandle, 0 );
+            break;
+
+        case eStart:
+            xResult = xTimerStart( pxTimer->xHandle, 0 );
+            break;
+
+        default:
+            break;
+    }
+
+    if( xResult != pdPASS )
+    {
+        ulFailures++;
+    }
+}
+
+/* One operation on both timers of a pair, in either order: the first one's
+ * command is pending when the second one is operated on while the scheduler
+ * is suspended. */
+static void prvOperatePair( TimerPair_t * pxPair,
+                            Operation_t eOperation )
+{
+    if( ( rand() % 2 ) == 0 )
+    {
+        prvOperate( &pxPair->xReset, eOperation, pdFALSE );
+        prvOperate( &pxPair->xTouch, eOperation, pdTRUE );
+    }
+    else
+    {
+        prvOperate( &pxPair->xTouch, eOperation, pdTRUE );
+        prvOperate( &pxPair->xReset, eOperation, pdFALSE );
+    }
+}
+
+static void prvCompare( TimerPair_t * pxPair,
+                        uint32_t ulStep )
+{
+    TestTimer_t * pxReset = &pxPair->xReset;
+    TestTimer_t * pxTouch = &pxPair->xTouch;
+    BaseType_t xActive = xTimerIsTimerActive( pxReset->xHandle );
+
+    if( ( pxReset->ulCalls != pxTouch->ulCalls ) ||
+        ( pxReset->xLastCall != pxTouch->xLastCall ) ||
+        ( xActive != xTimerIsTimerActive( pxTouch->xHandle ) ) ||
+        ( ( xActive != pdFALSE ) && ( xTimerGetExpiryTime( pxReset->xHandle ) != xTimerGetExpiryTime( pxTouch->xHandle ) ) ) )
+    {
+        if( ulMismatches++ < 10U )
+        {
+            printf( "step %lu, %s period %lu: reset %lu calls, last %lu, expiry %lu, touch %lu calls, last %lu, expiry %lu\n",
+                    ( unsigned long ) ulStep, ( xTimerGetReloadMode( pxReset->xHandle ) != pdFALSE ) ? "auto-reload" : "one-shot",
+                    ( unsigned long ) xTimerGetPeriod( pxReset->xHandle ),
+                    ( unsigned long ) pxReset->ulCalls, ( unsigned long ) pxReset->xLastCall, ( unsigned long ) xTimerGetExpiryTime( pxReset->xHandle ),
+                    ( unsigned long ) pxTouch->ulCalls, ( unsigned long ) pxTouch->xLastCall, ( unsigned long ) xTimerGetExpiryTime( pxTouch->xHandle ) );
+        }
+    }
+}
+
+static Operation_t prvRandomOperation( void )
+{
+    int iKind = rand() % 10;
+
+    /* Mostly restarts, the operation being compared */
+    return ( iKind < 7 ) ? eRestart : ( ( iKind < 9 ) ? eStop : eStart );
+}
+
+static void prvControlTask( void * pvParameters )
+{
+    static const TickType_t xPeriods[ PAIRS / 2 ] = { 1, 2, 7, 100 };
+    UBaseType_t uxAvoidedBefore;
+    uint32_t ulStep, ulPair, ulOperations, ulSuspendedSteps = 0;
+    TimerPair_t * pxPair;
+
+    ( void ) pvParameters;
+
+    for( ulPair = 0; ulPair < PAIRS; ulPair++ )
+    {
+        const TickType_t xPeriod = xPeriods[ ulPair % ( PAIRS / 2 ) ];
+        const BaseType_t xAutoReload = ( ulPair < ( PAIRS / 2 ) ) ? pdFALSE : pdTRUE;
+
+        pxPair = &xPairs[ ulPair ];
+        pxPair->xReset.xHandle = xTimerCreate( "Reset", xPeriod, xAutoReload, &pxPair->xReset, prvCallback );
+        pxPair->xTouch.xHandle = xTimerCreate( "Touch", xPeriod, xAutoReload, &pxPair->xTouch, prvCallback );
+        configASSERT( ( pxPair->xReset.xHandle != NULL ) && ( pxPair->xTouch.xHandle != NULL ) );
+    }
+
+    uxAvoidedBefore = uxTimerGetAvoidedCommandCount();
+
+    for( ulStep = 0; ulStep < STEPS; ulStep++ )
+    {
+        if( ( rand() % 3 ) == 0 )
+        {
+            /* Several operations on the same tick, queued behind each other. */
+            vTaskSuspendAll();
+            {
+                for( ulOperations = 1U + ( uint32_t ) rand() % 4U; ulOperations > 0U; ulOperations-- )
+                {
+                    prvOperatePair( &xPairs[ rand() % PAIRS ], prvRandomOperation() );
+                }
+            }
+            ( void ) xTaskResumeAll();
+            ulSuspendedSteps++;
+        }
+        else
+        {
+            /* The timer service task runs the command at once. */
+            prvOperatePair( &xPairs[ rand() % PAIRS ], prvRandomOperation() );
+        }
+
+        /* Often on the next tick or on the tick a short timer expires */
+        vTaskDelay( ( TickType_t ) ( rand() % 4 ) );
+
+        for( ulPair = 0; ulPair < PAIRS; ulPair++ )
+        {
+            prvCompare( &xPairs[ ulPair ], ulStep );
+        }
+    }
+
+    printf( "touch, %s: %d steps, %lu with the scheduler suspended, %lu touches without a command\n", pcBackend,
+            STEPS, ( unsigned long ) ulSuspendedSteps, ( unsigned long ) ( uxTimerGetAvoidedCommandCount() - uxAvoidedBefore ) );
+    printf( "touch, %s: %lu mismatches, %lu failed operations\n", pcBackend, ( unsigned long ) ulMismatches, ( unsigned long ) ulFailures );
+    fflush( stdout );
+
+    /* Ends the process from the task, as in the Lab4 delayed task test. */
+    _exit( ( ulMismatches + ulFailures ) ? 1 : 0 );
+}
+
+/* A timer service task that stops running keeps the test waiting, so it is
+ * failed on the host's clock. */
+static void * prvWatchdog( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    sleep( WATCHDOG_SECONDS );
+    printf( "touch: still running after %d s\n", WATCHDOG_SECONDS );
+    fflush( stdout );
+    _exit( 1 );
+
+    return NULL;
+}
+
+int main( void )
+{
+    pthread_t xWatchdog;
+    sigset_t xAll, xOld;
+
+    /* The tick signal of the POSIX port has to go to the kernel's threads. */
+    sigfillset( &xAll );
+    pthread_sigmask( SIG_BLOCK, &xAll, &xOld );
+    pthread_create( &xWatchdog, NULL, prvWatchdog, NULL );
+    pthread_sigmask( SIG_SETMASK, &xOld, NULL );
+
+    srand( 1 );
+    xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, CONTROL_PRIORITY, NULL );
+    vTaskStartScheduler();
+
+    return 1;
+}
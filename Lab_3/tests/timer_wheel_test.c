@@ -0,0 +1,374 @@
+/*
+ * Test of the software timer wheel (configUSE_TIMER_WHEEL).
+ *
+ * One-shot timers with periods from one tick to beyond the 2^20 ticks the
+ * four levels of the wheel cover are started on the same tick, 4096 ticks
+ * before the tick count wraps, so they are inserted at every level, cascade
+ * down on their way to level 0 and most of them expire after the wrap.  Then
+ * a batch of timers that all expire on the same tick, and auto-reload timers.
+ * Every callback has to run on the tick at which its timer is due.
+ *
+ * Then 10000 timers are started, reset and left to expire, and the time the
+ * timer service task takes per timer is reported.  The same source is built
+ * with the timer lists as timer_list_test to compare.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#define CHECK_TIMERS        2000
+#define BATCH_TIMERS        1000
+#define BATCH_PERIOD        5000    /* cascaded from level 2 */
+#define RELOAD_TIMERS       100
+#define RELOAD_PERIODS      20
+#define BENCH_TIMERS        10000
+#define CONTROL_PRIORITY    2
+#define WATCHDOG_SECONDS    60      /* the test takes a few seconds */
+
+/* What a callback checks, the timer ID points to it */
+typedef struct TestTimer
+{
+    TimerHandle_t xHandle;
+    TickType_t xPeriod;
+    TickType_t xDue;        /* tick of the next expiry */
+    uint32_t ulCalls;
+} TestTimer_t;
+
+static TaskHandle_t xControlTask;
+static uint32_t ulExpected;     /* callbacks that end the current phase */
+static uint32_t ulCallbacks;
+static uint32_t ulEarly, ulLate, ulWrongExpiry, ulFailures;
+static double dFirstCallbackCpu, dLastCallbackCpu; /* of the timer service task */
+
+static const char * const pcBackend = ( configUSE_TIMER_WHEEL == 1 ) ? "wheel" : "lists";
+
+static double prvSeconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_MONOTONIC, &xNow );
+    return ( double ) xNow.tv_sec + ( double ) xNow.tv_nsec * 1e-9;
+}
+
+static double prvThreadCpuSeconds( void )
+{
+    struct timespec xNow;
+
+    clock_gettime( CLOCK_THREAD_CPUTIME_ID, &xNow );
+    return ( double ) xNow.tv_sec + ( double ) xNow.tv_nsec * 1e-9;
+}
+
+static void prvCallback( TimerHandle_t xTimer )
+{
+    TestTimer_t * pxTimer = ( TestTimer_t * ) pvTimerGetTimerID( xTimer );
+    TickType_t xNow = xTaskGetTickCount();
+
+    if( xNow != pxTimer->xDue )
+    {
+        /* Compared as the distance from the due tick, the tick count wraps. */
+        if( ( TickType_t ) ( pxTimer->xDue - xNow ) <= ( TickType_t ) 0x7FFFFFFFUL )
+        {
+            ulEarly++;
+        }
+        else
+        {
+            ulLate++;
+        }
+
+        printf( "%s: timer due at %lu ran at %lu\n", pcBackend, ( unsigned long ) pxTimer->xDue, ( unsigned long ) xNow );
+    }
+
+    pxTimer->ulCalls++;
+    pxTimer->xDue += pxTimer->xPeriod;
+
+    if( ++ulCallbacks == 1U )
+    {
+        dFirstCallbackCpu = prvThreadCpuSeconds();
+    }
+
+    if( ulCallbacks == ulExpected )
+    {
+        dLastCallbackCpu = prvThreadCpuSeconds();
+        xTaskNotifyGive( xControlTask );
+    }
+}
+
+/* Creates the timers with the periods set in their records. */
+static void prvCreateTimers( TestTimer_t * pxTimers,
+                             uint32_t ulCount,
+                             BaseType_t xAutoReload )
+{
+    uint32_t ul;
+
+    for( ul = 0; ul < ulCount; ul++ )
+    {
+        pxTimers[ ul ].xHandle = xTimerCreate( "Test", pxTimers[ ul ].xPeriod, xAutoReload, &pxTimers[ ul ], prvCallback );
+        configASSERT( pxTimers[ ul ].xHandle != NULL );
+    }
+}
+
+static void prvDeleteTimers( TestTimer_t * pxTimers,
+                             uint32_t ulCount )
+{
+    uint32_t ul;
+
+    for( ul = 0; ul < ulCount; ul++ )
+    {
+        xTimerDelete( pxTimers[ ul ].xHandle, portMAX_DELAY );
+    }
+
+    /* The deletes are processed before this task runs again. */
+    free( pxTimers );
+}
+
+/* Starts or restarts the timers, all on the same tick: the commands carry the
+ * tick count of the call, and it does not move on while the scheduler is
+ * suspended.  The timer service task processes them when the scheduler is
+ * resumed, before this task runs again.  Returns the tick. */
+static TickType_t prvStartTimers( TestTimer_t * pxTimers,
+                                  uint32_t ulCount )
+{
+    TickType_t xStart;
+    uint32_t ul;
+
+    ulCallbacks = 0;
+    ulExpected = ulCount;
+
+    vTaskSuspendAll();
+    {
+        xStart = xTaskGetTickCount();
+
+        for( ul = 0; ul < ulCount; ul++ )
+        {
+            pxTimers[ ul ].xDue = xStart + pxTimers[ ul ].xPeriod;
+            pxTimers[ ul ].ulCalls = 0;
+
+            /* Queued without blocking while the scheduler is suspended. */
+            if( xTimerStart( pxTimers[ ul ].xHandle, 0 ) != pdPASS )
+            {
+                ulFailures++;
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return xStart;
+}
+
+static void prvWaitForCallbacks( void )
+{
+    ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+}
+
+/* Periods up to the level of the wheel that holds them, and beyond. */
+static TickType_t prvRandomPeriod( void )
+{
+    static const uint32_t ulLimits[] = { 1UL << 5, 1UL << 10, 1UL << 15, 1UL << 20, 1UL << 23 };
+    uint32_t ulLevel = ( uint32_t ) rand() % ( sizeof( ulLimits ) / sizeof( ulLimits[ 0 ] ) );
+
+    return ( TickType_t ) ( 1U + ( uint32_t ) rand() % ulLimits[ ulLevel ] );
+}
+
+static void prvCheckExpiry( void )
+{
+    TestTimer_t * pxTimers = calloc( CHECK_TIMERS, sizeof( TestTimer_t ) );
+    TickType_t xStart = xTaskGetTickCount();
+    uint32_t ul, ulAfterWrap = 0;
+
+    for( ul = 0; ul < CHECK_TIMERS; ul++ )
+    {
+        pxTimers[ ul ].xPeriod = prvRandomPeriod();
+    }
+
+    /* Timers that expire on the ticks either side of the wrap */
+    pxTimers[ 0 ].xPeriod = ( TickType_t ) ( 0U - xStart ) - 1U;
+    pxTimers[ 1 ].xPeriod = ( TickType_t ) ( 0U - xStart );
+    pxTimers[ 2 ].xPeriod = ( TickType_t ) ( 0U - xStart ) + 1U;
+
+    prvCreateTimers( pxTimers, CHECK_TIMERS, pdFALSE );
+    xStart = prvStartTimers( pxTimers, CHECK_TIMERS );
+
+    for( ul = 0; ul < CHECK_TIMERS; ul++ )
+    {
+        if( xTimerGetExpiryTime( pxTimers[ ul ].xHandle ) != ( TickType_t ) ( xStart + pxTimers[ ul ].xPeriod ) )
+        {
+            ulWrongExpiry++;
+        }
+
+        if( ( TickType_t ) ( xStart + pxTimers[ ul ].xPeriod ) < xStart )
+        {
+            ulAfterWrap++;
+        }
+    }
+
+    prvWaitForCallbacks();
+
+    for( ul = 0; ul < CHECK_TIMERS; ul++ )
+    {
+        if( ( pxTimers[ ul ].ulCalls != 1U ) || ( xTimerIsTimerActive( pxTimers[ ul ].xHandle ) != pdFALSE ) )
+        {
+            ulFailures++;
+        }
+    }
+
+    printf( "%s: %d one-shot timers from tick %lu, %lu due after the wrap\n", pcBackend, CHECK_TIMERS,
+            ( unsigned long ) xStart, ( unsigned long ) ulAfterWrap );
+    prvDeleteTimers( pxTimers, CHECK_TIMERS );
+}
+
+static void prvCheckBatch( void )
+{
+    TestTimer_t * pxTimers = calloc( BATCH_TIMERS, sizeof( TestTimer_t ) );
+    TestTimer_t * pxReload = calloc( RELOAD_TIMERS, sizeof( TestTimer_t ) );
+    TickType_t xStart, xStopping, xStopped;
+    uint32_t ul, ulMin, ulMax;
+
+    /* All due on the same tick, the callbacks check they run on it. */
+    for( ul = 0; ul < BATCH_TIMERS; ul++ )
+    {
+        pxTimers[ ul ].xPeriod = BATCH_PERIOD;
+    }
+
+    prvCreateTimers( pxTimers, BATCH_TIMERS, pdFALSE );
+    prvStartTimers( pxTimers, BATCH_TIMERS );
+    prvWaitForCallbacks();
+
+    /* Auto-reload timers with periods on both sides of a level 0 turn,
+     * several of them expiring together. */
+    for( ul = 0; ul < RELOAD_TIMERS; ul++ )
+    {
+        pxReload[ ul ].xPeriod = ( TickType_t ) ( 1U + ul % 50U );
+    }
+
+    prvCreateTimers( pxReload, RELOAD_TIMERS, pdTRUE );
+    xStart = prvStartTimers( pxReload, RELOAD_TIMERS );
+    ulExpected = 0;
+
+    /* The longest period runs RELOAD_PERIODS times. */
+    vTaskDelay( 50 * RELOAD_PERIODS );
+
+    vTaskSuspendAll();
+    {
+        xStopping = xTaskGetTickCount();
+
+        for( ul = 0; ul < RELOAD_TIMERS; ul++ )
+        {
+            xTimerStop( pxReload[ ul ].xHandle, 0 );
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    /* Expiries on ticks that passed while the scheduler was suspended are
+     * processed before the stop commands. */
+    xStopped = xTaskGetTickCount();
+
+    for( ul = 0; ul < RELOAD_TIMERS; ul++ )
+    {
+        ulMin = ( uint32_t ) ( ( TickType_t ) ( xStopping - xStart ) / pxReload[ ul ].xPeriod );
+        ulMax = ( uint32_t ) ( ( TickType_t ) ( xStopped - xStart ) / pxReload[ ul ].xPeriod );
+
+        if( ( pxReload[ ul ].ulCalls < ulMin ) || ( pxReload[ ul ].ulCalls > ulMax ) )
+        {
+            ulFailures++;
+        }
+    }
+
+    printf( "%s: %d timers due on the same tick, %d auto-reload timers\n", pcBackend, BATCH_TIMERS, RELOAD_TIMERS );
+    prvDeleteTimers( pxTimers, BATCH_TIMERS );
+    prvDeleteTimers( pxReload, RELOAD_TIMERS );
+}
+
+/*-----------------------------------------------------------*/
+
+static void prvBenchmark( void )
+{
+    TestTimer_t * pxTimers = calloc( BENCH_TIMERS, sizeof( TestTimer_t ) );
+    double dStart, dStartAll, dResetAll;
+    uint32_t ul;
+
+    for( ul = 0; ul < BENCH_TIMERS; ul++ )
+    {
+        pxTimers[ ul ].xPeriod = ( TickType_t ) ( 1000 + rand() % 100000 );
+    }
+
+    prvCreateTimers( pxTimers, BENCH_TIMERS, pdFALSE );
+
+    /* The timer service task processes all the commands while this task waits
+     * for it, measured from the resume. */
+    dStart = prvSeconds();
+    prvStartTimers( pxTimers, BENCH_TIMERS );
+    dStartAll = prvSeconds() - dStart;
+
+    /* A reset takes the timer out and inserts it again. */
+    dStart = prvSeconds();
+    prvStartTimers( pxTimers, BENCH_TIMERS );
+    dResetAll = prvSeconds() - dStart;
+
+    /* Expiring is timed as the processor time of the timer service task from
+     * the first callback to the last, without the idle task moving the tick
+     * count on in between. */
+    prvWaitForCallbacks();
+
+    printf( "%s: %d timers, start %6.0f ns, reset %6.0f ns, expire %6.0f ns per timer\n", pcBackend, BENCH_TIMERS,
+            dStartAll * 1e9 / BENCH_TIMERS, dResetAll * 1e9 / BENCH_TIMERS,
+            ( dLastCallbackCpu - dFirstCallbackCpu ) * 1e9 / ( BENCH_TIMERS - 1 ) );
+    prvDeleteTimers( pxTimers, BENCH_TIMERS );
+}
+
+static void prvControlTask( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    prvCheckExpiry();
+    prvCheckBatch();
+
+    /* Host times, the ratio between the backends carries over. */
+    prvBenchmark();
+
+    printf( "%s: %lu early, %lu late, %lu wrong expiry times, %lu other failures\n", pcBackend,
+            ( unsigned long ) ulEarly, ( unsigned long ) ulLate, ( unsigned long ) ulWrongExpiry, ( unsigned long ) ulFailures );
+    fflush( stdout );
+
+    /* Ends the process from the task, as in the Lab4 delayed task test. */
+    _exit( ( ulEarly + ulLate + ulWrongExpiry + ulFailures ) ? 1 : 0 );
+}
+
+/* A timer that never runs keeps the test waiting, so it is failed on the
+ * host's clock. */
+static void * prvWatchdog( void * pvParameters )
+{
+    ( void ) pvParameters;
+
+    sleep( WATCHDOG_SECONDS );
+    printf( "%s: still waiting after %d s, %lu of %lu callbacks\n", pcBackend, WATCHDOG_SECONDS,
+            ( unsigned long ) ulCallbacks, ( unsigned long ) ulExpected );
+    fflush( stdout );
+    _exit( 1 );
+
+    return NULL;
+}
+
+int main( void )
+{
+    pthread_t xWatchdog;
+    sigset_t xAll, xOld;
+
+    /* The tick signal of the POSIX port has to go to the kernel's threads. */
+    sigfillset( &xAll );
+    pthread_sigmask( SIG_BLOCK, &xAll, &xOld );
+    pthread_create( &xWatchdog, NULL, prvWatchdog, NULL );
+    pthread_sigmask( SIG_SETMASK, &xOld, NULL );
+
+    srand( 1 );
+    xTaskCreate( prvControlTask, "Control", configMINIMAL_STACK_SIZE, NULL, CONTROL_PRIORITY, &xControlTask );
+    vTaskStartScheduler();
+
+    return 1;
+}
@@ -0,0 +1,39 @@
+/*
+ * The tick of the host tests only moves on while the tasks are idle, so the
+ * tests see the kernel work of a tick as taking no time and can check timings
+ * to the tick.  The POSIX port's tick timer is stopped when the idle task
+ * first runs.  From then on the idle hook advances the tick count by one and
+ * tickless idle moves it straight to the next tick at which a task unblocks.
+ */
+
+#include <sys/time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+void vApplicationIdleHook( void )
+{
+    static BaseType_t xTickTimerStopped = pdFALSE;
+    static const struct itimerval xStopped = { { 0, 0 }, { 0, 0 } };
+
+    if( xTickTimerStopped == pdFALSE )
+    {
+        ( void ) setitimer( ITIMER_REAL, &xStopped, NULL );
+        xTickTimerStopped = pdTRUE;
+    }
+
+    ( void ) xTaskCatchUpTicks( 1 );
+}
+
+void vTestSkipIdleTicks( uint32_t ulExpectedIdleTime )
+{
+    /* Called with the scheduler suspended.  Jumping to the wake time leaves
+     * the last tick pending, it is processed when the scheduler resumes. */
+    portDISABLE_INTERRUPTS();
+
+    if( eTaskConfirmSleepModeStatus() == eStandardSleep )
+    {
+        vTaskStepTick( ulExpectedIdleTime );
+    }
+
+    portENABLE_INTERRUPTS();
+}